@@ -1,10 +1,19 @@
 #include <iostream>
 #include <fstream>
 #include <string>
+#include <string_view>
 #include <algorithm>
 #include <cctype>
 #include <sstream>
+#include <cmath>
+#include <cstring>
+#include <cstdio>
 #include <chrono> // For time measurement
+#include <thread>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
 using namespace std;
 using namespace std::chrono;
 
@@ -24,6 +33,11 @@ struct WordFrequency {
     int count;    // Frequency count of the word
 };
 
+struct NgramFrequency {
+    unsigned long long key;  // Packed token ids of the n-gram
+    int count;               // Frequency count of the n-gram
+};
+
 // Global variable to track recursion depth in Quick Sort
 int recursionDepth = 0;
 
@@ -213,263 +227,2864 @@ void insertionSort(News *articles, int count) {
     }
 }
 
-void selectionSort(WordFrequency* wordFreq, int wordCount) {
-    for (int i = 0; i < wordCount - 1; i++) {
-        int maxIdx = i;
-        for (int j = i + 1; j < wordCount; j++) {
-            if (wordFreq[j].count > wordFreq[maxIdx].count) {
-                maxIdx = j;
-            }
+// ---------------------------------------------------------
+// ranksHigher: Ordering used for the top-K word report.
+// Higher count wins; equal counts fall back to alphabetical order
+// so the output is deterministic.
+// ---------------------------------------------------------
+bool ranksHigher(const WordFrequency &a, const WordFrequency &b) {
+    if (a.count != b.count)
+        return a.count > b.count;
+    return a.word < b.word;
+}
+
+bool ranksHigher(const NgramFrequency &a, const NgramFrequency &b) {
+    if (a.count != b.count)
+        return a.count > b.count;
+    return a.key < b.key;
+}
+
+// ---------------------------------------------------------
+// heapSiftDown: Restore the min-heap property (weakest word at
+// the root) for the subtree rooted at index i.
+// ---------------------------------------------------------
+template<typename T>
+void heapSiftDown(T* heap, int heapSize, int i) {
+    while (true) {
+        int weakest = i;
+        int left = 2 * i + 1;
+        int right = 2 * i + 2;
+        if (left < heapSize && ranksHigher(heap[weakest], heap[left]))
+            weakest = left;
+        if (right < heapSize && ranksHigher(heap[weakest], heap[right]))
+            weakest = right;
+        if (weakest == i)
+            return;
+        swap(heap[i], heap[weakest]);
+        i = weakest;
+    }
+}
+
+// ---------------------------------------------------------
+// topKWords: Select the K most frequent words without sorting
+// the whole vocabulary. Keeps a size-K min-heap whose root is the
+// weakest of the current winners, so each remaining word costs
+// one comparison and, at most, O(log K) work.
+// Returns a new array of resultCount words in descending order
+// (caller must delete[] it), or nullptr if there is nothing to show.
+// Works for any entry type with a ranksHigher overload (words, n-grams).
+// ---------------------------------------------------------
+template<typename T>
+T* topKWords(T* wordFreq, int wordCount, int k, int &resultCount) {
+    resultCount = (k < wordCount) ? k : wordCount;
+    if (resultCount <= 0) {
+        resultCount = 0;
+        return nullptr;
+    }
+
+    // Seed the heap with the first K words and heapify.
+    T* heap = new T[resultCount];
+    for (int i = 0; i < resultCount; i++)
+        heap[i] = wordFreq[i];
+    for (int i = resultCount / 2 - 1; i >= 0; i--)
+        heapSiftDown(heap, resultCount, i);
+
+    // Replace the root whenever a better word shows up.
+    for (int i = resultCount; i < wordCount; i++) {
+        if (ranksHigher(wordFreq[i], heap[0])) {
+            heap[0] = wordFreq[i];
+            heapSiftDown(heap, resultCount, 0);
         }
-        swap(wordFreq[i], wordFreq[maxIdx]);
     }
+
+    // Pop the weakest to the back repeatedly: leaves the array in descending order.
+    for (int end = resultCount - 1; end > 0; end--) {
+        swap(heap[0], heap[end]);
+        heapSiftDown(heap, end, 0);
+    }
+    return heap;
+}
+
+// ---------------------------------------------------------
+// internSubject: Id of a subject in a name table, adding it if it
+// is new. The table doubles when it is full, so every distinct
+// subject keeps an id of its own.
+// ---------------------------------------------------------
+int internSubject(string* &names, int &count, int &capacity, const string &subject) {
+    for (int s = 0; s < count; s++)
+        if (names[s] == subject)
+            return s;
+    if (count == capacity) {
+        int newCapacity = capacity ? capacity * 2 : 16;
+        string* grown = new string[newCapacity];
+        for (int s = 0; s < count; s++)
+            grown[s].swap(names[s]);
+        delete[] names;
+        names = grown;
+        capacity = newCapacity;
+    }
+    names[count] = subject;
+    return count++;
+}
+
+// ---------------------------------------------------------
+// Aggregate cube built at load time: article counts by (year, month,
+// subject, label) in one dense array. Its size depends only on the
+// number of distinct years and subjects, so every count below reads a
+// fixed number of cells however many articles were loaded.
+// The last year slot holds articles without a year; month 0 holds
+// articles whose month is unknown.
+// ---------------------------------------------------------
+const int CUBE_MONTHS = 13;         // 0 = unknown, 1..12
+
+// Dimensions for cubeBreakdown
+const int CUBE_BY_YEAR = 0;
+const int CUBE_BY_MONTH = 1;
+const int CUBE_BY_SUBJECT = 2;
+const int CUBE_BY_LABEL = 3;
+
+struct AggregateCube {
+    int total = 0;
+    int minYear = 0;
+    int yearCount = 0;                  // year slots = yearCount + 1
+    int subjectCount = 0;
+    int subjectCapacity = 0;
+    string* subjectNames = nullptr;
+    int* cells = nullptr;               // [((yearSlot * 13 + month) * subjectCount + subject) * 2 + label]
+};
+
+// A sub-cube: every field left at its default matches everything.
+struct CubeSlice {
+    string subject;                     // substring of the subject name
+    int label = -1;                     // 0 = FAKE, 1 = TRUE
+    int fromYear = 0, toYear = 0;       // inclusive
+    int fromMonth = 0, toMonth = 0;     // inclusive, 1..12
+};
+
+int cubeCell(const AggregateCube &cube, int yearSlot, int month, int subject, int label) {
+    return ((yearSlot * CUBE_MONTHS + month) * cube.subjectCount + subject) * 2 + label;
+}
+
+// ---------------------------------------------------------
+// buildAggregateCube: Add every article to its cell in one pass (after
+// a pass over the years and subjects to size those dimensions).
+// ---------------------------------------------------------
+void buildAggregateCube(News *articles, int count, AggregateCube &cube) {
+    int maxYear = 0;
+    cube.minYear = 0;
+    for (int i = 0; i < count; i++) {
+        internSubject(cube.subjectNames, cube.subjectCount, cube.subjectCapacity, articles[i].subject);
+        int year = articles[i].year;
+        if (year <= 0) continue;
+        if (cube.minYear == 0 || year < cube.minYear) cube.minYear = year;
+        if (year > maxYear) maxYear = year;
+    }
+    cube.yearCount = (cube.minYear > 0) ? maxYear - cube.minYear + 1 : 0;
+    cube.cells = new int[(cube.yearCount + 1) * CUBE_MONTHS * (cube.subjectCount > 0 ? cube.subjectCount : 1) * 2]();
+    cube.total = count;
+
+    for (int i = 0; i < count; i++) {
+        int s = internSubject(cube.subjectNames, cube.subjectCount, cube.subjectCapacity, articles[i].subject);
+
+        int yearSlot = (articles[i].year > 0) ? articles[i].year - cube.minYear : cube.yearCount;
+        // Month from "DD-MM-YYYY"
+        int month = 0;
+        const string &date = articles[i].date;
+        if (date.size() >= 5 && isdigit(static_cast<unsigned char>(date[3])) && isdigit(static_cast<unsigned char>(date[4])))
+            month = (date[3] - '0') * 10 + (date[4] - '0');
+        if (month < 1 || month > 12)
+            month = 0;
+
+        cube.cells[cubeCell(cube, yearSlot, month, s, articles[i].isTrue ? 1 : 0)]++;
+    }
+}
+
+void freeAggregateCube(AggregateCube &cube) {
+    delete[] cube.cells;
+    delete[] cube.subjectNames;
+    cube = AggregateCube();
 }
 
 // ---------------------------------------------------------
-// linearSearch: Search for a word in the WordFrequency array.
-// Returns the index if found, or -1 if not found.
+// cubeBreakdown: Totals of a slice along one dimension, written to
+// 'totals' (caller provides cubeDimensionSize entries):
+//   CUBE_BY_YEAR    [year - minYear], last entry = no year
+//   CUBE_BY_MONTH   [month], 0 = unknown
+//   CUBE_BY_SUBJECT [subject id], names in cube.subjectNames
+//   CUBE_BY_LABEL   [0] FAKE, [1] TRUE
 // ---------------------------------------------------------
-int linearSearch(WordFrequency* wordFreq, int wordCount, const string &word) {
-    for (int i = 0; i < wordCount; i++) {
-        if (wordFreq[i].word == word) {
-            return i;
+int cubeDimensionSize(const AggregateCube &cube, int dimension) {
+    switch (dimension) {
+        case CUBE_BY_YEAR: return cube.yearCount + 1;
+        case CUBE_BY_MONTH: return CUBE_MONTHS;
+        case CUBE_BY_SUBJECT: return cube.subjectCount;
+        default: return 2;
+    }
+}
+
+void cubeBreakdown(const AggregateCube &cube, const CubeSlice &slice, int dimension, int *totals) {
+    for (int i = 0; i < cubeDimensionSize(cube, dimension); i++)
+        totals[i] = 0;
+
+    // Year slots in the slice; a year filter never matches the no-year slot.
+    int firstSlot = 0, lastSlot = cube.yearCount;
+    if (slice.fromYear != 0 || slice.toYear != 0) {
+        int fromYear = slice.fromYear != 0 ? slice.fromYear : cube.minYear;
+        int toYear = slice.toYear != 0 ? slice.toYear : cube.minYear + cube.yearCount - 1;
+        firstSlot = max(fromYear - cube.minYear, 0);
+        lastSlot = min(toYear - cube.minYear, cube.yearCount - 1);
+    }
+    int firstMonth = 0, lastMonth = CUBE_MONTHS - 1;
+    if (slice.fromMonth != 0 || slice.toMonth != 0) {
+        firstMonth = max(slice.fromMonth, 1);
+        lastMonth = min(slice.toMonth != 0 ? slice.toMonth : 12, 12);
+    }
+    bool* subjectMatches = new bool[cube.subjectCount > 0 ? cube.subjectCount : 1];
+    for (int s = 0; s < cube.subjectCount; s++)
+        subjectMatches[s] = slice.subject.empty() || cube.subjectNames[s].find(slice.subject) != string::npos;
+    int firstLabel = (slice.label == 1) ? 1 : 0;
+    int lastLabel = (slice.label == 0) ? 0 : 1;
+
+    for (int y = firstSlot; y <= lastSlot; y++) {
+        for (int m = firstMonth; m <= lastMonth; m++) {
+            for (int s = 0; s < cube.subjectCount; s++) {
+                if (!subjectMatches[s]) continue;
+                for (int l = firstLabel; l <= lastLabel; l++) {
+                    int cell = cube.cells[cubeCell(cube, y, m, s, l)];
+                    switch (dimension) {
+                        case CUBE_BY_YEAR: totals[y] += cell; break;
+                        case CUBE_BY_MONTH: totals[m] += cell; break;
+                        case CUBE_BY_SUBJECT: totals[s] += cell; break;
+                        default: totals[l] += cell; break;
+                    }
+                }
+            }
         }
     }
-    return -1;
+    delete[] subjectMatches;
+}
+
+// ---------------------------------------------------------
+// cubeCount: Number of articles in a slice.
+// ---------------------------------------------------------
+int cubeCount(const AggregateCube &cube, const CubeSlice &slice) {
+    int labels[2];
+    cubeBreakdown(cube, slice, CUBE_BY_LABEL, labels);
+    return labels[0] + labels[1];
+}
+
+int defaultThreadCount() {
+    int threadCount = static_cast<int>(thread::hardware_concurrency());
+    return threadCount > 0 ? threadCount : 1;
 }
 
 // ---------------------------------------------------------
-// traverseAndCountArticles: Traverse the News array,
-// print each article's title and year, and count fake/true articles.
+// ThreadPool: A fixed set of worker threads started once and fed
+// from one task queue. A thread that waits on a task it submitted
+// runs queued tasks itself (runPendingTask) instead of blocking, so
+// nested submits cannot deadlock.
+// ---------------------------------------------------------
+class ThreadPool {
+public:
+    explicit ThreadPool(int threadCount) : workerCount(threadCount > 0 ? threadCount : 0) {
+        workers = new thread[workerCount > 0 ? workerCount : 1];
+        for (int t = 0; t < workerCount; t++)
+            workers[t] = thread([this] { workerLoop(); });
+    }
+
+    ~ThreadPool() {
+        {
+            lock_guard<mutex> lock(queueMutex);
+            stopping = true;
+        }
+        queueReady.notify_all();
+        for (int t = 0; t < workerCount; t++)
+            workers[t].join();
+        delete[] workers;
+        while (head) {
+            Task* next = head->next;
+            delete head;
+            head = next;
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void submit(function<void()> work) {
+        Task* task = new Task{std::move(work), nullptr};
+        {
+            lock_guard<mutex> lock(queueMutex);
+            if (tail) tail->next = task;
+            else head = task;
+            tail = task;
+        }
+        queueReady.notify_one();
+    }
+
+    // Run one queued task on the calling thread; false if the queue is empty.
+    bool runPendingTask() {
+        Task* task = takeTask(false);
+        if (!task)
+            return false;
+        task->work();
+        delete task;
+        return true;
+    }
+
+    int threads() const { return workerCount + 1; }    // workers plus the caller
+
+private:
+    struct Task {
+        function<void()> work;
+        Task* next;
+    };
+
+    thread* workers;
+    int workerCount;
+    Task* head = nullptr;
+    Task* tail = nullptr;
+    bool stopping = false;
+    mutex queueMutex;
+    condition_variable queueReady;
+
+    Task* takeTask(bool wait) {
+        unique_lock<mutex> lock(queueMutex);
+        if (wait)
+            queueReady.wait(lock, [this] { return head || stopping; });
+        Task* task = head;
+        if (task) {
+            head = task->next;
+            if (!head) tail = nullptr;
+        }
+        return task;
+    }
+
+    void workerLoop() {
+        while (Task* task = takeTask(true)) {
+            task->work();
+            delete task;
+        }
+    }
+};
+
+// Grain below which parallelReduce stops splitting and runs a plain loop.
+const int REDUCE_GRAIN = 2048;
+
+// ---------------------------------------------------------
+// parallelReduce: combine(map(begin), ..., map(end - 1)) starting
+// from identity. The range is halved recursively: the right half
+// becomes a pool task, the left half runs on the current thread, and
+// the two results are combined. Recursion depth is
+// log2(count / grain). Ranges of at most 'grain' elements run as a
+// plain loop. 'combine' must be associative.
 // ---------------------------------------------------------
-void traverseAndCountArticles(News *articles, int count) {
-    int fakeCount = 0;
-    int trueCount = 0;
+template <typename T, typename Map, typename Combine>
+T parallelReduce(ThreadPool &pool, int begin, int end, const T &identity, const Map &map, const Combine &combine,
+                 int grain = REDUCE_GRAIN) {
+    if (end - begin <= grain || pool.threads() == 1) {
+        T result = identity;
+        for (int i = begin; i < end; i++)
+            result = combine(result, map(i));
+        return result;
+    }
+    int middle = begin + (end - begin) / 2;
+    T right = identity;
+    atomic<bool> rightDone(false);
+    pool.submit([&] {
+        right = parallelReduce(pool, middle, end, identity, map, combine, grain);
+        rightDone.store(true, memory_order_release);
+    });
+    T left = parallelReduce(pool, begin, middle, identity, map, combine, grain);
+    while (!rightDone.load(memory_order_acquire)) {
+        if (!pool.runPendingTask())
+            this_thread::yield();
+    }
+    return combine(left, right);
+}
+
+// Matching and fake articles for the 2016 politics percentage.
+struct PoliticsCounts {
+    int total;
+    int fake;
+};
+
+PoliticsCounts addPoliticsCounts(const PoliticsCounts &a, const PoliticsCounts &b) {
+    return PoliticsCounts{a.total + b.total, a.fake + b.fake};
+}
 
+// ---------------------------------------------------------
+// traverseAndCountArticles: Traverse the News array and print each
+// article's title and year; the fake/true totals come from the cube.
+// There is nothing to reduce here: the totals are a cube lookup and
+// the titles must be printed in order, so this stays on one thread.
+// ---------------------------------------------------------
+void traverseAndCountArticles(News *articles, int count, const AggregateCube &cube) {
     for (int i = 0; i < count; i++) {
         cout << "Title: " << articles[i].title << ", Year: " << articles[i].year << endl;
-        if (articles[i].isTrue) {
-            trueCount++;
-        } else {
-            fakeCount++;
-        }
     }
-    cout << "Total articles: " << count << endl;
+    int labels[2];
+    cubeBreakdown(cube, CubeSlice(), CUBE_BY_LABEL, labels);
+    int fakeCount = labels[0];
+    int trueCount = labels[1];
+    cout << "Total articles: " << cube.total << endl;
     cout << "Total FAKE articles: " << fakeCount << endl;
     cout << "Total TRUE articles: " << trueCount << endl;
 }
 
 // ---------------------------------------------------------
-// calculateFakePoliticalNewsPercentage:
-// Calculate and display the percentage of political news articles
-// from 2016 that are fake.
+// packDate: Convert "DD-MM-YYYY" into a sortable YYYYMMDD integer.
+// Returns 0 for anything that is not a well-formed date.
+// ---------------------------------------------------------
+int packDate(const string &date) {
+    if (date.size() != 10 || date[2] != '-' || date[5] != '-')
+        return 0;
+    for (int i = 0; i < 10; i++) {
+        if (i != 2 && i != 5 && !isdigit(static_cast<unsigned char>(date[i])))
+            return 0;
+    }
+    int day = (date[0] - '0') * 10 + (date[1] - '0');
+    int month = (date[3] - '0') * 10 + (date[4] - '0');
+    int year = (date[6] - '0') * 1000 + (date[7] - '0') * 100 + (date[8] - '0') * 10 + (date[9] - '0');
+    if (day < 1 || day > 31 || month < 1 || month > 12)
+        return 0;
+    return year * 10000 + month * 100 + day;
+}
+
+// ---------------------------------------------------------
+// ArticleTable: Columnar (structure of arrays) copy of the articles
+// for the scans. A scan over year or label reads 2 bytes or 1 bit
+// per article instead of pulling each whole News record (four
+// strings) through the cache. Titles and texts stay in the News
+// array; no scan here reads them.
 // ---------------------------------------------------------
-void calculateFakePoliticalNewsPercentage(News *articles, int count) {
-    int totalPolitics2016 = 0;
-    int fakePolitics2016 = 0;
+struct ArticleTable {
+    int rowCount = 0;
+    short* year = nullptr;                  // 0 = unknown
+    int* date = nullptr;                    // packed YYYYMMDD, 0 = invalid
+    unsigned long long* fakeBits = nullptr; // bit i set = article i is FAKE
+    unsigned short* subjectId = nullptr;    // two bytes: at most 50000 articles are loaded
+    int subjectCount = 0;
+    int subjectCapacity = 0;
+    string* subjectNames = nullptr;
+};
 
+void buildArticleTable(News *articles, int count, ArticleTable &table) {
+    table.rowCount = count;
+    table.year = new short[count > 0 ? count : 1];
+    table.date = new int[count > 0 ? count : 1];
+    table.fakeBits = new unsigned long long[(count + 63) / 64 + 1]();
+    table.subjectId = new unsigned short[count > 0 ? count : 1];
     for (int i = 0; i < count; i++) {
-        // Check if the article is from 2016 and its subject contains "politics".
-        if (articles[i].year == 2016 && articles[i].subject.find("politics") != string::npos) {
-            totalPolitics2016++;
-            if (!articles[i].isTrue) {
-                fakePolitics2016++;
-            }
-        }
+        table.year[i] = static_cast<short>(articles[i].year);
+        table.date[i] = packDate(articles[i].date);
+        if (!articles[i].isTrue)
+            table.fakeBits[i >> 6] |= 1ULL << (i & 63);
+        int s = internSubject(table.subjectNames, table.subjectCount, table.subjectCapacity, articles[i].subject);
+        table.subjectId[i] = static_cast<unsigned short>(s);
     }
+}
+
+void freeArticleTable(ArticleTable &table) {
+    delete[] table.year;
+    delete[] table.date;
+    delete[] table.fakeBits;
+    delete[] table.subjectId;
+    delete[] table.subjectNames;
+    table = ArticleTable();
+}
+
+// ---------------------------------------------------------
+// calculateFakePoliticalNewsPercentage:
+// Baseline for calculateFakePoliticalNewsPercentageCube: the same
+// percentage from a scan over the year, subject id and label
+// columns. The subject test is one lookup in a per-subject
+// table, the map has no branches, and the rows are counted with
+// parallelReduce.
+// ---------------------------------------------------------
+void calculateFakePoliticalNewsPercentage(ThreadPool &pool, const ArticleTable &table) {
+    unsigned char* politics = new unsigned char[table.subjectCount > 0 ? table.subjectCount : 1];
+    for (int s = 0; s < table.subjectCount; s++)
+        politics[s] = table.subjectNames[s].find("politics") != string::npos;
+
+    const short* year = table.year;
+    const unsigned short* subjectId = table.subjectId;
+    const unsigned long long* fakeBits = table.fakeBits;
+    PoliticsCounts counts = parallelReduce(pool, 0, table.rowCount, PoliticsCounts{0, 0},
+        [&](int i) {
+            int match = (year[i] == 2016) & politics[subjectId[i]];
+            return PoliticsCounts{match, match & static_cast<int>(fakeBits[i >> 6] >> (i & 63))};
+        }, addPoliticsCounts);
+    delete[] politics;
+    int totalPolitics2016 = counts.total;
+    int fakePolitics2016 = counts.fake;
 
     if (totalPolitics2016 > 0) {
         double percentage = (static_cast<double>(fakePolitics2016) / totalPolitics2016) * 100;
-        cout << "Percentage of fake political news articles in 2016: " << percentage << "%" << endl;
+        cout << "Baseline scan, percentage of fake political news articles in 2016: " << percentage << "%" << endl;
     } else {
-        cout << "No political news articles found for the year 2016." << endl;
+        cout << "Baseline scan: no political news articles found for the year 2016." << endl;
     }
 }
 
-void tokenize(const string &text, string* tokens, int &tokenCount) {
-    stringstream ss(text);
-    string word;
-    tokenCount = 0;
-    while (ss >> word) {
-        // Remove punctuation.
-        word.erase(remove_if(word.begin(), word.end(), ::ispunct), word.end());
-        // Convert to lowercase.
-        transform(word.begin(), word.end(), word.begin(), ::tolower);
-        tokens[tokenCount++] = word;
+// ---------------------------------------------------------
+// Roaring-style compressed bitmap of row ids.
+// Rows are split into chunks of 65536 by their high 16 bits. A sparse
+// chunk stores its sorted low 16 bits in an array; once it holds more
+// than 4096 rows it switches to a plain 65536-bit bitmap.
+// ---------------------------------------------------------
+const int ROARING_ARRAY_MAX = 4096;
+const int ROARING_WORDS = 1024;     // 65536 bits
+
+struct RoaringContainer {
+    int key = 0;                            // high 16 bits of the rows
+    int cardinality = 0;
+    int arrayCapacity = 0;
+    unsigned short* array = nullptr;        // sorted low bits (sparse chunk)
+    unsigned long long* bits = nullptr;     // 1024 words (dense chunk)
+};
+
+struct RoaringBitmap {
+    RoaringContainer* containers = nullptr;
+    int containerCount = 0;
+    int capacity = 0;
+};
+
+// Portable 64-bit population count.
+int popcount64(unsigned long long x) {
+    x = x - ((x >> 1) & 0x5555555555555555ULL);
+    x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+    x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return static_cast<int>((x * 0x0101010101010101ULL) >> 56);
+}
+
+RoaringContainer& roaringAppendContainer(RoaringBitmap &bm, int key) {
+    if (bm.containerCount == bm.capacity) {
+        int newCapacity = bm.capacity ? bm.capacity * 2 : 4;
+        RoaringContainer* grown = new RoaringContainer[newCapacity];
+        for (int i = 0; i < bm.containerCount; i++)
+            grown[i] = bm.containers[i];
+        delete[] bm.containers;
+        bm.containers = grown;
+        bm.capacity = newCapacity;
     }
+    RoaringContainer &c = bm.containers[bm.containerCount++];
+    c = RoaringContainer();
+    c.key = key;
+    return c;
 }
 
-void insertAtLastPosition(WordFrequency* wordFreq, int &wordCount, const string &word) {
-    wordFreq[wordCount].word = word;
-    wordFreq[wordCount].count = 1;
-    wordCount++;
+// Switch a sparse chunk to a dense bitmap.
+void roaringToBitmap(RoaringContainer &c) {
+    c.bits = new unsigned long long[ROARING_WORDS]();
+    for (int i = 0; i < c.cardinality; i++)
+        c.bits[c.array[i] >> 6] |= 1ULL << (c.array[i] & 63);
+    delete[] c.array;
+    c.array = nullptr;
+    c.arrayCapacity = 0;
 }
 
 // ---------------------------------------------------------
-// findMostFrequentWords:
-// Filters fake articles with "government" in the subject,
-// tokenizes their text, counts word frequencies, sorts them,
-// and displays the top N most frequent words.
+// roaringAdd: Add a row id. Rows must be added in increasing order,
+// which is how every index here is built (one pass over the rows).
 // ---------------------------------------------------------
-void findMostFrequentWords(News *articles, int count, int topN) {
-    const int MAX_WORDS = 10000;
-    // Dynamically allocate the word frequency array.
-    WordFrequency* wordFreq = new WordFrequency[MAX_WORDS];
-    int wordCount = 0;
+void roaringAdd(RoaringBitmap &bm, int row) {
+    int key = row >> 16;
+    unsigned short low = static_cast<unsigned short>(row & 0xFFFF);
+    RoaringContainer &c = (bm.containerCount > 0 && bm.containers[bm.containerCount - 1].key == key)
+                          ? bm.containers[bm.containerCount - 1]
+                          : roaringAppendContainer(bm, key);
+    if (c.bits) {
+        c.bits[low >> 6] |= 1ULL << (low & 63);
+        c.cardinality++;
+        return;
+    }
+    if (c.cardinality == ROARING_ARRAY_MAX) {
+        roaringToBitmap(c);
+        c.bits[low >> 6] |= 1ULL << (low & 63);
+        c.cardinality++;
+        return;
+    }
+    if (c.cardinality == c.arrayCapacity) {
+        int newCapacity = c.arrayCapacity ? c.arrayCapacity * 2 : 16;
+        unsigned short* grown = new unsigned short[newCapacity];
+        for (int i = 0; i < c.cardinality; i++)
+            grown[i] = c.array[i];
+        delete[] c.array;
+        c.array = grown;
+        c.arrayCapacity = newCapacity;
+    }
+    c.array[c.cardinality++] = low;
+}
 
-    for (int i = 0; i < count; i++) {
-        // Use a case-insensitive check for "government" in the subject.
-        if (!articles[i].isTrue && articles[i].subject.find("Government News") != string::npos) {
-            const int MAX_TOKENS = 10000;
-            // Dynamically allocate tokens array.
-            string* tokens = new string[MAX_TOKENS];
-            int tokenCount;
-            tokenize(articles[i].text, tokens, tokenCount);
-            for (int j = 0; j < tokenCount; j++) {
-                int index = linearSearch(wordFreq, wordCount, tokens[j]);
-                if (index != -1) {
-                    wordFreq[index].count++;
-                } else {
-                    insertAtLastPosition(wordFreq, wordCount, tokens[j]);
+int roaringCount(const RoaringBitmap &bm) {
+    int total = 0;
+    for (int i = 0; i < bm.containerCount; i++)
+        total += bm.containers[i].cardinality;
+    return total;
+}
+
+// AND of two chunks with the same key, written into 'out' (already keyed).
+void roaringAndContainer(const RoaringContainer &a, const RoaringContainer &b, RoaringContainer &out) {
+    if (a.bits && b.bits) {
+        int card = 0;
+        for (int w = 0; w < ROARING_WORDS; w++)
+            card += popcount64(a.bits[w] & b.bits[w]);
+        out.cardinality = card;
+        if (card > ROARING_ARRAY_MAX) {
+            out.bits = new unsigned long long[ROARING_WORDS];
+            for (int w = 0; w < ROARING_WORDS; w++)
+                out.bits[w] = a.bits[w] & b.bits[w];
+        } else {
+            out.array = new unsigned short[card > 0 ? card : 1];
+            out.arrayCapacity = card;
+            int n = 0;
+            for (int w = 0; w < ROARING_WORDS; w++) {
+                unsigned long long word = a.bits[w] & b.bits[w];
+                while (word) {
+                    int bit = popcount64((word & (~word + 1)) - 1);
+                    out.array[n++] = static_cast<unsigned short>(w * 64 + bit);
+                    word &= word - 1;
                 }
             }
-            delete[] tokens;  // Free tokens array.
+        }
+        return;
+    }
+    // At least one side is sparse: the result fits in an array.
+    const RoaringContainer &sparse = a.bits ? b : a;
+    const RoaringContainer &other = a.bits ? a : b;
+    out.array = new unsigned short[sparse.cardinality > 0 ? sparse.cardinality : 1];
+    out.arrayCapacity = sparse.cardinality;
+    int n = 0;
+    if (other.bits) {
+        for (int i = 0; i < sparse.cardinality; i++) {
+            unsigned short v = sparse.array[i];
+            if (other.bits[v >> 6] & (1ULL << (v & 63)))
+                out.array[n++] = v;
+        }
+    } else {
+        int i = 0, j = 0;
+        while (i < sparse.cardinality && j < other.cardinality) {
+            if (sparse.array[i] < other.array[j]) i++;
+            else if (sparse.array[i] > other.array[j]) j++;
+            else { out.array[n++] = sparse.array[i]; i++; j++; }
         }
     }
+    out.cardinality = n;
+}
 
-    // Sort the word frequency array using selection sort.
-    selectionSort(wordFreq, wordCount);
+// ---------------------------------------------------------
+// roaringAnd: Intersection of two bitmaps (new bitmap).
+// ---------------------------------------------------------
+RoaringBitmap roaringAnd(const RoaringBitmap &a, const RoaringBitmap &b) {
+    RoaringBitmap out;
+    int i = 0, j = 0;
+    while (i < a.containerCount && j < b.containerCount) {
+        if (a.containers[i].key < b.containers[j].key) i++;
+        else if (a.containers[i].key > b.containers[j].key) j++;
+        else {
+            RoaringContainer &c = roaringAppendContainer(out, a.containers[i].key);
+            roaringAndContainer(a.containers[i], b.containers[j], c);
+            if (c.cardinality == 0) {
+                delete[] c.array;
+                delete[] c.bits;
+                out.containerCount--;
+            }
+            i++;
+            j++;
+        }
+    }
+    return out;
+}
 
-    // Display the top N most frequent words.
-    cout << "Top " << topN << " most frequent words in fake government news:" << endl;
-    for (int i = 0; i < topN && i < wordCount; i++) {
-        cout << wordFreq[i].word << ": " << wordFreq[i].count << " occurrences" << endl;
+// ---------------------------------------------------------
+// roaringOr: Union of two bitmaps (new bitmap). Chunks are merged as
+// dense bitmaps and shrunk back to arrays when they are sparse.
+// ---------------------------------------------------------
+RoaringBitmap roaringOr(const RoaringBitmap &a, const RoaringBitmap &b) {
+    RoaringBitmap out;
+    int i = 0, j = 0;
+    while (i < a.containerCount || j < b.containerCount) {
+        int key;
+        if (j >= b.containerCount || (i < a.containerCount && a.containers[i].key < b.containers[j].key))
+            key = a.containers[i].key;
+        else
+            key = b.containers[j].key;
+        RoaringContainer &c = roaringAppendContainer(out, key);
+        c.bits = new unsigned long long[ROARING_WORDS]();
+        const RoaringContainer* sides[2] = {
+            (i < a.containerCount && a.containers[i].key == key) ? &a.containers[i++] : nullptr,
+            (j < b.containerCount && b.containers[j].key == key) ? &b.containers[j++] : nullptr
+        };
+        for (int s = 0; s < 2; s++) {
+            const RoaringContainer* side = sides[s];
+            if (!side) continue;
+            if (side->bits) {
+                for (int w = 0; w < ROARING_WORDS; w++)
+                    c.bits[w] |= side->bits[w];
+            } else {
+                for (int k = 0; k < side->cardinality; k++)
+                    c.bits[side->array[k] >> 6] |= 1ULL << (side->array[k] & 63);
+            }
+        }
+        c.cardinality = 0;
+        for (int w = 0; w < ROARING_WORDS; w++)
+            c.cardinality += popcount64(c.bits[w]);
+        if (c.cardinality <= ROARING_ARRAY_MAX) {
+            unsigned long long* bits = c.bits;
+            c.bits = nullptr;
+            c.array = new unsigned short[c.cardinality > 0 ? c.cardinality : 1];
+            c.arrayCapacity = c.cardinality;
+            int n = 0;
+            for (int w = 0; w < ROARING_WORDS; w++) {
+                for (unsigned long long word = bits[w]; word; word &= word - 1)
+                    c.array[n++] = static_cast<unsigned short>(w * 64 + popcount64((word & (~word + 1)) - 1));
+            }
+            delete[] bits;
+        }
     }
+    return out;
+}
 
-    // Free the dynamically allocated word frequency array.
-    delete[] wordFreq;
+// ---------------------------------------------------------
+// roaringAndCount: Size of the intersection without building it.
+// ---------------------------------------------------------
+int roaringAndCount(const RoaringBitmap &a, const RoaringBitmap &b) {
+    int total = 0;
+    int i = 0, j = 0;
+    while (i < a.containerCount && j < b.containerCount) {
+        if (a.containers[i].key < b.containers[j].key) { i++; continue; }
+        if (a.containers[i].key > b.containers[j].key) { j++; continue; }
+        const RoaringContainer &x = a.containers[i++];
+        const RoaringContainer &y = b.containers[j++];
+        if (x.bits && y.bits) {
+            for (int w = 0; w < ROARING_WORDS; w++)
+                total += popcount64(x.bits[w] & y.bits[w]);
+        } else if (x.bits || y.bits) {
+            const RoaringContainer &sparse = x.bits ? y : x;
+            const RoaringContainer &dense = x.bits ? x : y;
+            for (int k = 0; k < sparse.cardinality; k++) {
+                unsigned short v = sparse.array[k];
+                if (dense.bits[v >> 6] & (1ULL << (v & 63)))
+                    total++;
+            }
+        } else {
+            int p = 0, q = 0;
+            while (p < x.cardinality && q < y.cardinality) {
+                if (x.array[p] < y.array[q]) p++;
+                else if (x.array[p] > y.array[q]) q++;
+                else { total++; p++; q++; }
+            }
+        }
+    }
+    return total;
+}
+
+void freeRoaring(RoaringBitmap &bm) {
+    for (int i = 0; i < bm.containerCount; i++) {
+        delete[] bm.containers[i].array;
+        delete[] bm.containers[i].bits;
+    }
+    delete[] bm.containers;
+    bm = RoaringBitmap();
 }
 
 // ---------------------------------------------------------
-// measureEfficiency: Measures the time taken by a function.
+// Facet bitmaps built at load time: one bitmap per subject, per
+// label and per year-month. Row ids are load positions.
 // ---------------------------------------------------------
-template<typename Func, typename... Args>
-long long measureEfficiency(const string& operationName, Func func, Args&&... args) {
-    auto start = high_resolution_clock::now(); // Start time
-    func(forward<Args>(args)...); // Execute the function
-    auto end = high_resolution_clock::now(); // End time
-    auto duration = duration_cast<microseconds>(end - start); // Duration in microseconds
-    return duration.count();
+struct FacetIndex {
+    int rowCount = 0;
+    int subjectCount = 0;
+    int subjectCapacity = 0;
+    string* subjectNames = nullptr;
+    RoaringBitmap* subjects = nullptr;  // subjectCapacity bitmaps
+    RoaringBitmap fake;
+    RoaringBitmap real;
+    int minYear = 0;
+    int yearCount = 0;
+    RoaringBitmap* years = nullptr;     // [year - minYear]
+    RoaringBitmap* months = nullptr;    // [(year - minYear) * 12 + month - 1]
+};
+
+// ---------------------------------------------------------
+// facetSubjectUnion: Union of every subject bitmap whose name contains
+// 'subject' (new bitmap).
+// ---------------------------------------------------------
+RoaringBitmap facetSubjectUnion(const FacetIndex &index, const string &subject) {
+    RoaringBitmap result;
+    for (int s = 0; s < index.subjectCount; s++) {
+        if (index.subjectNames[s].find(subject) == string::npos)
+            continue;
+        RoaringBitmap merged = roaringOr(result, index.subjects[s]);
+        freeRoaring(result);
+        result = merged;
+    }
+    return result;
 }
 
 // ---------------------------------------------------------
-// main: Entry point of the program.
-// Prompts the user for an option and calls the corresponding function.
+// facetCount: Generic facet query. Counts rows whose subject contains
+// 'subject' ("" = any), with the given label (-1 = any, 0 = FAKE,
+// 1 = TRUE), year (0 = any) and month (0 = any).
 // ---------------------------------------------------------
-int main() {
-    News* articles = nullptr;
-    // Load articles from the CSV file.
-    int count = loadArticles("DataCleaned.csv", articles);
-    if (count == 0) {
-        cerr << "No articles loaded." << endl;
-        return 1;
+int facetCount(const FacetIndex &index, const string &subject, int label, int year, int month) {
+    // Time facet first: it is the most selective for the reports.
+    const RoaringBitmap* timeFacet = nullptr;
+    if (year != 0) {
+        if (year < index.minYear || year >= index.minYear + index.yearCount)
+            return 0;
+        if (month >= 1 && month <= 12)
+            timeFacet = &index.months[(year - index.minYear) * 12 + month - 1];
+        else
+            timeFacet = &index.years[year - index.minYear];
     }
+    const RoaringBitmap* labelFacet = (label == 0) ? &index.fake : (label == 1) ? &index.real : nullptr;
 
-    string option;
-    
-    // Display options to the user.
-    cout << "Enter Your Option:" << endl
-         << "1. Sort the news articles by year and display all articles" << endl
-         << "2. Percentage of political news articles from 2016" << endl
-         << "3. Most frequently words used in fake government news" << endl
-         << "Option: ";
-    cin >> option;
-    
-    if (option == "1") {
-        // Use Quick Sort to sort articles by year and then traverse all articles.
-        long long sortingTime = measureEfficiency("Quick Sort", quickSort, articles, 0, count - 1);
-        double sortingTimeSec = sortingTime / 1e6;
-        traverseAndCountArticles(articles, count);
-        
-        // Calculate memory usage based on total articles.
-        size_t memoryUsed = count * sizeof(News);
-    
-        // Display results.
-        cout << "=== Quick Sort (All Articles) ===" << endl;
-        cout << "Sorting Time: " << sortingTime << " µs (" << sortingTimeSec << " seconds)" << endl;
-        cout << "Memory Used by Array: " << memoryUsed << " bytes" << endl;
-        cout << "Recursion Depth: " << recursionDepth << endl;
-    
-    } else if (option == "2") {
-        // Use Insertion Sort on the articles.
-        long long sortingTime = measureEfficiency("Insertion Sort", insertionSort, articles, count);
-        double sortingTimeSec = sortingTime / 1e6;
-        calculateFakePoliticalNewsPercentage(articles, count);
-    
-        // Calculate memory usage based on total articles.
-        size_t memoryUsed = count * sizeof(News);
-    
-        // Display results.
-        cout << "=== Insertion Sort (All Articles) and Linear Search ===" << endl;
-        cout << "Sorting Time: " << sortingTime << " µs (" << sortingTimeSec << " seconds)" << endl;
-        cout << "Memory Used by Array: " << memoryUsed << " bytes" << endl;
-    
-    } else if (option == "3") {
-        int topN;
-        cout << "Enter the number of top frequent words to display: ";
-        cin >> topN;
-    
-        // Create a WordFrequency array for word frequency analysis
-        const int MAX_WORDS = 100000;
-        WordFrequency* wordFreq = new WordFrequency[MAX_WORDS];
-        int wordCount = 0;
-    
-        // Populate the word frequency array.
-        for (int i = 0; i < count; i++) {
-            if (!articles[i].isTrue && articles[i].subject.find("Government News") != string::npos) {
-                const int MAX_TOKENS = 10000;
-                string* tokens = new string[MAX_TOKENS];
-                int tokenCount;
-                tokenize(articles[i].text, tokens, tokenCount);
-                for (int j = 0; j < tokenCount; j++) {
-                    int index = linearSearch(wordFreq, wordCount, tokens[j]);
-                    if (index != -1) {
-                        wordFreq[index].count++;
-                    } else {
-                        insertAtLastPosition(wordFreq, wordCount, tokens[j]);
-                    }
-                }
-                delete[] tokens;  // Free tokens array.
-            }
-        }
-    
-        // Use Selection Sort for Option 3.
-        long long sortingTime = measureEfficiency("Selection Sort", selectionSort, wordFreq, wordCount);
-        double sortingTimeSec = sortingTime / 1e6;
-        auto startSearch = high_resolution_clock::now();
-        cout << "Top " << topN << " most frequent words in fake government news:" << endl;
-        for (int i = 0; i < topN && i < wordCount; i++) {
-            cout << wordFreq[i].word << ": " << wordFreq[i].count << " occurrences" << endl;
-        }
-        auto endSearch = high_resolution_clock::now();
-        long long searchingTime = duration_cast<microseconds>(endSearch - startSearch).count();
-        double searchingTimeSec = searchingTime / 1e6;
-    
-        // Calculate memory usage.
-        size_t memoryUsed = wordCount * sizeof(WordFrequency);
-    
-        // Display results.
-        cout << "=== Selection Sort (Word Frequency Analysis) ===" << endl;
-        cout << "Sorting Time: " << sortingTime << " µs (" << sortingTimeSec << " seconds)" << endl;
-        cout << "Searching Time: " << searchingTime << " µs (" << searchingTimeSec << " seconds)" << endl;
-        cout << "Memory Used by Array: " << memoryUsed << " bytes" << endl;
-    
-        delete[] wordFreq;
+    bool anySubject = subject.empty();
+    RoaringBitmap subjectFacet;
+    if (!anySubject)
+        subjectFacet = facetSubjectUnion(index, subject);
+
+    const RoaringBitmap* facets[3];
+    int facetTotal = 0;
+    if (timeFacet) facets[facetTotal++] = timeFacet;
+    if (!anySubject) facets[facetTotal++] = &subjectFacet;
+    if (labelFacet) facets[facetTotal++] = labelFacet;
+
+    int result;
+    if (facetTotal == 0) {
+        result = index.rowCount;
+    } else if (facetTotal == 1) {
+        result = roaringCount(*facets[0]);
+    } else if (facetTotal == 2) {
+        result = roaringAndCount(*facets[0], *facets[1]);
+    } else {
+        RoaringBitmap pair = roaringAnd(*facets[0], *facets[1]);
+        result = roaringAndCount(pair, *facets[2]);
+        freeRoaring(pair);
+    }
+    freeRoaring(subjectFacet);
+    return result;
+}
+
+void freeFacetIndex(FacetIndex &index) {
+    for (int s = 0; s < index.subjectCount; s++)
+        freeRoaring(index.subjects[s]);
+    delete[] index.subjects;
+    delete[] index.subjectNames;
+    freeRoaring(index.fake);
+    freeRoaring(index.real);
+    for (int y = 0; y < index.yearCount; y++)
+        freeRoaring(index.years[y]);
+    for (int m = 0; m < index.yearCount * 12; m++)
+        freeRoaring(index.months[m]);
+    delete[] index.years;
+    delete[] index.months;
+    index = FacetIndex();
+}
+
+// ---------------------------------------------------------
+// buildFacetIndex: One pass over the articles, appending each row id
+// to its subject, label, year and year-month bitmaps.
+// ---------------------------------------------------------
+void buildFacetIndex(News *articles, int count, FacetIndex &index) {
+    index.rowCount = count;
+    int maxYear = 0;
+    index.minYear = 0;
+    for (int i = 0; i < count; i++) {
+        int year = articles[i].year;
+        if (year <= 0) continue;
+        if (index.minYear == 0 || year < index.minYear) index.minYear = year;
+        if (year > maxYear) maxYear = year;
+    }
+    index.yearCount = (index.minYear > 0) ? maxYear - index.minYear + 1 : 0;
+    index.years = new RoaringBitmap[index.yearCount > 0 ? index.yearCount : 1];
+    index.months = new RoaringBitmap[index.yearCount > 0 ? index.yearCount * 12 : 1];
+
+    for (int i = 0; i < count; i++) {
+        int oldCapacity = index.subjectCapacity;
+        int s = internSubject(index.subjectNames, index.subjectCount, index.subjectCapacity, articles[i].subject);
+        if (index.subjectCapacity != oldCapacity) {
+            RoaringBitmap* grown = new RoaringBitmap[index.subjectCapacity];
+            for (int b = 0; b < oldCapacity; b++)
+                grown[b] = index.subjects[b];
+            delete[] index.subjects;
+            index.subjects = grown;
+        }
+        roaringAdd(index.subjects[s], i);
+
+        roaringAdd(articles[i].isTrue ? index.real : index.fake, i);
+
+        if (articles[i].year > 0) {
+            int y = articles[i].year - index.minYear;
+            roaringAdd(index.years[y], i);
+            // Month from "DD-MM-YYYY"
+            const string &date = articles[i].date;
+            if (date.size() >= 5 && isdigit(static_cast<unsigned char>(date[3])) && isdigit(static_cast<unsigned char>(date[4]))) {
+                int month = (date[3] - '0') * 10 + (date[4] - '0');
+                if (month >= 1 && month <= 12)
+                    roaringAdd(index.months[y * 12 + month - 1], i);
+            }
+        }
+    }
+}
+
+// ---------------------------------------------------------
+// calculateFakePoliticalNewsPercentageCube:
+// Calculate and display the percentage of political news articles
+// from 2016 that are fake, read from the aggregate cube (politics in
+// 2016, broken down by label).
+// ---------------------------------------------------------
+void calculateFakePoliticalNewsPercentageCube(const AggregateCube &cube) {
+    CubeSlice politics2016;
+    politics2016.subject = "politics";
+    politics2016.fromYear = politics2016.toYear = 2016;
+    int labels[2];
+    cubeBreakdown(cube, politics2016, CUBE_BY_LABEL, labels);
+    int totalPolitics2016 = labels[0] + labels[1];
+    int fakePolitics2016 = labels[0];
+
+    if (totalPolitics2016 > 0) {
+        double percentage = (static_cast<double>(fakePolitics2016) / totalPolitics2016) * 100;
+        cout << "Percentage of fake political news articles in 2016: " << percentage << "%" << endl;
+    } else {
+        cout << "No political news articles found for the year 2016." << endl;
+    }
+}
+
+// ---------------------------------------------------------
+// Streaming tokenizer.
+// A token is a whitespace-separated run of characters with only its
+// letters and digits kept, lowercased. DataCleaning builds
+// WordIndex.bin with the same rule. The text is read 8 bytes at a
+// time into a 64-bit word and classified with SWAR arithmetic: each
+// class test sets the top bit of every byte in the class, and adding
+// the uppercase mask shifted down to 0x20 lowercases A-Z in the
+// register. A block of 8 letters and digits is appended whole; other
+// blocks are walked byte by byte using the masks. Tokens are passed to
+// the callback as string_views into a reusable buffer, so nothing is
+// allocated per token; a view is only valid during its callback.
+// ---------------------------------------------------------
+const unsigned long long SWAR_ONES = 0x0101010101010101ULL;
+const unsigned long long SWAR_HIGH_BITS = 0x8080808080808080ULL;
+const unsigned long long SWAR_LOW_BITS = 0x7F7F7F7F7F7F7F7FULL;
+
+// Top bit of each byte of word that lies in [lo, hi]; lo and hi below 0x80.
+// Both sums stay inside their byte, so no carry crosses into the next one.
+inline unsigned long long swarInRange(unsigned long long word, unsigned char lo, unsigned char hi) {
+    unsigned long long low = word & SWAR_LOW_BITS;
+    unsigned long long atLeastLo = low + SWAR_ONES * (0x80 - lo);
+    unsigned long long atMostHi = SWAR_ONES * (0x80 + hi) - low;
+    return atLeastLo & atMostHi & ~word & SWAR_HIGH_BITS;
+}
+
+template<typename Callback>
+void forEachToken(string_view text, Callback onToken) {
+    char localBuffer[256];
+    char* buffer = localBuffer;
+    size_t bufferSize = sizeof(localBuffer);
+    size_t length = 0;
+    for (size_t i = 0; i < text.size(); i += 8) {
+        size_t blockSize = text.size() - i < 8 ? text.size() - i : 8;
+        unsigned long long word = 0;                    // A short last block is zero padded
+        memcpy(&word, text.data() + i, blockSize);
+        unsigned long long upper = swarInRange(word, 'A', 'Z');
+        unsigned long long alnum = upper | swarInRange(word, 'a', 'z') | swarInRange(word, '0', '9');
+        unsigned long long space = swarInRange(word, '\t', '\r') | swarInRange(word, ' ', ' ');
+        word += upper >> 2;                             // 0x80 >> 2 == 'a' - 'A'
+        if (length + 8 > bufferSize) {
+            // Only tokens longer than the local buffer reach the heap.
+            char* larger = new char[bufferSize * 2];
+            for (size_t j = 0; j < length; j++)
+                larger[j] = buffer[j];
+            if (buffer != localBuffer)
+                delete[] buffer;
+            buffer = larger;
+            bufferSize *= 2;
+        }
+        if (alnum == SWAR_HIGH_BITS) {
+            memcpy(buffer + length, &word, 8);
+            length += 8;
+            continue;
+        }
+        unsigned char bytes[8], alnumBytes[8], spaceBytes[8];
+        memcpy(bytes, &word, 8);
+        memcpy(alnumBytes, &alnum, 8);
+        memcpy(spaceBytes, &space, 8);
+        for (size_t j = 0; j < blockSize; j++) {
+            if (alnumBytes[j]) {
+                buffer[length++] = static_cast<char>(bytes[j]);
+            } else if (spaceBytes[j] && length > 0) {
+                onToken(string_view(buffer, length));
+                length = 0;
+            }
+        }
+    }
+    if (length > 0)
+        onToken(string_view(buffer, length));
+    if (buffer != localBuffer)
+        delete[] buffer;
+}
+
+// ---------------------------------------------------------
+// Stopword filter.
+// The 144 stopwords are placed in a table at compile time with a hash
+// seed that gives every stopword its own slot (a perfect hash), so a
+// lookup is one hash, one slot and at most one comparison. The seed is
+// found offline and kept in STOPWORD_SEED, so the compiler only places
+// the words once instead of searching (MSVC stops constant evaluation
+// after 100000 steps); buildStopwordTable still searches onwards if the
+// list is edited, and the static_assert then asks for the new seed.
+// filterStopwords switches the filter on and off at run time.
+// ---------------------------------------------------------
+constexpr string_view STOPWORDS[] = {
+    "a", "about", "above", "after", "again", "against", "all", "also", "am", "an",
+    "and", "any", "are", "arent", "as", "at", "be", "because", "been", "before",
+    "being", "below", "between", "both", "but", "by", "can", "cant", "could", "couldnt",
+    "did", "didnt", "do", "does", "doesnt", "doing", "dont", "down", "during", "each",
+    "few", "for", "from", "further", "had", "hadnt", "has", "hasnt", "have", "havent",
+    "having", "he", "her", "here", "hers", "herself", "him", "himself", "his", "how",
+    "i", "if", "in", "into", "is", "isnt", "it", "its", "itself", "just",
+    "me", "more", "most", "my", "myself", "no", "nor", "not", "now", "of",
+    "off", "on", "once", "only", "or", "other", "our", "ours", "ourselves", "out",
+    "over", "own", "s", "said", "same", "she", "should", "so", "some", "such",
+    "t", "than", "that", "thats", "the", "their", "theirs", "them", "themselves", "then",
+    "there", "these", "they", "this", "those", "through", "to", "too", "under", "until",
+    "up", "very", "was", "wasnt", "we", "were", "werent", "what", "when", "where",
+    "which", "while", "who", "whom", "why", "will", "with", "wont", "would", "you",
+    "your", "yours", "yourself", "yourselves"
+};
+constexpr int STOPWORD_COUNT = sizeof(STOPWORDS) / sizeof(STOPWORDS[0]);
+constexpr int STOPWORD_TABLE_SIZE = 2048;   // power of two
+constexpr unsigned int STOPWORD_SEED = 53;  // first collision-free seed for this list
+static_assert(STOPWORD_COUNT < 256, "stopword slots are stored in one byte");
+
+struct StopwordTable {
+    unsigned int seed = 0;
+    size_t maxLength = 0;
+    unsigned char slot[STOPWORD_TABLE_SIZE] = {};   // stopword index + 1, 0 = empty
+};
+
+constexpr unsigned int stopwordHash(string_view word, unsigned int seed) {
+    unsigned int h = 2166136261u ^ (seed * 0x9E3779B1u);
+    for (size_t i = 0; i < word.size(); i++) {
+        h ^= static_cast<unsigned char>(word[i]);
+        h *= 16777619u;
+    }
+    return h;
+}
+
+constexpr StopwordTable buildStopwordTable() {
+    StopwordTable table;
+    for (int w = 0; w < STOPWORD_COUNT; w++)
+        if (STOPWORDS[w].size() > table.maxLength)
+            table.maxLength = STOPWORDS[w].size();
+    for (unsigned int seed = STOPWORD_SEED; ; seed++) {
+        int placed = 0;
+        while (placed < STOPWORD_COUNT) {
+            unsigned int pos = stopwordHash(STOPWORDS[placed], seed) & (STOPWORD_TABLE_SIZE - 1);
+            if (table.slot[pos] != 0)
+                break;
+            table.slot[pos] = static_cast<unsigned char>(placed + 1);
+            placed++;
+        }
+        if (placed == STOPWORD_COUNT) {
+            table.seed = seed;
+            return table;
+        }
+        for (int w = 0; w < placed; w++)     // Clear only the slots this seed used
+            table.slot[stopwordHash(STOPWORDS[w], seed) & (STOPWORD_TABLE_SIZE - 1)] = 0;
+    }
+}
+
+constexpr StopwordTable stopwordTable = buildStopwordTable();
+static_assert(stopwordTable.seed == STOPWORD_SEED, "stopword list changed: set STOPWORD_SEED to stopwordTable.seed");
+
+bool filterStopwords = true;
+
+bool isStopword(string_view word) {
+    if (word.size() > stopwordTable.maxLength)
+        return false;
+    unsigned char index = stopwordTable.slot[stopwordHash(word, stopwordTable.seed) & (STOPWORD_TABLE_SIZE - 1)];
+    return index != 0 && STOPWORDS[index - 1] == word;
+}
+
+// ---------------------------------------------------------
+// forEachWord: forEachToken for word counting; drops stopwords
+// while the filter is on.
+// ---------------------------------------------------------
+template<typename Callback>
+void forEachWord(string_view text, Callback onWord) {
+    forEachToken(text, [&onWord](string_view token) {
+        if (!(filterStopwords && isStopword(token)))
+            onWord(token);
+    });
+}
+
+// ---------------------------------------------------------
+// WordCounter: Open-addressing hash table of word counts using
+// Robin Hood probing (an entry that is further from its home slot
+// takes the place of one that is closer, keeping probe runs short).
+// Each word is copied once into an arena of fixed-size blocks and the
+// table stores a string_view into it with the precomputed hash.
+// The table doubles once it is 80% full, so there is no word limit.
+// ---------------------------------------------------------
+const size_t ARENA_BLOCK_SIZE = 64 * 1024;
+
+struct ArenaBlock {
+    char* data;
+    size_t used;
+    size_t capacity;
+    ArenaBlock* next;
+};
+
+struct CounterSlot {
+    string_view word;
+    unsigned int hash = 0;
+    int count = 0;
+    int distance = -1;      // probes from the home slot, -1 = empty
+};
+
+struct WordCounter {
+    CounterSlot* slots = nullptr;
+    int capacity = 0;       // power of two
+    int size = 0;
+    ArenaBlock* arena = nullptr;
+};
+
+// FNV-1a hash of a word.
+unsigned int hashWord(string_view word) {
+    unsigned int h = 2166136261u;
+    for (unsigned char c : word) {
+        h ^= c;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+// Copy a word into the arena; blocks never move, so views stay valid.
+string_view arenaCopy(WordCounter &counter, string_view word) {
+    ArenaBlock* block = counter.arena;
+    if (!block || block->used + word.size() > block->capacity) {
+        size_t capacity = word.size() > ARENA_BLOCK_SIZE ? word.size() : ARENA_BLOCK_SIZE;
+        block = new ArenaBlock{ new char[capacity], 0, capacity, counter.arena };
+        counter.arena = block;
+    }
+    char* dest = block->data + block->used;
+    for (size_t i = 0; i < word.size(); i++)
+        dest[i] = word[i];
+    block->used += word.size();
+    return string_view(dest, word.size());
+}
+
+// Place an entry starting at its home slot, displacing richer entries.
+void counterPlace(WordCounter &counter, CounterSlot entry) {
+    int mask = counter.capacity - 1;
+    int pos = entry.hash & mask;
+    entry.distance = 0;
+    while (counter.slots[pos].distance >= 0) {
+        if (counter.slots[pos].distance < entry.distance)
+            swap(counter.slots[pos], entry);
+        pos = (pos + 1) & mask;
+        entry.distance++;
+    }
+    counter.slots[pos] = entry;
+}
+
+void counterGrow(WordCounter &counter) {
+    CounterSlot* old = counter.slots;
+    int oldCapacity = counter.capacity;
+    counter.capacity = oldCapacity ? oldCapacity * 2 : 1024;
+    counter.slots = new CounterSlot[counter.capacity];
+    for (int i = 0; i < oldCapacity; i++) {
+        if (old[i].distance >= 0)
+            counterPlace(counter, old[i]);
+    }
+    delete[] old;
+}
+
+// ---------------------------------------------------------
+// counterAdd: Add 'amount' occurrences of a word whose hash is known.
+// ---------------------------------------------------------
+void counterAddHashed(WordCounter &counter, string_view word, unsigned int hash, int amount) {
+    if ((counter.size + 1) * 5 > counter.capacity * 4)
+        counterGrow(counter);
+    int mask = counter.capacity - 1;
+    int pos = hash & mask;
+    // Lookup: stop at an empty slot or at an entry closer to home than we are.
+    for (int distance = 0; counter.slots[pos].distance >= distance; distance++) {
+        CounterSlot &slot = counter.slots[pos];
+        if (slot.hash == hash && slot.word == word) {
+            slot.count += amount;
+            return;
+        }
+        pos = (pos + 1) & mask;
+    }
+    CounterSlot entry;
+    entry.word = arenaCopy(counter, word);
+    entry.hash = hash;
+    entry.count = amount;
+    counterPlace(counter, entry);
+    counter.size++;
+}
+
+void counterAdd(WordCounter &counter, string_view word, int amount = 1) {
+    counterAddHashed(counter, word, hashWord(word), amount);
+}
+
+// ---------------------------------------------------------
+// counterToArray: Copy the counts into a new WordFrequency array
+// (caller must delete[] it) for ranking.
+// ---------------------------------------------------------
+WordFrequency* counterToArray(const WordCounter &counter, int &wordCount) {
+    WordFrequency* wordFreq = new WordFrequency[counter.size > 0 ? counter.size : 1];
+    wordCount = 0;
+    for (int i = 0; i < counter.capacity; i++) {
+        if (counter.slots[i].distance >= 0) {
+            wordFreq[wordCount].word = string(counter.slots[i].word);
+            wordFreq[wordCount].count = counter.slots[i].count;
+            wordCount++;
+        }
+    }
+    return wordFreq;
+}
+
+void freeWordCounter(WordCounter &counter) {
+    delete[] counter.slots;
+    while (counter.arena) {
+        ArenaBlock* next = counter.arena->next;
+        delete[] counter.arena->data;
+        delete counter.arena;
+        counter.arena = next;
+    }
+    counter = WordCounter();
+}
+
+// ---------------------------------------------------------
+// isFakeGovernmentNews: Articles counted by the word frequency analysis.
+// ---------------------------------------------------------
+bool isFakeGovernmentNews(const News &article) {
+    return !article.isTrue && article.subject.find("Government News") != string::npos;
+}
+
+// ---------------------------------------------------------
+// countWords: Single-threaded word count of the fake government
+// articles. Returns a new WordFrequency array (caller must delete[] it).
+// ---------------------------------------------------------
+WordFrequency* countWords(News *articles, int count, int &wordCount) {
+    WordCounter counter;
+    for (int i = 0; i < count; i++) {
+        if (isFakeGovernmentNews(articles[i])) {
+            forEachWord(articles[i].text, [&counter](string_view token) {
+                counterAdd(counter, token);
+            });
+        }
+    }
+    WordFrequency* wordFreq = counterToArray(counter, wordCount);
+    freeWordCounter(counter);
+    return wordFreq;
+}
+
+// ---------------------------------------------------------
+// Parallel word count (map-reduce).
+// Map: each thread tokenizes every threadCount-th article and counts
+// into its own WORD_PARTITIONS tables, picking the table from the top
+// bits of the word hash. Reduce: each thread merges one partition from
+// every map table; partitions hold disjoint words, so the results are
+// just concatenated and no single-threaded merge is needed.
+// ---------------------------------------------------------
+const int WORD_PARTITION_BITS = 6;
+const int WORD_PARTITIONS = 1 << WORD_PARTITION_BITS;
+
+int wordPartition(unsigned int hash) {
+    return static_cast<int>(hash >> (32 - WORD_PARTITION_BITS));
+}
+
+void countWordsMap(News *articles, int count, int first, int step, WordCounter* partitions) {
+    for (int i = first; i < count; i += step) {
+        if (!isFakeGovernmentNews(articles[i]))
+            continue;
+        forEachWord(articles[i].text, [partitions](string_view token) {
+            unsigned int hash = hashWord(token);
+            counterAddHashed(partitions[wordPartition(hash)], token, hash, 1);
+        });
+    }
+}
+
+void countWordsReduce(WordCounter* mapTables, int threadCount, int first, int step, WordCounter* merged) {
+    for (int p = first; p < WORD_PARTITIONS; p += step) {
+        for (int t = 0; t < threadCount; t++) {
+            const WordCounter &local = mapTables[t * WORD_PARTITIONS + p];
+            for (int i = 0; i < local.capacity; i++) {
+                if (local.slots[i].distance >= 0)
+                    counterAddHashed(merged[p], local.slots[i].word, local.slots[i].hash, local.slots[i].count);
+            }
+        }
+    }
+}
+
+// ---------------------------------------------------------
+// countWordsParallel: Same result as countWords, computed with
+// threadCount workers. Returns a new WordFrequency array.
+// ---------------------------------------------------------
+WordFrequency* countWordsParallel(News *articles, int count, int threadCount, int &wordCount) {
+    if (threadCount <= 0) threadCount = 1;
+    WordCounter* mapTables = new WordCounter[threadCount * WORD_PARTITIONS];
+    WordCounter* merged = new WordCounter[WORD_PARTITIONS];
+    thread* workers = new thread[threadCount];
+
+    for (int t = 0; t < threadCount; t++)
+        workers[t] = thread(countWordsMap, articles, count, t, threadCount, mapTables + t * WORD_PARTITIONS);
+    for (int t = 0; t < threadCount; t++)
+        workers[t].join();
+
+    for (int t = 0; t < threadCount; t++)
+        workers[t] = thread(countWordsReduce, mapTables, threadCount, t, threadCount, merged);
+    for (int t = 0; t < threadCount; t++)
+        workers[t].join();
+
+    // Concatenate the disjoint partitions.
+    int total = 0;
+    for (int p = 0; p < WORD_PARTITIONS; p++)
+        total += merged[p].size;
+    WordFrequency* wordFreq = new WordFrequency[total > 0 ? total : 1];
+    wordCount = 0;
+    for (int p = 0; p < WORD_PARTITIONS; p++) {
+        for (int i = 0; i < merged[p].capacity; i++) {
+            if (merged[p].slots[i].distance >= 0) {
+                wordFreq[wordCount].word = string(merged[p].slots[i].word);
+                wordFreq[wordCount].count = merged[p].slots[i].count;
+                wordCount++;
+            }
+        }
+    }
+
+    for (int i = 0; i < threadCount * WORD_PARTITIONS; i++)
+        freeWordCounter(mapTables[i]);
+    for (int p = 0; p < WORD_PARTITIONS; p++)
+        freeWordCounter(merged[p]);
+    delete[] workers;
+    delete[] merged;
+    delete[] mapTables;
+    return wordFreq;
+}
+
+// ---------------------------------------------------------
+// findMostFrequentWords:
+// Filters fake articles with "government" in the subject,
+// counts the words of their text in parallel, selects the
+// top N with a size-N heap, and displays them.
+// ---------------------------------------------------------
+void findMostFrequentWords(News *articles, int count, int topN) {
+    // Count words across all cores.
+    int wordCount = 0;
+    WordFrequency* wordFreq = countWordsParallel(articles, count, defaultThreadCount(), wordCount);
+
+    // Select the top N words with a min-heap instead of sorting everything.
+    int topCount = 0;
+    WordFrequency* topWords = topKWords(wordFreq, wordCount, topN, topCount);
+
+    // Display the top N most frequent words.
+    cout << "Top " << topN << " most frequent words in fake government news:" << endl;
+    for (int i = 0; i < topCount; i++) {
+        cout << topWords[i].word << ": " << topWords[i].count << " occurrences" << endl;
+    }
+
+    // Free the dynamically allocated word frequency arrays.
+    delete[] topWords;
+    delete[] wordFreq;
+}
+
+// ---------------------------------------------------------
+// Count-Min sketch: depth rows of width counters. A word's estimate
+// is the smallest of its counters, which is never below the true
+// count and is at most epsilon * N above it with probability
+// 1 - delta. Updates are conservative (only the smallest counters
+// are raised), which keeps the estimates tighter.
+// ---------------------------------------------------------
+struct CountMinSketch {
+    int depth = 0;
+    int width = 0;
+    long long* table = nullptr;
+};
+
+void buildSketch(CountMinSketch &sketch, double epsilon, double delta) {
+    sketch.width = static_cast<int>(ceil(exp(1.0) / epsilon));
+    sketch.depth = static_cast<int>(ceil(log(1.0 / delta)));
+    if (sketch.depth < 1) sketch.depth = 1;
+    sketch.table = new long long[static_cast<size_t>(sketch.depth) * sketch.width]();
+}
+
+// Column of a word in row i, by double hashing of its FNV-1a hash.
+int sketchColumn(const CountMinSketch &sketch, unsigned int hash, int row) {
+    unsigned int step = ((hash * 0x9E3779B1u) ^ (hash >> 15)) | 1u;
+    return static_cast<int>((hash + static_cast<unsigned int>(row) * step) % static_cast<unsigned int>(sketch.width));
+}
+
+// Count one occurrence and return the word's new estimate.
+long long sketchAdd(CountMinSketch &sketch, unsigned int hash) {
+    long long estimate = -1;
+    for (int row = 0; row < sketch.depth; row++) {
+        long long value = sketch.table[static_cast<size_t>(row) * sketch.width + sketchColumn(sketch, hash, row)];
+        if (estimate < 0 || value < estimate) estimate = value;
+    }
+    estimate++;
+    for (int row = 0; row < sketch.depth; row++) {
+        long long &value = sketch.table[static_cast<size_t>(row) * sketch.width + sketchColumn(sketch, hash, row)];
+        if (value < estimate) value = estimate;
+    }
+    return estimate;
+}
+
+// ---------------------------------------------------------
+// Space-Saving heavy hitters: a fixed number of counters, ceil(1/epsilon).
+// A new word takes over the counter with the smallest count c and
+// starts at c + 1 with error c, so every word's true count lies in
+// [count - error, count], the error is at most N / counters, and any
+// word seen more than epsilon * N times is always kept. Counters form
+// a min-heap on count, so each word costs O(log counters) sift steps;
+// 'slots' is an open-addressing table from word hash to heap position.
+// With a Count-Min sketch, a new word starts at its sketch estimate
+// instead, which is usually far below c + 1 for rare words; the error
+// bound then holds with probability 1 - delta. The number of counters
+// is capped at MAX_SUMMARY_COUNTERS, which raises a smaller bound.
+// ---------------------------------------------------------
+const int MAX_SUMMARY_COUNTERS = 1 << 20;
+
+struct HeavyHitter {
+    string word;
+    unsigned int hash = 0;
+    long long count = 0;
+    long long error = 0;
+    int slot = -1;          // position in SpaceSaving::slots
+};
+
+bool ranksHigher(const HeavyHitter &a, const HeavyHitter &b) {
+    if (a.count != b.count)
+        return a.count > b.count;
+    return a.word < b.word;
+}
+
+struct SpaceSaving {
+    HeavyHitter* heap = nullptr;
+    int capacity = 0;
+    int size = 0;
+    int* slots = nullptr;   // heap positions, -1 = empty
+    int slotMask = 0;
+    long long total = 0;    // words seen
+    long long maxEvicted = 0;   // bound on the count of any word not kept
+    bool useSketch = false;
+    CountMinSketch sketch;
+};
+
+void initSpaceSaving(SpaceSaving &summary, double epsilon, bool useSketch) {
+    if (epsilon < 1.0 / MAX_SUMMARY_COUNTERS)
+        epsilon = 1.0 / MAX_SUMMARY_COUNTERS;
+    summary.capacity = static_cast<int>(ceil(1.0 / epsilon));
+    summary.heap = new HeavyHitter[summary.capacity];
+    int slotCount = 1;
+    while (slotCount < summary.capacity * 2)
+        slotCount *= 2;
+    summary.slots = new int[slotCount];
+    for (int i = 0; i < slotCount; i++)
+        summary.slots[i] = -1;
+    summary.slotMask = slotCount - 1;
+    summary.useSketch = useSketch;
+    if (useSketch)
+        buildSketch(summary.sketch, epsilon, 0.01);
+}
+
+void swapHeavyHitters(SpaceSaving &summary, int a, int b) {
+    swap(summary.heap[a], summary.heap[b]);
+    summary.slots[summary.heap[a].slot] = a;
+    summary.slots[summary.heap[b].slot] = b;
+}
+
+void spaceSavingSiftDown(SpaceSaving &summary, int i) {
+    while (true) {
+        int smallest = i;
+        int left = 2 * i + 1, right = 2 * i + 2;
+        if (left < summary.size && summary.heap[left].count < summary.heap[smallest].count)
+            smallest = left;
+        if (right < summary.size && summary.heap[right].count < summary.heap[smallest].count)
+            smallest = right;
+        if (smallest == i)
+            return;
+        swapHeavyHitters(summary, i, smallest);
+        i = smallest;
+    }
+}
+
+void spaceSavingSiftUp(SpaceSaving &summary, int i) {
+    while (i > 0 && summary.heap[(i - 1) / 2].count > summary.heap[i].count) {
+        swapHeavyHitters(summary, i, (i - 1) / 2);
+        i = (i - 1) / 2;
+    }
+}
+
+// Slot holding the word, or the empty slot where it would go.
+int spaceSavingProbe(const SpaceSaving &summary, string_view word, unsigned int hash) {
+    int pos = hash & summary.slotMask;
+    while (summary.slots[pos] != -1) {
+        const HeavyHitter &entry = summary.heap[summary.slots[pos]];
+        if (entry.hash == hash && entry.word == word)
+            return pos;
+        pos = (pos + 1) & summary.slotMask;
+    }
+    return pos;
+}
+
+// Remove a slot, shifting later entries of the probe run back.
+void spaceSavingUnlink(SpaceSaving &summary, int pos) {
+    summary.slots[pos] = -1;
+    int next = (pos + 1) & summary.slotMask;
+    while (summary.slots[next] != -1) {
+        int home = summary.heap[summary.slots[next]].hash & summary.slotMask;
+        // Move the entry back unless its home lies in (pos, next].
+        bool stays = (pos <= next) ? (pos < home && home <= next) : (pos < home || home <= next);
+        if (!stays) {
+            summary.slots[pos] = summary.slots[next];
+            summary.heap[summary.slots[pos]].slot = pos;
+            summary.slots[next] = -1;
+            pos = next;
+        }
+        next = (next + 1) & summary.slotMask;
+    }
+}
+
+void spaceSavingAdd(SpaceSaving &summary, string_view word) {
+    unsigned int hash = hashWord(word);
+    summary.total++;
+    long long estimate = summary.useSketch ? sketchAdd(summary.sketch, hash) : -1;
+    int pos = spaceSavingProbe(summary, word, hash);
+    if (summary.slots[pos] != -1) {
+        int i = summary.slots[pos];
+        summary.heap[i].count++;
+        spaceSavingSiftDown(summary, i);
+        return;
+    }
+    if (summary.size < summary.capacity) {
+        int i = summary.size++;
+        summary.heap[i].word = string(word);
+        summary.heap[i].hash = hash;
+        summary.heap[i].count = 1;
+        summary.heap[i].error = 0;
+        summary.heap[i].slot = pos;
+        summary.slots[pos] = i;
+        spaceSavingSiftUp(summary, i);
+        return;
+    }
+    // Replace the word with the smallest count. With a sketch, the
+    // estimate is used instead, as it also bounds any count the word
+    // had before an earlier eviction.
+    HeavyHitter &victim = summary.heap[0];
+    if (victim.count > summary.maxEvicted)
+        summary.maxEvicted = victim.count;
+    long long count = (estimate >= 0) ? estimate : victim.count + 1;
+    spaceSavingUnlink(summary, victim.slot);
+    pos = spaceSavingProbe(summary, word, hash);
+    victim.word.assign(word.data(), word.size());
+    victim.hash = hash;
+    victim.count = count;
+    victim.error = count - 1;   // the word has been seen at least once
+    victim.slot = pos;
+    summary.slots[pos] = 0;
+    spaceSavingSiftDown(summary, 0);
+}
+
+size_t spaceSavingMemory(const SpaceSaving &summary) {
+    size_t bytes = summary.capacity * sizeof(HeavyHitter) + (summary.slotMask + 1) * sizeof(int);
+    for (int i = 0; i < summary.size; i++)
+        bytes += summary.heap[i].word.capacity();
+    if (summary.useSketch)
+        bytes += static_cast<size_t>(summary.sketch.depth) * summary.sketch.width * sizeof(long long);
+    return bytes;
+}
+
+void freeSpaceSaving(SpaceSaving &summary) {
+    delete[] summary.heap;
+    delete[] summary.slots;
+    delete[] summary.sketch.table;
+    summary = SpaceSaving();
+}
+
+// ---------------------------------------------------------
+// findMostFrequentWordsApprox:
+// Approximate version of findMostFrequentWords in fixed memory. Each
+// count is shown with the range that holds the true count (with the
+// sketch on, with high probability); a '*' marks words whose lower
+// bound beats every other count.
+// ---------------------------------------------------------
+void findMostFrequentWordsApprox(News *articles, int count, int topN, double epsilon, bool useSketch) {
+    SpaceSaving summary;
+    initSpaceSaving(summary, epsilon, useSketch);
+    for (int i = 0; i < count; i++) {
+        if (isFakeGovernmentNews(articles[i])) {
+            forEachWord(articles[i].text, [&summary](string_view token) {
+                spaceSavingAdd(summary, token);
+            });
+        }
+    }
+
+    int topCount = 0;
+    HeavyHitter* ranked = topKWords(summary.heap, summary.size, topN, topCount);
+    // Largest possible count outside the top N; a word whose lower bound
+    // beats it is certainly in the top N.
+    long long nextCount = summary.maxEvicted;
+    for (int j = 0; j < summary.size; j++) {
+        const HeavyHitter &entry = summary.heap[j];
+        if ((topCount == 0 || ranksHigher(ranked[topCount - 1], entry)) && entry.count > nextCount)
+            nextCount = entry.count;
+    }
+
+    cout << "Top " << topN << " most frequent words in fake government news (approximate):" << endl;
+    for (int i = 0; i < topCount; i++) {
+        cout << (ranked[i].count - ranked[i].error > nextCount ? "* " : "  ")
+             << ranked[i].word << ": " << ranked[i].count << " occurrences (true count "
+             << ranked[i].count - ranked[i].error << " - " << ranked[i].count << ")" << endl;
+    }
+    cout << "Words Seen: " << summary.total << ", Counters: " << summary.capacity
+         << (useSketch ? " + Count-Min sketch" : "") << endl;
+    cout << "Maximum Error: " << static_cast<long long>(ceil(summary.total / static_cast<double>(summary.capacity)))
+         << " occurrences (epsilon " << epsilon
+         << (useSketch ? ", holds with high probability" : "") << ")" << endl;
+    cout << "Memory Used by Summary: " << spaceSavingMemory(summary) << " bytes" << endl;
+
+    delete[] ranked;
+    freeSpaceSaving(summary);
+}
+
+// ---------------------------------------------------------
+// TokenInterner: Gives each distinct word a dense id (0, 1, 2, ...).
+// The ids are kept in a WordCounter (its count field holds the id),
+// so the words live once in its arena; 'words' maps ids back to them.
+// ---------------------------------------------------------
+struct TokenInterner {
+    WordCounter table;
+    string_view* words = nullptr;
+    int size = 0;
+    int capacity = 0;
+};
+
+// Find the slot of a word in a WordCounter, or nullptr.
+CounterSlot* counterFind(WordCounter &counter, string_view word, unsigned int hash) {
+    if (counter.capacity == 0)
+        return nullptr;
+    int mask = counter.capacity - 1;
+    int pos = hash & mask;
+    for (int distance = 0; counter.slots[pos].distance >= distance; distance++) {
+        if (counter.slots[pos].hash == hash && counter.slots[pos].word == word)
+            return &counter.slots[pos];
+        pos = (pos + 1) & mask;
+    }
+    return nullptr;
+}
+
+int internToken(TokenInterner &interner, string_view word) {
+    unsigned int hash = hashWord(word);
+    CounterSlot* slot = counterFind(interner.table, word, hash);
+    if (slot)
+        return slot->count;
+    if (interner.size == interner.capacity) {
+        int newCapacity = interner.capacity ? interner.capacity * 2 : 1024;
+        string_view* words = new string_view[newCapacity];
+        for (int i = 0; i < interner.size; i++)
+            words[i] = interner.words[i];
+        delete[] interner.words;
+        interner.words = words;
+        interner.capacity = newCapacity;
+    }
+    int id = interner.size++;
+    counterAddHashed(interner.table, word, hash, id);
+    interner.words[id] = counterFind(interner.table, word, hash)->word;
+    return id;
+}
+
+void freeTokenInterner(TokenInterner &interner) {
+    freeWordCounter(interner.table);
+    delete[] interner.words;
+    interner = TokenInterner();
+}
+
+// ---------------------------------------------------------
+// NgramCounter: Counts n-grams (n = 2 or 3) packed into one 64-bit
+// key of NGRAM_ID_BITS per token id, so no phrase strings are built.
+// Ids are stored plus one, which keeps key 0 free to mark empty
+// slots. Open addressing with linear probing, doubled at 70% load.
+// ---------------------------------------------------------
+const int NGRAM_ID_BITS = 21;
+const unsigned long long NGRAM_ID_LIMIT = (1ULL << NGRAM_ID_BITS) - 1;
+
+struct NgramSlot {
+    unsigned long long key = 0;
+    int count = 0;
+};
+
+struct NgramCounter {
+    NgramSlot* slots = nullptr;
+    int capacity = 0;   // power of two
+    int size = 0;
+};
+
+// Mix the key bits so that neighbouring ids spread over the table.
+unsigned long long hashNgram(unsigned long long key) {
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+    key *= 0xc4ceb9fe1a85ec53ULL;
+    key ^= key >> 33;
+    return key;
+}
+
+void ngramGrow(NgramCounter &counter) {
+    NgramSlot* old = counter.slots;
+    int oldCapacity = counter.capacity;
+    counter.capacity = oldCapacity ? oldCapacity * 2 : 4096;
+    counter.slots = new NgramSlot[counter.capacity];
+    int mask = counter.capacity - 1;
+    for (int i = 0; i < oldCapacity; i++) {
+        if (old[i].key == 0)
+            continue;
+        int pos = static_cast<int>(hashNgram(old[i].key) & mask);
+        while (counter.slots[pos].key != 0)
+            pos = (pos + 1) & mask;
+        counter.slots[pos] = old[i];
+    }
+    delete[] old;
+}
+
+void ngramAdd(NgramCounter &counter, unsigned long long key) {
+    if ((counter.size + 1) * 10 > counter.capacity * 7)
+        ngramGrow(counter);
+    int mask = counter.capacity - 1;
+    int pos = static_cast<int>(hashNgram(key) & mask);
+    while (counter.slots[pos].key != 0 && counter.slots[pos].key != key)
+        pos = (pos + 1) & mask;
+    if (counter.slots[pos].key == 0) {
+        counter.slots[pos].key = key;
+        counter.size++;
+    }
+    counter.slots[pos].count++;
+}
+
+// Join the words of a packed n-gram with spaces.
+string ngramText(const TokenInterner &interner, unsigned long long key, int n) {
+    string text;
+    for (int i = n - 1; i >= 0; i--) {
+        unsigned long long id = (key >> (i * NGRAM_ID_BITS)) & NGRAM_ID_LIMIT;
+        if (!text.empty())
+            text += ' ';
+        text += interner.words[id - 1];
+    }
+    return text;
+}
+
+// ---------------------------------------------------------
+// findMostFrequentPhrases:
+// Counts the n-grams (bigrams or trigrams) of fake government news
+// and displays the top N. An n-gram never spans two articles, and
+// while the stopword filter is on it never spans a dropped stopword
+// either: the window restarts after one.
+// ---------------------------------------------------------
+void findMostFrequentPhrases(News *articles, int count, int n, int topN) {
+    TokenInterner interner;
+    NgramCounter counter;
+    for (int i = 0; i < count; i++) {
+        if (!isFakeGovernmentNews(articles[i]))
+            continue;
+        unsigned long long window = 0;
+        int filled = 0;
+        forEachToken(articles[i].text, [&](string_view token) {
+            if (filterStopwords && isStopword(token)) {
+                filled = 0;     // a phrase does not bridge a dropped stopword
+                return;
+            }
+            unsigned long long id = static_cast<unsigned long long>(internToken(interner, token)) + 1;
+            if (id > NGRAM_ID_LIMIT) {
+                filled = 0;     // id does not fit in the key; restart the window
+                return;
+            }
+            window = ((window << NGRAM_ID_BITS) | id) & ((1ULL << (n * NGRAM_ID_BITS)) - 1);
+            if (++filled >= n)
+                ngramAdd(counter, window);
+        });
+    }
+
+    NgramFrequency* ngrams = new NgramFrequency[counter.size > 0 ? counter.size : 1];
+    int ngramCount = 0;
+    for (int i = 0; i < counter.capacity; i++) {
+        if (counter.slots[i].key != 0) {
+            ngrams[ngramCount].key = counter.slots[i].key;
+            ngrams[ngramCount].count = counter.slots[i].count;
+            ngramCount++;
+        }
+    }
+    int topCount = 0;
+    NgramFrequency* topNgrams = topKWords(ngrams, ngramCount, topN, topCount);
+
+    cout << "Top " << topN << (n == 2 ? " bigrams" : " trigrams") << " in fake government news:" << endl;
+    for (int i = 0; i < topCount; i++) {
+        cout << ngramText(interner, topNgrams[i].key, n) << ": " << topNgrams[i].count << " occurrences" << endl;
+    }
+    size_t memoryUsed = counter.capacity * sizeof(NgramSlot)
+                      + interner.table.capacity * sizeof(CounterSlot)
+                      + interner.capacity * sizeof(string_view);
+    for (ArenaBlock* block = interner.table.arena; block; block = block->next)
+        memoryUsed += block->capacity;
+    cout << "Distinct " << (n == 2 ? "Bigrams: " : "Trigrams: ") << ngramCount
+         << ", Vocabulary: " << interner.size << endl;
+    cout << "Memory Used by Tables: " << memoryUsed << " bytes" << endl;
+
+    delete[] topNgrams;
+    delete[] ngrams;
+    delete[] counter.slots;
+    freeTokenInterner(interner);
+}
+
+// ---------------------------------------------------------
+// Term statistics for the distinctive terms report.
+// One pass over all articles gathers, for every term, its count
+// in FAKE and TRUE articles, the number of FAKE and TRUE articles
+// containing it, and its count in every subject. Worker threads take
+// every threadCount-th article into their own TermTable; the tables
+// are then added together by term.
+// ---------------------------------------------------------
+const int TERM_TF_FAKE = 0;
+const int TERM_TF_TRUE = 1;
+const int TERM_DF_FAKE = 2;
+const int TERM_DF_TRUE = 3;
+const int TERM_TF_SUBJECT = 4;  // first of subjectCount subject counts
+
+struct TermTable {
+    TokenInterner terms;
+    int stride = 0;             // ints per term: 4 + subjectCount
+    int* stats = nullptr;       // [term * stride + TERM_...]
+    int* lastDoc = nullptr;     // last article counted in the term's df
+    int capacity = 0;
+};
+
+struct TermCorpus {
+    TermTable table;
+    int subjectCount = 0;
+    int subjectCapacity = 0;
+    string* subjectNames = nullptr;
+    long long labelTokens[2] = {0, 0};      // [0] FAKE, [1] TRUE
+    int labelDocs[2] = {0, 0};
+    long long* subjectTokens = nullptr;     // subjectCount entries
+    int* subjectDocs = nullptr;
+};
+
+// Id of a term in the table, adding a zeroed row for a new term.
+int termRow(TermTable &table, string_view word) {
+    int id = internToken(table.terms, word);
+    if (id >= table.capacity) {
+        int newCapacity = table.capacity ? table.capacity * 2 : 1024;
+        int* stats = new int[static_cast<size_t>(newCapacity) * table.stride]();
+        int* lastDoc = new int[newCapacity];
+        for (size_t i = 0; i < static_cast<size_t>(table.capacity) * table.stride; i++)
+            stats[i] = table.stats[i];
+        for (int i = 0; i < newCapacity; i++)
+            lastDoc[i] = (i < table.capacity) ? table.lastDoc[i] : -1;
+        delete[] table.stats;
+        delete[] table.lastDoc;
+        table.stats = stats;
+        table.lastDoc = lastDoc;
+        table.capacity = newCapacity;
+    }
+    return id;
+}
+
+void freeTermTable(TermTable &table) {
+    freeTokenInterner(table.terms);
+    delete[] table.stats;
+    delete[] table.lastDoc;
+    table = TermTable();
+}
+
+void freeTermCorpus(TermCorpus &corpus) {
+    freeTermTable(corpus.table);
+    delete[] corpus.subjectNames;
+    delete[] corpus.subjectTokens;
+    delete[] corpus.subjectDocs;
+    corpus = TermCorpus();
+}
+
+void termStatsMap(News *articles, int count, int first, int step, const int* subjectIds, TermCorpus* local) {
+    TermTable &table = local->table;
+    for (int i = first; i < count; i += step) {
+        int label = articles[i].isTrue ? 1 : 0;
+        int subject = subjectIds[i];
+        local->labelDocs[label]++;
+        local->subjectDocs[subject]++;
+        forEachWord(articles[i].text, [&](string_view token) {
+            int id = termRow(table, token);
+            int* row = table.stats + static_cast<size_t>(id) * table.stride;
+            row[TERM_TF_FAKE + label]++;
+            row[TERM_TF_SUBJECT + subject]++;
+            if (table.lastDoc[id] != i) {
+                table.lastDoc[id] = i;
+                row[TERM_DF_FAKE + label]++;
+            }
+            local->labelTokens[label]++;
+            local->subjectTokens[subject]++;
+        });
+    }
+}
+
+// ---------------------------------------------------------
+// buildTermCorpus: Gather the term statistics of all articles
+// with threadCount workers.
+// ---------------------------------------------------------
+void buildTermCorpus(News *articles, int count, int threadCount, TermCorpus &corpus) {
+    if (threadCount <= 0) threadCount = 1;
+    int* subjectIds = new int[count > 0 ? count : 1];
+    for (int i = 0; i < count; i++)
+        subjectIds[i] = internSubject(corpus.subjectNames, corpus.subjectCount, corpus.subjectCapacity, articles[i].subject);
+    corpus.table.stride = TERM_TF_SUBJECT + corpus.subjectCount;
+    int subjectSlots = corpus.subjectCount > 0 ? corpus.subjectCount : 1;
+    corpus.subjectTokens = new long long[subjectSlots]();
+    corpus.subjectDocs = new int[subjectSlots]();
+
+    TermCorpus* partial = new TermCorpus[threadCount];
+    thread* workers = new thread[threadCount];
+    for (int t = 0; t < threadCount; t++) {
+        partial[t].table.stride = corpus.table.stride;
+        partial[t].subjectTokens = new long long[subjectSlots]();
+        partial[t].subjectDocs = new int[subjectSlots]();
+        workers[t] = thread(termStatsMap, articles, count, t, threadCount, subjectIds, partial + t);
+    }
+    for (int t = 0; t < threadCount; t++)
+        workers[t].join();
+
+    // Add the per-thread tables together; each article was seen by one thread only.
+    for (int t = 0; t < threadCount; t++) {
+        const TermTable &local = partial[t].table;
+        for (int id = 0; id < local.terms.size; id++) {
+            int row = termRow(corpus.table, local.terms.words[id]);
+            for (int k = 0; k < corpus.table.stride; k++)
+                corpus.table.stats[static_cast<size_t>(row) * corpus.table.stride + k] +=
+                    local.stats[static_cast<size_t>(id) * local.stride + k];
+        }
+        for (int label = 0; label < 2; label++) {
+            corpus.labelTokens[label] += partial[t].labelTokens[label];
+            corpus.labelDocs[label] += partial[t].labelDocs[label];
+        }
+        for (int s = 0; s < corpus.subjectCount; s++) {
+            corpus.subjectTokens[s] += partial[t].subjectTokens[s];
+            corpus.subjectDocs[s] += partial[t].subjectDocs[s];
+        }
+        freeTermCorpus(partial[t]);
+    }
+    delete[] workers;
+    delete[] partial;
+    delete[] subjectIds;
+}
+
+struct TermScore {
+    string_view word;
+    double score;
+    int count;      // supporting count shown next to the score
+};
+
+bool ranksHigher(const TermScore &a, const TermScore &b) {
+    if (a.score != b.score)
+        return a.score > b.score;
+    return a.word < b.word;
+}
+
+void displayTermScores(TermScore* scores, int termCount, int topN, const string &heading) {
+    int topCount = 0;
+    TermScore* top = topKWords(scores, termCount, topN, topCount);
+    cout << heading << endl;
+    for (int i = 0; i < topCount; i++)
+        cout << "  " << top[i].word << ": " << top[i].score << " (" << top[i].count << " occurrences)" << endl;
+    delete[] top;
+}
+
+// ---------------------------------------------------------
+// reportDistinctiveTerms: Rank the terms that set FAKE apart from
+// TRUE articles.
+//   metric 1: TF-IDF with each label as one document,
+//             (tf in label / words in label) * log(articles / df).
+//   metric 2: log-odds ratio with an informative Dirichlet prior
+//             (the pooled counts), shown as a z-score; positive
+//             leans FAKE, negative leans TRUE.
+//   metric 3: TF-IDF with each subject as one document.
+// Terms seen fewer than minCount times are skipped.
+// ---------------------------------------------------------
+void reportDistinctiveTerms(const TermCorpus &corpus, int metric, int topN, int minCount) {
+    const TermTable &table = corpus.table;
+    int termCount = table.terms.size;
+    int documents = corpus.labelDocs[0] + corpus.labelDocs[1];
+    TermScore* scores = new TermScore[termCount > 0 ? termCount : 1];
+    double* idf = new double[termCount > 0 ? termCount : 1];
+    for (int id = 0; id < termCount; id++) {
+        const int* row = table.stats + static_cast<size_t>(id) * table.stride;
+        idf[id] = log(static_cast<double>(documents) / (row[TERM_DF_FAKE] + row[TERM_DF_TRUE]));
+    }
+
+    if (metric == 2) {
+        double total = static_cast<double>(corpus.labelTokens[0] + corpus.labelTokens[1]);
+        for (int side = 0; side < 2; side++) {
+            int scored = 0;
+            for (int id = 0; id < termCount; id++) {
+                const int* row = table.stats + static_cast<size_t>(id) * table.stride;
+                double fake = row[TERM_TF_FAKE], real = row[TERM_TF_TRUE];
+                if (fake + real < minCount)
+                    continue;
+                double prior = fake + real;     // alpha_w, with alpha_0 = total
+                double delta = log((fake + prior) / (corpus.labelTokens[0] + total - fake - prior))
+                             - log((real + prior) / (corpus.labelTokens[1] + total - real - prior));
+                double z = delta / sqrt(1.0 / (fake + prior) + 1.0 / (real + prior));
+                scores[scored++] = { table.terms.words[id], side == 0 ? z : -z, static_cast<int>(side == 0 ? fake : real) };
+            }
+            displayTermScores(scores, scored, topN, side == 0 ? "Most FAKE-leaning terms (log-odds z-score):"
+                                                              : "Most TRUE-leaning terms (log-odds z-score):");
+        }
+    } else if (metric == 3) {
+        for (int s = 0; s < corpus.subjectCount; s++) {
+            int scored = 0;
+            for (int id = 0; id < termCount; id++) {
+                int tf = table.stats[static_cast<size_t>(id) * table.stride + TERM_TF_SUBJECT + s];
+                if (tf < minCount || corpus.subjectTokens[s] == 0)
+                    continue;
+                scores[scored++] = { table.terms.words[id], tf / static_cast<double>(corpus.subjectTokens[s]) * idf[id], tf };
+            }
+            displayTermScores(scores, scored, topN, "Top TF-IDF terms for subject \"" + corpus.subjectNames[s] + "\":");
+        }
+    } else {
+        for (int label = 0; label < 2; label++) {
+            int scored = 0;
+            for (int id = 0; id < termCount; id++) {
+                int tf = table.stats[static_cast<size_t>(id) * table.stride + TERM_TF_FAKE + label];
+                if (tf < minCount || corpus.labelTokens[label] == 0)
+                    continue;
+                scores[scored++] = { table.terms.words[id], tf / static_cast<double>(corpus.labelTokens[label]) * idf[id], tf };
+            }
+            displayTermScores(scores, scored, topN, label == 0 ? "Top TF-IDF terms in FAKE articles:"
+                                                               : "Top TF-IDF terms in TRUE articles:");
+        }
+    }
+    cout << "Articles: " << corpus.labelDocs[0] << " FAKE, " << corpus.labelDocs[1] << " TRUE; Terms: " << termCount << endl;
+
+    delete[] idf;
+    delete[] scores;
+}
+
+// ---------------------------------------------------------
+// WordCountIndex: The word count index written by DataCleaning
+// ("WordIndex.bin"): token counts per (subject, label, year-month,
+// field) group, with a sorted term dictionary and varint-compressed
+// (term id gap, count) postings per group. The file is read into one
+// buffer and used in place; see DataCleaning.cpp for the layout.
+// ---------------------------------------------------------
+const char WORD_INDEX_MAGIC[8] = {'W', 'C', 'I', 'D', 'X', '0', '2', '\0'};
+const int WORD_INDEX_GROUP_FIELDS = 8;  // subject, label, field, YYYYMM, entries, offset, length, tokens
+
+struct WordCountIndex {
+    char* data = nullptr;
+    size_t size = 0;
+    unsigned int termCount = 0;
+    unsigned int subjectCount = 0;
+    unsigned int groupCount = 0;
+    const unsigned int* termOffsets = nullptr;  // termCount + 1, into pool
+    const unsigned int* subjects = nullptr;     // (pool offset, length) pairs
+    const char* pool = nullptr;
+    const unsigned int* groups = nullptr;       // WORD_INDEX_GROUP_FIELDS per group
+    const unsigned char* postings = nullptr;
+    size_t postingsSize = 0;
+};
+
+// Which groups to add up; an empty subject, label -1 or month 0 means any.
+struct WordCountFilter {
+    string subject;             // case-insensitive substring of the subject
+    int label = -1;             // 0 FAKE, 1 TRUE
+    unsigned int fromMonth = 0; // YYYYMM, inclusive
+    unsigned int toMonth = 0;
+    bool fields[2] = {false, true};     // title, text
+};
+
+void freeWordCountIndex(WordCountIndex &index) {
+    delete[] index.data;
+    index = WordCountIndex();
+}
+
+// ---------------------------------------------------------
+// hashFilePrefix: 64-bit FNV-1a hash of the first 'length' bytes of
+// a file, the fingerprint DataCleaning stores in the index header.
+// Returns false if the file is shorter than 'length'.
+// ---------------------------------------------------------
+bool hashFilePrefix(ifstream &file, unsigned long long length, unsigned long long &hash) {
+    hash = 14695981039346656037ULL;
+    char buffer[65536];
+    file.seekg(0);
+    while (length > 0) {
+        streamsize chunk = static_cast<streamsize>(length < sizeof(buffer) ? length : sizeof(buffer));
+        if (!file.read(buffer, chunk))
+            return false;
+        for (streamsize i = 0; i < chunk; i++) {
+            hash ^= static_cast<unsigned char>(buffer[i]);
+            hash *= 1099511628211ULL;
+        }
+        length -= static_cast<unsigned long long>(chunk);
+    }
+    return true;
+}
+
+// ---------------------------------------------------------
+// readIndexVarint: Decode one varint at p, advancing p. Fails instead
+// of reading past 'end' or decoding more than 32 bits.
+// ---------------------------------------------------------
+bool readIndexVarint(const unsigned char* &p, const unsigned char* end, unsigned int &value) {
+    value = 0;
+    for (int shift = 0; shift < 35 && p < end; shift += 7) {
+        unsigned char byte = *p++;
+        value |= static_cast<unsigned int>(byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+            return shift < 28 || byte < 0x10;
+    }
+    return false;
+}
+
+// ---------------------------------------------------------
+// validateWordCountIndex: Check every table of a loaded index: term
+// and subject strings inside the pool, every group's subject, label
+// and field in range and its postings inside the postings section,
+// and every posting decoding to a term id below termCount. Queries
+// can then use the index without further checks.
+// ---------------------------------------------------------
+bool validateWordCountIndex(const WordCountIndex &index, size_t poolSize) {
+    for (unsigned int t = 0; t < index.termCount; t++)
+        if (index.termOffsets[t] > index.termOffsets[t + 1])
+            return false;
+    if (index.termCount > 0 && (index.termOffsets[0] != 0 || index.termOffsets[index.termCount] > poolSize))
+        return false;
+    for (unsigned int s = 0; s < index.subjectCount; s++)
+        if (static_cast<unsigned long long>(index.subjects[s * 2]) + index.subjects[s * 2 + 1] > poolSize)
+            return false;
+    for (unsigned int g = 0; g < index.groupCount; g++) {
+        const unsigned int* group = index.groups + g * WORD_INDEX_GROUP_FIELDS;
+        if (group[0] >= index.subjectCount || group[1] > 1 || group[2] > 1
+            || static_cast<unsigned long long>(group[5]) + group[6] > index.postingsSize)
+            return false;
+        const unsigned char* p = index.postings + group[5];
+        const unsigned char* end = p + group[6];
+        unsigned long long term = 0;
+        unsigned int gap = 0, count = 0;
+        for (unsigned int e = 0; e < group[4]; e++) {
+            if (!readIndexVarint(p, end, gap) || !readIndexVarint(p, end, count))
+                return false;
+            term += gap;
+            if (term >= index.termCount)
+                return false;
+        }
+    }
+    return true;
+}
+
+// ---------------------------------------------------------
+// loadWordCountIndex: Load the index if it exists, was built from
+// the current contents of sourceFile (same size and hash) and passes
+// validateWordCountIndex. Otherwise returns false and the caller
+// counts the articles directly.
+// ---------------------------------------------------------
+bool loadWordCountIndex(const string &filename, const string &sourceFile, WordCountIndex &index) {
+    ifstream source(sourceFile, ios::binary | ios::ate);
+    ifstream file(filename, ios::binary | ios::ate);
+    if (!source || !file)
+        return false;
+    unsigned long long sourceSize = static_cast<unsigned long long>(source.tellg());
+    size_t size = static_cast<size_t>(file.tellg());
+    const size_t HEADER_SIZE = 8 + 8 + 8 + 8 * 4;
+    if (size < HEADER_SIZE)
+        return false;
+    char* data = new char[size];
+    file.seekg(0);
+    file.read(data, size);
+
+    unsigned long long indexedSize = 0, indexedHash = 0, sourceHash = 0;
+    unsigned int header[8];
+    memcpy(&indexedSize, data + 8, sizeof(indexedSize));
+    memcpy(&indexedHash, data + 16, sizeof(indexedHash));
+    memcpy(header, data + 24, sizeof(header));
+    unsigned int termCount = header[0], subjectCount = header[1], groupCount = header[2];
+    unsigned int termTablePos = header[3], poolPos = header[4], subjectTablePos = header[5];
+    unsigned int groupTablePos = header[6], postingsPos = header[7];
+    bool valid = file && memcmp(data, WORD_INDEX_MAGIC, sizeof(WORD_INDEX_MAGIC)) == 0 && indexedSize == sourceSize
+              && (termTablePos | poolPos | subjectTablePos | groupTablePos | postingsPos) % 4 == 0
+              && termTablePos >= HEADER_SIZE && subjectTablePos >= HEADER_SIZE && groupTablePos >= HEADER_SIZE
+              && termTablePos + (termCount + 1ULL) * 4 <= size && subjectTablePos + subjectCount * 8ULL <= size
+              && groupTablePos + groupCount * 32ULL <= size && poolPos >= HEADER_SIZE && poolPos <= groupTablePos
+              && postingsPos <= size
+              && hashFilePrefix(source, sourceSize, sourceHash) && sourceHash == indexedHash;
+    if (valid) {
+        index.data = data;
+        index.size = size;
+        index.termCount = termCount;
+        index.subjectCount = subjectCount;
+        index.groupCount = groupCount;
+        index.termOffsets = reinterpret_cast<const unsigned int*>(data + termTablePos);
+        index.subjects = reinterpret_cast<const unsigned int*>(data + subjectTablePos);
+        index.pool = data + poolPos;
+        index.groups = reinterpret_cast<const unsigned int*>(data + groupTablePos);
+        index.postings = reinterpret_cast<const unsigned char*>(data + postingsPos);
+        index.postingsSize = size - postingsPos;
+        valid = validateWordCountIndex(index, groupTablePos - poolPos);
+    }
+    if (!valid) {
+        delete[] data;
+        index = WordCountIndex();
+        return false;
+    }
+    return true;
+}
+
+string_view indexTerm(const WordCountIndex &index, unsigned int id) {
+    return string_view(index.pool + index.termOffsets[id], index.termOffsets[id + 1] - index.termOffsets[id]);
+}
+
+string_view indexSubject(const WordCountIndex &index, unsigned int id) {
+    return string_view(index.pool + index.subjects[id * 2], index.subjects[id * 2 + 1]);
+}
+
+bool containsIgnoreCase(string_view text, const string &part) {
+    if (part.size() > text.size())
+        return false;
+    for (size_t start = 0; start + part.size() <= text.size(); start++) {
+        size_t i = 0;
+        while (i < part.size() && tolower(static_cast<unsigned char>(text[start + i])) ==
+                                  tolower(static_cast<unsigned char>(part[i])))
+            i++;
+        if (i == part.size())
+            return true;
+    }
+    return false;
+}
+
+// ---------------------------------------------------------
+// queryWordCounts: Add up the count vectors of every group that
+// matches the filter. Returns a new array of termCount counts
+// indexed by term id (caller must delete[] it).
+// ---------------------------------------------------------
+long long* queryWordCounts(const WordCountIndex &index, const WordCountFilter &filter, int &groupsUsed) {
+    long long* counts = new long long[index.termCount > 0 ? index.termCount : 1]();
+    groupsUsed = 0;
+    for (unsigned int g = 0; g < index.groupCount; g++) {
+        const unsigned int* group = index.groups + g * WORD_INDEX_GROUP_FIELDS;
+        if (filter.label >= 0 && group[1] != static_cast<unsigned int>(filter.label))
+            continue;
+        if (!filter.fields[group[2]])
+            continue;
+        if (filter.fromMonth != 0 && (group[3] < filter.fromMonth || group[3] > filter.toMonth))
+            continue;
+        if (!filter.subject.empty() && !containsIgnoreCase(indexSubject(index, group[0]), filter.subject))
+            continue;
+        groupsUsed++;
+        const unsigned char* p = index.postings + group[5];
+        const unsigned char* end = p + group[6];
+        unsigned int term = 0, gap = 0, count = 0;
+        for (unsigned int e = 0; e < group[4] && readIndexVarint(p, end, gap) && readIndexVarint(p, end, count); e++) {
+            term += gap;
+            counts[term] += count;
+        }
+    }
+    return counts;
+}
+
+// ---------------------------------------------------------
+// indexWordCounts: queryWordCounts as a WordFrequency array (caller
+// must delete[] it), leaving out stopwords while the filter is on.
+// ---------------------------------------------------------
+WordFrequency* indexWordCounts(const WordCountIndex &index, const WordCountFilter &filter, int &wordCount, int &groupsUsed) {
+    long long* counts = queryWordCounts(index, filter, groupsUsed);
+    wordCount = 0;
+    for (unsigned int id = 0; id < index.termCount; id++)
+        if (counts[id] > 0) wordCount++;
+    WordFrequency* wordFreq = new WordFrequency[wordCount > 0 ? wordCount : 1];
+    wordCount = 0;
+    for (unsigned int id = 0; id < index.termCount; id++) {
+        string_view term = indexTerm(index, id);
+        if (counts[id] > 0 && !(filterStopwords && isStopword(term))) {
+            wordFreq[wordCount].word = string(term);
+            wordFreq[wordCount].count = static_cast<int>(counts[id]);
+            wordCount++;
+        }
+    }
+    delete[] counts;
+    return wordFreq;
+}
+
+// ---------------------------------------------------------
+// readWordCountFilter: Prompt for a filter. Subject is a word of the
+// subject or "all"; label is FAKE, TRUE or ALL; month is YYYY-MM,
+// YYYY or "all". Fills 'description' for the report heading.
+// ---------------------------------------------------------
+void readWordCountFilter(WordCountFilter &filter, string &description) {
+    string subject, label, month;
+    cout << "Subject contains (e.g. government, or all): ";
+    cin >> subject;
+    cout << "Label (FAKE, TRUE or ALL): ";
+    cin >> label;
+    cout << "Month (YYYY-MM, YYYY or all): ";
+    cin >> month;
+
+    filter.subject = (subject == "all" || subject == "ALL") ? "" : subject;
+    transform(label.begin(), label.end(), label.begin(), ::toupper);
+    filter.label = (label == "FAKE") ? 0 : (label == "TRUE") ? 1 : -1;
+    filter.fromMonth = filter.toMonth = 0;
+    bool validMonth = month.size() >= 4 && all_of(month.begin(), month.begin() + 4, ::isdigit);
+    if (validMonth && month.size() == 4) {
+        unsigned int year = stoi(month);
+        filter.fromMonth = year * 100 + 1;
+        filter.toMonth = year * 100 + 12;
+    } else if (validMonth && month.size() == 7 && month[4] == '-' && isdigit(month[5]) && isdigit(month[6])) {
+        filter.fromMonth = filter.toMonth = stoi(month.substr(0, 4)) * 100 + stoi(month.substr(5, 2));
+    } else {
+        month = "all";
+    }
+    description = string(filter.label == 0 ? "fake" : filter.label == 1 ? "true" : "all")
+                + " news, subject " + (filter.subject.empty() ? "any" : "\"" + filter.subject + "\"")
+                + ", month " + month;
+}
+
+// ---------------------------------------------------------
+// measureEfficiency: Measures the time taken by a function.
+// ---------------------------------------------------------
+template<typename Func, typename... Args>
+long long measureEfficiency(const string& operationName, Func func, Args&&... args) {
+    auto start = high_resolution_clock::now(); // Start time
+    func(forward<Args>(args)...); // Execute the function
+    auto end = high_resolution_clock::now(); // End time
+    auto duration = duration_cast<microseconds>(end - start); // Duration in microseconds
+    return duration.count();
+}
+
+// ---------------------------------------------------------
+// Script mode: run a list of operations against one loaded
+// dataset without the menu and print the results and timings
+// as JSON. Operations come from the command line
+// (--run "top 10") or a script file (--script FILE, one per
+// line, '#' starts a comment); --out FILE writes the JSON to
+// a file instead of standard output.
+//   sort quick|insertion          sort a copy of the articles by year
+//   search YEAR                   articles published in YEAR
+//   percentage [YEAR] [SUBJECT]   fake share of SUBJECT in YEAR by month
+//                                 (default 2016 politics)
+//   top N                         N most frequent words in fake government news
+//   stopwords on|off              stopword filter for the word counts
+// ---------------------------------------------------------
+struct BatchJob {
+    string* ops = nullptr;
+    int opCount = 0;
+    int opCapacity = 0;
+    string outFile;     // empty = standard output
+};
+
+void addBatchOp(BatchJob &job, const string &op) {
+    if (job.opCount == job.opCapacity) {
+        int capacity = job.opCapacity ? job.opCapacity * 2 : 16;
+        string* larger = new string[capacity];
+        for (int i = 0; i < job.opCount; i++)
+            larger[i] = job.ops[i];
+        delete[] job.ops;
+        job.ops = larger;
+        job.opCapacity = capacity;
+    }
+    job.ops[job.opCount++] = op;
+}
+
+// ---------------------------------------------------------
+// parseBatchArgs: Collect the operations from the command line
+// and script files. Returns false (with a message) on a bad
+// argument or unreadable script.
+// ---------------------------------------------------------
+bool parseBatchArgs(int argc, char const *argv[], BatchJob &job, string &error) {
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if ((arg == "--run" || arg == "--script" || arg == "--out") && i + 1 >= argc) {
+            error = arg + " needs a value";
+            return false;
+        }
+        if (arg == "--run") {
+            addBatchOp(job, argv[++i]);
+        } else if (arg == "--out") {
+            job.outFile = argv[++i];
+        } else if (arg == "--script") {
+            ifstream script(argv[++i]);
+            if (!script) {
+                error = string("Cannot open script ") + argv[i];
+                return false;
+            }
+            string line;
+            while (getline(script, line)) {
+                size_t hash = line.find('#');
+                if (hash != string::npos)
+                    line.erase(hash);
+                size_t first = line.find_first_not_of(" \t\r");
+                if (first == string::npos)
+                    continue;
+                line = line.substr(first, line.find_last_not_of(" \t\r") - first + 1);
+                addBatchOp(job, line);
+            }
+        } else {
+            error = "Unknown argument: " + arg;
+            return false;
+        }
+    }
+    if (job.opCount == 0) {
+        error = "No operations given";
+        return false;
+    }
+    return true;
+}
+
+string jsonEscape(const string &text) {
+    string out;
+    for (unsigned char c : text) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += static_cast<char>(c);
+        } else if (c < 0x20) {
+            char code[8];
+            snprintf(code, sizeof(code), "\\u%04x", c);
+            out += code;
+        } else {
+            out += static_cast<char>(c);
+        }
+    }
+    return out;
+}
+
+// Fake share as a JSON number with 4 decimals, or null.
+string jsonShare(int fake, int total) {
+    if (total == 0)
+        return "null";
+    char number[32];
+    snprintf(number, sizeof(number), "%.4f", 100.0 * fake / total);
+    return number;
+}
+
+// ---------------------------------------------------------
+// runBatchOp: Run one operation and write its JSON object.
+// Returns false if the operation could not be run.
+// ---------------------------------------------------------
+bool runBatchOp(const string &op, News *articles, int count, const AggregateCube &cube, ostream &json) {
+    istringstream words(op);
+    string name;
+    words >> name;
+    json << "    {\"op\": \"" << jsonEscape(op) << "\", ";
+
+    if (name == "sort") {
+        string algorithm;
+        words >> algorithm;
+        if (algorithm != "quick" && algorithm != "insertion") {
+            json << "\"error\": \"algorithm must be quick or insertion\"}";
+            return false;
+        }
+        // Sort a copy so every sort starts from the load order.
+        News *copy = new News[count];
+        for (int i = 0; i < count; i++)
+            copy[i] = articles[i];
+        recursionDepth = 0;
+        auto start = high_resolution_clock::now();
+        if (algorithm == "quick")
+            quickSort(copy, 0, count - 1);
+        else
+            insertionSort(copy, count);
+        auto end = high_resolution_clock::now();
+        bool sorted = true;
+        for (int i = 1; i < count && sorted; i++)
+            sorted = copy[i - 1].year <= copy[i].year;
+        json << "\"time_us\": " << duration_cast<microseconds>(end - start).count()
+             << ", \"result\": {\"algorithm\": \"" << algorithm << "\", \"articles\": " << count
+             << ", \"sorted\": " << (sorted ? "true" : "false");
+        if (algorithm == "quick")
+            json << ", \"recursion_depth\": " << recursionDepth;
+        json << "}}";
+        delete[] copy;
+        return true;
+    }
+
+    if (name == "search") {
+        int year = 0;
+        if (!(words >> year)) {
+            json << "\"error\": \"usage: search YEAR\"}";
+            return false;
+        }
+        auto start = high_resolution_clock::now();
+        int matches = 0, fake = 0;
+        for (int i = 0; i < count; i++) {
+            if (articles[i].year == year) {
+                matches++;
+                fake += !articles[i].isTrue;
+            }
+        }
+        auto end = high_resolution_clock::now();
+        json << "\"time_us\": " << duration_cast<microseconds>(end - start).count()
+             << ", \"result\": {\"year\": " << year << ", \"matches\": " << matches
+             << ", \"fake\": " << fake << ", \"true\": " << matches - fake << "}}";
+        return true;
+    }
+
+    if (name == "percentage") {
+        int year = 2016;
+        string subject = "politics";
+        string word;
+        while (words >> word) {
+            if (word.size() <= 9 && all_of(word.begin(), word.end(), ::isdigit))
+                year = stoi(word);
+            else
+                subject = word;
+        }
+        CubeSlice slice;
+        slice.subject = subject;
+        slice.fromYear = slice.toYear = year;
+        int monthTotals[CUBE_MONTHS], monthFake[CUBE_MONTHS];
+        auto start = high_resolution_clock::now();
+        cubeBreakdown(cube, slice, CUBE_BY_MONTH, monthTotals);
+        slice.label = 0;
+        cubeBreakdown(cube, slice, CUBE_BY_MONTH, monthFake);
+        auto end = high_resolution_clock::now();
+        int total = 0, fake = 0;
+        for (int m = 0; m < CUBE_MONTHS; m++) {
+            total += monthTotals[m];
+            fake += monthFake[m];
+        }
+        json << "\"time_us\": " << duration_cast<microseconds>(end - start).count()
+             << ", \"result\": {\"year\": " << year << ", \"subject\": \"" << jsonEscape(subject)
+             << "\", \"total\": " << total << ", \"fake\": " << fake << ", \"percentage\": " << jsonShare(fake, total)
+             << ", \"by_month\": [";
+        for (int m = 1; m <= 12; m++) {
+            json << (m > 1 ? ", " : "") << "{\"month\": " << m << ", \"total\": " << monthTotals[m]
+                 << ", \"fake\": " << monthFake[m] << ", \"percentage\": " << jsonShare(monthFake[m], monthTotals[m]) << "}";
+        }
+        json << "]}}";
+        return true;
+    }
+
+    if (name == "top") {
+        int topN = 0;
+        if (!(words >> topN) || topN < 1) {
+            json << "\"error\": \"usage: top N\"}";
+            return false;
+        }
+        auto start = high_resolution_clock::now();
+        int wordCount = 0, topCount = 0;
+        WordFrequency* wordFreq = countWords(articles, count, wordCount);
+        WordFrequency* topWords = topKWords(wordFreq, wordCount, topN, topCount);
+        auto end = high_resolution_clock::now();
+        json << "\"time_us\": " << duration_cast<microseconds>(end - start).count()
+             << ", \"result\": {\"vocabulary\": " << wordCount << ", \"stopwords_filtered\": "
+             << (filterStopwords ? "true" : "false") << ", \"words\": [";
+        for (int i = 0; i < topCount; i++) {
+            json << (i > 0 ? ", " : "") << "{\"word\": \"" << jsonEscape(topWords[i].word)
+                 << "\", \"count\": " << topWords[i].count << "}";
+        }
+        json << "]}}";
+        delete[] topWords;
+        delete[] wordFreq;
+        return true;
+    }
+
+    if (name == "stopwords") {
+        string setting;
+        words >> setting;
+        if (setting != "on" && setting != "off") {
+            json << "\"error\": \"usage: stopwords on|off\"}";
+            return false;
+        }
+        filterStopwords = (setting == "on");
+        json << "\"time_us\": 0, \"result\": {\"stopwords_filtered\": " << (filterStopwords ? "true" : "false") << "}}";
+        return true;
+    }
+
+    json << "\"error\": \"unknown operation\"}";
+    return false;
+}
+
+// ---------------------------------------------------------
+// runBatch: Run every operation of the job and write the JSON
+// report. Returns the number of operations that failed.
+// ---------------------------------------------------------
+int runBatch(const BatchJob &job, News *articles, int count, const AggregateCube &cube, long long loadTime, ostream &json) {
+    int failed = 0;
+    json << "{\n  \"program\": \"ArrayAlgorithm\",\n  \"dataset\": \"DataCleaned.csv\",\n"
+         << "  \"articles\": " << count << ",\n  \"load_us\": " << loadTime << ",\n  \"operations\": [\n";
+    for (int i = 0; i < job.opCount; i++) {
+        if (!runBatchOp(job.ops[i], articles, count, cube, json))
+            failed++;
+        json << (i + 1 < job.opCount ? ",\n" : "\n");
+    }
+    json << "  ],\n  \"failed\": " << failed << "\n}" << endl;
+    return failed;
+}
+
+// ---------------------------------------------------------
+// main: Entry point of the program.
+// Prompts the user for an option and calls the corresponding function,
+// or runs the operations given on the command line (script mode).
+// ---------------------------------------------------------
+int main(int argc, char const *argv[]) {
+    BatchJob job;
+    if (argc > 1) {
+        string error;
+        if (!parseBatchArgs(argc, argv, job, error)) {
+            cerr << error << endl;
+            cerr << "Usage: ArrayAlgorithm [--script FILE] [--run \"OPERATION\"]... [--out FILE]" << endl;
+            delete[] job.ops;
+            return 2;
+        }
+    }
+    // In script mode only the JSON report is printed.
+    streambuf* stdoutBuffer = cout.rdbuf();
+    if (job.opCount > 0)
+        cout.rdbuf(nullptr);
+    auto loadStart = high_resolution_clock::now();
+
+    News* articles = nullptr;
+    // Load articles from the CSV file.
+    int count = loadArticles("DataCleaned.csv", articles);
+    if (count == 0) {
+        cout.rdbuf(stdoutBuffer);
+        cerr << "No articles loaded." << endl;
+        delete[] job.ops;
+        return 1;
+    }
+
+    // Build the subject / label / year-month bitmaps once at load time.
+    FacetIndex facetIndex;
+    buildFacetIndex(articles, count, facetIndex);
+
+    // Build the (year, month, subject, label) count cube once at load time.
+    AggregateCube cube;
+    buildAggregateCube(articles, count, cube);
+
+    // Columnar copy of the articles for filter scans.
+    ArticleTable table;
+    buildArticleTable(articles, count, table);
+
+    // Load the word count index written by DataCleaning, if it is up to date.
+    WordCountIndex wordIndex;
+    bool hasWordIndex = loadWordCountIndex("WordIndex.bin", "DataCleaned.csv", wordIndex);
+
+    if (job.opCount > 0) {
+        long long loadTime = duration_cast<microseconds>(high_resolution_clock::now() - loadStart).count();
+        int failed = 0;
+        if (job.outFile.empty()) {
+            ostream json(stdoutBuffer);
+            failed = runBatch(job, articles, count, cube, loadTime, json);
+        } else {
+            ofstream json(job.outFile);
+            if (json)
+                failed = runBatch(job, articles, count, cube, loadTime, json);
+            else
+                cerr << "Cannot write " << job.outFile << endl;
+            if (!json)
+                failed = job.opCount;
+        }
+        cout.rdbuf(stdoutBuffer);
+        delete[] job.ops;
+        freeWordCountIndex(wordIndex);
+        freeArticleTable(table);
+        freeAggregateCube(cube);
+        freeFacetIndex(facetIndex);
+        delete[] articles;
+        return failed > 0 ? 1 : 0;
+    }
+
+    // Worker threads for parallelReduce; the calling thread works too.
+    ThreadPool pool(defaultThreadCount() - 1);
+
+    string option;
+    
+    // Display options to the user.
+    cout << "Enter Your Option:" << endl
+         << "1. Sort the news articles by year and display all articles" << endl
+         << "2. Percentage of political news articles from 2016" << endl
+         << "3. Most frequently words used in fake government news" << endl
+         << "4. Most frequent phrases (bigrams / trigrams) in fake government news" << endl
+         << "5. Terms that distinguish fake from true news (TF-IDF / log-odds)" << endl
+         << "Option: ";
+    cin >> option;
+    
+    if (option == "1") {
+        // Use Quick Sort to sort articles by year and then traverse all articles.
+        long long sortingTime = measureEfficiency("Quick Sort", quickSort, articles, 0, count - 1);
+        double sortingTimeSec = sortingTime / 1e6;
+        traverseAndCountArticles(articles, count, cube);
+        
+        // Calculate memory usage based on total articles.
+        size_t memoryUsed = count * sizeof(News);
+    
+        // Display results.
+        cout << "=== Quick Sort (All Articles) ===" << endl;
+        cout << "Sorting Time: " << sortingTime << " µs (" << sortingTimeSec << " seconds)" << endl;
+        cout << "Memory Used by Array: " << memoryUsed << " bytes" << endl;
+        cout << "Recursion Depth: " << recursionDepth << endl;
+    
+    } else if (option == "2") {
+        // Use Insertion Sort on the articles.
+        long long sortingTime = measureEfficiency("Insertion Sort", insertionSort, articles, count);
+        double sortingTimeSec = sortingTime / 1e6;
+        long long cubeTime = measureEfficiency("Aggregate Cube", calculateFakePoliticalNewsPercentageCube, cube);
+        long long scanTime = measureEfficiency("Baseline Scan", calculateFakePoliticalNewsPercentage, std::ref(pool), std::cref(table));
+    
+        // Calculate memory usage based on total articles.
+        size_t memoryUsed = count * sizeof(News);
+    
+        // Display results.
+        cout << "=== Insertion Sort (All Articles) and Linear Search ===" << endl;
+        cout << "Sorting Time: " << sortingTime << " µs (" << sortingTimeSec << " seconds)" << endl;
+        cout << "Aggregate Cube Time: " << cubeTime << " µs" << endl;
+        cout << "Baseline Scan Time: " << scanTime << " µs" << endl;
+        cout << "Memory Used by Array: " << memoryUsed << " bytes" << endl;
+    
+    } else if (option == "3") {
+        int topN;
+        cout << "Enter the number of top frequent words to display: ";
+        cin >> topN;
+    
+        string stopwords;
+        cout << "Filter stopwords? (y/n): ";
+        cin >> stopwords;
+        filterStopwords = (stopwords != "n" && stopwords != "N");
+        string mode;
+        cout << "Counting mode (1. Single thread, 2. Parallel, 3. Approximate, 4. Word index): ";
+        cin >> mode;
+    
+        if (mode == "3") {
+            // Space-Saving summary in memory fixed by the error bound.
+            double epsilon;
+            cout << "Error bound as a fraction of all words (e.g. 0.001): ";
+            cin >> epsilon;
+            if (!(epsilon > 0 && epsilon < 1)) {
+                cout << "Invalid error bound, using 0.001." << endl;
+                epsilon = 0.001;
+            } else if (epsilon < 1.0 / MAX_SUMMARY_COUNTERS) {
+                cout << "Error bound needs more than " << MAX_SUMMARY_COUNTERS << " counters, using "
+                     << 1.0 / MAX_SUMMARY_COUNTERS << "." << endl;
+                epsilon = 1.0 / MAX_SUMMARY_COUNTERS;
+            }
+            string sketch;
+            cout << "Back the counters with a Count-Min sketch? (y/n): ";
+            cin >> sketch;
+            bool useSketch = (sketch == "y" || sketch == "Y");
+            long long countingTime = measureEfficiency("Space-Saving", findMostFrequentWordsApprox,
+                                                       articles, count, topN, epsilon, useSketch);
+            cout << "=== Space-Saving Heavy Hitters (Word Frequency Analysis) ===" << endl;
+            cout << "Counting Time: " << countingTime << " µs (" << countingTime / 1e6 << " seconds)" << endl;
+        } else {
+            int threadCount = (mode == "2") ? defaultThreadCount() : 1;
+            string heading = "fake government news";
+            WordCountFilter filter;
+            if (mode == "4" && !hasWordIndex) {
+                cout << "WordIndex.bin is missing or out of date; run DataCleaning to rebuild it. Counting directly." << endl;
+                mode = "1";
+            } else if (mode == "4") {
+                readWordCountFilter(filter, heading);
+            }
+    
+            // Count words in a hash table (grows as needed, no vocabulary limit),
+            // or add up the matching count vectors of the word index.
+            int wordCount = 0;
+            int groupsUsed = 0;
+            WordFrequency* wordFreq = nullptr;
+            auto startCount = high_resolution_clock::now();
+            if (mode == "4")
+                wordFreq = indexWordCounts(wordIndex, filter, wordCount, groupsUsed);
+            else if (mode == "2")
+                wordFreq = countWordsParallel(articles, count, threadCount, wordCount);
+            else
+                wordFreq = countWords(articles, count, wordCount);
+            auto endCount = high_resolution_clock::now();
+            long long countingTime = duration_cast<microseconds>(endCount - startCount).count();
+    
+            // Use a size-N min-heap for Option 3 (only the top N are ordered).
+            int topCount = 0;
+            WordFrequency* topWords = nullptr;
+            auto startSelect = high_resolution_clock::now();
+            topWords = topKWords(wordFreq, wordCount, topN, topCount);
+            auto endSelect = high_resolution_clock::now();
+            long long selectionTime = duration_cast<microseconds>(endSelect - startSelect).count();
+            double selectionTimeSec = selectionTime / 1e6;
+            auto startSearch = high_resolution_clock::now();
+            cout << "Top " << topN << " most frequent words in " << heading << ":" << endl;
+            for (int i = 0; i < topCount; i++) {
+                cout << topWords[i].word << ": " << topWords[i].count << " occurrences" << endl;
+            }
+            auto endSearch = high_resolution_clock::now();
+            long long searchingTime = duration_cast<microseconds>(endSearch - startSearch).count();
+            double searchingTimeSec = searchingTime / 1e6;
+    
+            // Calculate memory usage.
+            size_t memoryUsed = (wordCount + topCount) * sizeof(WordFrequency);
+    
+            // Display results.
+            cout << "=== Heap Top-K Selection (Word Frequency Analysis) ===" << endl;
+            if (mode == "4")
+                cout << "Counting Time (word index, " << groupsUsed << " groups): ";
+            else
+                cout << "Counting Time (" << threadCount << (threadCount == 1 ? " thread" : " threads") << "): ";
+            cout << countingTime << " µs (" << countingTime / 1e6 << " seconds)" << endl;
+            cout << "Top-K Selection Time: " << selectionTime << " µs (" << selectionTimeSec << " seconds)" << endl;
+            cout << "Searching Time: " << searchingTime << " µs (" << searchingTimeSec << " seconds)" << endl;
+            cout << "Memory Used by Array: " << memoryUsed << " bytes" << endl;
+    
+            delete[] topWords;
+            delete[] wordFreq;
+        }
+    } else if (option == "4") {
+        int n, topN;
+        cout << "Phrase length (2 = bigrams, 3 = trigrams): ";
+        cin >> n;
+        if (n != 2 && n != 3) {
+            cout << "Invalid phrase length, using bigrams." << endl;
+            n = 2;
+        }
+        cout << "Enter the number of top frequent phrases to display: ";
+        cin >> topN;
+        string stopwords;
+        cout << "Filter stopwords? (y/n): ";
+        cin >> stopwords;
+        filterStopwords = (stopwords != "n" && stopwords != "N");
+    
+        long long countingTime = measureEfficiency("N-gram Count", findMostFrequentPhrases, articles, count, n, topN);
+    
+        // Display results.
+        cout << "=== N-gram Frequency (" << (n == 2 ? "Bigrams" : "Trigrams") << ") ===" << endl;
+        cout << "Counting Time: " << countingTime << " µs (" << countingTime / 1e6 << " seconds)" << endl;
+    } else if (option == "5") {
+        int metric, topN;
+        cout << "Ranking (1. TF-IDF by label, 2. Log-odds fake vs true, 3. TF-IDF by subject): ";
+        cin >> metric;
+        cout << "Enter the number of terms to display per list: ";
+        cin >> topN;
+        string stopwords;
+        cout << "Filter stopwords? (y/n): ";
+        cin >> stopwords;
+        filterStopwords = (stopwords != "n" && stopwords != "N");
+    
+        // One parallel pass over all articles, then rank.
+        TermCorpus corpus;
+        int threadCount = defaultThreadCount();
+        long long countingTime = measureEfficiency("Term Statistics", buildTermCorpus, articles, count, threadCount, corpus);
+        long long rankingTime = measureEfficiency("Term Ranking", reportDistinctiveTerms, corpus, metric, topN, 5);
+    
+        // Display results.
+        cout << "=== Distinctive Terms (" << threadCount << (threadCount == 1 ? " thread" : " threads") << ") ===" << endl;
+        cout << "Counting Time: " << countingTime << " µs (" << countingTime / 1e6 << " seconds)" << endl;
+        cout << "Ranking Time: " << rankingTime << " µs (" << rankingTime / 1e6 << " seconds)" << endl;
+        freeTermCorpus(corpus);
     } else {
         cout << "Invalid option." << endl;
     }
     
     // Free the dynamically allocated memory for articles.
+    freeWordCountIndex(wordIndex);
+    freeArticleTable(table);
+    freeAggregateCube(cube);
+    freeFacetIndex(facetIndex);
     delete[] articles;
     return 0;
 }
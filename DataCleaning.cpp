@@ -2,6 +2,10 @@
 #include <fstream>
 #include <sstream>
 #include <string>
+#include <string_view>
+#include <cstring>
+#include <cctype>
+#include <algorithm>
 
 using namespace std;
 
@@ -188,14 +192,425 @@ void parseCSVLine(const string &line, string &title, string &text, string &subje
     }
 }
 
+/**
+ * Word count index ("WordIndex.bin")
+ * Holds the token counts of every (subject, label, year-month, field) group of
+ * DataCleaned.csv so the analyzers can answer word-frequency questions for any
+ * filter by adding a few count vectors instead of re-tokenizing the articles.
+ * Tokens are whitespace-separated runs with only their letters and digits kept,
+ * lowercased, exactly like the analyzers' tokenizer.
+ *
+ * Layout (host byte order, every section 4-byte aligned, positions from the
+ * start of the file, so the file can be mapped into memory and used in place):
+ *   header:    magic "WCIDX02\0", uint64 size and uint64 FNV-1a hash of the
+ *              bytes of DataCleaned.csv, then uint32 termCount, subjectCount, groupCount, termTablePos, poolPos,
+ *              subjectTablePos, groupTablePos, postingsPos
+ *   terms:     termCount + 1 uint32 offsets into the pool; terms are sorted,
+ *              so a term id is its alphabetical rank
+ *   subjects:  subjectCount pairs of uint32 (pool offset, length)
+ *   pool:      term bytes followed by subject bytes
+ *   groups:    groupCount records of 8 uint32: subject, label (0 FAKE, 1 TRUE),
+ *              field (0 title, 1 text), year-month (YYYYMM, 0 if unknown),
+ *              entry count, postings offset, postings length, token total;
+ *              sorted by subject, label, field and year-month
+ *   postings:  per group, (term id gap, count) pairs as varints, by term id
+ */
+const char WORD_INDEX_MAGIC[8] = {'W', 'C', 'I', 'D', 'X', '0', '2', '\0'};
+
+/**
+ * Function to fingerprint a file for the word index: its size and the 64-bit
+ * FNV-1a hash of its bytes. The analyzers hash the CSV the same way on load,
+ * so an index is never used with a different file of the same size.
+ * @param filename File to hash
+ * @param size Receives the number of bytes read
+ * @param hash Receives the hash
+ */
+bool hashFile(const string &filename, unsigned long long &size, unsigned long long &hash) {
+    ifstream file(filename, ios::binary);
+    if (!file) return false;
+    size = 0;
+    hash = 14695981039346656037ULL;
+    char buffer[65536];
+    while (file.read(buffer, sizeof(buffer)) || file.gcount() > 0) {
+        streamsize got = file.gcount();
+        for (streamsize i = 0; i < got; i++) {
+            hash ^= static_cast<unsigned char>(buffer[i]);
+            hash *= 1099511628211ULL;
+        }
+        size += static_cast<unsigned long long>(got);
+    }
+    return true;
+}
+
+/**
+ * Streaming tokenizer
+ * A token is a whitespace-separated run of characters with only its letters
+ * and digits kept, lowercased; ArrayAlgorithm and linked_list_doc split the
+ * text the same way, so their words match WordIndex.bin. The text is read 8
+ * bytes at a time into a 64-bit word and classified with SWAR arithmetic: each
+ * class test sets the top bit of every byte in the class, and adding the
+ * uppercase mask shifted down to 0x20 lowercases A-Z in the register. A block
+ * of 8 letters and digits is appended whole; other blocks are walked byte by
+ * byte using the masks. Tokens are passed to the callback as string_views into
+ * a reusable buffer, so nothing is allocated per token. A view is only valid
+ * during its callback.
+ */
+const unsigned long long SWAR_ONES = 0x0101010101010101ULL;
+const unsigned long long SWAR_HIGH_BITS = 0x8080808080808080ULL;
+const unsigned long long SWAR_LOW_BITS = 0x7F7F7F7F7F7F7F7FULL;
+
+/**
+ * Bytes of a word that lie in [lo, hi]. Both sums stay inside their byte, so
+ * no carry crosses into the next one
+ * @param word 8 bytes of text
+ * @param lo Lowest byte value of the class, below 0x80
+ * @param hi Highest byte value of the class, below 0x80
+ * @return word with the top bit set in each byte of the class
+ */
+inline unsigned long long swarInRange(unsigned long long word, unsigned char lo, unsigned char hi) {
+    unsigned long long low = word & SWAR_LOW_BITS;
+    unsigned long long atLeastLo = low + SWAR_ONES * (0x80 - lo);
+    unsigned long long atMostHi = SWAR_ONES * (0x80 + hi) - low;
+    return atLeastLo & atMostHi & ~word & SWAR_HIGH_BITS;
+}
+
+/**
+ * Call onToken for every token of a text
+ * @param text Text to split
+ * @param onToken Callable taking a string_view
+ */
+template<typename Callback>
+void forEachToken(string_view text, Callback onToken) {
+    char localBuffer[256];
+    char* buffer = localBuffer;
+    size_t bufferSize = sizeof(localBuffer);
+    size_t length = 0;
+    for (size_t i = 0; i < text.size(); i += 8) {
+        size_t blockSize = text.size() - i < 8 ? text.size() - i : 8;
+        unsigned long long word = 0;                    // A short last block is zero padded
+        memcpy(&word, text.data() + i, blockSize);
+        unsigned long long upper = swarInRange(word, 'A', 'Z');
+        unsigned long long alnum = upper | swarInRange(word, 'a', 'z') | swarInRange(word, '0', '9');
+        unsigned long long space = swarInRange(word, '\t', '\r') | swarInRange(word, ' ', ' ');
+        word += upper >> 2;                             // 0x80 >> 2 == 'a' - 'A'
+        if (length + 8 > bufferSize) {
+            // Only tokens longer than the local buffer reach the heap
+            char* larger = new char[bufferSize * 2];
+            for (size_t j = 0; j < length; j++)
+                larger[j] = buffer[j];
+            if (buffer != localBuffer)
+                delete[] buffer;
+            buffer = larger;
+            bufferSize *= 2;
+        }
+        if (alnum == SWAR_HIGH_BITS) {
+            memcpy(buffer + length, &word, 8);
+            length += 8;
+            continue;
+        }
+        unsigned char bytes[8], alnumBytes[8], spaceBytes[8];
+        memcpy(bytes, &word, 8);
+        memcpy(alnumBytes, &alnum, 8);
+        memcpy(spaceBytes, &space, 8);
+        for (size_t j = 0; j < blockSize; j++) {
+            if (alnumBytes[j]) {
+                buffer[length++] = static_cast<char>(bytes[j]);
+            } else if (spaceBytes[j] && length > 0) {
+                onToken(string_view(buffer, length));
+                length = 0;
+            }
+        }
+    }
+    if (length > 0)
+        onToken(string_view(buffer, length));
+    if (buffer != localBuffer)
+        delete[] buffer;
+}
+
+struct IndexEntry {
+    unsigned long long group;  // subject << 22 | label << 21 | field << 20 | YYYYMM
+    unsigned int term;
+    unsigned int count;        // 0 = empty slot
+};
+
+class WordIndexBuilder {
+    private:
+        // Term dictionary: open addressing on the word, ids in insertion order
+        string* words;
+        int* termSlots;
+        int termCount;
+        int termCapacity;
+        int termSlotCount;
+
+        // Counts keyed by group and term
+        IndexEntry* entries;
+        int entryCount;
+        int entrySlotCount;
+
+        // Subject names in id order, doubled when full
+        string* subjectNames;
+        int subjectCount;
+        int subjectCapacity;
+
+        static unsigned int hashWord(const char* word, size_t length) {
+            unsigned int h = 2166136261u;
+            for (size_t i = 0; i < length; i++) {
+                h ^= static_cast<unsigned char>(word[i]);
+                h *= 16777619u;
+            }
+            return h;
+        }
+
+        static unsigned long long hashKey(unsigned long long key) {
+            key ^= key >> 33;
+            key *= 0xff51afd7ed558ccdULL;
+            key ^= key >> 33;
+            return key;
+        }
+
+        int termId(const char* word, size_t length) {
+            if ((termCount + 1) * 2 > termSlotCount) {                  // Keep the table at most half full
+                int newSlotCount = termSlotCount ? termSlotCount * 2 : 4096;
+                int* newSlots = new int[newSlotCount];
+                for (int i = 0; i < newSlotCount; i++) newSlots[i] = -1;
+                for (int id = 0; id < termCount; id++) {
+                    int pos = hashWord(words[id].data(), words[id].size()) & (newSlotCount - 1);
+                    while (newSlots[pos] != -1) pos = (pos + 1) & (newSlotCount - 1);
+                    newSlots[pos] = id;
+                }
+                delete[] termSlots;
+                termSlots = newSlots;
+                termSlotCount = newSlotCount;
+            }
+            int pos = hashWord(word, length) & (termSlotCount - 1);
+            while (termSlots[pos] != -1) {
+                const string &existing = words[termSlots[pos]];
+                if (existing.size() == length && existing.compare(0, length, word, length) == 0)
+                    return termSlots[pos];
+                pos = (pos + 1) & (termSlotCount - 1);
+            }
+            if (termCount == termCapacity) {
+                termCapacity = termCapacity ? termCapacity * 2 : 4096;
+                string* larger = new string[termCapacity];
+                for (int i = 0; i < termCount; i++) larger[i].swap(words[i]);
+                delete[] words;
+                words = larger;
+            }
+            words[termCount].assign(word, length);
+            termSlots[pos] = termCount;
+            return termCount++;
+        }
+
+        static unsigned long long hashEntry(unsigned long long group, unsigned int term) {
+            return hashKey(group * 0x9E3779B97F4A7C15ULL + term);
+        }
+
+        void addCount(unsigned long long group, unsigned int term) {
+            if ((entryCount + 1) * 2 > entrySlotCount) {
+                int newSlotCount = entrySlotCount ? entrySlotCount * 2 : 65536;
+                IndexEntry* newEntries = new IndexEntry[newSlotCount]();
+                for (int i = 0; i < entrySlotCount; i++) {
+                    if (entries[i].count == 0) continue;
+                    int pos = static_cast<int>(hashEntry(entries[i].group, entries[i].term) & (newSlotCount - 1));
+                    while (newEntries[pos].count != 0) pos = (pos + 1) & (newSlotCount - 1);
+                    newEntries[pos] = entries[i];
+                }
+                delete[] entries;
+                entries = newEntries;
+                entrySlotCount = newSlotCount;
+            }
+            int pos = static_cast<int>(hashEntry(group, term) & (entrySlotCount - 1));
+            while (entries[pos].count != 0 && (entries[pos].group != group || entries[pos].term != term))
+                pos = (pos + 1) & (entrySlotCount - 1);
+            if (entries[pos].count == 0) {
+                entries[pos].group = group;
+                entries[pos].term = term;
+                entryCount++;
+            }
+            entries[pos].count++;
+        }
+
+        static void writeU32(ofstream &out, unsigned int value) {
+            out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+        }
+
+        static void writeVarint(string &out, unsigned int value) {
+            while (value >= 0x80) {
+                out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+                value >>= 7;
+            }
+            out.push_back(static_cast<char>(value));
+        }
+
+    public:
+        WordIndexBuilder() : words(nullptr), termSlots(nullptr), termCount(0), termCapacity(0), termSlotCount(0),
+                             entries(nullptr), entryCount(0), entrySlotCount(0),
+                             subjectNames(nullptr), subjectCount(0), subjectCapacity(0) {}
+
+        /**
+         * Count the tokens of one cleaned article
+         * @param title, text, subject, date Cleaned fields (date as "DD-MM-YYYY")
+         * @param label 0 for fake news, 1 for true news
+         */
+        void addArticle(const string &title, const string &text, const string &subject, const string &date, int label) {
+            int subjectId = 0;
+            while (subjectId < subjectCount && subjectNames[subjectId] != subject) subjectId++;
+            if (subjectId == subjectCount) {
+                if (subjectCount == subjectCapacity) {
+                    subjectCapacity = subjectCapacity ? subjectCapacity * 2 : 64;
+                    string* larger = new string[subjectCapacity];
+                    for (int i = 0; i < subjectCount; i++) larger[i].swap(subjectNames[i]);
+                    delete[] subjectNames;
+                    subjectNames = larger;
+                }
+                subjectNames[subjectCount++] = subject;
+            }
+
+            unsigned int yearMonth = 0;                                 // 0 = date not in "DD-MM-YYYY" form
+            if (date.size() == 10 && date[2] == '-' && date[5] == '-') {
+                bool digits = true;
+                for (int i : {0, 1, 3, 4, 6, 7, 8, 9}) digits = digits && isdigit(static_cast<unsigned char>(date[i]));
+                if (digits) yearMonth = stoi(date.substr(6, 4)) * 100 + stoi(date.substr(3, 2));
+            }
+
+            const string* fields[2] = { &title, &text };
+            for (int field = 0; field < 2; field++) {
+                // Group key: subject | label (1 bit) | field (1) | YYYYMM (20)
+                unsigned long long group = (static_cast<unsigned long long>(subjectId) << 22)
+                                         | (static_cast<unsigned long long>(label) << 21)
+                                         | (static_cast<unsigned long long>(field) << 20) | yearMonth;
+                forEachToken(*fields[field], [&](string_view token) {
+                    addCount(group, static_cast<unsigned int>(termId(token.data(), token.size())));
+                });
+            }
+        }
+
+        /**
+         * Write the index file
+         * @param filename Output file name
+         * @param sourceSize Size in bytes of the CSV file the counts came from
+         * @param sourceHash hashFile() hash of that CSV file
+         */
+        bool write(const string &filename, unsigned long long sourceSize, unsigned long long sourceHash) {
+            // Sort the terms to give every term its alphabetical rank
+            int* order = new int[termCount > 0 ? termCount : 1];
+            for (int i = 0; i < termCount; i++) order[i] = i;
+            sort(order, order + termCount, [this](int a, int b) { return words[a] < words[b]; });
+            unsigned int* rank = new unsigned int[termCount > 0 ? termCount : 1];
+            for (int i = 0; i < termCount; i++) rank[order[i]] = i;
+
+            // Re-key the counts by (group, rank) and sort them into group runs
+            IndexEntry* sorted = new IndexEntry[entryCount > 0 ? entryCount : 1];
+            int sortedCount = 0;
+            for (int i = 0; i < entrySlotCount; i++) {
+                if (entries[i].count == 0) continue;
+                sorted[sortedCount] = entries[i];
+                sorted[sortedCount++].term = rank[entries[i].term];
+            }
+            sort(sorted, sorted + sortedCount, [](const IndexEntry &a, const IndexEntry &b) {
+                return a.group != b.group ? a.group < b.group : a.term < b.term;
+            });
+
+            // Encode the postings of each group
+            int groupCount = 0;
+            for (int i = 0; i < sortedCount; i++)
+                if (i == 0 || sorted[i].group != sorted[i - 1].group) groupCount++;
+            unsigned int* groupTable = new unsigned int[groupCount * 8 + 1];
+            string postings;
+            int g = -1;
+            unsigned int previousTerm = 0;
+            for (int i = 0; i < sortedCount; i++) {
+                unsigned long long group = sorted[i].group;
+                unsigned int term = sorted[i].term;
+                if (i == 0 || group != sorted[i - 1].group) {
+                    if (g >= 0) groupTable[g * 8 + 6] = static_cast<unsigned int>(postings.size()) - groupTable[g * 8 + 5];
+                    g++;
+                    groupTable[g * 8 + 0] = static_cast<unsigned int>(group >> 22);          // subject
+                    groupTable[g * 8 + 1] = static_cast<unsigned int>((group >> 21) & 1);    // label
+                    groupTable[g * 8 + 2] = static_cast<unsigned int>((group >> 20) & 1);    // field
+                    groupTable[g * 8 + 3] = static_cast<unsigned int>(group & 0xFFFFF);      // year-month
+                    groupTable[g * 8 + 4] = 0;
+                    groupTable[g * 8 + 5] = static_cast<unsigned int>(postings.size());
+                    groupTable[g * 8 + 7] = 0;
+                    previousTerm = 0;
+                }
+                writeVarint(postings, term - previousTerm);
+                writeVarint(postings, sorted[i].count);
+                previousTerm = term;
+                groupTable[g * 8 + 4]++;
+                groupTable[g * 8 + 7] += sorted[i].count;
+            }
+            if (g >= 0) groupTable[g * 8 + 6] = static_cast<unsigned int>(postings.size()) - groupTable[g * 8 + 5];
+
+            // String pool: sorted terms, then subjects
+            string pool;
+            unsigned int* termOffsets = new unsigned int[termCount + 1];
+            for (int i = 0; i < termCount; i++) {
+                termOffsets[i] = static_cast<unsigned int>(pool.size());
+                pool += words[order[i]];
+            }
+            termOffsets[termCount] = static_cast<unsigned int>(pool.size());
+            unsigned int* subjectTable = new unsigned int[subjectCount * 2 + 1];
+            for (int s = 0; s < subjectCount; s++) {
+                subjectTable[s * 2] = static_cast<unsigned int>(pool.size());
+                subjectTable[s * 2 + 1] = static_cast<unsigned int>(subjectNames[s].size());
+                pool += subjectNames[s];
+            }
+            while (pool.size() % 4 != 0) pool.push_back('\0');
+
+            unsigned int headerSize = 8 + 8 + 8 + 8 * 4;
+            unsigned int termTablePos = headerSize;
+            unsigned int subjectTablePos = termTablePos + (termCount + 1) * 4;
+            unsigned int poolPos = subjectTablePos + subjectCount * 8;
+            unsigned int groupTablePos = poolPos + static_cast<unsigned int>(pool.size());
+            unsigned int postingsPos = groupTablePos + groupCount * 32;
+
+            ofstream out(filename, ios::binary);
+            bool ok = static_cast<bool>(out);
+            if (ok) {
+                out.write(WORD_INDEX_MAGIC, sizeof(WORD_INDEX_MAGIC));
+                out.write(reinterpret_cast<const char*>(&sourceSize), sizeof(sourceSize));
+                out.write(reinterpret_cast<const char*>(&sourceHash), sizeof(sourceHash));
+                unsigned int header[8] = { static_cast<unsigned int>(termCount), static_cast<unsigned int>(subjectCount),
+                                           static_cast<unsigned int>(groupCount), termTablePos, poolPos,
+                                           subjectTablePos, groupTablePos, postingsPos };
+                for (unsigned int value : header) writeU32(out, value);
+                out.write(reinterpret_cast<const char*>(termOffsets), (termCount + 1) * 4);
+                out.write(reinterpret_cast<const char*>(subjectTable), subjectCount * 8);
+                out.write(pool.data(), pool.size());
+                out.write(reinterpret_cast<const char*>(groupTable), groupCount * 32);
+                out.write(postings.data(), postings.size());
+                ok = static_cast<bool>(out);
+            }
+
+            delete[] subjectTable;
+            delete[] termOffsets;
+            delete[] groupTable;
+            delete[] sorted;
+            delete[] rank;
+            delete[] order;
+            return ok;
+        }
+
+        int terms() const { return termCount; }
+
+        ~WordIndexBuilder() {
+            delete[] words;
+            delete[] termSlots;
+            delete[] entries;
+            delete[] subjectNames;
+        }
+};
+
 /**
  * Function to process a CSV file, clean the data, reformat the date, and add a new "source" column.
  * The source column helps identify whether the data comes from "fake.csv" or "true.csv".
  * @param filename The name of the CSV file to process (e.g., "fake.csv" or "true.csv").
  * @param outfile The output file stream where the cleaned and merged data is written.
  * @param source The source label (either "fake" or "true") that gets added as a new column.
+ * @param index Word count index that also receives every cleaned article.
  */
-void processCSV(const string &filename, ofstream &outfile, const string &source, bool skipHeader) {
+void processCSV(const string &filename, ofstream &outfile, const string &source, bool skipHeader, WordIndexBuilder &index) {
     ifstream infile(filename); // Open the input CSV file
 
     // Check if the file was opened successfully
@@ -240,6 +655,7 @@ void processCSV(const string &filename, ofstream &outfile, const string &source,
                     << "\"" << subject << "\","
                     << "\"" << date << "\","
                     << "\"" << source << "\"\n";
+            index.addArticle(title, text, subject, date, source == "FAKE" ? 0 : 1);
         }
     }
 
@@ -264,11 +680,21 @@ int main() {
     outfile << "title,text,subject,date,T/F\n";
 
     // Process both CSV files, skipping headers in them
-    processCSV("fake.csv", outfile, "FAKE", true);
-    processCSV("true.csv", outfile, "TRUE", true);
+    WordIndexBuilder index;
+    processCSV("fake.csv", outfile, "FAKE", true, index);
+    processCSV("true.csv", outfile, "TRUE", true, index);
 
     outfile.close(); // Close the output file
     cout << "Cleaning complete: DataCleaned.csv" << endl;
 
+    // Write the word count index for the analyzers, fingerprinted with the
+    // written CSV so they can detect a stale index
+    unsigned long long cleanedSize = 0, cleanedHash = 0;
+    if (hashFile("DataCleaned.csv", cleanedSize, cleanedHash) && index.write("WordIndex.bin", cleanedSize, cleanedHash)) {
+        cout << "Word index complete: WordIndex.bin (" << index.terms() << " terms)" << endl;
+    } else {
+        cerr << "Error writing WordIndex.bin!" << endl;
+    }
+
     return 0;
 }
\ No newline at end of file
@@ -6,8 +6,16 @@
 #include <sstream>
 #include <iomanip>
 #include <chrono>
+#include <cmath>
+#include <cstring>
 #include <functional>   
 #include <utility>     
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <climits>
+#include <cstdio>
 using namespace std;
 using namespace std::chrono;
 // ----------------------------------------------------------------
@@ -27,6 +35,32 @@ struct WordFrequency {
     int count;
 };
 
+// Per-year index built once at load time.
+// order[] is a permutation of article indices sorted (stably) by year, and
+// offsets[] is a CSR table: the articles of year y are
+// order[offsets[y - minYear]] .. order[offsets[y - minYear + 1] - 1].
+struct YearIndex {
+    int minYear = 0;
+    int maxYear = -1;
+    int* order = nullptr;
+    int* offsets = nullptr;
+};
+
+// Sorted date column with a static B+-tree-style block index on top.
+// levels[0] is the sorted key column itself; every level above stores the
+// largest key of each DATE_BLOCK-sized node of the level below, so a lookup
+// touches one cache line per level instead of binary-searching the column.
+const int DATE_BLOCK = 16;      // keys per node (16 ints = one 64-byte cache line)
+const int MAX_DATE_LEVELS = 8;
+struct DateIndex {
+    int count = 0;
+    int* keys = nullptr;        // packed dates (YYYYMMDD), ascending
+    int* order = nullptr;       // article index for each key
+    int levelCount = 0;
+    int* levels[MAX_DATE_LEVELS] = {nullptr};
+    int levelSize[MAX_DATE_LEVELS] = {0};
+};
+
 // Global variable to track recursion depth in Quick Sort
 int recursionDepth = 0;
 
@@ -35,49 +69,81 @@ int recursionDepth = 0;
 // ----------------------------------------------------------------
 template<typename Func, typename... Args>
 long long measureEfficiency(const string& operationName, Func func, Args&&... args) {
-    cout << "Starting " << operationName << endl; // Debug statement
     auto start = high_resolution_clock::now();
     func(forward<Args>(args)...);
     auto end = high_resolution_clock::now();
     auto duration = duration_cast<microseconds>(end - start);
-    cout << "Completed " << operationName << endl; // Debug statement
     return duration.count();
 }
 // ----------------------------------------------------------------
-// loadArticles: Load articles from a CSV file into a dynamic array.
-// Returns the number of articles loaded.
+// Position in the news feed. DataCleaned.csv is only ever appended
+// to, so everything before 'offset' is already in the articles array;
+// a refresh reads from there and adds the new articles to the indexes.
+// The array is allocated once at MAX_ARTICLES entries, so the indexes
+// can keep plain article indices across refreshes.
 // ----------------------------------------------------------------
-int loadArticles(const string &filename, News *&articles) {
-    const int MAX_ARTICLES = 50000;
-    articles = new News[MAX_ARTICLES];
-    int articleCount = 0;
-    
-    ifstream file(filename);
-    if (!file) {
-        cerr << "Error opening file: " << filename << endl;
-        return 0;
-    }
-    
-    // Skip header.
-    string header;
-    getline(file, header);
-    
+const int MAX_ARTICLES = 50000;
+
+struct FeedState {
+    string filename;
+    unsigned long long offset = 0;          // bytes consumed, including the header
+    int rowCount = 0;
+    unsigned long long pendingBytes = 0;    // incomplete record held back by the last load
+};
+
+// ----------------------------------------------------------------
+// loadNewArticles: Append the articles added to the feed since the
+// last call (the whole file on the first call) to the array.
+// DataCleaning ends every record with a newline, so a last record
+// without one, or with a quoted field still open, is still being
+// written: it is held back (see 'pendingBytes') and read again next
+// time. Stops at MAX_ARTICLES.
+// Returns the number of new articles, or -1 if the file is missing or
+// shorter than the offset.
+// ----------------------------------------------------------------
+int loadNewArticles(FeedState &feed, News *articles) {
+    feed.pendingBytes = 0;
+    ifstream file(feed.filename, ios::binary | ios::ate);
+    if (!file)
+        return -1;
+    unsigned long long fileSize = static_cast<unsigned long long>(file.tellg());
+    if (fileSize < feed.offset)
+        return -1;
+    file.seekg(static_cast<streamoff>(feed.offset));
+
+    int articleCount = feed.rowCount;
     string line;
-    while (getline(file, line) && articleCount < MAX_ARTICLES) {
+    while (articleCount < MAX_ARTICLES && getline(file, line)) {
+        unsigned long long recordBytes = line.size() + 1;
+        bool complete = !file.eof();
         // --- Handle multi-line records ---
         int quoteCount = 0;
         for (char c : line)
             if (c == '"') quoteCount++;
-        while ((quoteCount % 2) != 0 && !file.eof()) {
+        while (complete && (quoteCount % 2) != 0) {
             string extra;
-            if (!getline(file, extra))
+            if (!getline(file, extra)) {
+                complete = false;
                 break;
+            }
+            recordBytes += extra.size() + 1;
+            complete = !file.eof();
             line += "\n" + extra;
             quoteCount = 0;
             for (char c : line)
                 if (c == '"') quoteCount++;
         }
-        
+        if (!complete) {
+            feed.pendingBytes = fileSize - feed.offset;
+            break;
+        }
+        unsigned long long start = feed.offset;
+        feed.offset += recordBytes;
+        if (start == 0)
+            continue; // Skip header.
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+
         // --- Parse CSV fields ---
         const int TEMP_FIELD_SIZE = 20;
         string* tempFields = new string[TEMP_FIELD_SIZE];
@@ -144,8 +210,22 @@ int loadArticles(const string &filename, News *&articles) {
         articles[articleCount++] = article;
         delete[] tempFields;
     }
-    file.close();
-    return articleCount;
+    int added = articleCount - feed.rowCount;
+    feed.rowCount = articleCount;
+    return added;
+}
+
+// ----------------------------------------------------------------
+// loadArticles: Load articles from a CSV file into a dynamic array.
+// Returns the number of articles loaded.
+// ----------------------------------------------------------------
+int loadArticles(FeedState &feed, News *&articles) {
+    articles = new News[MAX_ARTICLES];
+    if (loadNewArticles(feed, articles) < 0) {
+        cerr << "Error opening file: " << feed.filename << endl;
+        return 0;
+    }
+    return feed.rowCount;
 }
 
 // ----------------------------------------------------------------
@@ -256,281 +336,3876 @@ void insertionSort(News *articles, int count) {
 }
 
 // ----------------------------------------------------------------
-// Utility Function: Display articles and count totals.
+// internSubject: Id of a subject in a name table, adding it if it is
+// new. The table doubles when it is full, so every distinct subject
+// keeps an id of its own.
 // ----------------------------------------------------------------
-void traverseAndCountArticles(News *articles, int count) {
-    int fakeCount = 0;
-    int trueCount = 0;
-    for (int i = 0; i < count; i++) {
-        cout << "Title: " << articles[i].title << ", Year: " << articles[i].year << endl;
-        if (articles[i].isTrue)
-            trueCount++;
-        else
-            fakeCount++;
+int internSubject(string* &names, int &count, int &capacity, const string &subject) {
+    for (int s = 0; s < count; s++)
+        if (names[s] == subject)
+            return s;
+    if (count == capacity) {
+        int newCapacity = capacity ? capacity * 2 : 16;
+        string* grown = new string[newCapacity];
+        for (int s = 0; s < count; s++)
+            grown[s].swap(names[s]);
+        delete[] names;
+        names = grown;
+        capacity = newCapacity;
     }
-    cout << "Total articles: " << count << endl;
-    cout << "Total FAKE articles: " << fakeCount << endl;
-    cout << "Total TRUE articles: " << trueCount << endl;
+    names[count] = subject;
+    return count++;
 }
 
 // ----------------------------------------------------------------
-// Option 2: Counting Articles
+// Aggregate cube built at load time: article counts by (year, month,
+// subject, label) in one dense array. Its size depends only on the
+// number of distinct years and subjects, so every count below reads a
+// fixed number of cells however many articles were loaded.
+// The last year slot holds articles without a year; month 0 holds
+// articles whose month is unknown.
 // ----------------------------------------------------------------
-void countArticlesRecursive(News *articles, int count, int index, int &fakeCount, int &trueCount) {
-    cout << "Recursive count at index: " << index << endl; // Debug statement
-    if (index >= count) return;
-    if (articles[index].isTrue)
-        trueCount++;
-    else
-        fakeCount++;
-    countArticlesRecursive(articles, count, index + 1, fakeCount, trueCount);
+const int CUBE_MONTHS = 13;         // 0 = unknown, 1..12
+
+// Dimensions for cubeBreakdown
+const int CUBE_BY_YEAR = 0;
+const int CUBE_BY_MONTH = 1;
+const int CUBE_BY_SUBJECT = 2;
+const int CUBE_BY_LABEL = 3;
+
+struct AggregateCube {
+    int total = 0;
+    int minYear = 0;
+    int yearCount = 0;                  // year slots = yearCount + 1
+    int subjectCount = 0;
+    int subjectCapacity = 0;            // subject stride of cells
+    string* subjectNames = nullptr;
+    int* cells = nullptr;               // [((yearSlot * 13 + month) * subjectCapacity + subject) * 2 + label]
+};
+
+// A sub-cube: every field left at its default matches everything.
+struct CubeSlice {
+    string subject;                     // substring of the subject name
+    int label = -1;                     // 0 = FAKE, 1 = TRUE
+    int fromYear = 0, toYear = 0;       // inclusive
+    int fromMonth = 0, toMonth = 0;     // inclusive, 1..12
+};
+
+int cubeCell(const AggregateCube &cube, int yearSlot, int month, int subject, int label) {
+    return ((yearSlot * CUBE_MONTHS + month) * cube.subjectCapacity + subject) * 2 + label;
 }
 
-void countArticlesIterative(News *articles, int count, int &fakeCount, int &trueCount) {
-    fakeCount = 0;
-    trueCount = 0;
-    for (int i = 0; i < count; i++) {
-        if (articles[i].isTrue)
-            trueCount++;
-        else
-            fakeCount++;
+// ----------------------------------------------------------------
+// growCubeYears: Widen the year dimension to include 'year', moving
+// every year slot (and the "no year" slot, which stays last) to its
+// place in the larger array.
+// ----------------------------------------------------------------
+void growCubeYears(AggregateCube &cube, int year) {
+    int lastYear = cube.minYear + cube.yearCount - 1;
+    int minYear = (cube.yearCount == 0 || year < cube.minYear) ? year : cube.minYear;
+    int maxYear = (cube.yearCount == 0 || year > lastYear) ? year : lastYear;
+    int yearCount = maxYear - minYear + 1;
+    int slotSize = CUBE_MONTHS * cube.subjectCapacity * 2;
+    int* cells = new int[(yearCount + 1) * slotSize]();
+    int shift = (cube.yearCount == 0) ? 0 : cube.minYear - minYear;
+    for (int slot = 0; slot <= cube.yearCount; slot++) {
+        int target = (slot == cube.yearCount) ? yearCount : slot + shift;
+        for (int i = 0; i < slotSize; i++)
+            cells[target * slotSize + i] = cube.cells[slot * slotSize + i];
     }
+    delete[] cube.cells;
+    cube.cells = cells;
+    cube.minYear = minYear;
+    cube.yearCount = yearCount;
 }
 
 // ----------------------------------------------------------------
-// Option 3: Searching (using dynamic arrays, no vectors)
+// growCubeSubjects: Widen the subject stride after the name table grew
+// from oldCapacity, moving every (year, month) row of subject cells to
+// its larger row.
 // ----------------------------------------------------------------
-int* linearSearchByYear(News *articles, int count, int targetYear, int &matchCount) {
-    matchCount = 0;
-    for (int i = 0; i < count; i++) {
-        if (articles[i].year == targetYear)
-            matchCount++;
+void growCubeSubjects(AggregateCube &cube, int oldCapacity) {
+    int rows = (cube.yearCount + 1) * CUBE_MONTHS;
+    int* cells = new int[rows * cube.subjectCapacity * 2]();
+    for (int r = 0; r < rows; r++) {
+        for (int i = 0; i < oldCapacity * 2; i++)
+            cells[r * cube.subjectCapacity * 2 + i] = cube.cells[r * oldCapacity * 2 + i];
     }
-    if (matchCount == 0)
-        return nullptr;
-    int* indices = new int[matchCount];
-    int j = 0;
+    delete[] cube.cells;
+    cube.cells = cells;
+}
+
+// ----------------------------------------------------------------
+// addToAggregateCube: Add articles [first, count) to their cells,
+// widening the year and subject dimensions when an article needs it.
+// ----------------------------------------------------------------
+void addToAggregateCube(News *articles, int first, int count, AggregateCube &cube) {
+    for (int i = first; i < count; i++) {
+        int oldCapacity = cube.subjectCapacity;
+        int s = internSubject(cube.subjectNames, cube.subjectCount, cube.subjectCapacity, articles[i].subject);
+        if (cube.subjectCapacity != oldCapacity)
+            growCubeSubjects(cube, oldCapacity);
+
+        int year = articles[i].year;
+        if (year > 0 && (cube.yearCount == 0 || year < cube.minYear || year >= cube.minYear + cube.yearCount))
+            growCubeYears(cube, year);
+        int yearSlot = (year > 0) ? year - cube.minYear : cube.yearCount;
+        // Month from "DD-MM-YYYY"
+        int month = 0;
+        const string &date = articles[i].date;
+        if (date.size() >= 5 && isdigit(static_cast<unsigned char>(date[3])) && isdigit(static_cast<unsigned char>(date[4])))
+            month = (date[3] - '0') * 10 + (date[4] - '0');
+        if (month < 1 || month > 12)
+            month = 0;
+
+        cube.cells[cubeCell(cube, yearSlot, month, s, articles[i].isTrue ? 1 : 0)]++;
+        cube.total++;
+    }
+}
+
+// ----------------------------------------------------------------
+// buildAggregateCube: Size the year and subject dimensions in a first
+// pass, then add every article to its cell.
+// ----------------------------------------------------------------
+void buildAggregateCube(News *articles, int count, AggregateCube &cube) {
+    int maxYear = 0;
+    cube.minYear = 0;
     for (int i = 0; i < count; i++) {
-        if (articles[i].year == targetYear)
-            indices[j++] = i;
+        internSubject(cube.subjectNames, cube.subjectCount, cube.subjectCapacity, articles[i].subject);
+        int year = articles[i].year;
+        if (year <= 0) continue;
+        if (cube.minYear == 0 || year < cube.minYear) cube.minYear = year;
+        if (year > maxYear) maxYear = year;
     }
-    return indices;
+    cube.yearCount = (cube.minYear > 0) ? maxYear - cube.minYear + 1 : 0;
+    cube.cells = new int[(cube.yearCount + 1) * CUBE_MONTHS * cube.subjectCapacity * 2]();
+    addToAggregateCube(articles, 0, count, cube);
 }
 
-int binarySearchByYear(News *articles, int left, int right, int targetYear) {
-    if (left > right)
-        return -1;
-    int mid = left + (right - left) / 2;
-    if (articles[mid].year == targetYear)
-        return mid;
-    else if (articles[mid].year < targetYear)
-        return binarySearchByYear(articles, mid + 1, right, targetYear);
-    else
-        return binarySearchByYear(articles, left, mid - 1, targetYear);
+void freeAggregateCube(AggregateCube &cube) {
+    delete[] cube.cells;
+    delete[] cube.subjectNames;
+    cube = AggregateCube();
 }
 
 // ----------------------------------------------------------------
-// Option 4: Fake Political News Percentage by Month (2016)
+// cubeBreakdown: Totals of a slice along one dimension, written to
+// 'totals' (caller provides cubeDimensionSize entries):
+//   CUBE_BY_YEAR    [year - minYear], last entry = no year
+//   CUBE_BY_MONTH   [month], 0 = unknown
+//   CUBE_BY_SUBJECT [subject id], names in cube.subjectNames
+//   CUBE_BY_LABEL   [0] FAKE, [1] TRUE
 // ----------------------------------------------------------------
-void percentageByMonthLinear(News *articles, int count) {
-    int total[13] = {0};  // months 1..12
-    int fake[13] = {0};
-
-    // Count total/fake for political news in 2016
-    for (int i = 0; i < count; i++) {
-        if (articles[i].year == 2016 && articles[i].subject.find("politics") != string::npos) {
-            string monthStr = articles[i].date.substr(3, 2);
-            int month = stoi(monthStr);
-            total[month]++;
-            if (!articles[i].isTrue)
-                fake[month]++;
-        }
+int cubeDimensionSize(const AggregateCube &cube, int dimension) {
+    switch (dimension) {
+        case CUBE_BY_YEAR: return cube.yearCount + 1;
+        case CUBE_BY_MONTH: return CUBE_MONTHS;
+        case CUBE_BY_SUBJECT: return cube.subjectCount;
+        default: return 2;
     }
+}
 
-    cout << "=== Percentage for Fake Political News by Month (Linear Scan) ===" << endl;
-    for (int m = 1; m <= 12; m++) {
-        if (total[m] > 0) {
-            double percentage = (static_cast<double>(fake[m]) / total[m]) * 100.0;
-            // Number of stars is the integer part of the percentage
-            int starCount = static_cast<int>(percentage);
+void cubeBreakdown(const AggregateCube &cube, const CubeSlice &slice, int dimension, int *totals) {
+    for (int i = 0; i < cubeDimensionSize(cube, dimension); i++)
+        totals[i] = 0;
 
-            cout << "Month " << m << ": ";
-            // Print stars
-            for (int s = 0; s < starCount; s++) {
-                cout << "*";
+    // Year slots in the slice; a year filter never matches the no-year slot.
+    int firstSlot = 0, lastSlot = cube.yearCount;
+    if (slice.fromYear != 0 || slice.toYear != 0) {
+        int fromYear = slice.fromYear != 0 ? slice.fromYear : cube.minYear;
+        int toYear = slice.toYear != 0 ? slice.toYear : cube.minYear + cube.yearCount - 1;
+        firstSlot = max(fromYear - cube.minYear, 0);
+        lastSlot = min(toYear - cube.minYear, cube.yearCount - 1);
+    }
+    int firstMonth = 0, lastMonth = CUBE_MONTHS - 1;
+    if (slice.fromMonth != 0 || slice.toMonth != 0) {
+        firstMonth = max(slice.fromMonth, 1);
+        lastMonth = min(slice.toMonth != 0 ? slice.toMonth : 12, 12);
+    }
+    bool* subjectMatches = new bool[cube.subjectCount > 0 ? cube.subjectCount : 1];
+    for (int s = 0; s < cube.subjectCount; s++)
+        subjectMatches[s] = slice.subject.empty() || cube.subjectNames[s].find(slice.subject) != string::npos;
+    int firstLabel = (slice.label == 1) ? 1 : 0;
+    int lastLabel = (slice.label == 0) ? 0 : 1;
+
+    for (int y = firstSlot; y <= lastSlot; y++) {
+        for (int m = firstMonth; m <= lastMonth; m++) {
+            for (int s = 0; s < cube.subjectCount; s++) {
+                if (!subjectMatches[s]) continue;
+                for (int l = firstLabel; l <= lastLabel; l++) {
+                    int cell = cube.cells[cubeCell(cube, y, m, s, l)];
+                    switch (dimension) {
+                        case CUBE_BY_YEAR: totals[y] += cell; break;
+                        case CUBE_BY_MONTH: totals[m] += cell; break;
+                        case CUBE_BY_SUBJECT: totals[s] += cell; break;
+                        default: totals[l] += cell; break;
+                    }
+                }
             }
-            // Print percentage with 4 decimal places (optional)
-            cout << " " << fixed << setprecision(4) << percentage << "%" << endl;
-        } else {
-            cout << "Month " << m << ": No data" << endl;
         }
     }
+    delete[] subjectMatches;
 }
 
+// ----------------------------------------------------------------
+// cubeCount: Number of articles in a slice.
+// ----------------------------------------------------------------
+int cubeCount(const AggregateCube &cube, const CubeSlice &slice) {
+    int labels[2];
+    cubeBreakdown(cube, slice, CUBE_BY_LABEL, labels);
+    return labels[0] + labels[1];
+}
 
-void percentageByMonthSorting(News *articles, int count) {
-    // Filter political news in 2016
-    int filteredCount = 0;
-    News* filtered = new News[count]; // worst-case size
-    for (int i = 0; i < count; i++) {
-        if (articles[i].year == 2016 && articles[i].subject.find("politics") != string::npos) {
-            filtered[filteredCount++] = articles[i];
+// ----------------------------------------------------------------
+// Utility Function: Display articles; totals come from the cube.
+// ----------------------------------------------------------------
+void traverseAndCountArticles(News *articles, int count, const AggregateCube &cube) {
+    for (int i = 0; i < count; i++)
+        cout << "Title: " << articles[i].title << ", Year: " << articles[i].year << endl;
+    int labels[2];
+    cubeBreakdown(cube, CubeSlice(), CUBE_BY_LABEL, labels);
+    int fakeCount = labels[0];
+    int trueCount = labels[1];
+    cout << "Total articles: " << cube.total << endl;
+    cout << "Total FAKE articles: " << fakeCount << endl;
+    cout << "Total TRUE articles: " << trueCount << endl;
+}
+
+// ----------------------------------------------------------------
+// ThreadPool: Fixed set of worker threads taking tasks from a FIFO
+// queue. A thread that has to wait for a task can call
+// runPendingTask to work on the queue meanwhile, so nested tasks
+// never leave every thread blocked.
+// ----------------------------------------------------------------
+class ThreadPool {
+public:
+    explicit ThreadPool(int threadCount) : workerCount(threadCount > 0 ? threadCount : 0) {
+        workers = new thread[workerCount > 0 ? workerCount : 1];
+        for (int t = 0; t < workerCount; t++)
+            workers[t] = thread([this] { workerLoop(); });
+    }
+
+    ~ThreadPool() {
+        {
+            lock_guard<mutex> lock(queueMutex);
+            stopping = true;
+        }
+        queueReady.notify_all();
+        for (int t = 0; t < workerCount; t++)
+            workers[t].join();
+        delete[] workers;
+        while (head) {
+            Task* next = head->next;
+            delete head;
+            head = next;
         }
     }
 
-    // Helper lambda to extract month from date
-    auto getMonth = [](const News &article) -> int {
-        if (article.date.size() >= 5) {
-            try {
-                return stoi(article.date.substr(3, 2));
-            } catch(...) {
-                return 0;
-            }
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void submit(function<void()> work) {
+        Task* task = new Task{std::move(work), nullptr};
+        {
+            lock_guard<mutex> lock(queueMutex);
+            if (tail) tail->next = task;
+            else head = task;
+            tail = task;
         }
-        return 0;
+        queueReady.notify_one();
+    }
+
+    // Run one queued task on the calling thread; false if the queue is empty.
+    bool runPendingTask() {
+        Task* task = takeTask(false);
+        if (!task)
+            return false;
+        task->work();
+        delete task;
+        return true;
+    }
+
+    int threads() const { return workerCount + 1; }    // workers plus the caller
+
+private:
+    struct Task {
+        function<void()> work;
+        Task* next;
     };
 
-    // Sort by month using a simple bubble sort
-    for (int i = 0; i < filteredCount - 1; i++) {
-        for (int j = 0; j < filteredCount - i - 1; j++) {
-            if (getMonth(filtered[j]) > getMonth(filtered[j+1])) {
-                swap(filtered[j], filtered[j+1]);
-            }
+    thread* workers;
+    int workerCount;
+    Task* head = nullptr;
+    Task* tail = nullptr;
+    bool stopping = false;
+    mutex queueMutex;
+    condition_variable queueReady;
+
+    Task* takeTask(bool wait) {
+        unique_lock<mutex> lock(queueMutex);
+        if (wait)
+            queueReady.wait(lock, [this] { return head || stopping; });
+        Task* task = head;
+        if (task) {
+            head = task->next;
+            if (!head) tail = nullptr;
         }
+        return task;
     }
 
-    cout << "=== Percentage for Fake Political News by Month (Sorting & Grouping) ===" << endl;
+    void workerLoop() {
+        while (Task* task = takeTask(true)) {
+            task->work();
+            delete task;
+        }
+    }
+};
 
-    int i = 0;
-    while (i < filteredCount) {
-        int month = getMonth(filtered[i]);
-        int total = 0;
-        int fakeCount = 0;
+// Grain below which parallelReduce stops splitting and runs a plain loop.
+const int REDUCE_GRAIN = 2048;
 
-        // Count how many articles are in this month
-        while (i < filteredCount && getMonth(filtered[i]) == month) {
-            total++;
-            if (!filtered[i].isTrue)
-                fakeCount++;
-            i++;
+// ----------------------------------------------------------------
+// parallelReduce: combine(map(begin), ..., map(end - 1)) starting from
+// identity. The range is halved recursively: the right half becomes a
+// pool task, the left half runs on the current thread, and the two
+// results are combined. Recursion depth is log2(count / grain).
+// Ranges of at most 'grain' elements run as a plain loop.
+// 'combine' must be associative.
+// ----------------------------------------------------------------
+template <typename T, typename Map, typename Combine>
+T parallelReduce(ThreadPool &pool, int begin, int end, const T &identity, const Map &map, const Combine &combine,
+                 int grain = REDUCE_GRAIN) {
+    if (end - begin <= grain || pool.threads() == 1) {
+        T result = identity;
+        for (int i = begin; i < end; i++)
+            result = combine(result, map(i));
+        return result;
+    }
+    int middle = begin + (end - begin) / 2;
+    T right = identity;
+    atomic<bool> rightDone(false);
+    pool.submit([&] {
+        right = parallelReduce(pool, middle, end, identity, map, combine, grain);
+        rightDone.store(true, memory_order_release);
+    });
+    T left = parallelReduce(pool, begin, middle, identity, map, combine, grain);
+    while (!rightDone.load(memory_order_acquire)) {
+        if (!pool.runPendingTask())
+            this_thread::yield();
+    }
+    return combine(left, right);
+}
+
+// ----------------------------------------------------------------
+// packDate: Convert "DD-MM-YYYY" into a sortable YYYYMMDD integer.
+// Returns 0 for anything that is not a well-formed date.
+// ----------------------------------------------------------------
+int packDate(const string &date) {
+    if (date.size() != 10 || date[2] != '-' || date[5] != '-')
+        return 0;
+    for (int i = 0; i < 10; i++) {
+        if (i != 2 && i != 5 && !isdigit(static_cast<unsigned char>(date[i])))
+            return 0;
+    }
+    int day = (date[0] - '0') * 10 + (date[1] - '0');
+    int month = (date[3] - '0') * 10 + (date[4] - '0');
+    int year = (date[6] - '0') * 1000 + (date[7] - '0') * 100 + (date[8] - '0') * 10 + (date[9] - '0');
+    if (day < 1 || day > 31 || month < 1 || month > 12)
+        return 0;
+    return year * 10000 + month * 100 + day;
+}
+
+// Portable 64-bit population count.
+int popcount64(unsigned long long x) {
+    x = x - ((x >> 1) & 0x5555555555555555ULL);
+    x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+    x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return static_cast<int>((x * 0x0101010101010101ULL) >> 56);
+}
+
+// ----------------------------------------------------------------
+// ArticleTable: Columnar (structure of arrays) copy of the articles
+// for the scans. A scan over year or label reads 2 bytes or 1 bit
+// per article instead of pulling each whole News record (four
+// strings) through the cache. Titles and texts stay in the News
+// array; only the title / text filter steps read them.
+// ----------------------------------------------------------------
+struct ArticleTable {
+    int rowCount = 0;
+    int rowCapacity = 0;
+    short* year = nullptr;                  // 0 = unknown
+    int* date = nullptr;                    // packed YYYYMMDD, 0 = invalid
+    unsigned long long* fakeBits = nullptr; // bit i set = article i is FAKE
+    unsigned short* subjectId = nullptr;    // two bytes: at most 50000 articles are loaded
+    int subjectCount = 0;
+    int subjectCapacity = 0;
+    string* subjectNames = nullptr;
+};
+
+// Append articles [first, count) to the columns, doubling their
+// capacity when they are full.
+void addToArticleTable(News *articles, int first, int count, ArticleTable &table) {
+    if (count > table.rowCapacity || !table.year) {
+        int capacity = table.rowCapacity * 2 > count ? table.rowCapacity * 2 : count;
+        if (capacity < 1)
+            capacity = 1;
+        short* year = new short[capacity];
+        int* date = new int[capacity];
+        unsigned long long* fakeBits = new unsigned long long[(capacity + 63) / 64 + 1]();
+        unsigned short* subjectId = new unsigned short[capacity];
+        for (int i = 0; i < table.rowCount; i++) {
+            year[i] = table.year[i];
+            date[i] = table.date[i];
+            subjectId[i] = table.subjectId[i];
         }
+        for (int w = 0; w < (table.rowCount + 63) / 64; w++)
+            fakeBits[w] = table.fakeBits[w];
+        delete[] table.year;
+        delete[] table.date;
+        delete[] table.fakeBits;
+        delete[] table.subjectId;
+        table.year = year;
+        table.date = date;
+        table.fakeBits = fakeBits;
+        table.subjectId = subjectId;
+        table.rowCapacity = capacity;
+    }
+    for (int i = first; i < count; i++) {
+        table.year[i] = static_cast<short>(articles[i].year);
+        table.date[i] = packDate(articles[i].date);
+        if (!articles[i].isTrue)
+            table.fakeBits[i >> 6] |= 1ULL << (i & 63);
+        int s = internSubject(table.subjectNames, table.subjectCount, table.subjectCapacity, articles[i].subject);
+        table.subjectId[i] = static_cast<unsigned short>(s);
+    }
+    table.rowCount = count;
+}
+
+void buildArticleTable(News *articles, int count, ArticleTable &table) {
+    addToArticleTable(articles, 0, count, table);
+}
+
+void freeArticleTable(ArticleTable &table) {
+    delete[] table.year;
+    delete[] table.date;
+    delete[] table.fakeBits;
+    delete[] table.subjectId;
+    delete[] table.subjectNames;
+    table = ArticleTable();
+}
+
+// ----------------------------------------------------------------
+// Option 2: Counting Articles
+// ----------------------------------------------------------------
+// Baseline for countArticlesCube: fake/true totals from the label
+// bit-vector, 64 articles per popcount.
+void countArticlesIterative(const ArticleTable &table, int &fakeCount, int &trueCount) {
+    int words = (table.rowCount + 63) / 64;
+    fakeCount = 0;
+    for (int w = 0; w < words; w++)
+        fakeCount += popcount64(table.fakeBits[w]);
+    trueCount = table.rowCount - fakeCount;
+}
+
+void countArticlesCube(const AggregateCube &cube, int &fakeCount, int &trueCount) {
+    int labels[2];
+    cubeBreakdown(cube, CubeSlice(), CUBE_BY_LABEL, labels);
+    fakeCount = labels[0];
+    trueCount = labels[1];
+}
+
+// ----------------------------------------------------------------
+// Option 3: Searching (using dynamic arrays, no vectors)
+// ----------------------------------------------------------------
+// Both passes over the year column are branch-free: the first sums
+// the comparisons, the second writes every row id and only advances
+// past the matches.
+int* linearSearchByYear(const ArticleTable &table, int targetYear, int &matchCount) {
+    const short* year = table.year;
+    const short target = static_cast<short>(targetYear);
+    int n = table.rowCount;
+    int matches = 0;
+    for (int i = 0; i < n; i++)
+        matches += (year[i] == target);
+    matchCount = matches;
+    if (matches == 0)
+        return nullptr;
+    int* indices = new int[matches + 1];    // one spare slot for the unconditional store
+    int j = 0;
+    for (int i = 0; i < n; i++) {
+        indices[j] = i;
+        j += (year[i] == target);
+    }
+    return indices;
+}
+
+// ----------------------------------------------------------------
+// addToYearIndex: Add articles [first, count) to the year index. The
+// old slot sizes plus a histogram of the new articles give the new
+// offsets; each year's old slice is copied across and its new
+// articles appended after it, so load order is kept within a year.
+// O(articles + years) per call, with no sort.
+// ----------------------------------------------------------------
+void addToYearIndex(News *articles, int first, int count, YearIndex &index) {
+    if (count <= first)
+        return;
+    int minYear = index.offsets ? index.minYear : articles[first].year;
+    int maxYear = index.offsets ? index.maxYear : articles[first].year;
+    for (int i = first; i < count; i++) {
+        if (articles[i].year < minYear) minYear = articles[i].year;
+        if (articles[i].year > maxYear) maxYear = articles[i].year;
+    }
 
-        double percentage = (static_cast<double>(fakeCount) / total) * 100.0;
-        int starCount = static_cast<int>(percentage);
+    // Histogram (old slot sizes, then the new articles), then exclusive prefix sum into offsets
+    int yearSpan = maxYear - minYear + 1;
+    int* offsets = new int[yearSpan + 1]();
+    if (index.offsets) {
+        for (int y = index.minYear; y <= index.maxYear; y++)
+            offsets[y - minYear + 1] = index.offsets[y - index.minYear + 1] - index.offsets[y - index.minYear];
+    }
+    for (int i = first; i < count; i++)
+        offsets[articles[i].year - minYear + 1]++;
+    for (int y = 0; y < yearSpan; y++)
+        offsets[y + 1] += offsets[y];
 
-        cout << "Month " << month << ": ";
-        // Print stars
-        for (int s = 0; s < starCount; s++) {
-            cout << "*";
+    // Copy every old slice to the start of its slot, then scatter the new indices after it
+    int* order = new int[count];
+    int* cursor = new int[yearSpan];
+    for (int y = 0; y < yearSpan; y++)
+        cursor[y] = offsets[y];
+    if (index.offsets) {
+        for (int y = index.minYear; y <= index.maxYear; y++) {
+            for (int k = index.offsets[y - index.minYear]; k < index.offsets[y - index.minYear + 1]; k++)
+                order[cursor[y - minYear]++] = index.order[k];
         }
-        // Print percentage
-        cout << " " << fixed << setprecision(4) << percentage << "%" << endl;
     }
-    delete[] filtered;
+    for (int i = first; i < count; i++)
+        order[cursor[articles[i].year - minYear]++] = i;
+    delete[] cursor;
+
+    delete[] index.order;
+    delete[] index.offsets;
+    index.order = order;
+    index.offsets = offsets;
+    index.minYear = minYear;
+    index.maxYear = maxYear;
 }
 
+// ----------------------------------------------------------------
+// buildYearIndex: Counting sort of article indices by year.
+// Two passes over the array at load time; every later lookup is O(1).
+// ----------------------------------------------------------------
+void buildYearIndex(News *articles, int count, YearIndex &index) {
+    addToYearIndex(articles, 0, count, index);
+}
 
 // ----------------------------------------------------------------
-// Main Menu Loop
+// lookupYear: O(1) range lookup in the year index.
+// Sets [begin, end) to the slice of index.order for targetYear and
+// returns the number of matches.
 // ----------------------------------------------------------------
-int main() {
-    News* articles = nullptr;
-    int count = loadArticles("DataCleaned.csv", articles);
-    if (count == 0) {
-        cerr << "No articles loaded." << endl;
-        return 1;
+int lookupYear(const YearIndex &index, int targetYear, int &begin, int &end) {
+    begin = end = 0;
+    if (!index.offsets || targetYear < index.minYear || targetYear > index.maxYear)
+        return 0;
+    begin = index.offsets[targetYear - index.minYear];
+    end = index.offsets[targetYear - index.minYear + 1];
+    return end - begin;
+}
+
+void freeYearIndex(YearIndex &index) {
+    delete[] index.order;
+    delete[] index.offsets;
+    index.order = nullptr;
+    index.offsets = nullptr;
+}
+
+// ----------------------------------------------------------------
+// radixSortDates: Stable LSD radix sort of packed dates and the
+// article index that goes with each. Packed dates fit in 27 bits:
+// three 9-bit counting-sort passes.
+// ----------------------------------------------------------------
+void radixSortDates(int *&keys, int *&order, int count) {
+    const int RADIX_BITS = 9;
+    const int BUCKETS = 1 << RADIX_BITS;
+    int* tmpKeys = new int[count > 0 ? count : 1];
+    int* tmpOrder = new int[count > 0 ? count : 1];
+    int* bucket = new int[BUCKETS];
+    for (int shift = 0; shift < 27; shift += RADIX_BITS) {
+        for (int b = 0; b < BUCKETS; b++)
+            bucket[b] = 0;
+        for (int i = 0; i < count; i++)
+            bucket[(keys[i] >> shift) & (BUCKETS - 1)]++;
+        int sum = 0;
+        for (int b = 0; b < BUCKETS; b++) {
+            int c = bucket[b];
+            bucket[b] = sum;
+            sum += c;
+        }
+        for (int i = 0; i < count; i++) {
+            int pos = bucket[(keys[i] >> shift) & (BUCKETS - 1)]++;
+            tmpKeys[pos] = keys[i];
+            tmpOrder[pos] = order[i];
+        }
+        int* swapKeys = keys;
+        keys = tmpKeys;
+        tmpKeys = swapKeys;
+        int* swapOrder = order;
+        order = tmpOrder;
+        tmpOrder = swapOrder;
     }
-    
-    int mainChoice = 0;
-    do {
-        cout << "\n==================== MAIN MENU ====================" << endl;
-        cout << "1. Sort the news articles by year" << endl;
-        cout << "2. Calculate total articles (fake and true)" << endl;
-        cout << "3. Search article by year" << endl;
-        cout << "4. Display percentage for fake political news by month in 2016" << endl;
-        cout << "5. Exit" << endl;
-        cout << "Enter your option: ";
-        cin >> mainChoice;
-        
-        if (mainChoice == 1) {
-            int sortChoice = 0;
-            cout << "\n--- Choose Sorting Algorithm ---" << endl;
-            cout << "1. Merge Sort" << endl;
-            cout << "2. Quick Sort" << endl;
-            cout << "3. Insertion Sort" << endl;
-            cout << "Enter your choice: ";
-            cin >> sortChoice;
-            
-            // Create a temporary copy for sorting
-            News *articlesCopy = new News[count];
-            for (int i = 0; i < count; i++)
-                articlesCopy[i] = articles[i];
-            long long timeTaken = 0;
-            size_t memoryUsed = count * sizeof(News);
-            
-            switch (sortChoice) {
-                case 1:
-                    timeTaken = measureEfficiency("Merge Sort", mergeSort, articlesCopy, 0, count - 1);
-                    cout << "\n=== Sorted Articles using Merge Sort ===" << endl;
-                    break;
-                case 2:
-                    recursionDepth = 0; // reset recursion depth
-                    timeTaken = measureEfficiency("Quick Sort", quickSort, articlesCopy, 0, count - 1);
-                    cout << "\n=== Sorted Articles using Quick Sort ===" << endl;
-                    cout << "Quick Sort Recursion Depth: " << recursionDepth << endl;
-                    break;
-                case 3:
-                    timeTaken = measureEfficiency("Insertion Sort", insertionSort, articlesCopy, count);
-                    cout << "\n=== Sorted Articles using Insertion Sort ===" << endl;
-                    break;
-                default:
-                    cout << "Invalid sorting option." << endl;
-                    delete[] articlesCopy;
-                    continue;
-            }
-            
-            traverseAndCountArticles(articlesCopy, count);
-            cout << "Time Taken: " << timeTaken << " µs" << endl;
-            cout << "Memory Used: " << memoryUsed << " bytes" << endl;
-            delete[] articlesCopy;
-            
+    delete[] tmpKeys;
+    delete[] tmpOrder;
+    delete[] bucket;
+}
 
-        } else if (mainChoice == 2) {
-            cout << "Starting option 2..." << endl;
-        
-            int fakeCountRec = 0, trueCountRec = 0;
-            cout << "Before Recursive Count" << endl;
-            long long timeRec = measureEfficiency("Recursive Count", countArticlesIterative, articles, count, 
-                                                    std::ref(fakeCountRec), std::ref(trueCountRec));
-            cout << "After Recursive Count" << endl;
-            cout << "Recursive count completed." << endl;
-        
-            int fakeCountIter = 0, trueCountIter = 0;
-            cout << "Before Iterative Count" << endl;
-            long long timeIter = measureEfficiency("Iterative Count", countArticlesIterative, articles, count, 
-                                                     std::ref(fakeCountIter), std::ref(trueCountIter));
-            cout << "After Iterative Count" << endl;
-            cout << "Iterative count completed." << endl;
-        
-            cout << "\n=== Total Articles Count ===" << endl;
-            cout << "Recursive Count: Total Articles: " << count 
-                 << ", TRUE: " << trueCountRec << ", FAKE: " << fakeCountRec 
-                 << ", Time: " << timeRec << " µs" << endl;
-            cout << "Iterative Count: Total Articles: " << count 
-                 << ", TRUE: " << trueCountIter << ", FAKE: " << fakeCountIter 
-                 << ", Time: " << timeIter << " µs" << endl;
-            
-            
-        } else if (mainChoice == 3) {
-            int targetYear;
-            cout << "Enter the year to search for: ";
+// ----------------------------------------------------------------
+// buildDateLevels: (Re)build the block index levels above the sorted
+// key column.
+// ----------------------------------------------------------------
+void buildDateLevels(DateIndex &index) {
+    for (int l = 1; l < index.levelCount; l++)
+        delete[] index.levels[l];
+    // Level 0 is the key column; each level above keeps the max key of every node below.
+    index.levels[0] = index.keys;
+    index.levelSize[0] = index.count;
+    index.levelCount = 1;
+    while (index.levelSize[index.levelCount - 1] > DATE_BLOCK && index.levelCount < MAX_DATE_LEVELS) {
+        int below = index.levelCount - 1;
+        int size = (index.levelSize[below] + DATE_BLOCK - 1) / DATE_BLOCK;
+        int* level = new int[size];
+        for (int i = 0; i < size; i++) {
+            int last = (i + 1) * DATE_BLOCK;
+            if (last > index.levelSize[below])
+                last = index.levelSize[below];
+            level[i] = index.levels[below][last - 1];
+        }
+        index.levels[index.levelCount] = level;
+        index.levelSize[index.levelCount] = size;
+        index.levelCount++;
+    }
+}
+
+// ----------------------------------------------------------------
+// addToDateIndex: Add articles [first, count) to the date index. Only
+// the new dates are radix sorted; they are then merged into the sorted
+// column (old keys first on ties, so equal dates stay in load order)
+// and the block levels are rebuilt.
+// ----------------------------------------------------------------
+void addToDateIndex(News *articles, int first, int count, DateIndex &index) {
+    int added = count - first;
+    if (added <= 0 && index.keys)
+        return;
+    if (added < 0)
+        added = 0;
+    int* newKeys = new int[added > 0 ? added : 1];
+    int* newOrder = new int[added > 0 ? added : 1];
+    for (int i = 0; i < added; i++) {
+        newKeys[i] = packDate(articles[first + i].date);
+        newOrder[i] = first + i;
+    }
+    radixSortDates(newKeys, newOrder, added);
+
+    int total = index.count + added;
+    int* keys = new int[total > 0 ? total : 1];
+    int* order = new int[total > 0 ? total : 1];
+    int a = 0, b = 0, out = 0;
+    while (a < index.count && b < added) {
+        if (newKeys[b] < index.keys[a]) {
+            keys[out] = newKeys[b];
+            order[out++] = newOrder[b++];
+        } else {
+            keys[out] = index.keys[a];
+            order[out++] = index.order[a++];
+        }
+    }
+    for (; a < index.count; a++, out++) {
+        keys[out] = index.keys[a];
+        order[out] = index.order[a];
+    }
+    for (; b < added; b++, out++) {
+        keys[out] = newKeys[b];
+        order[out] = newOrder[b];
+    }
+    delete[] newKeys;
+    delete[] newOrder;
+    delete[] index.keys;
+    delete[] index.order;
+    index.keys = keys;
+    index.order = order;
+    index.count = total;
+    buildDateLevels(index);
+}
+
+// ----------------------------------------------------------------
+// buildDateIndex: Sort the packed dates (LSD radix sort, stable) and
+// build the block index levels above the sorted column.
+// ----------------------------------------------------------------
+void buildDateIndex(News *articles, int count, DateIndex &index) {
+    addToDateIndex(articles, 0, count, index);
+}
+
+// ----------------------------------------------------------------
+// dateBound: Position of the first key >= key (lower bound) or, with
+// upper = true, the first key > key (upper bound). Descends the block
+// index from the top level, scanning one node per level.
+// ----------------------------------------------------------------
+int dateBound(const DateIndex &index, int key, bool upper) {
+    if (index.count == 0)
+        return 0;
+    int node = 0;
+    for (int l = index.levelCount - 1; l >= 0; l--) {
+        int pos = node * DATE_BLOCK;
+        int last = pos + DATE_BLOCK;
+        if (last > index.levelSize[l])
+            last = index.levelSize[l];
+        while (pos < last && (upper ? index.levels[l][pos] <= key : index.levels[l][pos] < key))
+            pos++;
+        if (pos == last)
+            return index.count; // every key is on the left of the bound
+        node = pos;
+    }
+    return node;
+}
+
+// ----------------------------------------------------------------
+// queryDateRange: All articles dated within [from, to] (packed dates),
+// optionally restricted to subjects containing 'subject' and to a
+// label ("FAKE" or "TRUE"). Empty filters match everything.
+// Returns a new array of article indices in date order (caller must
+// delete[] it), or nullptr when nothing matches.
+// ----------------------------------------------------------------
+int* queryDateRange(News *articles, const DateIndex &index, int from, int to,
+                    const string &subject, const string &label, int &matchCount) {
+    matchCount = 0;
+    if (from <= 0 || to < from)
+        return nullptr;
+    int begin = dateBound(index, from, false);
+    int end = dateBound(index, to, true);
+    if (begin >= end)
+        return nullptr;
+
+    int* indices = new int[end - begin];
+    for (int i = begin; i < end; i++) {
+        const News &article = articles[index.order[i]];
+        if (!subject.empty() && article.subject.find(subject) == string::npos)
+            continue;
+        if (label == "FAKE" && article.isTrue)
+            continue;
+        if (label == "TRUE" && !article.isTrue)
+            continue;
+        indices[matchCount++] = index.order[i];
+    }
+    if (matchCount == 0) {
+        delete[] indices;
+        return nullptr;
+    }
+    return indices;
+}
+
+void freeDateIndex(DateIndex &index) {
+    // levels[0] aliases keys
+    for (int l = 1; l < index.levelCount; l++)
+        delete[] index.levels[l];
+    delete[] index.keys;
+    delete[] index.order;
+    index.keys = nullptr;
+    index.order = nullptr;
+    index.levelCount = 0;
+}
+
+// ----------------------------------------------------------------
+// forEachToken: The tokenizer shared by the inverted index, the
+// queries run against it and the watchlist. A token is a run of
+// letters and digits, lowercased; every other byte ends the token.
+// This differs on purpose from ArrayAlgorithm, linked_list_doc and
+// DataCleaning, which split only on whitespace and drop punctuation
+// ("don't" -> "dont") to match WordIndex.bin: here "don't" gives
+// "don" and "t", so a query phrase matches however it is punctuated.
+// The text is read 8 bytes at a time into a 64-bit word and
+// classified with SWAR arithmetic: each class test sets the top bit
+// of every byte in the class, and adding the uppercase mask shifted
+// down to 0x20 lowercases A-Z in the register. A block of 8 letters
+// and digits is appended whole; other blocks are walked byte by byte.
+// The callback gets a reused buffer, so it must copy the token if it
+// keeps it.
+// ----------------------------------------------------------------
+const unsigned long long SWAR_ONES = 0x0101010101010101ULL;
+const unsigned long long SWAR_HIGH_BITS = 0x8080808080808080ULL;
+const unsigned long long SWAR_LOW_BITS = 0x7F7F7F7F7F7F7F7FULL;
+
+// Top bit of each byte of word that lies in [lo, hi]; lo and hi below 0x80.
+// Both sums stay inside their byte, so no carry crosses into the next one.
+inline unsigned long long swarInRange(unsigned long long word, unsigned char lo, unsigned char hi) {
+    unsigned long long low = word & SWAR_LOW_BITS;
+    unsigned long long atLeastLo = low + SWAR_ONES * (0x80 - lo);
+    unsigned long long atMostHi = SWAR_ONES * (0x80 + hi) - low;
+    return atLeastLo & atMostHi & ~word & SWAR_HIGH_BITS;
+}
+
+template<typename Callback>
+void forEachToken(const string &text, Callback onToken) {
+    string token;
+    for (size_t i = 0; i < text.size(); i += 8) {
+        size_t blockSize = text.size() - i < 8 ? text.size() - i : 8;
+        unsigned long long word = 0;                    // A short last block is zero padded
+        memcpy(&word, text.data() + i, blockSize);
+        unsigned long long upper = swarInRange(word, 'A', 'Z');
+        unsigned long long alnum = upper | swarInRange(word, 'a', 'z') | swarInRange(word, '0', '9');
+        word += upper >> 2;                             // 0x80 >> 2 == 'a' - 'A'
+        char bytes[8];
+        memcpy(bytes, &word, 8);
+        if (alnum == SWAR_HIGH_BITS) {
+            token.append(bytes, 8);
+            continue;
+        }
+        unsigned char alnumBytes[8];
+        memcpy(alnumBytes, &alnum, 8);
+        for (size_t j = 0; j < blockSize; j++) {
+            if (alnumBytes[j]) {
+                token.push_back(bytes[j]);
+            } else if (!token.empty()) {
+                onToken(token);
+                token.clear();
+            }
+        }
+    }
+    if (!token.empty())
+        onToken(token);
+}
+
+// ----------------------------------------------------------------
+// Inverted index: full-text search over title + text.
+// Each token maps to a posting list of (article delta, term frequency)
+// pairs, varint encoded, appended in article order in a single pass.
+// ----------------------------------------------------------------
+struct PostingList {
+    unsigned char* bytes = nullptr; // varint-encoded (doc delta, tf) pairs
+    int size = 0;
+    int capacity = 0;
+    int docFreq = 0;                // number of articles containing the term
+    int lastDoc = -1;               // last article written (delta base)
+    int pendingDoc = -1;            // article currently being counted
+    int pendingTf = 0;              // occurrences in pendingDoc so far
+};
+
+struct InvertedIndex {
+    int termCount = 0;
+    int termCapacity = 0;
+    string* terms = nullptr;            // term id -> token
+    PostingList* postings = nullptr;    // term id -> posting list
+    int* slots = nullptr;               // open-addressing table of term id + 1 (0 = empty)
+    int slotCapacity = 0;               // power of two
+    int docCount = 0;
+    int docCapacity = 0;
+    int* docLength = nullptr;           // tokens per article
+    long long totalLength = 0;
+    double avgDocLength = 0;
+    size_t compressedBytes = 0;
+};
+
+// FNV-1a hash of a token.
+unsigned int hashToken(const string &token) {
+    unsigned int h = 2166136261u;
+    for (unsigned char c : token) {
+        h ^= c;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+// Find the term id of a token, or -1 if it was never indexed.
+int findTerm(const InvertedIndex &index, const string &token) {
+    if (index.slotCapacity == 0)
+        return -1;
+    unsigned int mask = index.slotCapacity - 1;
+    for (unsigned int slot = hashToken(token) & mask; index.slots[slot] != 0; slot = (slot + 1) & mask) {
+        if (index.terms[index.slots[slot] - 1] == token)
+            return index.slots[slot] - 1;
+    }
+    return -1;
+}
+
+// Find the term id of a token, adding it to the dictionary if needed.
+int findOrAddTerm(InvertedIndex &index, const string &token) {
+    // Keep the table at most half full.
+    if ((index.termCount + 1) * 2 > index.slotCapacity) {
+        int newCapacity = index.slotCapacity ? index.slotCapacity * 2 : 1024;
+        int* newSlots = new int[newCapacity]();
+        for (int t = 0; t < index.termCount; t++) {
+            unsigned int slot = hashToken(index.terms[t]) & (newCapacity - 1);
+            while (newSlots[slot] != 0)
+                slot = (slot + 1) & (newCapacity - 1);
+            newSlots[slot] = t + 1;
+        }
+        delete[] index.slots;
+        index.slots = newSlots;
+        index.slotCapacity = newCapacity;
+    }
+
+    unsigned int mask = index.slotCapacity - 1;
+    unsigned int slot = hashToken(token) & mask;
+    while (index.slots[slot] != 0) {
+        if (index.terms[index.slots[slot] - 1] == token)
+            return index.slots[slot] - 1;
+        slot = (slot + 1) & mask;
+    }
+
+    if (index.termCount == index.termCapacity) {
+        int newCapacity = index.termCapacity ? index.termCapacity * 2 : 1024;
+        string* newTerms = new string[newCapacity];
+        PostingList* newPostings = new PostingList[newCapacity];
+        for (int t = 0; t < index.termCount; t++) {
+            newTerms[t].swap(index.terms[t]);
+            newPostings[t] = index.postings[t];
+        }
+        delete[] index.terms;
+        delete[] index.postings;
+        index.terms = newTerms;
+        index.postings = newPostings;
+        index.termCapacity = newCapacity;
+    }
+    index.terms[index.termCount] = token;
+    index.slots[slot] = index.termCount + 1;
+    return index.termCount++;
+}
+
+// Append one varint (7 bits per byte, high bit = more bytes follow).
+void appendVarint(PostingList &list, unsigned int value) {
+    if (list.size + 5 > list.capacity) {
+        int newCapacity = list.capacity ? list.capacity * 2 : 16;
+        unsigned char* newBytes = new unsigned char[newCapacity];
+        for (int i = 0; i < list.size; i++)
+            newBytes[i] = list.bytes[i];
+        delete[] list.bytes;
+        list.bytes = newBytes;
+        list.capacity = newCapacity;
+    }
+    while (value >= 0x80) {
+        list.bytes[list.size++] = static_cast<unsigned char>(value | 0x80);
+        value >>= 7;
+    }
+    list.bytes[list.size++] = static_cast<unsigned char>(value);
+}
+
+unsigned int readVarint(const unsigned char* bytes, int &pos) {
+    unsigned int value = 0;
+    int shift = 0;
+    while (bytes[pos] & 0x80) {
+        value |= static_cast<unsigned int>(bytes[pos++] & 0x7F) << shift;
+        shift += 7;
+    }
+    value |= static_cast<unsigned int>(bytes[pos++]) << shift;
+    return value;
+}
+
+// ----------------------------------------------------------------
+// addToInvertedIndex: One pass over articles [first, count). Tokens
+// come from forEachToken over the title and text. Term
+// frequencies are accumulated per article and flushed to the posting
+// lists when the article ends, so every list stays sorted by article;
+// new articles always have higher ids, so a refresh just continues
+// each list's deltas.
+// ----------------------------------------------------------------
+void addToInvertedIndex(News *articles, int first, int count, InvertedIndex &index) {
+    if (count > index.docCapacity) {
+        int capacity = index.docCapacity * 2 > count ? index.docCapacity * 2 : count;
+        int* docLength = new int[capacity]();
+        for (int d = 0; d < index.docCount; d++)
+            docLength[d] = index.docLength[d];
+        delete[] index.docLength;
+        index.docLength = docLength;
+        index.docCapacity = capacity;
+    }
+    int touchedCapacity = 1024;
+    int* touched = new int[touchedCapacity];
+
+    for (int doc = first; doc < count; doc++) {
+        int touchedCount = 0;
+        auto addToken = [&](const string &token) {
+            int term = findOrAddTerm(index, token);
+            PostingList &list = index.postings[term];
+            if (list.pendingDoc != doc) {
+                list.pendingDoc = doc;
+                list.pendingTf = 0;
+                if (touchedCount == touchedCapacity) {
+                    int* grown = new int[touchedCapacity * 2];
+                    for (int t = 0; t < touchedCount; t++)
+                        grown[t] = touched[t];
+                    delete[] touched;
+                    touched = grown;
+                    touchedCapacity *= 2;
+                }
+                touched[touchedCount++] = term;
+            }
+            list.pendingTf++;
+            index.docLength[doc]++;
+        };
+        forEachToken(articles[doc].title, addToken);
+        forEachToken(articles[doc].text, addToken);
+        // Flush this article's term frequencies.
+        for (int t = 0; t < touchedCount; t++) {
+            PostingList &list = index.postings[touched[t]];
+            appendVarint(list, static_cast<unsigned int>(doc - list.lastDoc));
+            appendVarint(list, static_cast<unsigned int>(list.pendingTf));
+            list.lastDoc = doc;
+            list.docFreq++;
+        }
+        index.totalLength += index.docLength[doc];
+    }
+    delete[] touched;
+
+    index.docCount = count;
+    index.avgDocLength = count > 0 ? static_cast<double>(index.totalLength) / count : 0;
+    index.compressedBytes = 0;
+    for (int t = 0; t < index.termCount; t++)
+        index.compressedBytes += index.postings[t].size;
+}
+
+void buildInvertedIndex(News *articles, int count, InvertedIndex &index) {
+    addToInvertedIndex(articles, 0, count, index);
+}
+
+// ----------------------------------------------------------------
+// decodePostings: Expand a term's posting list into article ids
+// (ascending) and, if tfs is not null, term frequencies.
+// Returns a new array of docFreq article ids (caller must delete[]).
+// ----------------------------------------------------------------
+int* decodePostings(const PostingList &list, int* tfs) {
+    int* docs = new int[list.docFreq > 0 ? list.docFreq : 1];
+    int pos = 0;
+    int doc = -1;
+    for (int i = 0; i < list.docFreq; i++) {
+        doc += static_cast<int>(readVarint(list.bytes, pos));
+        docs[i] = doc;
+        int tf = static_cast<int>(readVarint(list.bytes, pos));
+        if (tfs)
+            tfs[i] = tf;
+    }
+    return docs;
+}
+
+// ----------------------------------------------------------------
+// Sorted article-id set operations used by the boolean search.
+// Each returns a new array (caller must delete[]).
+// ----------------------------------------------------------------
+int* intersectDocs(const int* a, int aCount, const int* b, int bCount, int &resultCount) {
+    int* result = new int[(aCount < bCount ? aCount : bCount) + 1];
+    resultCount = 0;
+    int i = 0, j = 0;
+    while (i < aCount && j < bCount) {
+        if (a[i] < b[j]) i++;
+        else if (a[i] > b[j]) j++;
+        else { result[resultCount++] = a[i]; i++; j++; }
+    }
+    return result;
+}
+
+int* uniteDocs(const int* a, int aCount, const int* b, int bCount, int &resultCount) {
+    int* result = new int[aCount + bCount + 1];
+    resultCount = 0;
+    int i = 0, j = 0;
+    while (i < aCount || j < bCount) {
+        if (j >= bCount || (i < aCount && a[i] < b[j])) result[resultCount++] = a[i++];
+        else if (i >= aCount || b[j] < a[i]) result[resultCount++] = b[j++];
+        else { result[resultCount++] = a[i]; i++; j++; }
+    }
+    return result;
+}
+
+int* subtractDocs(const int* a, int aCount, const int* b, int bCount, int &resultCount) {
+    int* result = new int[aCount + 1];
+    resultCount = 0;
+    int j = 0;
+    for (int i = 0; i < aCount; i++) {
+        while (j < bCount && b[j] < a[i]) j++;
+        if (j >= bCount || b[j] != a[i]) result[resultCount++] = a[i];
+    }
+    return result;
+}
+
+// ----------------------------------------------------------------
+// queryWordDocs: Articles containing a query word. The word goes
+// through forEachToken like the indexed text, so "don't", "well-known"
+// and "u.s." become the tokens "don" "t", "well" "known" and "u" "s",
+// and an article must contain all of them.
+// Returns a new array of article ids (caller must delete[]), or
+// nullptr if the word has no letters or digits.
+// ----------------------------------------------------------------
+int* queryWordDocs(const InvertedIndex &index, const string &word, int &docCount) {
+    int* docs = nullptr;
+    docCount = 0;
+    forEachToken(word, [&](const string &token) {
+        int termId = findTerm(index, token);
+        int tokenCount = termId >= 0 ? index.postings[termId].docFreq : 0;
+        int* tokenDocs = termId >= 0 ? decodePostings(index.postings[termId], nullptr) : new int[1];
+        if (!docs) {
+            docs = tokenDocs;
+            docCount = tokenCount;
+            return;
+        }
+        int combinedCount;
+        int* combined = intersectDocs(docs, docCount, tokenDocs, tokenCount, combinedCount);
+        delete[] docs;
+        delete[] tokenDocs;
+        docs = combined;
+        docCount = combinedCount;
+    });
+    return docs;
+}
+
+// ----------------------------------------------------------------
+// searchBoolean: Evaluate a query such as "trump AND wall NOT mexico"
+// or "clinton OR obama" left to right. Adjacent terms default to AND,
+// and NOT negates the term that follows it.
+// Returns a new array of matching article ids (caller must delete[]).
+// ----------------------------------------------------------------
+int* searchBoolean(const InvertedIndex &index, const string &query, int &matchCount) {
+    stringstream ss(query);
+    string word;
+    int* result = nullptr;
+    matchCount = 0;
+    bool first = true;
+    bool useOr = false;
+    bool negate = false;
+
+    // All article ids, used when a NOT has nothing on its left
+    int* allDocs = new int[index.docCount + 1];
+    for (int d = 0; d < index.docCount; d++)
+        allDocs[d] = d;
+
+    while (ss >> word) {
+        if (word == "AND") { useOr = false; continue; }
+        if (word == "OR") { useOr = true; continue; }
+        if (word == "NOT") { negate = !negate; continue; }
+
+        int docCount;
+        int* docs = queryWordDocs(index, word, docCount);
+        if (!docs)
+            continue;
+
+        if (negate) {
+            int complementCount;
+            int* complement = subtractDocs(allDocs, index.docCount, docs, docCount, complementCount);
+            delete[] docs;
+            docs = complement;
+            docCount = complementCount;
+        }
+
+        if (first) {
+            result = docs;
+            matchCount = docCount;
+            first = false;
+        } else {
+            int combinedCount;
+            int* combined = useOr ? uniteDocs(result, matchCount, docs, docCount, combinedCount)
+                                  : intersectDocs(result, matchCount, docs, docCount, combinedCount);
+            delete[] result;
+            delete[] docs;
+            result = combined;
+            matchCount = combinedCount;
+        }
+        useOr = false;
+        negate = false;
+    }
+    delete[] allDocs;
+    return result;
+}
+
+// ----------------------------------------------------------------
+// searchRanked: Score every article containing any query term with
+// BM25 and return the best topK (article ids and scores, best first).
+// Operators are ignored. Returns the number of results written.
+// ----------------------------------------------------------------
+int searchRanked(const InvertedIndex &index, const string &query, int topK, int* resultDocs, double* resultScores) {
+    const double k1 = 1.2;
+    const double b = 0.75;
+    double* scores = new double[index.docCount]();
+
+    stringstream ss(query);
+    string word;
+    while (ss >> word) {
+        if (word == "AND" || word == "OR" || word == "NOT")
+            continue;
+        // Every token of the word ("u.s." is "u" and "s") is scored as a term.
+        forEachToken(word, [&](const string &token) {
+            int termId = findTerm(index, token);
+            if (termId < 0)
+                return;
+            const PostingList &list = index.postings[termId];
+            double idf = log(1.0 + (index.docCount - list.docFreq + 0.5) / (list.docFreq + 0.5));
+            int* tfs = new int[list.docFreq];
+            int* docs = decodePostings(list, tfs);
+            for (int i = 0; i < list.docFreq; i++) {
+                double norm = k1 * (1.0 - b + b * index.docLength[docs[i]] / index.avgDocLength);
+                scores[docs[i]] += idf * (tfs[i] * (k1 + 1.0)) / (tfs[i] + norm);
+            }
+            delete[] docs;
+            delete[] tfs;
+        });
+    }
+
+    // Keep the best topK with insertion into a small sorted array.
+    int resultCount = 0;
+    for (int d = 0; d < index.docCount; d++) {
+        if (scores[d] <= 0)
+            continue;
+        if (resultCount == topK && scores[d] <= resultScores[resultCount - 1])
+            continue;
+        int pos = resultCount < topK ? resultCount++ : topK - 1;
+        while (pos > 0 && resultScores[pos - 1] < scores[d]) {
+            resultScores[pos] = resultScores[pos - 1];
+            resultDocs[pos] = resultDocs[pos - 1];
+            pos--;
+        }
+        resultScores[pos] = scores[d];
+        resultDocs[pos] = d;
+    }
+    delete[] scores;
+    return resultCount;
+}
+
+void freeInvertedIndex(InvertedIndex &index) {
+    for (int t = 0; t < index.termCount; t++)
+        delete[] index.postings[t].bytes;
+    delete[] index.postings;
+    delete[] index.terms;
+    delete[] index.slots;
+    delete[] index.docLength;
+    index = InvertedIndex();
+}
+
+// ----------------------------------------------------------------
+// Watchlist scan: Aho-Corasick automaton over a double-array trie.
+// Phrases and article text are normalized the same way: lowercase
+// alphanumerics, with every run of other characters collapsed into
+// one space. Each phrase is stored as " phrase " so that it only
+// matches whole words.
+// ----------------------------------------------------------------
+struct WatchlistAutomaton {
+    int size = 0;               // number of double-array slots in use
+    int capacity = 0;
+    int* base = nullptr;        // child of s on byte c is base[s] + c ...
+    int* check = nullptr;       // ... if check[base[s] + c] == s
+    int* fail = nullptr;        // failure link
+    int* phraseAt = nullptr;    // phrase ending at this state, or -1
+    int* outLink = nullptr;     // nearest state on the failure chain with a phrase, or -1
+    int phraseCount = 0;
+    string* phrases = nullptr;
+};
+
+// Normalize text for the watchlist: its forEachToken tokens, each
+// followed by one space, after a leading space.
+string normalizeWatchText(const string &text) {
+    string out;
+    out.reserve(text.size() + 2);
+    out.push_back(' ');
+    forEachToken(text, [&out](const string &token) {
+        out += token;
+        out.push_back(' ');
+    });
+    return out;
+}
+
+void growAutomaton(WatchlistAutomaton &ac, int needed) {
+    if (needed <= ac.capacity)
+        return;
+    int newCapacity = ac.capacity ? ac.capacity : 1024;
+    while (newCapacity < needed)
+        newCapacity *= 2;
+    int** arrays[5] = { &ac.base, &ac.check, &ac.fail, &ac.phraseAt, &ac.outLink };
+    for (int a = 0; a < 5; a++) {
+        int* grown = new int[newCapacity];
+        for (int i = 0; i < ac.capacity; i++)
+            grown[i] = (*arrays[a])[i];
+        for (int i = ac.capacity; i < newCapacity; i++)
+            grown[i] = -1;
+        delete[] *arrays[a];
+        *arrays[a] = grown;
+    }
+    ac.capacity = newCapacity;
+}
+
+// Transition of state s on byte c, or -1.
+inline int acNext(const WatchlistAutomaton &ac, int s, unsigned char c) {
+    int t = ac.base[s] + c;
+    return (t < ac.size && ac.check[t] == s) ? t : -1;
+}
+
+// ----------------------------------------------------------------
+// buildWatchlist: Build a plain trie (first-child / next-sibling),
+// then lay it out breadth first into the double array, filling in
+// failure and output links as each level is placed.
+// ----------------------------------------------------------------
+void buildWatchlist(string* phrases, int phraseCount, WatchlistAutomaton &ac) {
+    ac.phraseCount = phraseCount;
+    ac.phrases = new string[phraseCount];
+
+    // Temporary pointer trie
+    int trieCapacity = 1024, trieSize = 1;
+    int* firstChild = new int[trieCapacity];
+    int* nextSibling = new int[trieCapacity];
+    unsigned char* label = new unsigned char[trieCapacity];
+    int* triePhrase = new int[trieCapacity];
+    firstChild[0] = nextSibling[0] = triePhrase[0] = -1;
+    label[0] = 0;
+
+    for (int p = 0; p < phraseCount; p++) {
+        ac.phrases[p] = phrases[p];
+        string key = normalizeWatchText(phrases[p]);
+        if (key.size() <= 2)
+            continue; // nothing but separators
+        int node = 0;
+        for (unsigned char c : key) {
+            int child = firstChild[node];
+            while (child != -1 && label[child] != c)
+                child = nextSibling[child];
+            if (child == -1) {
+                if (trieSize == trieCapacity) {
+                    int newCapacity = trieCapacity * 2;
+                    int* a = new int[newCapacity];
+                    int* b = new int[newCapacity];
+                    unsigned char* l = new unsigned char[newCapacity];
+                    int* ph = new int[newCapacity];
+                    for (int i = 0; i < trieSize; i++) {
+                        a[i] = firstChild[i]; b[i] = nextSibling[i]; l[i] = label[i]; ph[i] = triePhrase[i];
+                    }
+                    delete[] firstChild; delete[] nextSibling; delete[] label; delete[] triePhrase;
+                    firstChild = a; nextSibling = b; label = l; triePhrase = ph;
+                    trieCapacity = newCapacity;
+                }
+                child = trieSize++;
+                firstChild[child] = -1;
+                triePhrase[child] = -1;
+                label[child] = c;
+                nextSibling[child] = firstChild[node];
+                firstChild[node] = child;
+            }
+            node = child;
+        }
+        if (triePhrase[node] == -1)
+            triePhrase[node] = p; // duplicate phrases count towards the first copy
+    }
+
+    // Breadth-first placement into the double array
+    growAutomaton(ac, 512);
+    ac.size = 1;
+    ac.check[0] = 0;
+    ac.fail[0] = 0;
+    int* queueTrie = new int[trieSize];
+    int* queueState = new int[trieSize];
+    int head = 0, tail = 0;
+    queueTrie[tail] = 0;
+    queueState[tail++] = 0;
+    int searchFrom = 1;
+
+    while (head < tail) {
+        int node = queueTrie[head];
+        int s = queueState[head++];
+        if (firstChild[node] == -1)
+            continue;
+
+        // Find the smallest base where every child label lands on a free slot
+        int b = searchFrom;
+        while (true) {
+            growAutomaton(ac, b + 256);
+            bool fits = true;
+            for (int child = firstChild[node]; child != -1; child = nextSibling[child]) {
+                if (ac.check[b + label[child]] != -1) {
+                    fits = false;
+                    break;
+                }
+            }
+            if (fits)
+                break;
+            b++;
+        }
+        ac.base[s] = b;
+        for (int child = firstChild[node]; child != -1; child = nextSibling[child]) {
+            int t = b + label[child];
+            ac.check[t] = s;
+            ac.phraseAt[t] = triePhrase[child];
+            if (t + 1 > ac.size)
+                ac.size = t + 1;
+        }
+        while (searchFrom < ac.size && ac.check[searchFrom] != -1)
+            searchFrom++;
+
+        // Failure and output links for the children (parents are already linked)
+        for (int child = firstChild[node]; child != -1; child = nextSibling[child]) {
+            int t = b + label[child];
+            int f = 0;
+            if (s != 0) {
+                f = ac.fail[s];
+                while (f != 0 && acNext(ac, f, label[child]) == -1)
+                    f = ac.fail[f];
+                int next = acNext(ac, f, label[child]);
+                f = (next != -1) ? next : 0;
+            }
+            ac.fail[t] = f;
+            ac.outLink[t] = (ac.phraseAt[f] != -1) ? f : ac.outLink[f];
+            queueTrie[tail] = child;
+            queueState[tail++] = t;
+        }
+    }
+    // States without children keep base -1; point them past the array so lookups fail.
+    for (int s = 0; s < ac.size; s++) {
+        if (ac.base[s] == -1)
+            ac.base[s] = ac.size;
+    }
+
+    delete[] queueTrie;
+    delete[] queueState;
+    delete[] firstChild;
+    delete[] nextSibling;
+    delete[] label;
+    delete[] triePhrase;
+}
+
+void freeWatchlist(WatchlistAutomaton &ac) {
+    delete[] ac.base;
+    delete[] ac.check;
+    delete[] ac.fail;
+    delete[] ac.phraseAt;
+    delete[] ac.outLink;
+    delete[] ac.phrases;
+    ac = WatchlistAutomaton();
+}
+
+// Per-phrase hit counters, split by label, subject id and month slot.
+struct WatchlistCounts {
+    int phraseCount = 0;
+    int subjectCount = 0;
+    int monthCount = 0;
+    long long* byLabel = nullptr;   // [phrase][0 = FAKE, 1 = TRUE]
+    long long* bySubject = nullptr; // [phrase][subject]
+    long long* byMonth = nullptr;   // [phrase][month slot]
+
+    void allocate(int phrases, int subjects, int months) {
+        phraseCount = phrases;
+        subjectCount = subjects;
+        monthCount = months;
+        byLabel = new long long[phrases * 2]();
+        bySubject = new long long[phrases * subjects]();
+        byMonth = new long long[phrases * months]();
+    }
+    void release() {
+        delete[] byLabel;
+        delete[] bySubject;
+        delete[] byMonth;
+        byLabel = bySubject = byMonth = nullptr;
+    }
+};
+
+// ----------------------------------------------------------------
+// scanWatchlistRange: Stream articles [begin, end) through the
+// automaton and add every phrase hit to 'counts'. Each field is fed
+// as forEachToken tokens with a space before and after each one (the
+// same bytes normalizeWatchText would produce), so no normalized copy
+// of the text is made.
+// ----------------------------------------------------------------
+void scanWatchlistRange(const WatchlistAutomaton &ac, News *articles, int begin, int end,
+                        const int* subjectIds, const int* monthSlots, WatchlistCounts &counts) {
+    for (int i = begin; i < end; i++) {
+        int label = articles[i].isTrue ? 1 : 0;
+        int s = 0;
+        auto feed = [&](unsigned char c) {
+            int next;
+            while ((next = acNext(ac, s, c)) == -1 && s != 0)
+                s = ac.fail[s];
+            s = (next != -1) ? next : 0;
+            for (int o = (ac.phraseAt[s] != -1) ? s : ac.outLink[s]; o != -1; o = ac.outLink[o]) {
+                int p = ac.phraseAt[o];
+                counts.byLabel[p * 2 + label]++;
+                counts.bySubject[p * counts.subjectCount + subjectIds[i]]++;
+                if (monthSlots[i] >= 0)
+                    counts.byMonth[p * counts.monthCount + monthSlots[i]]++;
+            }
+        };
+        const string* fields[2] = { &articles[i].title, &articles[i].text };
+        for (int f = 0; f < 2; f++) {
+            s = 0;
+            feed(' ');
+            forEachToken(*fields[f], [&feed](const string &token) {
+                for (unsigned char c : token)
+                    feed(c);
+                feed(' ');
+            });
+        }
+    }
+}
+
+// ----------------------------------------------------------------
+// scanWatchlist: Compile the phrases, split the articles across all
+// cores, count into per-thread tables and add them up, then report
+// hits per phrase by label, subject and month.
+// ----------------------------------------------------------------
+void scanWatchlist(News *articles, int count, string* phrases, int phraseCount) {
+    WatchlistAutomaton ac;
+    buildWatchlist(phrases, phraseCount, ac);
+
+    // Dense subject ids and month slots for every article
+    string* subjectNames = nullptr;
+    int subjectCount = 0, subjectCapacity = 0;
+    int* subjectIds = new int[count];
+    int* monthSlots = new int[count];
+    int minYear = 0, maxYear = -1;
+    for (int i = 0; i < count; i++) {
+        int packed = packDate(articles[i].date);
+        if (packed != 0) {
+            int year = packed / 10000;
+            if (maxYear < minYear) minYear = maxYear = year;
+            if (year < minYear) minYear = year;
+            if (year > maxYear) maxYear = year;
+        }
+    }
+    for (int i = 0; i < count; i++) {
+        subjectIds[i] = internSubject(subjectNames, subjectCount, subjectCapacity, articles[i].subject);
+        int packed = packDate(articles[i].date);
+        monthSlots[i] = packed ? (packed / 10000 - minYear) * 12 + (packed / 100 % 100 - 1) : -1;
+    }
+    int monthCount = (maxYear >= minYear) ? (maxYear - minYear + 1) * 12 : 1;
+
+    // One counter table per thread, merged at the end
+    int threadCount = static_cast<int>(thread::hardware_concurrency());
+    if (threadCount <= 0) threadCount = 1;
+    if (threadCount > count) threadCount = count > 0 ? count : 1;
+    WatchlistCounts* partial = new WatchlistCounts[threadCount];
+    thread* workers = new thread[threadCount];
+    for (int t = 0; t < threadCount; t++) {
+        partial[t].allocate(phraseCount, subjectCount, monthCount);
+        int begin = static_cast<int>(static_cast<long long>(count) * t / threadCount);
+        int end = static_cast<int>(static_cast<long long>(count) * (t + 1) / threadCount);
+        workers[t] = thread(scanWatchlistRange, std::cref(ac), articles, begin, end,
+                            subjectIds, monthSlots, std::ref(partial[t]));
+    }
+    for (int t = 0; t < threadCount; t++)
+        workers[t].join();
+    WatchlistCounts &total = partial[0];
+    for (int t = 1; t < threadCount; t++) {
+        for (int i = 0; i < phraseCount * 2; i++) total.byLabel[i] += partial[t].byLabel[i];
+        for (int i = 0; i < phraseCount * subjectCount; i++) total.bySubject[i] += partial[t].bySubject[i];
+        for (int i = 0; i < phraseCount * monthCount; i++) total.byMonth[i] += partial[t].byMonth[i];
+    }
+
+    cout << "\n=== Watchlist Hits (" << phraseCount << " phrases, " << threadCount << " threads) ===" << endl;
+    for (int p = 0; p < phraseCount; p++) {
+        long long fake = total.byLabel[p * 2];
+        long long real = total.byLabel[p * 2 + 1];
+        if (fake + real == 0)
+            continue;
+        cout << "\"" << ac.phrases[p] << "\": " << fake + real << " hits (FAKE: " << fake << ", TRUE: " << real << ")" << endl;
+        cout << "  By subject:";
+        for (int sub = 0; sub < subjectCount; sub++) {
+            long long hits = total.bySubject[p * subjectCount + sub];
+            if (hits > 0)
+                cout << " " << subjectNames[sub] << "=" << hits;
+        }
+        cout << endl << "  By month:";
+        for (int m = 0; m < monthCount; m++) {
+            long long hits = total.byMonth[p * monthCount + m];
+            if (hits > 0)
+                cout << " " << (minYear + m / 12) << "-" << setw(2) << setfill('0') << (m % 12 + 1) << setfill(' ') << "=" << hits;
+        }
+        cout << endl;
+    }
+
+    for (int t = 0; t < threadCount; t++)
+        partial[t].release();
+    delete[] partial;
+    delete[] workers;
+    delete[] subjectIds;
+    delete[] subjectNames;
+    delete[] monthSlots;
+    freeWatchlist(ac);
+}
+
+// ----------------------------------------------------------------
+// loadWatchlist: Read one phrase per line (blank lines are skipped).
+// Returns a new array of phrases (caller must delete[]).
+// ----------------------------------------------------------------
+string* loadWatchlist(const string &filename, int &phraseCount) {
+    phraseCount = 0;
+    ifstream file(filename);
+    if (!file) {
+        cerr << "Error opening file: " << filename << endl;
+        return nullptr;
+    }
+    int capacity = 64;
+    string* phrases = new string[capacity];
+    string line;
+    while (getline(file, line)) {
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+        if (line.find_first_not_of(" \t") == string::npos)
+            continue;
+        if (phraseCount == capacity) {
+            string* grown = new string[capacity * 2];
+            for (int i = 0; i < phraseCount; i++)
+                grown[i].swap(phrases[i]);
+            delete[] phrases;
+            phrases = grown;
+            capacity *= 2;
+        }
+        phrases[phraseCount++] = line;
+    }
+    return phrases;
+}
+
+// ----------------------------------------------------------------
+// Roaring-style compressed bitmap of row ids.
+// Rows are split into chunks of 65536 by their high 16 bits. A sparse
+// chunk stores its sorted low 16 bits in an array; once it holds more
+// than 4096 rows it switches to a plain 65536-bit bitmap.
+// ----------------------------------------------------------------
+const int ROARING_ARRAY_MAX = 4096;
+const int ROARING_WORDS = 1024;     // 65536 bits
+
+struct RoaringContainer {
+    int key = 0;                            // high 16 bits of the rows
+    int cardinality = 0;
+    int arrayCapacity = 0;
+    unsigned short* array = nullptr;        // sorted low bits (sparse chunk)
+    unsigned long long* bits = nullptr;     // 1024 words (dense chunk)
+};
+
+struct RoaringBitmap {
+    RoaringContainer* containers = nullptr;
+    int containerCount = 0;
+    int capacity = 0;
+};
+
+RoaringContainer& roaringAppendContainer(RoaringBitmap &bm, int key) {
+    if (bm.containerCount == bm.capacity) {
+        int newCapacity = bm.capacity ? bm.capacity * 2 : 4;
+        RoaringContainer* grown = new RoaringContainer[newCapacity];
+        for (int i = 0; i < bm.containerCount; i++)
+            grown[i] = bm.containers[i];
+        delete[] bm.containers;
+        bm.containers = grown;
+        bm.capacity = newCapacity;
+    }
+    RoaringContainer &c = bm.containers[bm.containerCount++];
+    c = RoaringContainer();
+    c.key = key;
+    return c;
+}
+
+// Switch a sparse chunk to a dense bitmap.
+void roaringToBitmap(RoaringContainer &c) {
+    c.bits = new unsigned long long[ROARING_WORDS]();
+    for (int i = 0; i < c.cardinality; i++)
+        c.bits[c.array[i] >> 6] |= 1ULL << (c.array[i] & 63);
+    delete[] c.array;
+    c.array = nullptr;
+    c.arrayCapacity = 0;
+}
+
+// ----------------------------------------------------------------
+// roaringAdd: Add a row id. Rows must be added in increasing order,
+// which is how every index here is built (one pass over the rows).
+// ----------------------------------------------------------------
+void roaringAdd(RoaringBitmap &bm, int row) {
+    int key = row >> 16;
+    unsigned short low = static_cast<unsigned short>(row & 0xFFFF);
+    RoaringContainer &c = (bm.containerCount > 0 && bm.containers[bm.containerCount - 1].key == key)
+                          ? bm.containers[bm.containerCount - 1]
+                          : roaringAppendContainer(bm, key);
+    if (c.bits) {
+        c.bits[low >> 6] |= 1ULL << (low & 63);
+        c.cardinality++;
+        return;
+    }
+    if (c.cardinality == ROARING_ARRAY_MAX) {
+        roaringToBitmap(c);
+        c.bits[low >> 6] |= 1ULL << (low & 63);
+        c.cardinality++;
+        return;
+    }
+    if (c.cardinality == c.arrayCapacity) {
+        int newCapacity = c.arrayCapacity ? c.arrayCapacity * 2 : 16;
+        unsigned short* grown = new unsigned short[newCapacity];
+        for (int i = 0; i < c.cardinality; i++)
+            grown[i] = c.array[i];
+        delete[] c.array;
+        c.array = grown;
+        c.arrayCapacity = newCapacity;
+    }
+    c.array[c.cardinality++] = low;
+}
+
+int roaringCount(const RoaringBitmap &bm) {
+    int total = 0;
+    for (int i = 0; i < bm.containerCount; i++)
+        total += bm.containers[i].cardinality;
+    return total;
+}
+
+// AND of two chunks with the same key, written into 'out' (already keyed).
+void roaringAndContainer(const RoaringContainer &a, const RoaringContainer &b, RoaringContainer &out) {
+    if (a.bits && b.bits) {
+        int card = 0;
+        for (int w = 0; w < ROARING_WORDS; w++)
+            card += popcount64(a.bits[w] & b.bits[w]);
+        out.cardinality = card;
+        if (card > ROARING_ARRAY_MAX) {
+            out.bits = new unsigned long long[ROARING_WORDS];
+            for (int w = 0; w < ROARING_WORDS; w++)
+                out.bits[w] = a.bits[w] & b.bits[w];
+        } else {
+            out.array = new unsigned short[card > 0 ? card : 1];
+            out.arrayCapacity = card;
+            int n = 0;
+            for (int w = 0; w < ROARING_WORDS; w++) {
+                unsigned long long word = a.bits[w] & b.bits[w];
+                while (word) {
+                    int bit = popcount64((word & (~word + 1)) - 1);
+                    out.array[n++] = static_cast<unsigned short>(w * 64 + bit);
+                    word &= word - 1;
+                }
+            }
+        }
+        return;
+    }
+    // At least one side is sparse: the result fits in an array.
+    const RoaringContainer &sparse = a.bits ? b : a;
+    const RoaringContainer &other = a.bits ? a : b;
+    out.array = new unsigned short[sparse.cardinality > 0 ? sparse.cardinality : 1];
+    out.arrayCapacity = sparse.cardinality;
+    int n = 0;
+    if (other.bits) {
+        for (int i = 0; i < sparse.cardinality; i++) {
+            unsigned short v = sparse.array[i];
+            if (other.bits[v >> 6] & (1ULL << (v & 63)))
+                out.array[n++] = v;
+        }
+    } else {
+        int i = 0, j = 0;
+        while (i < sparse.cardinality && j < other.cardinality) {
+            if (sparse.array[i] < other.array[j]) i++;
+            else if (sparse.array[i] > other.array[j]) j++;
+            else { out.array[n++] = sparse.array[i]; i++; j++; }
+        }
+    }
+    out.cardinality = n;
+}
+
+// ----------------------------------------------------------------
+// roaringAnd: Intersection of two bitmaps (new bitmap).
+// ----------------------------------------------------------------
+RoaringBitmap roaringAnd(const RoaringBitmap &a, const RoaringBitmap &b) {
+    RoaringBitmap out;
+    int i = 0, j = 0;
+    while (i < a.containerCount && j < b.containerCount) {
+        if (a.containers[i].key < b.containers[j].key) i++;
+        else if (a.containers[i].key > b.containers[j].key) j++;
+        else {
+            RoaringContainer &c = roaringAppendContainer(out, a.containers[i].key);
+            roaringAndContainer(a.containers[i], b.containers[j], c);
+            if (c.cardinality == 0) {
+                delete[] c.array;
+                delete[] c.bits;
+                out.containerCount--;
+            }
+            i++;
+            j++;
+        }
+    }
+    return out;
+}
+
+// ----------------------------------------------------------------
+// roaringOr: Union of two bitmaps (new bitmap). Chunks are merged as
+// dense bitmaps and shrunk back to arrays when they are sparse.
+// ----------------------------------------------------------------
+RoaringBitmap roaringOr(const RoaringBitmap &a, const RoaringBitmap &b) {
+    RoaringBitmap out;
+    int i = 0, j = 0;
+    while (i < a.containerCount || j < b.containerCount) {
+        int key;
+        if (j >= b.containerCount || (i < a.containerCount && a.containers[i].key < b.containers[j].key))
+            key = a.containers[i].key;
+        else
+            key = b.containers[j].key;
+        RoaringContainer &c = roaringAppendContainer(out, key);
+        c.bits = new unsigned long long[ROARING_WORDS]();
+        const RoaringContainer* sides[2] = {
+            (i < a.containerCount && a.containers[i].key == key) ? &a.containers[i++] : nullptr,
+            (j < b.containerCount && b.containers[j].key == key) ? &b.containers[j++] : nullptr
+        };
+        for (int s = 0; s < 2; s++) {
+            const RoaringContainer* side = sides[s];
+            if (!side) continue;
+            if (side->bits) {
+                for (int w = 0; w < ROARING_WORDS; w++)
+                    c.bits[w] |= side->bits[w];
+            } else {
+                for (int k = 0; k < side->cardinality; k++)
+                    c.bits[side->array[k] >> 6] |= 1ULL << (side->array[k] & 63);
+            }
+        }
+        c.cardinality = 0;
+        for (int w = 0; w < ROARING_WORDS; w++)
+            c.cardinality += popcount64(c.bits[w]);
+        if (c.cardinality <= ROARING_ARRAY_MAX) {
+            unsigned long long* bits = c.bits;
+            c.bits = nullptr;
+            c.array = new unsigned short[c.cardinality > 0 ? c.cardinality : 1];
+            c.arrayCapacity = c.cardinality;
+            int n = 0;
+            for (int w = 0; w < ROARING_WORDS; w++) {
+                for (unsigned long long word = bits[w]; word; word &= word - 1)
+                    c.array[n++] = static_cast<unsigned short>(w * 64 + popcount64((word & (~word + 1)) - 1));
+            }
+            delete[] bits;
+        }
+    }
+    return out;
+}
+
+// ----------------------------------------------------------------
+// roaringAndCount: Size of the intersection without building it.
+// ----------------------------------------------------------------
+int roaringAndCount(const RoaringBitmap &a, const RoaringBitmap &b) {
+    int total = 0;
+    int i = 0, j = 0;
+    while (i < a.containerCount && j < b.containerCount) {
+        if (a.containers[i].key < b.containers[j].key) { i++; continue; }
+        if (a.containers[i].key > b.containers[j].key) { j++; continue; }
+        const RoaringContainer &x = a.containers[i++];
+        const RoaringContainer &y = b.containers[j++];
+        if (x.bits && y.bits) {
+            for (int w = 0; w < ROARING_WORDS; w++)
+                total += popcount64(x.bits[w] & y.bits[w]);
+        } else if (x.bits || y.bits) {
+            const RoaringContainer &sparse = x.bits ? y : x;
+            const RoaringContainer &dense = x.bits ? x : y;
+            for (int k = 0; k < sparse.cardinality; k++) {
+                unsigned short v = sparse.array[k];
+                if (dense.bits[v >> 6] & (1ULL << (v & 63)))
+                    total++;
+            }
+        } else {
+            int p = 0, q = 0;
+            while (p < x.cardinality && q < y.cardinality) {
+                if (x.array[p] < y.array[q]) p++;
+                else if (x.array[p] > y.array[q]) q++;
+                else { total++; p++; q++; }
+            }
+        }
+    }
+    return total;
+}
+
+void freeRoaring(RoaringBitmap &bm) {
+    for (int i = 0; i < bm.containerCount; i++) {
+        delete[] bm.containers[i].array;
+        delete[] bm.containers[i].bits;
+    }
+    delete[] bm.containers;
+    bm = RoaringBitmap();
+}
+
+// ----------------------------------------------------------------
+// Facet bitmaps built at load time: one bitmap per subject, per
+// label and per year-month. Row ids are load positions.
+// ----------------------------------------------------------------
+struct FacetIndex {
+    int rowCount = 0;
+    int subjectCount = 0;
+    int subjectCapacity = 0;
+    string* subjectNames = nullptr;
+    RoaringBitmap* subjects = nullptr;  // subjectCapacity bitmaps
+    RoaringBitmap fake;
+    RoaringBitmap real;
+    int minYear = 0;
+    int yearCount = 0;
+    RoaringBitmap* years = nullptr;     // [year - minYear]
+    RoaringBitmap* months = nullptr;    // [(year - minYear) * 12 + month - 1]
+};
+
+// ----------------------------------------------------------------
+// facetSubjectUnion: Union of every subject bitmap whose name contains
+// 'subject' (new bitmap).
+// ----------------------------------------------------------------
+RoaringBitmap facetSubjectUnion(const FacetIndex &index, const string &subject) {
+    RoaringBitmap result;
+    for (int s = 0; s < index.subjectCount; s++) {
+        if (index.subjectNames[s].find(subject) == string::npos)
+            continue;
+        RoaringBitmap merged = roaringOr(result, index.subjects[s]);
+        freeRoaring(result);
+        result = merged;
+    }
+    return result;
+}
+
+// ----------------------------------------------------------------
+// facetCount: Generic facet query. Counts rows whose subject contains
+// 'subject' ("" = any), with the given label (-1 = any, 0 = FAKE,
+// 1 = TRUE), year (0 = any) and month (0 = any).
+// ----------------------------------------------------------------
+int facetCount(const FacetIndex &index, const string &subject, int label, int year, int month) {
+    // Time facet first: it is the most selective for the reports.
+    const RoaringBitmap* timeFacet = nullptr;
+    if (year != 0) {
+        if (year < index.minYear || year >= index.minYear + index.yearCount)
+            return 0;
+        if (month >= 1 && month <= 12)
+            timeFacet = &index.months[(year - index.minYear) * 12 + month - 1];
+        else
+            timeFacet = &index.years[year - index.minYear];
+    }
+    const RoaringBitmap* labelFacet = (label == 0) ? &index.fake : (label == 1) ? &index.real : nullptr;
+
+    bool anySubject = subject.empty();
+    RoaringBitmap subjectFacet;
+    if (!anySubject)
+        subjectFacet = facetSubjectUnion(index, subject);
+
+    const RoaringBitmap* facets[3];
+    int facetTotal = 0;
+    if (timeFacet) facets[facetTotal++] = timeFacet;
+    if (!anySubject) facets[facetTotal++] = &subjectFacet;
+    if (labelFacet) facets[facetTotal++] = labelFacet;
+
+    int result;
+    if (facetTotal == 0) {
+        result = index.rowCount;
+    } else if (facetTotal == 1) {
+        result = roaringCount(*facets[0]);
+    } else if (facetTotal == 2) {
+        result = roaringAndCount(*facets[0], *facets[1]);
+    } else {
+        RoaringBitmap pair = roaringAnd(*facets[0], *facets[1]);
+        result = roaringAndCount(pair, *facets[2]);
+        freeRoaring(pair);
+    }
+    freeRoaring(subjectFacet);
+    return result;
+}
+
+void freeFacetIndex(FacetIndex &index) {
+    for (int s = 0; s < index.subjectCount; s++)
+        freeRoaring(index.subjects[s]);
+    delete[] index.subjects;
+    delete[] index.subjectNames;
+    freeRoaring(index.fake);
+    freeRoaring(index.real);
+    for (int y = 0; y < index.yearCount; y++)
+        freeRoaring(index.years[y]);
+    for (int m = 0; m < index.yearCount * 12; m++)
+        freeRoaring(index.months[m]);
+    delete[] index.years;
+    delete[] index.months;
+    index = FacetIndex();
+}
+
+// ----------------------------------------------------------------
+// growFacetYears: Widen the year range to include 'year'. The bitmaps
+// are plain structs, so the existing ones are moved into the larger
+// arrays without copying rows.
+// ----------------------------------------------------------------
+void growFacetYears(FacetIndex &index, int year) {
+    int lastYear = index.minYear + index.yearCount - 1;
+    int minYear = (index.yearCount == 0 || year < index.minYear) ? year : index.minYear;
+    int maxYear = (index.yearCount == 0 || year > lastYear) ? year : lastYear;
+    int yearCount = maxYear - minYear + 1;
+    RoaringBitmap* years = new RoaringBitmap[yearCount];
+    RoaringBitmap* months = new RoaringBitmap[yearCount * 12];
+    int shift = index.minYear - minYear;
+    for (int y = 0; y < index.yearCount; y++) {
+        years[y + shift] = index.years[y];
+        for (int m = 0; m < 12; m++)
+            months[(y + shift) * 12 + m] = index.months[y * 12 + m];
+    }
+    delete[] index.years;
+    delete[] index.months;
+    index.years = years;
+    index.months = months;
+    index.minYear = minYear;
+    index.yearCount = yearCount;
+}
+
+// ----------------------------------------------------------------
+// addToFacetIndex: One pass over articles [first, count), appending
+// each row id to its subject, label, year and year-month bitmaps.
+// ----------------------------------------------------------------
+void addToFacetIndex(News *articles, int first, int count, FacetIndex &index) {
+    for (int i = first; i < count; i++) {
+        int oldCapacity = index.subjectCapacity;
+        int s = internSubject(index.subjectNames, index.subjectCount, index.subjectCapacity, articles[i].subject);
+        if (index.subjectCapacity != oldCapacity) {
+            RoaringBitmap* grown = new RoaringBitmap[index.subjectCapacity];
+            for (int b = 0; b < oldCapacity; b++)
+                grown[b] = index.subjects[b];
+            delete[] index.subjects;
+            index.subjects = grown;
+        }
+        roaringAdd(index.subjects[s], i);
+
+        roaringAdd(articles[i].isTrue ? index.real : index.fake, i);
+
+        int year = articles[i].year;
+        if (year > 0) {
+            if (index.yearCount == 0 || year < index.minYear || year >= index.minYear + index.yearCount)
+                growFacetYears(index, year);
+            int y = year - index.minYear;
+            roaringAdd(index.years[y], i);
+            int packed = packDate(articles[i].date);
+            if (packed != 0)
+                roaringAdd(index.months[y * 12 + packed / 100 % 100 - 1], i);
+        }
+    }
+    if (count > index.rowCount)
+        index.rowCount = count;
+}
+
+// ----------------------------------------------------------------
+// buildFacetIndex: Size the year range in a first pass, then add
+// every article.
+// ----------------------------------------------------------------
+void buildFacetIndex(News *articles, int count, FacetIndex &index) {
+    int maxYear = 0;
+    index.minYear = 0;
+    for (int i = 0; i < count; i++) {
+        int year = articles[i].year;
+        if (year <= 0) continue;
+        if (index.minYear == 0 || year < index.minYear) index.minYear = year;
+        if (year > maxYear) maxYear = year;
+    }
+    index.yearCount = (index.minYear > 0) ? maxYear - index.minYear + 1 : 0;
+    index.years = new RoaringBitmap[index.yearCount > 0 ? index.yearCount : 1];
+    index.months = new RoaringBitmap[index.yearCount > 0 ? index.yearCount * 12 : 1];
+    addToFacetIndex(articles, 0, count, index);
+}
+
+// ----------------------------------------------------------------
+// Group-by operator: group a set of rows (an index array into the
+// articles, nothing is copied) by an integer key and compute count,
+// fake count and fake ratio per group. The strategy follows the key
+// cardinality:
+//   direct - the key range is small: one array slot per key value
+//   hash   - few distinct keys over a wide range: open-addressing table
+//   sort   - many distinct keys: radix sort (key, row) pairs, then
+//            aggregate adjacent runs
+// Groups come back in ascending key order whatever the strategy.
+// ----------------------------------------------------------------
+const int GROUP_DIRECT = 0;
+const int GROUP_HASH = 1;
+const int GROUP_SORT = 2;
+const int GROUP_DIRECT_LIMIT = 1 << 16;     // widest key range for direct arrays
+const int GROUP_SAMPLE = 1024;              // rows sampled to estimate cardinality
+
+struct GroupRow {
+    int key = 0;
+    int count = 0;
+    int fakeCount = 0;
+    double fakeRatio() const { return count > 0 ? static_cast<double>(fakeCount) / count : 0.0; }
+};
+
+struct GroupTable {
+    GroupRow* groups = nullptr;
+    int groupCount = 0;
+    int strategy = GROUP_DIRECT;
+};
+
+void freeGroupTable(GroupTable &table) {
+    delete[] table.groups;
+    table = GroupTable();
+}
+
+const char* groupStrategyName(int strategy) {
+    switch (strategy) {
+        case GROUP_DIRECT: return "direct";
+        case GROUP_HASH: return "hash";
+        default: return "sort";
+    }
+}
+
+// ----------------------------------------------------------------
+// radixSortByKey: Stable LSD radix sort of 'keys' (8 bits per pass),
+// moving 'payload' along with them.
+// ----------------------------------------------------------------
+void radixSortByKey(unsigned int *keys, int *payload, int n) {
+    if (n <= 1)
+        return;
+    unsigned int* keyBuffer = new unsigned int[n];
+    int* payloadBuffer = new int[n];
+    unsigned int* srcKeys = keys;
+    int* srcPayload = payload;
+    unsigned int* dstKeys = keyBuffer;
+    int* dstPayload = payloadBuffer;
+    for (int shift = 0; shift < 32; shift += 8) {
+        int offsets[257] = {0};
+        for (int i = 0; i < n; i++)
+            offsets[((srcKeys[i] >> shift) & 0xFF) + 1]++;
+        if (offsets[((srcKeys[0] >> shift) & 0xFF) + 1] == n)
+            continue;   // every key has the same byte here
+        for (int b = 0; b < 256; b++)
+            offsets[b + 1] += offsets[b];
+        for (int i = 0; i < n; i++) {
+            int pos = offsets[(srcKeys[i] >> shift) & 0xFF]++;
+            dstKeys[pos] = srcKeys[i];
+            dstPayload[pos] = srcPayload[i];
+        }
+        swap(srcKeys, dstKeys);
+        swap(srcPayload, dstPayload);
+    }
+    if (srcKeys != keys) {
+        for (int i = 0; i < n; i++) {
+            keys[i] = srcKeys[i];
+            payload[i] = srcPayload[i];
+        }
+    }
+    delete[] keyBuffer;
+    delete[] payloadBuffer;
+}
+
+// ----------------------------------------------------------------
+// estimateDistinctKeys: Distinct keys among GROUP_SAMPLE evenly
+// spaced rows (all rows if there are fewer).
+// ----------------------------------------------------------------
+int estimateDistinctKeys(const int *keys, int n) {
+    int sampleSize = n < GROUP_SAMPLE ? n : GROUP_SAMPLE;
+    const int SLOTS = GROUP_SAMPLE * 2;
+    int seen[SLOTS];
+    bool used[SLOTS] = {false};
+    int distinct = 0;
+    for (int k = 0; k < sampleSize; k++) {
+        int key = keys[static_cast<long long>(k) * n / sampleSize];
+        unsigned int pos = (static_cast<unsigned int>(key) * 2654435761u) % SLOTS;
+        while (used[pos] && seen[pos] != key)
+            pos = (pos + 1) % SLOTS;
+        if (!used[pos]) {
+            used[pos] = true;
+            seen[pos] = key;
+            distinct++;
+        }
+    }
+    return distinct;
+}
+
+// ----------------------------------------------------------------
+// groupBy: Group 'rows' of 'articles' by keyOf(row) (an int).
+// ----------------------------------------------------------------
+template <typename KeyFunc>
+GroupTable groupBy(const News *articles, const int *rows, int rowCount, KeyFunc keyOf) {
+    GroupTable result;
+    if (rowCount <= 0)
+        return result;
+
+    // Evaluate every key once.
+    int* keys = new int[rowCount];
+    keys[0] = keyOf(rows[0]);
+    int minKey = keys[0], maxKey = keys[0];
+    for (int i = 1; i < rowCount; i++) {
+        keys[i] = keyOf(rows[i]);
+        if (keys[i] < minKey) minKey = keys[i];
+        if (keys[i] > maxKey) maxKey = keys[i];
+    }
+    long long range = static_cast<long long>(maxKey) - minKey + 1;
+
+    if (range <= GROUP_DIRECT_LIMIT && range <= 4LL * rowCount + 256) {
+        result.strategy = GROUP_DIRECT;
+        GroupRow* slots = new GroupRow[range];
+        for (int i = 0; i < rowCount; i++) {
+            GroupRow &g = slots[keys[i] - minKey];
+            g.count++;
+            g.fakeCount += !articles[rows[i]].isTrue;
+        }
+        for (long long k = 0; k < range; k++)
+            if (slots[k].count > 0) result.groupCount++;
+        result.groups = new GroupRow[result.groupCount > 0 ? result.groupCount : 1];
+        int n = 0;
+        for (long long k = 0; k < range; k++) {
+            if (slots[k].count == 0) continue;
+            result.groups[n] = slots[k];
+            result.groups[n++].key = static_cast<int>(minKey + k);
+        }
+        delete[] slots;
+    } else if (estimateDistinctKeys(keys, rowCount) * 2 <= min(rowCount, GROUP_SAMPLE)) {
+        // Keys repeat a lot in the sample: few groups, aggregate in a hash table.
+        result.strategy = GROUP_HASH;
+        int capacity = 64;
+        GroupRow* table = new GroupRow[capacity];
+        for (int i = 0; i < rowCount; i++) {
+            if ((result.groupCount + 1) * 10 > capacity * 7) {
+                GroupRow* old = table;
+                int oldCapacity = capacity;
+                capacity *= 2;
+                table = new GroupRow[capacity];
+                for (int s = 0; s < oldCapacity; s++) {
+                    if (old[s].count == 0) continue;
+                    unsigned int pos = (static_cast<unsigned int>(old[s].key) * 2654435761u) & (capacity - 1);
+                    while (table[pos].count != 0)
+                        pos = (pos + 1) & (capacity - 1);
+                    table[pos] = old[s];
+                }
+                delete[] old;
+            }
+            unsigned int pos = (static_cast<unsigned int>(keys[i]) * 2654435761u) & (capacity - 1);
+            while (table[pos].count != 0 && table[pos].key != keys[i])
+                pos = (pos + 1) & (capacity - 1);
+            if (table[pos].count == 0) {
+                table[pos].key = keys[i];
+                result.groupCount++;
+            }
+            table[pos].count++;
+            table[pos].fakeCount += !articles[rows[i]].isTrue;
+        }
+        // Order the groups by key.
+        unsigned int* groupKeys = new unsigned int[result.groupCount];
+        int* groupSlots = new int[result.groupCount];
+        int n = 0;
+        for (int s = 0; s < capacity; s++) {
+            if (table[s].count == 0) continue;
+            groupKeys[n] = static_cast<unsigned int>(table[s].key) - static_cast<unsigned int>(minKey);
+            groupSlots[n++] = s;
+        }
+        radixSortByKey(groupKeys, groupSlots, n);
+        result.groups = new GroupRow[n];
+        for (int g = 0; g < n; g++)
+            result.groups[g] = table[groupSlots[g]];
+        delete[] groupKeys;
+        delete[] groupSlots;
+        delete[] table;
+    } else {
+        // Mostly distinct keys: sort (key, row) pairs and aggregate the runs.
+        result.strategy = GROUP_SORT;
+        unsigned int* sortKeys = new unsigned int[rowCount];
+        int* sortRows = new int[rowCount];
+        for (int i = 0; i < rowCount; i++) {
+            sortKeys[i] = static_cast<unsigned int>(keys[i]) - static_cast<unsigned int>(minKey);
+            sortRows[i] = rows[i];
+        }
+        radixSortByKey(sortKeys, sortRows, rowCount);
+        for (int i = 0; i < rowCount; i++)
+            if (i == 0 || sortKeys[i] != sortKeys[i - 1]) result.groupCount++;
+        result.groups = new GroupRow[result.groupCount];
+        int g = -1;
+        for (int i = 0; i < rowCount; i++) {
+            if (i == 0 || sortKeys[i] != sortKeys[i - 1])
+                result.groups[++g].key = static_cast<int>(static_cast<unsigned int>(minKey) + sortKeys[i]);
+            result.groups[g].count++;
+            result.groups[g].fakeCount += !articles[sortRows[i]].isTrue;
+        }
+        delete[] sortKeys;
+        delete[] sortRows;
+    }
+    delete[] keys;
+    return result;
+}
+
+// ----------------------------------------------------------------
+// Option 4: Fake Political News Percentage by Month (2016)
+// ----------------------------------------------------------------
+// Baseline for percentageByMonthCube. The subject test is one lookup
+// in a per-subject table and the month histogram is updated without
+// branches. Blocks of rows are counted
+// on the thread pool and their histograms added up.
+struct MonthCounts {
+    int total[13];  // month 0 collects the rows that do not match
+    int fake[13];
+};
+
+void percentageByMonthLinear(ThreadPool &pool, const ArticleTable &table) {
+    unsigned char* politics = new unsigned char[table.subjectCount > 0 ? table.subjectCount : 1];
+    for (int s = 0; s < table.subjectCount; s++)
+        politics[s] = table.subjectNames[s].find("politics") != string::npos;
+
+    const short* year = table.year;
+    const int* date = table.date;
+    const unsigned short* subjectId = table.subjectId;
+    const unsigned long long* fakeBits = table.fakeBits;
+    int rowCount = table.rowCount;
+    int blockCount = (rowCount + REDUCE_GRAIN - 1) / REDUCE_GRAIN;
+    MonthCounts counts = parallelReduce(pool, 0, blockCount, MonthCounts{},
+        [&](int block) {
+            MonthCounts c = {};
+            int end = min(rowCount, (block + 1) * REDUCE_GRAIN);
+            for (int i = block * REDUCE_GRAIN; i < end; i++) {
+                int match = (year[i] == 2016) & politics[subjectId[i]] & (date[i] != 0);
+                int month = match * (date[i] / 100 % 100);
+                c.total[month] += match;
+                c.fake[month] += match & static_cast<int>(fakeBits[i >> 6] >> (i & 63));
+            }
+            return c;
+        },
+        [](const MonthCounts &a, const MonthCounts &b) {
+            MonthCounts c;
+            for (int m = 0; m < 13; m++) {
+                c.total[m] = a.total[m] + b.total[m];
+                c.fake[m] = a.fake[m] + b.fake[m];
+            }
+            return c;
+        }, 1);
+    delete[] politics;
+    const int* total = counts.total;
+    const int* fake = counts.fake;
+
+    cout << "=== Percentage for Fake Political News by Month (Baseline: Linear Scan) ===" << endl;
+    for (int m = 1; m <= 12; m++) {
+        if (total[m] > 0) {
+            double percentage = (static_cast<double>(fake[m]) / total[m]) * 100.0;
+            // Number of stars is the integer part of the percentage
+            int starCount = static_cast<int>(percentage);
+
+            cout << "Month " << m << ": ";
+            // Print stars
+            for (int s = 0; s < starCount; s++) {
+                cout << "*";
+            }
+            // Print percentage with 4 decimal places (optional)
+            cout << " " << fixed << setprecision(4) << percentage << "%" << endl;
+        } else {
+            cout << "Month " << m << ": No data" << endl;
+        }
+    }
+}
+
+// ----------------------------------------------------------------
+// percentageByMonthCube: The report read from the aggregate cube
+// (politics in 2016 broken down by month, then FAKE only).
+// ----------------------------------------------------------------
+void percentageByMonthCube(const AggregateCube &cube) {
+    cout << "=== Percentage for Fake Political News by Month (Aggregate Cube) ===" << endl;
+    CubeSlice politics2016;
+    politics2016.subject = "politics";
+    politics2016.fromYear = politics2016.toYear = 2016;
+    int total[CUBE_MONTHS];
+    int fake[CUBE_MONTHS];
+    cubeBreakdown(cube, politics2016, CUBE_BY_MONTH, total);
+    politics2016.label = 0;
+    cubeBreakdown(cube, politics2016, CUBE_BY_MONTH, fake);
+    for (int m = 1; m <= 12; m++) {
+        if (total[m] > 0) {
+            double percentage = (static_cast<double>(fake[m]) / total[m]) * 100.0;
+            int starCount = static_cast<int>(percentage);
+
+            cout << "Month " << m << ": ";
+            for (int s = 0; s < starCount; s++) {
+                cout << "*";
+            }
+            cout << " " << fixed << setprecision(4) << percentage << "%" << endl;
+        } else {
+            cout << "Month " << m << ": No data" << endl;
+        }
+    }
+}
+
+// ----------------------------------------------------------------
+// displayArticleGroups: Article counts and fake share per year and
+// per subject, from the group-by operator over every row. cout's
+// format is restored after.
+// ----------------------------------------------------------------
+void displayArticleGroups(News *articles, int count, const ArticleTable &table) {
+    ios_base::fmtflags savedFlags = cout.flags();
+    streamsize savedPrecision = cout.precision();
+    int* rows = new int[count > 0 ? count : 1];
+    for (int i = 0; i < count; i++)
+        rows[i] = i;
+
+    GroupTable byYear = groupBy(articles, rows, count, [articles](int row) { return articles[row].year; });
+    cout << "\n=== Articles by Year (group-by: " << groupStrategyName(byYear.strategy) << ") ===" << endl;
+    for (int g = 0; g < byYear.groupCount; g++) {
+        const GroupRow &group = byYear.groups[g];
+        cout << (group.key > 0 ? to_string(group.key) : "Unknown") << ": " << group.count << " articles, "
+             << group.fakeCount << " FAKE (" << fixed << setprecision(2) << group.fakeRatio() * 100.0 << "%)" << endl;
+    }
+
+    const unsigned short* subjectId = table.subjectId;
+    GroupTable bySubject = groupBy(articles, rows, count, [subjectId](int row) { return static_cast<int>(subjectId[row]); });
+    cout << "\n=== Articles by Subject (group-by: " << groupStrategyName(bySubject.strategy) << ") ===" << endl;
+    for (int g = 0; g < bySubject.groupCount; g++) {
+        const GroupRow &group = bySubject.groups[g];
+        cout << table.subjectNames[group.key] << ": " << group.count << " articles, "
+             << group.fakeCount << " FAKE (" << fixed << setprecision(2) << group.fakeRatio() * 100.0 << "%)" << endl;
+    }
+
+    cout.flags(savedFlags);
+    cout.precision(savedPrecision);
+    freeGroupTable(byYear);
+    freeGroupTable(bySubject);
+    delete[] rows;
+}
+
+// ----------------------------------------------------------------
+// Filter expressions: ad-hoc article queries such as
+//     year=2016 AND subject~politics AND label=FAKE AND date>=2016-03-01
+// A term is <field> <op> <value>. Fields: year, month, date,
+// subject, label, title, text. Ops: = != < <= > >= and ~ / !~
+// (contains / does not contain, ignoring case). Terms combine with
+// AND, OR, NOT and parentheses. Values with spaces go in double
+// quotes; dates are YYYY-MM-DD or DD-MM-YYYY.
+//
+// The expression is parsed once into a predicate tree, which is then
+// compiled into a flat plan over the ArticleTable columns. The plan
+// runs QUERY_BATCH rows at a time: each step reads a selection vector
+// (the row ids still in play) and writes a new one, so a term is one
+// tight loop over one column rather than a tree walk per row.
+// ----------------------------------------------------------------
+const int QUERY_BATCH = 1024;
+
+const int QUERY_TERM = 0;
+const int QUERY_AND = 1;
+const int QUERY_OR = 2;
+const int QUERY_NOT = 3;
+
+const int FIELD_YEAR = 0;
+const int FIELD_MONTH = 1;
+const int FIELD_DATE = 2;
+const int FIELD_SUBJECT = 3;
+const int FIELD_LABEL = 4;
+const int FIELD_TITLE = 5;
+const int FIELD_TEXT = 6;
+
+const int OP_EQ = 0;
+const int OP_NE = 1;
+const int OP_LT = 2;
+const int OP_LE = 3;
+const int OP_GT = 4;
+const int OP_GE = 5;
+const int OP_CONTAINS = 6;
+const int OP_NOT_CONTAINS = 7;
+
+const char* const QUERY_FIELD_NAMES[] = {"year", "month", "date", "subject", "label", "title", "text"};
+const char* const QUERY_OP_NAMES[] = {"=", "!=", "<", "<=", ">", ">=", "~", "!~"};
+
+struct QueryNode {
+    int type = QUERY_TERM;
+    int field = 0;                  // terms only
+    int op = 0;
+    string value;                   // lowercased for subject / title / text
+    int number = 0;                 // year, month, packed date, or 1 = FAKE
+    QueryNode* left = nullptr;      // AND / OR / NOT
+    QueryNode* right = nullptr;     // AND / OR
+};
+
+void freeQueryNode(QueryNode *node) {
+    if (!node)
+        return;
+    freeQueryNode(node->left);
+    freeQueryNode(node->right);
+    delete node;
+}
+
+// Case-insensitive substring test; 'needle' is already lowercase.
+bool containsIgnoreCase(const char *text, size_t length, const string &needle) {
+    size_t m = needle.size();
+    if (m == 0)
+        return true;
+    for (size_t i = 0; i + m <= length; i++) {
+        size_t k = 0;
+        while (k < m && tolower(static_cast<unsigned char>(text[i + k])) == needle[k])
+            k++;
+        if (k == m)
+            return true;
+    }
+    return false;
+}
+
+string toLowerCopy(string s) {
+    for (char &c : s)
+        c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+    return s;
+}
+
+// Days in a month of the Gregorian calendar.
+int daysInMonth(int year, int month) {
+    static const int days[12] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+    bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    return (month == 2 && leap) ? 29 : days[month - 1];
+}
+
+// "YYYY-MM-DD" or "DD-MM-YYYY" -> packed YYYYMMDD (0 if malformed,
+// -1 if well formed but the day does not exist in that month).
+int parseQueryDate(const string &value) {
+    int packed;
+    if (value.size() == 10 && value[4] == '-' && value[7] == '-')
+        packed = packDate(value.substr(8, 2) + "-" + value.substr(5, 2) + "-" + value.substr(0, 4));
+    else
+        packed = packDate(value);
+    if (packed != 0 && packed % 100 > daysInMonth(packed / 10000, packed / 100 % 100))
+        return -1;
+    return packed;
+}
+
+// ----------------------------------------------------------------
+// Recursive-descent parser. Precedence: NOT, then AND, then OR.
+// Every parse function returns nullptr (with 'error' set) on failure
+// and frees whatever it had built.
+// ----------------------------------------------------------------
+struct QueryParser {
+    string text;
+    size_t pos = 0;
+    string error;
+};
+
+void skipQuerySpace(QueryParser &p) {
+    while (p.pos < p.text.size() && isspace(static_cast<unsigned char>(p.text[p.pos])))
+        p.pos++;
+}
+
+// Consume 'keyword' (any case) if it is the next whole word.
+bool acceptQueryKeyword(QueryParser &p, const char *keyword) {
+    skipQuerySpace(p);
+    size_t n = strlen(keyword);
+    if (p.pos + n > p.text.size())
+        return false;
+    for (size_t i = 0; i < n; i++) {
+        if (toupper(static_cast<unsigned char>(p.text[p.pos + i])) != keyword[i])
+            return false;
+    }
+    if (p.pos + n < p.text.size()) {
+        char next = p.text[p.pos + n];
+        if (!isspace(static_cast<unsigned char>(next)) && next != '(' && next != ')')
+            return false;
+    }
+    p.pos += n;
+    return true;
+}
+
+QueryNode* parseQueryOr(QueryParser &p);
+
+QueryNode* parseQueryTerm(QueryParser &p) {
+    skipQuerySpace(p);
+    size_t start = p.pos;
+    while (p.pos < p.text.size() && isalpha(static_cast<unsigned char>(p.text[p.pos])))
+        p.pos++;
+    string name = toLowerCopy(p.text.substr(start, p.pos - start));
+    int field = -1;
+    for (int f = FIELD_YEAR; f <= FIELD_TEXT; f++) {
+        if (name == QUERY_FIELD_NAMES[f])
+            field = f;
+    }
+    if (field < 0) {
+        p.error = name.empty() ? "expected a field at position " + to_string(start + 1)
+                               : "unknown field '" + name + "'";
+        return nullptr;
+    }
+
+    skipQuerySpace(p);
+    int op = -1;
+    for (int o = OP_NOT_CONTAINS; o >= OP_EQ; o--) {
+        size_t n = strlen(QUERY_OP_NAMES[o]);
+        if (p.text.compare(p.pos, n, QUERY_OP_NAMES[o]) == 0 && (op < 0 || n > strlen(QUERY_OP_NAMES[op])))
+            op = o;
+    }
+    if (op < 0) {
+        p.error = "expected an operator after '" + name + "'";
+        return nullptr;
+    }
+    p.pos += strlen(QUERY_OP_NAMES[op]);
+
+    skipQuerySpace(p);
+    string value;
+    if (p.pos < p.text.size() && p.text[p.pos] == '"') {
+        size_t close = p.text.find('"', p.pos + 1);
+        if (close == string::npos) {
+            p.error = "unterminated quote";
+            return nullptr;
+        }
+        value = p.text.substr(p.pos + 1, close - p.pos - 1);
+        p.pos = close + 1;
+    } else {
+        while (p.pos < p.text.size() && !isspace(static_cast<unsigned char>(p.text[p.pos]))
+               && p.text[p.pos] != '(' && p.text[p.pos] != ')')
+            value.push_back(p.text[p.pos++]);
+    }
+    if (value.empty()) {
+        p.error = "missing value for '" + name + "'";
+        return nullptr;
+    }
+
+    QueryNode* node = new QueryNode;
+    node->field = field;
+    node->op = op;
+    node->value = value;
+    bool numeric = (field == FIELD_YEAR || field == FIELD_MONTH || field == FIELD_DATE);
+    bool textOp = (op == OP_CONTAINS || op == OP_NOT_CONTAINS);
+    if (numeric) {
+        if (textOp) {
+            p.error = "'" + name + "' takes = != < <= > >=";
+        } else if (field == FIELD_DATE) {
+            node->number = parseQueryDate(value);
+            if (node->number == 0)
+                p.error = "bad date '" + value + "' (use YYYY-MM-DD)";
+            else if (node->number == -1)
+                p.error = "bad date '" + value + "' (no such day in that month)";
+        } else {
+            bool digits = value.size() <= 6;
+            for (char c : value)
+                digits = digits && isdigit(static_cast<unsigned char>(c));
+            node->number = digits ? stoi(value) : 0;
+            if (!digits || (field == FIELD_MONTH && (node->number < 1 || node->number > 12)))
+                p.error = "bad " + name + " '" + value + "'";
+        }
+    } else if (field == FIELD_LABEL) {
+        string label = toLowerCopy(value);
+        if ((op != OP_EQ && op != OP_NE) || (label != "fake" && label != "true"))
+            p.error = "use label=FAKE, label=TRUE or label!=...";
+        node->number = (label == "fake") ? 1 : 0;
+    } else {
+        if (op != OP_EQ && op != OP_NE && !textOp)
+            p.error = "'" + name + "' takes = != ~ !~";
+        if (field != FIELD_SUBJECT && !textOp)
+            p.error = "'" + name + "' takes ~ or !~";
+        node->value = toLowerCopy(value);
+    }
+    if (!p.error.empty()) {
+        freeQueryNode(node);
+        return nullptr;
+    }
+    return node;
+}
+
+QueryNode* parseQueryUnary(QueryParser &p) {
+    if (acceptQueryKeyword(p, "NOT")) {
+        QueryNode* child = parseQueryUnary(p);
+        if (!child)
+            return nullptr;
+        QueryNode* node = new QueryNode;
+        node->type = QUERY_NOT;
+        node->left = child;
+        return node;
+    }
+    skipQuerySpace(p);
+    if (p.pos < p.text.size() && p.text[p.pos] == '(') {
+        p.pos++;
+        QueryNode* inner = parseQueryOr(p);
+        if (!inner)
+            return nullptr;
+        skipQuerySpace(p);
+        if (p.pos >= p.text.size() || p.text[p.pos] != ')') {
+            p.error = "missing ')'";
+            freeQueryNode(inner);
+            return nullptr;
+        }
+        p.pos++;
+        return inner;
+    }
+    return parseQueryTerm(p);
+}
+
+// One binary level of the grammar: operand (KEYWORD operand)*
+QueryNode* parseQueryChain(QueryParser &p, const char *keyword, int type, QueryNode* (*operand)(QueryParser &)) {
+    QueryNode* left = operand(p);
+    while (left && acceptQueryKeyword(p, keyword)) {
+        QueryNode* right = operand(p);
+        if (!right) {
+            freeQueryNode(left);
+            return nullptr;
+        }
+        QueryNode* node = new QueryNode;
+        node->type = type;
+        node->left = left;
+        node->right = right;
+        left = node;
+    }
+    return left;
+}
+
+QueryNode* parseQueryAnd(QueryParser &p) {
+    return parseQueryChain(p, "AND", QUERY_AND, parseQueryUnary);
+}
+
+QueryNode* parseQueryOr(QueryParser &p) {
+    return parseQueryChain(p, "OR", QUERY_OR, parseQueryAnd);
+}
+
+// ----------------------------------------------------------------
+// parseQuery: Parse a whole expression. Returns nullptr and sets
+// 'error' if it is not valid.
+// ----------------------------------------------------------------
+QueryNode* parseQuery(const string &text, string &error) {
+    QueryParser p;
+    p.text = text;
+    QueryNode* root = parseQueryOr(p);
+    skipQuerySpace(p);
+    if (root && p.pos < p.text.size()) {
+        p.error = "unexpected '" + p.text.substr(p.pos) + "'";
+        freeQueryNode(root);
+        root = nullptr;
+    }
+    error = p.error;
+    return root;
+}
+
+// ----------------------------------------------------------------
+// queryMatches: Row-at-a-time evaluation of the predicate tree on one
+// article (the baseline the compiled plan is timed against). Rows
+// without a valid date or year fail every comparison except !=.
+// ----------------------------------------------------------------
+bool compareQueryNumber(int x, int op, int value) {
+    if (x == 0)
+        return op == OP_NE;
+    switch (op) {
+        case OP_EQ: return x == value;
+        case OP_NE: return x != value;
+        case OP_LT: return x < value;
+        case OP_LE: return x <= value;
+        case OP_GT: return x > value;
+        default:    return x >= value;
+    }
+}
+
+bool queryMatches(const QueryNode *node, const News &article) {
+    switch (node->type) {
+        case QUERY_AND: return queryMatches(node->left, article) && queryMatches(node->right, article);
+        case QUERY_OR:  return queryMatches(node->left, article) || queryMatches(node->right, article);
+        case QUERY_NOT: return !queryMatches(node->left, article);
+    }
+    bool negate = (node->op == OP_NE || node->op == OP_NOT_CONTAINS);
+    switch (node->field) {
+        case FIELD_YEAR:
+            return compareQueryNumber(article.year, node->op, node->number);
+        case FIELD_MONTH:
+            return compareQueryNumber(packDate(article.date) / 100 % 100, node->op, node->number);
+        case FIELD_DATE:
+            return compareQueryNumber(packDate(article.date), node->op, node->number);
+        case FIELD_LABEL:
+            return ((!article.isTrue) == (node->number == 1)) != negate;
+        case FIELD_SUBJECT:
+            if (node->op == OP_EQ || node->op == OP_NE)
+                return (toLowerCopy(article.subject) == node->value) != negate;
+            return containsIgnoreCase(article.subject.data(), article.subject.size(), node->value) != negate;
+        case FIELD_TITLE:
+            return containsIgnoreCase(article.title.data(), article.title.size(), node->value) != negate;
+        default:
+            return containsIgnoreCase(article.text.data(), article.text.size(), node->value) != negate;
+    }
+}
+
+int* queryArticlesRowByRow(News *articles, int count, const QueryNode *root, int &matchCount) {
+    int* rows = new int[count > 0 ? count : 1];
+    matchCount = 0;
+    for (int i = 0; i < count; i++) {
+        if (queryMatches(root, articles[i]))
+            rows[matchCount++] = i;
+    }
+    return rows;
+}
+
+// ----------------------------------------------------------------
+// Query plan. Register 0 holds the rows of the current batch; every
+// step writes its own register:
+//   FILTER  out = rows of 'input' that pass one term (one column)
+//   EXCEPT  out = input minus other (other is a subset of input)
+//   UNION   out = input merged with other (disjoint, both sorted)
+// AND feeds the left result into the right term, OR runs the right
+// side only on the rows the left side rejected, and NOT subtracts
+// its child from its input. The cheap column terms of an AND go
+// before title / text scans.
+// ----------------------------------------------------------------
+const int STEP_FILTER = 0;
+const int STEP_EXCEPT = 1;
+const int STEP_UNION = 2;
+
+struct QueryStep {
+    int kind = STEP_FILTER;
+    int input = 0;
+    int other = 0;
+    int output = 0;
+    int field = 0;
+    int lo = 0, hi = 0;         // year / month / date range, FAKE bit in lo
+    bool negate = false;
+    bool* subjectMask = nullptr;    // [subject id], subject filters only
+    string needle;              // title / text, lowercase
+};
+
+struct QueryPlan {
+    QueryStep* steps = nullptr;
+    int stepCount = 0;
+    int registerCount = 1;
+    int result = 0;             // register holding the matches
+};
+
+int countQuerySteps(const QueryNode *node) {
+    switch (node->type) {
+        case QUERY_AND: return countQuerySteps(node->left) + countQuerySteps(node->right);
+        case QUERY_OR:  return countQuerySteps(node->left) + countQuerySteps(node->right) + 2;
+        case QUERY_NOT: return countQuerySteps(node->left) + 1;
+        default:        return 1;
+    }
+}
+
+// Number of title / text scans under a node, used to order AND
+// operands: a string scan costs far more than a column compare.
+int queryCost(const QueryNode *node) {
+    if (node->type == QUERY_TERM)
+        return (node->field == FIELD_TITLE || node->field == FIELD_TEXT) ? 1 : 0;
+    return queryCost(node->left) + (node->right ? queryCost(node->right) : 0);
+}
+
+int addQueryStep(QueryPlan &plan, int kind, int input, int other) {
+    QueryStep &step = plan.steps[plan.stepCount++];
+    step.kind = kind;
+    step.input = input;
+    step.other = other;
+    step.output = plan.registerCount++;
+    return step.output;
+}
+
+int compileQueryNode(const QueryNode *node, int input, const ArticleTable &table, QueryPlan &plan) {
+    if (node->type == QUERY_AND) {
+        const QueryNode* first = node->left;
+        const QueryNode* second = node->right;
+        if (queryCost(first) > queryCost(second))
+            swap(first, second);
+        return compileQueryNode(second, compileQueryNode(first, input, table, plan), table, plan);
+    }
+    if (node->type == QUERY_OR) {
+        int left = compileQueryNode(node->left, input, table, plan);
+        int rest = addQueryStep(plan, STEP_EXCEPT, input, left);
+        int right = compileQueryNode(node->right, rest, table, plan);
+        return addQueryStep(plan, STEP_UNION, left, right);
+    }
+    if (node->type == QUERY_NOT) {
+        int child = compileQueryNode(node->left, input, table, plan);
+        return addQueryStep(plan, STEP_EXCEPT, input, child);
+    }
+
+    int output = addQueryStep(plan, STEP_FILTER, input, 0);
+    QueryStep &step = plan.steps[plan.stepCount - 1];
+    step.field = node->field;
+    step.negate = (node->op == OP_NE || node->op == OP_NOT_CONTAINS);
+    if (node->field == FIELD_YEAR || node->field == FIELD_MONTH || node->field == FIELD_DATE) {
+        // Every comparison becomes an inclusive range; 0 (unknown) is never inside it.
+        int value = node->number;
+        step.lo = 1;
+        step.hi = INT_MAX;
+        switch (node->op) {
+            case OP_EQ: case OP_NE: step.lo = step.hi = value; break;
+            case OP_LT: step.hi = value - 1; break;
+            case OP_LE: step.hi = value; break;
+            case OP_GT: step.lo = value + 1; break;
+            case OP_GE: step.lo = value; break;
+        }
+    } else if (node->field == FIELD_LABEL) {
+        step.lo = node->number;
+    } else if (node->field == FIELD_SUBJECT) {
+        // Resolve the subject test against the dictionary once.
+        bool exact = (node->op == OP_EQ || node->op == OP_NE);
+        step.subjectMask = new bool[table.subjectCount > 0 ? table.subjectCount : 1];
+        for (int s = 0; s < table.subjectCount; s++) {
+            const string &name = table.subjectNames[s];
+            bool match = exact ? toLowerCopy(name) == node->value
+                               : containsIgnoreCase(name.data(), name.size(), node->value);
+            step.subjectMask[s] = match != step.negate;
+        }
+        step.negate = false;
+    } else {
+        step.needle = node->value;
+    }
+    return output;
+}
+
+// ----------------------------------------------------------------
+// compileQuery: Turn a predicate tree into a plan for 'table'.
+// ----------------------------------------------------------------
+QueryPlan compileQuery(const QueryNode *root, const ArticleTable &table) {
+    QueryPlan plan;
+    plan.steps = new QueryStep[countQuerySteps(root)];
+    plan.result = compileQueryNode(root, 0, table, plan);
+    return plan;
+}
+
+void freeQueryPlan(QueryPlan &plan) {
+    for (int i = 0; i < plan.stepCount; i++)
+        delete[] plan.steps[i].subjectMask;
+    delete[] plan.steps;
+    plan = QueryPlan();
+}
+
+void printQueryPlan(const QueryPlan &plan) {
+    cout << "Query plan (" << plan.stepCount << " steps):" << endl;
+    for (int i = 0; i < plan.stepCount; i++) {
+        const QueryStep &step = plan.steps[i];
+        cout << "  r" << step.output << " = ";
+        if (step.kind == STEP_EXCEPT) {
+            cout << "r" << step.input << " EXCEPT r" << step.other << endl;
+            continue;
+        }
+        if (step.kind == STEP_UNION) {
+            cout << "r" << step.input << " UNION r" << step.other << endl;
+            continue;
+        }
+        cout << "r" << step.input << " WHERE " << (step.negate ? "NOT " : "") << QUERY_FIELD_NAMES[step.field];
+        if (step.field == FIELD_SUBJECT)
+            cout << " in subject mask";
+        else if (step.field == FIELD_LABEL)
+            cout << " is " << (step.lo ? "FAKE" : "TRUE");
+        else if (step.field == FIELD_TITLE || step.field == FIELD_TEXT)
+            cout << " contains \"" << step.needle << "\"";
+        else
+            cout << " in [" << step.lo << ", " << step.hi << "]";
+        cout << endl;
+    }
+}
+
+// One FILTER step over a selection vector. Writes every row id and
+// advances past the ones that pass, so the column loops do not branch.
+int runQueryFilter(const QueryStep &step, const News *articles, const ArticleTable &table, const int *in, int n, int *out) {
+    int j = 0;
+    bool negate = step.negate;
+    if (step.field <= FIELD_DATE && step.lo > step.hi) {
+        if (negate)
+            memcpy(out, in, n * sizeof(int));
+        return negate ? n : 0;
+    }
+    unsigned int lo = static_cast<unsigned int>(step.lo);
+    unsigned int width = static_cast<unsigned int>(step.hi) - lo;
+    switch (step.field) {
+        case FIELD_YEAR: {
+            const short* year = table.year;
+            for (int i = 0; i < n; i++) {
+                int r = in[i];
+                out[j] = r;
+                j += ((static_cast<unsigned int>(year[r]) - lo <= width) != negate);
+            }
+            break;
+        }
+        case FIELD_MONTH: {
+            const int* date = table.date;
+            for (int i = 0; i < n; i++) {
+                int r = in[i];
+                out[j] = r;
+                j += ((static_cast<unsigned int>(date[r] / 100 % 100) - lo <= width) != negate);
+            }
+            break;
+        }
+        case FIELD_DATE: {
+            const int* date = table.date;
+            for (int i = 0; i < n; i++) {
+                int r = in[i];
+                out[j] = r;
+                j += ((static_cast<unsigned int>(date[r]) - lo <= width) != negate);
+            }
+            break;
+        }
+        case FIELD_SUBJECT: {
+            const unsigned short* subjectId = table.subjectId;
+            const bool* mask = step.subjectMask;
+            for (int i = 0; i < n; i++) {
+                int r = in[i];
+                out[j] = r;
+                j += mask[subjectId[r]];
+            }
+            break;
+        }
+        case FIELD_LABEL: {
+            const unsigned long long* bits = table.fakeBits;
+            for (int i = 0; i < n; i++) {
+                int r = in[i];
+                out[j] = r;
+                j += ((((bits[r >> 6] >> (r & 63)) & 1) == lo) != negate);
+            }
+            break;
+        }
+        case FIELD_TITLE:
+            for (int i = 0; i < n; i++) {
+                int r = in[i];
+                out[j] = r;
+                const string &title = articles[r].title;
+                j += (containsIgnoreCase(title.data(), title.size(), step.needle) != negate);
+            }
+            break;
+        default:
+            for (int i = 0; i < n; i++) {
+                int r = in[i];
+                out[j] = r;
+                const string &text = articles[r].text;
+                j += (containsIgnoreCase(text.data(), text.size(), step.needle) != negate);
+            }
+            break;
+    }
+    return j;
+}
+
+// ----------------------------------------------------------------
+// runQueryPlan: Matching row ids in ascending order (caller must
+// delete[]). Each batch's registers are reused by the next batch.
+// ----------------------------------------------------------------
+int* runQueryPlan(const QueryPlan &plan, const News *articles, const ArticleTable &table, int &matchCount) {
+    int n = table.rowCount;
+    int* results = new int[n > 0 ? n : 1];
+    int* registers = new int[plan.registerCount * QUERY_BATCH];
+    int* sizes = new int[plan.registerCount];
+    matchCount = 0;
+    for (int start = 0; start < n; start += QUERY_BATCH) {
+        int end = (start + QUERY_BATCH < n) ? start + QUERY_BATCH : n;
+        for (int r = start; r < end; r++)
+            registers[r - start] = r;
+        sizes[0] = end - start;
+
+        for (int s = 0; s < plan.stepCount; s++) {
+            const QueryStep &step = plan.steps[s];
+            const int* in = registers + step.input * QUERY_BATCH;
+            const int* other = registers + step.other * QUERY_BATCH;
+            int* out = registers + step.output * QUERY_BATCH;
+            int inSize = sizes[step.input], otherSize = sizes[step.other];
+            int j = 0;
+            if (step.kind == STEP_FILTER) {
+                j = runQueryFilter(step, articles, table, in, inSize, out);
+            } else if (step.kind == STEP_EXCEPT) {
+                int k = 0;
+                for (int i = 0; i < inSize; i++) {
+                    if (k < otherSize && other[k] == in[i])
+                        k++;
+                    else
+                        out[j++] = in[i];
+                }
+            } else {
+                int a = 0, b = 0;
+                while (a < inSize && b < otherSize)
+                    out[j++] = (in[a] < other[b]) ? in[a++] : other[b++];
+                while (a < inSize)
+                    out[j++] = in[a++];
+                while (b < otherSize)
+                    out[j++] = other[b++];
+            }
+            sizes[step.output] = j;
+        }
+
+        memcpy(results + matchCount, registers + plan.result * QUERY_BATCH, sizes[plan.result] * sizeof(int));
+        matchCount += sizes[plan.result];
+    }
+    delete[] registers;
+    delete[] sizes;
+    return results;
+}
+
+// ----------------------------------------------------------------
+// Fake-share time series: fake / total article counts per period for
+// every subject (plus one "all subjects" series) across the whole
+// archive. One pass over the ArticleTable columns fills the monthly
+// and the weekly series together. Weeks start on Monday.
+// ----------------------------------------------------------------
+struct TimeSeries {
+    bool weekly = false;
+    int firstPeriod = 0;        // year * 12 + month - 1, or Monday-based week number
+    int periodCount = 0;
+    int seriesCount = 0;        // subjectCount + 1; the last series is all subjects
+    int* total = nullptr;       // [series * periodCount + period]
+    int* fake = nullptr;
+};
+
+// Days since 1970-01-01 for a packed YYYYMMDD date (proleptic
+// Gregorian calendar).
+int daySerial(int packed) {
+    int y = packed / 10000, m = packed / 100 % 100, d = packed % 100;
+    y -= (m <= 2);
+    int era = (y >= 0 ? y : y - 399) / 400;
+    int yearOfEra = y - era * 400;
+    int dayOfYear = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    int dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + dayOfEra - 719468;
+}
+
+// Inverse of daySerial: packed YYYYMMDD.
+int dateFromSerial(int serial) {
+    serial += 719468;
+    int era = (serial >= 0 ? serial : serial - 146096) / 146097;
+    int dayOfEra = serial - era * 146097;
+    int yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    int dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    int mp = (5 * dayOfYear + 2) / 153;
+    int d = dayOfYear - (153 * mp + 2) / 5 + 1;
+    int m = mp + (mp < 10 ? 3 : -9);
+    int y = yearOfEra + era * 400 + (m <= 2);
+    return y * 10000 + m * 100 + d;
+}
+
+// 1970-01-01 was a Thursday, so shifting by 3 days makes weeks start
+// on Monday. Floor division keeps earlier dates on the right week.
+int weekNumber(int packed) {
+    int shifted = daySerial(packed) + 3;
+    return (shifted >= 0) ? shifted / 7 : (shifted - 6) / 7;
+}
+
+int monthNumber(int packed) {
+    return (packed / 10000) * 12 + packed / 100 % 100 - 1;
+}
+
+void initTimeSeries(TimeSeries &series, bool weekly, int first, int last, int seriesCount) {
+    series.weekly = weekly;
+    series.firstPeriod = first;
+    series.periodCount = last - first + 1;
+    series.seriesCount = seriesCount;
+    series.total = new int[seriesCount * series.periodCount]();
+    series.fake = new int[seriesCount * series.periodCount]();
+}
+
+void freeTimeSeries(TimeSeries &series) {
+    delete[] series.total;
+    delete[] series.fake;
+    series = TimeSeries();
+}
+
+// ----------------------------------------------------------------
+// buildTimeSeries: Size both series from the first and last valid
+// date, then add every dated article to its subject and to the "all
+// subjects" series, monthly and weekly, in the same pass.
+// ----------------------------------------------------------------
+void buildTimeSeries(const ArticleTable &table, TimeSeries &monthly, TimeSeries &weekly) {
+    int minDate = 0, maxDate = 0;
+    for (int i = 0; i < table.rowCount; i++) {
+        int date = table.date[i];
+        if (date == 0)
+            continue;
+        if (minDate == 0 || date < minDate) minDate = date;
+        if (date > maxDate) maxDate = date;
+    }
+    if (minDate == 0)
+        return;
+
+    int seriesCount = table.subjectCount + 1;
+    int all = table.subjectCount;
+    initTimeSeries(monthly, false, monthNumber(minDate), monthNumber(maxDate), seriesCount);
+    initTimeSeries(weekly, true, weekNumber(minDate), weekNumber(maxDate), seriesCount);
+    for (int i = 0; i < table.rowCount; i++) {
+        int date = table.date[i];
+        if (date == 0)
+            continue;
+        int isFake = static_cast<int>((table.fakeBits[i >> 6] >> (i & 63)) & 1);
+        int m = monthNumber(date) - monthly.firstPeriod;
+        int w = weekNumber(date) - weekly.firstPeriod;
+        int subjectMonth = table.subjectId[i] * monthly.periodCount + m;
+        int subjectWeek = table.subjectId[i] * weekly.periodCount + w;
+        int allMonth = all * monthly.periodCount + m;
+        int allWeek = all * weekly.periodCount + w;
+        monthly.total[subjectMonth]++;
+        monthly.fake[subjectMonth] += isFake;
+        monthly.total[allMonth]++;
+        monthly.fake[allMonth] += isFake;
+        weekly.total[subjectWeek]++;
+        weekly.fake[subjectWeek] += isFake;
+        weekly.total[allWeek]++;
+        weekly.fake[allWeek] += isFake;
+    }
+}
+
+// "2016-03" for a month, the Monday's date ("2016-02-29") for a week.
+string periodLabel(const TimeSeries &series, int period) {
+    int n = series.firstPeriod + period;
+    char label[16];
+    if (series.weekly) {
+        int date = dateFromSerial(n * 7 - 3);
+        snprintf(label, sizeof(label), "%04d-%02d-%02d", date / 10000, date / 100 % 100, date % 100);
+    } else {
+        snprintf(label, sizeof(label), "%04d-%02d", n / 12, n % 12 + 1);
+    }
+    return label;
+}
+
+// ----------------------------------------------------------------
+// rollingFakeShare: Fake share over the 'window' periods ending at
+// each period (total fake / total articles in the window, so quiet
+// periods weigh less). The window sums are updated with one add and
+// one subtract per step. Periods whose window is empty get -1.
+// ----------------------------------------------------------------
+void rollingFakeShare(const TimeSeries &series, int seriesIndex, int window, double *out) {
+    const int* total = series.total + seriesIndex * series.periodCount;
+    const int* fake = series.fake + seriesIndex * series.periodCount;
+    long long windowTotal = 0, windowFake = 0;
+    for (int p = 0; p < series.periodCount; p++) {
+        windowTotal += total[p];
+        windowFake += fake[p];
+        if (p >= window) {
+            windowTotal -= total[p - window];
+            windowFake -= fake[p - window];
+        }
+        out[p] = (windowTotal > 0) ? static_cast<double>(windowFake) / windowTotal : -1.0;
+    }
+}
+
+// ----------------------------------------------------------------
+// displayTimeSeries: ASCII plot of one series, one line per period:
+// the bar is the period's fake share (one '*' per 2%), followed by
+// the share and the rolling share. cout's format is restored after.
+// ----------------------------------------------------------------
+void displayTimeSeries(const TimeSeries &series, const ArticleTable &table, int seriesIndex, int window) {
+    ios_base::fmtflags savedFlags = cout.flags();
+    streamsize savedPrecision = cout.precision();
+    string name = (seriesIndex == table.subjectCount) ? "All subjects" : table.subjectNames[seriesIndex];
+    cout << "\n=== Fake News Share by " << (series.weekly ? "Week" : "Month") << ": " << name
+         << " (rolling " << window << ") ===" << endl;
+    double* rolling = new double[series.periodCount > 0 ? series.periodCount : 1];
+    rollingFakeShare(series, seriesIndex, window, rolling);
+    for (int p = 0; p < series.periodCount; p++) {
+        int total = series.total[seriesIndex * series.periodCount + p];
+        int fake = series.fake[seriesIndex * series.periodCount + p];
+        cout << setw(10) << left << periodLabel(series, p) << right << " | ";
+        if (total == 0) {
+            cout << "no articles";
+        } else {
+            double percentage = 100.0 * fake / total;
+            cout << setw(50) << left << string(static_cast<int>(percentage / 2), '*') << right
+                 << " " << fixed << setprecision(1) << setw(5) << percentage << "%";
+        }
+        if (rolling[p] >= 0)
+            cout << "  rolling " << fixed << setprecision(1) << setw(5) << rolling[p] * 100.0 << "%";
+        cout << endl;
+    }
+    cout.flags(savedFlags);
+    cout.precision(savedPrecision);
+    delete[] rolling;
+}
+
+// ----------------------------------------------------------------
+// writeTimeSeriesCsv: Every series (each subject, then all subjects)
+// as CSV rows: period,subject,total,fake,fake_share,rolling_share.
+// Shares are fractions; empty periods leave the share blank.
+// ----------------------------------------------------------------
+bool writeTimeSeriesCsv(const TimeSeries &series, const ArticleTable &table, int window, const string &filename) {
+    ofstream out(filename);
+    if (!out)
+        return false;
+    out << "period,subject,total,fake,fake_share,rolling_share" << endl;
+    double* rolling = new double[series.periodCount > 0 ? series.periodCount : 1];
+    for (int s = 0; s < series.seriesCount; s++) {
+        string name = (s == table.subjectCount) ? "ALL" : table.subjectNames[s];
+        rollingFakeShare(series, s, window, rolling);
+        for (int p = 0; p < series.periodCount; p++) {
+            int total = series.total[s * series.periodCount + p];
+            int fake = series.fake[s * series.periodCount + p];
+            out << periodLabel(series, p) << ",\"" << name << "\"," << total << "," << fake << ",";
+            if (total > 0)
+                out << fixed << setprecision(4) << static_cast<double>(fake) / total;
+            out << ",";
+            if (rolling[p] >= 0)
+                out << fixed << setprecision(4) << rolling[p];
+            out << "\n";
+        }
+    }
+    delete[] rolling;
+    return true;
+}
+
+// ----------------------------------------------------------------
+// Script mode: run a list of operations against one loaded dataset
+// without the menu and print the results and timings as JSON.
+// Operations come from the command line (--run "top 10") or a
+// script file (--script FILE, one per line, '#' starts a comment);
+// --out FILE writes the JSON to a file instead of standard output.
+//   sort merge|quick|insertion    sort a copy of the articles by year
+//   search YEAR                   articles published in YEAR (year index)
+//   percentage [YEAR] [SUBJECT]   fake share of SUBJECT in YEAR by month
+//                                 (default 2016 politics)
+//   top N                         N most frequent terms in fake government
+//                                 news, from the inverted index
+// ----------------------------------------------------------------
+struct BatchJob {
+    string* ops = nullptr;
+    int opCount = 0;
+    int opCapacity = 0;
+    string outFile;     // empty = standard output
+};
+
+void addBatchOp(BatchJob &job, const string &op) {
+    if (job.opCount == job.opCapacity) {
+        int capacity = job.opCapacity ? job.opCapacity * 2 : 16;
+        string* larger = new string[capacity];
+        for (int i = 0; i < job.opCount; i++)
+            larger[i] = job.ops[i];
+        delete[] job.ops;
+        job.ops = larger;
+        job.opCapacity = capacity;
+    }
+    job.ops[job.opCount++] = op;
+}
+
+// ----------------------------------------------------------------
+// parseBatchArgs: Collect the operations from the command line and
+// script files. Returns false (with a message) on a bad argument or
+// an unreadable script.
+// ----------------------------------------------------------------
+bool parseBatchArgs(int argc, char const *argv[], BatchJob &job, string &error) {
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if ((arg == "--run" || arg == "--script" || arg == "--out") && i + 1 >= argc) {
+            error = arg + " needs a value";
+            return false;
+        }
+        if (arg == "--run") {
+            addBatchOp(job, argv[++i]);
+        } else if (arg == "--out") {
+            job.outFile = argv[++i];
+        } else if (arg == "--script") {
+            ifstream script(argv[++i]);
+            if (!script) {
+                error = string("Cannot open script ") + argv[i];
+                return false;
+            }
+            string line;
+            while (getline(script, line)) {
+                size_t hash = line.find('#');
+                if (hash != string::npos)
+                    line.erase(hash);
+                size_t first = line.find_first_not_of(" \t\r");
+                if (first == string::npos)
+                    continue;
+                line = line.substr(first, line.find_last_not_of(" \t\r") - first + 1);
+                addBatchOp(job, line);
+            }
+        } else {
+            error = "Unknown argument: " + arg;
+            return false;
+        }
+    }
+    if (job.opCount == 0) {
+        error = "No operations given";
+        return false;
+    }
+    return true;
+}
+
+string jsonEscape(const string &text) {
+    string out;
+    for (unsigned char c : text) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += static_cast<char>(c);
+        } else if (c < 0x20) {
+            char code[8];
+            snprintf(code, sizeof(code), "\\u%04x", c);
+            out += code;
+        } else {
+            out += static_cast<char>(c);
+        }
+    }
+    return out;
+}
+
+// Fake share as a JSON number with 4 decimals, or null.
+string jsonShare(int fake, int total) {
+    if (total == 0)
+        return "null";
+    char number[32];
+    snprintf(number, sizeof(number), "%.4f", 100.0 * fake / total);
+    return number;
+}
+
+// ----------------------------------------------------------------
+// topIndexTerms: The topN terms with the most occurrences in the
+// articles flagged in 'selected', summed from the term frequencies
+// of the posting lists (no article is tokenized again). Ties go to
+// the alphabetically smaller term. Returns a new array of term ids
+// (caller must delete[]) and sets resultCount.
+// ----------------------------------------------------------------
+int* topIndexTerms(const InvertedIndex &index, const bool *selected, int topN, long long *topCounts, int &resultCount) {
+    int* topIds = new int[topN];
+    resultCount = 0;
+    int* tfs = new int[index.docCount > 0 ? index.docCount : 1];
+    for (int t = 0; t < index.termCount; t++) {
+        const PostingList &list = index.postings[t];
+        int* docs = decodePostings(list, tfs);
+        long long total = 0;
+        for (int i = 0; i < list.docFreq; i++) {
+            if (selected[docs[i]])
+                total += tfs[i];
+        }
+        delete[] docs;
+        if (total == 0)
+            continue;
+
+        // Insert into the sorted top list, dropping the weakest when full.
+        int pos = resultCount;
+        while (pos > 0 && (topCounts[pos - 1] < total ||
+                           (topCounts[pos - 1] == total && index.terms[topIds[pos - 1]] > index.terms[t])))
+            pos--;
+        if (pos >= topN)
+            continue;
+        int last = (resultCount < topN) ? resultCount++ : topN - 1;
+        for (int i = last; i > pos; i--) {
+            topIds[i] = topIds[i - 1];
+            topCounts[i] = topCounts[i - 1];
+        }
+        topIds[pos] = t;
+        topCounts[pos] = total;
+    }
+    delete[] tfs;
+    return topIds;
+}
+
+// ----------------------------------------------------------------
+// runBatchOp: Run one operation and write its JSON object.
+// Returns false if the operation could not be run.
+// ----------------------------------------------------------------
+bool runBatchOp(const string &op, News *articles, int count, const YearIndex &yearIndex,
+                const InvertedIndex &textIndex, const AggregateCube &cube, ostream &json) {
+    istringstream words(op);
+    string name;
+    words >> name;
+    json << "    {\"op\": \"" << jsonEscape(op) << "\", ";
+
+    if (name == "sort") {
+        string algorithm;
+        words >> algorithm;
+        if (algorithm != "merge" && algorithm != "quick" && algorithm != "insertion") {
+            json << "\"error\": \"algorithm must be merge, quick or insertion\"}";
+            return false;
+        }
+        // Sort a copy so every sort starts from the load order.
+        News *articlesCopy = new News[count];
+        for (int i = 0; i < count; i++)
+            articlesCopy[i] = articles[i];
+        recursionDepth = 0;
+        long long timeTaken;
+        if (algorithm == "merge")
+            timeTaken = measureEfficiency("Merge Sort", mergeSort, articlesCopy, 0, count - 1);
+        else if (algorithm == "quick")
+            timeTaken = measureEfficiency("Quick Sort", quickSort, articlesCopy, 0, count - 1);
+        else
+            timeTaken = measureEfficiency("Insertion Sort", insertionSort, articlesCopy, count);
+        bool sorted = true;
+        for (int i = 1; i < count && sorted; i++)
+            sorted = articlesCopy[i - 1].year <= articlesCopy[i].year;
+        json << "\"time_us\": " << timeTaken << ", \"result\": {\"algorithm\": \"" << algorithm
+             << "\", \"articles\": " << count << ", \"sorted\": " << (sorted ? "true" : "false");
+        if (algorithm == "quick")
+            json << ", \"recursion_depth\": " << recursionDepth;
+        json << "}}";
+        delete[] articlesCopy;
+        return true;
+    }
+
+    if (name == "search") {
+        int year = 0;
+        if (!(words >> year)) {
+            json << "\"error\": \"usage: search YEAR\"}";
+            return false;
+        }
+        auto start = high_resolution_clock::now();
+        int begin = 0, end = 0;
+        int matches = lookupYear(yearIndex, year, begin, end);
+        int fake = 0;
+        for (int i = begin; i < end; i++)
+            fake += !articles[yearIndex.order[i]].isTrue;
+        auto stop = high_resolution_clock::now();
+        json << "\"time_us\": " << duration_cast<microseconds>(stop - start).count()
+             << ", \"result\": {\"year\": " << year << ", \"matches\": " << matches
+             << ", \"fake\": " << fake << ", \"true\": " << matches - fake << "}}";
+        return true;
+    }
+
+    if (name == "percentage") {
+        int year = 2016;
+        string subject = "politics";
+        string word;
+        while (words >> word) {
+            if (word.size() <= 9 && all_of(word.begin(), word.end(), ::isdigit))
+                year = stoi(word);
+            else
+                subject = word;
+        }
+        CubeSlice slice;
+        slice.subject = subject;
+        slice.fromYear = slice.toYear = year;
+        int monthTotals[CUBE_MONTHS], monthFake[CUBE_MONTHS];
+        auto start = high_resolution_clock::now();
+        cubeBreakdown(cube, slice, CUBE_BY_MONTH, monthTotals);
+        slice.label = 0;
+        cubeBreakdown(cube, slice, CUBE_BY_MONTH, monthFake);
+        auto stop = high_resolution_clock::now();
+        int total = 0, fake = 0;
+        for (int m = 0; m < CUBE_MONTHS; m++) {
+            total += monthTotals[m];
+            fake += monthFake[m];
+        }
+        json << "\"time_us\": " << duration_cast<microseconds>(stop - start).count()
+             << ", \"result\": {\"year\": " << year << ", \"subject\": \"" << jsonEscape(subject)
+             << "\", \"total\": " << total << ", \"fake\": " << fake << ", \"percentage\": " << jsonShare(fake, total)
+             << ", \"by_month\": [";
+        for (int m = 1; m <= 12; m++) {
+            json << (m > 1 ? ", " : "") << "{\"month\": " << m << ", \"total\": " << monthTotals[m]
+                 << ", \"fake\": " << monthFake[m] << ", \"percentage\": " << jsonShare(monthFake[m], monthTotals[m]) << "}";
+        }
+        json << "]}}";
+        return true;
+    }
+
+    if (name == "top") {
+        int topN = 0;
+        if (!(words >> topN) || topN < 1) {
+            json << "\"error\": \"usage: top N\"}";
+            return false;
+        }
+        auto start = high_resolution_clock::now();
+        bool* selected = new bool[count > 0 ? count : 1];
+        for (int i = 0; i < count; i++)
+            selected[i] = !articles[i].isTrue && articles[i].subject.find("Government News") != string::npos;
+        long long* topCounts = new long long[topN];
+        int resultCount = 0;
+        int* topIds = topIndexTerms(textIndex, selected, topN, topCounts, resultCount);
+        auto stop = high_resolution_clock::now();
+        json << "\"time_us\": " << duration_cast<microseconds>(stop - start).count()
+             << ", \"result\": {\"vocabulary\": " << textIndex.termCount << ", \"stopwords_filtered\": false, \"words\": [";
+        for (int i = 0; i < resultCount; i++) {
+            json << (i > 0 ? ", " : "") << "{\"word\": \"" << jsonEscape(textIndex.terms[topIds[i]])
+                 << "\", \"count\": " << topCounts[i] << "}";
+        }
+        json << "]}}";
+        delete[] topIds;
+        delete[] topCounts;
+        delete[] selected;
+        return true;
+    }
+
+    json << "\"error\": \"unknown operation\"}";
+    return false;
+}
+
+// ----------------------------------------------------------------
+// runBatch: Run every operation of the job and write the JSON report.
+// Returns the number of operations that failed.
+// ----------------------------------------------------------------
+int runBatch(const BatchJob &job, News *articles, int count, const YearIndex &yearIndex,
+             const InvertedIndex &textIndex, const AggregateCube &cube, long long loadTime, ostream &json) {
+    int failed = 0;
+    json << "{\n  \"program\": \"arrayvideo\",\n  \"dataset\": \"DataCleaned.csv\",\n"
+         << "  \"articles\": " << count << ",\n  \"load_us\": " << loadTime << ",\n  \"operations\": [\n";
+    for (int i = 0; i < job.opCount; i++) {
+        if (!runBatchOp(job.ops[i], articles, count, yearIndex, textIndex, cube, json))
+            failed++;
+        json << (i + 1 < job.opCount ? ",\n" : "\n");
+    }
+    json << "  ],\n  \"failed\": " << failed << "\n}" << endl;
+    return failed;
+}
+
+// ----------------------------------------------------------------
+// Main Menu Loop (or script mode when operations are given on the
+// command line)
+// ----------------------------------------------------------------
+int main(int argc, char const *argv[]) {
+    BatchJob job;
+    if (argc > 1) {
+        string error;
+        if (!parseBatchArgs(argc, argv, job, error)) {
+            cerr << error << endl;
+            cerr << "Usage: arrayvideo [--script FILE] [--run \"OPERATION\"]... [--out FILE]" << endl;
+            delete[] job.ops;
+            return 2;
+        }
+    }
+    // In script mode only the JSON report is printed.
+    streambuf* stdoutBuffer = cout.rdbuf();
+    if (job.opCount > 0)
+        cout.rdbuf(nullptr);
+    auto loadStart = high_resolution_clock::now();
+
+    // The feed remembers how far the file has been read, so a refresh
+    // only loads the articles appended after that.
+    FeedState feed;
+    feed.filename = "DataCleaned.csv";
+    News* articles = nullptr;
+    int count = loadArticles(feed, articles);
+    if (count == 0) {
+        cout.rdbuf(stdoutBuffer);
+        cerr << "No articles loaded." << endl;
+        delete[] job.ops;
+        return 1;
+    }
+
+    // Build the year index once so year lookups never rescan or resort.
+    YearIndex yearIndex;
+    long long timeIndex = measureEfficiency("Year Index Build", buildYearIndex, articles, count, std::ref(yearIndex));
+    cout << "Year index built in " << timeIndex << " µs" << endl;
+    DateIndex dateIndex;
+    long long timeDateIndex = measureEfficiency("Date Index Build", buildDateIndex, articles, count, std::ref(dateIndex));
+    cout << "Date index built in " << timeDateIndex << " µs" << endl;
+    InvertedIndex textIndex;
+    long long timeTextIndex = measureEfficiency("Inverted Index Build", buildInvertedIndex, articles, count, std::ref(textIndex));
+    cout << "Inverted index built in " << timeTextIndex << " µs (" << textIndex.termCount << " terms, "
+         << textIndex.compressedBytes << " bytes of postings)" << endl;
+    FacetIndex facetIndex;
+    long long timeFacetIndex = measureEfficiency("Facet Bitmap Build", buildFacetIndex, articles, count, std::ref(facetIndex));
+    cout << "Facet bitmaps built in " << timeFacetIndex << " µs" << endl;
+    AggregateCube cube;
+    long long timeCube = measureEfficiency("Aggregate Cube Build", buildAggregateCube, articles, count, std::ref(cube));
+    cout << "Aggregate cube built in " << timeCube << " µs" << endl;
+    // Worker threads for parallelReduce; the calling thread works too.
+    int hardwareThreads = static_cast<int>(thread::hardware_concurrency());
+    ThreadPool pool(hardwareThreads > 1 ? hardwareThreads - 1 : 0);
+    ArticleTable table;
+    long long timeTable = measureEfficiency("Article Table Build", buildArticleTable, articles, count, std::ref(table));
+    cout << "Columnar article table built in " << timeTable << " µs" << endl;
+
+    int failed = 0;
+    if (job.opCount > 0) {
+        long long loadTime = duration_cast<microseconds>(high_resolution_clock::now() - loadStart).count();
+        if (job.outFile.empty()) {
+            ostream json(stdoutBuffer);
+            failed = runBatch(job, articles, count, yearIndex, textIndex, cube, loadTime, json);
+        } else {
+            ofstream json(job.outFile);
+            if (json)
+                failed = runBatch(job, articles, count, yearIndex, textIndex, cube, loadTime, json);
+            if (!json) {
+                cerr << "Cannot write " << job.outFile << endl;
+                failed = job.opCount;
+            }
+        }
+        cout.rdbuf(stdoutBuffer);
+    }
+    
+    if (feed.pendingBytes > 0)
+        cout << "Last record is not complete yet (" << feed.pendingBytes << " bytes); option 6 loads it once it is" << endl;
+
+    int mainChoice = job.opCount > 0 ? 7 : 0;
+    while (mainChoice != 7) {
+        cout << "\n==================== MAIN MENU ====================" << endl;
+        cout << "1. Sort the news articles by year" << endl;
+        cout << "2. Calculate total articles (fake and true)" << endl;
+        cout << "3. Search articles (by year or date range)" << endl;
+        cout << "4. Display percentage for fake political news by month in 2016" << endl;
+        cout << "5. Fake news share time series (all years, monthly / weekly)" << endl;
+        cout << "6. Refresh: load articles appended to " << feed.filename << endl;
+        cout << "7. Exit" << endl;
+        cout << "Enter your option: ";
+        cin >> mainChoice;
+        
+        if (mainChoice == 1) {
+            int sortChoice = 0;
+            cout << "\n--- Choose Sorting Algorithm ---" << endl;
+            cout << "1. Merge Sort" << endl;
+            cout << "2. Quick Sort" << endl;
+            cout << "3. Insertion Sort" << endl;
+            cout << "Enter your choice: ";
+            cin >> sortChoice;
+            
+            // Create a temporary copy for sorting
+            News *articlesCopy = new News[count];
+            for (int i = 0; i < count; i++)
+                articlesCopy[i] = articles[i];
+            long long timeTaken = 0;
+            size_t memoryUsed = count * sizeof(News);
+            
+            switch (sortChoice) {
+                case 1:
+                    timeTaken = measureEfficiency("Merge Sort", mergeSort, articlesCopy, 0, count - 1);
+                    cout << "\n=== Sorted Articles using Merge Sort ===" << endl;
+                    break;
+                case 2:
+                    recursionDepth = 0; // reset recursion depth
+                    timeTaken = measureEfficiency("Quick Sort", quickSort, articlesCopy, 0, count - 1);
+                    cout << "\n=== Sorted Articles using Quick Sort ===" << endl;
+                    cout << "Quick Sort Recursion Depth: " << recursionDepth << endl;
+                    break;
+                case 3:
+                    timeTaken = measureEfficiency("Insertion Sort", insertionSort, articlesCopy, count);
+                    cout << "\n=== Sorted Articles using Insertion Sort ===" << endl;
+                    break;
+                default:
+                    cout << "Invalid sorting option." << endl;
+                    delete[] articlesCopy;
+                    continue;
+            }
+            
+            traverseAndCountArticles(articlesCopy, count, cube);
+            cout << "Time Taken: " << timeTaken << " µs" << endl;
+            cout << "Memory Used: " << memoryUsed << " bytes" << endl;
+            delete[] articlesCopy;
+            
+
+        } else if (mainChoice == 2) {
+            int fakeCountCube = 0, trueCountCube = 0;
+            long long timeCube = measureEfficiency("Aggregate Cube Count", countArticlesCube, std::cref(cube),
+                                                   std::ref(fakeCountCube), std::ref(trueCountCube));
+
+            int fakeCountIter = 0, trueCountIter = 0;
+            long long timeIter = measureEfficiency("Iterative Count", countArticlesIterative, std::cref(table),
+                                                     std::ref(fakeCountIter), std::ref(trueCountIter));
+        
+            cout << "\n=== Total Articles Count ===" << endl;
+            cout << "Aggregate Cube Count: Total Articles: " << cube.total
+                 << ", TRUE: " << trueCountCube << ", FAKE: " << fakeCountCube
+                 << ", Time: " << timeCube << " µs" << endl;
+            cout << "Baseline Iterative Count: Total Articles: " << table.rowCount
+                 << ", TRUE: " << trueCountIter << ", FAKE: " << fakeCountIter 
+                 << ", Time: " << timeIter << " µs" << endl;
+
+            long long timeGroups = measureEfficiency("Group-By Year / Subject", displayArticleGroups, articles, count, std::cref(table));
+            cout << "Group-By Time: " << timeGroups << " µs" << endl;
+            
+            
+        } else if (mainChoice == 3) {
+            int searchChoice = 0;
+            cout << "\n--- Choose Search Criteria ---" << endl;
+            cout << "1. Search by year" << endl;
+            cout << "2. Search by date range" << endl;
+            cout << "3. Full-text search (AND / OR / NOT)" << endl;
+            cout << "4. Ranked full-text search" << endl;
+            cout << "5. Watchlist phrase scan" << endl;
+            cout << "6. Filter expression (e.g. year=2016 AND subject~politics AND label=FAKE)" << endl;
+            cout << "Enter your choice: ";
+            cin >> searchChoice;
+
+            if (searchChoice == 2) {
+                string fromStr, toStr, subject, label;
+                cout << "Enter start date (DD-MM-YYYY): ";
+                cin >> fromStr;
+                cout << "Enter end date (DD-MM-YYYY): ";
+                cin >> toStr;
+                cout << "Subject contains (or 'all'): ";
+                cin >> subject;
+                cout << "Label FAKE/TRUE (or 'all'): ";
+                cin >> label;
+                if (subject == "all") subject = "";
+                transform(label.begin(), label.end(), label.begin(), ::toupper);
+                if (label == "ALL") label = "";
+
+                int from = packDate(fromStr);
+                int to = packDate(toStr);
+                if (from == 0 || to == 0) {
+                    cout << "Invalid date. Please use DD-MM-YYYY." << endl;
+                    continue;
+                }
+
+                int matchCountRange = 0;
+                auto startRange = high_resolution_clock::now();
+                int* rangeIndices = queryDateRange(articles, dateIndex, from, to, subject, label, matchCountRange);
+                auto endRange = high_resolution_clock::now();
+                long long timeRange = duration_cast<microseconds>(endRange - startRange).count();
+
+                cout << "\n=== Date Range Search Results ===" << endl;
+                if (matchCountRange == 0) {
+                    cout << "No articles found between " << fromStr << " and " << toStr << endl;
+                } else {
+                    cout << "Found " << matchCountRange << " articles:" << endl;
+                    for (int i = 0; i < matchCountRange; i++) {
+                        int idx = rangeIndices[i];
+                        cout << "Title: " << articles[idx].title << ", Date: " << articles[idx].date << endl;
+                    }
+                }
+                cout << "Date Range Search Time: " << timeRange << " µs" << endl;
+                delete[] rangeIndices;
+                continue;
+            } else if (searchChoice == 3 || searchChoice == 4) {
+                string query;
+                cout << "Enter search terms: ";
+                cin >> ws;
+                getline(cin, query);
+
+                auto startText = high_resolution_clock::now();
+                int matchCountText = 0;
+                int* textIndices = nullptr;
+                const int TOP_RESULTS = 10;
+                double* textScores = nullptr;
+                if (searchChoice == 3) {
+                    textIndices = searchBoolean(textIndex, query, matchCountText);
+                } else {
+                    textIndices = new int[TOP_RESULTS];
+                    textScores = new double[TOP_RESULTS];
+                    matchCountText = searchRanked(textIndex, query, TOP_RESULTS, textIndices, textScores);
+                }
+                auto endText = high_resolution_clock::now();
+                long long timeText = duration_cast<microseconds>(endText - startText).count();
+
+                cout << "\n=== Full-Text Search Results ===" << endl;
+                if (matchCountText == 0) {
+                    cout << "No articles found for \"" << query << "\"" << endl;
+                } else {
+                    cout << "Found " << matchCountText << " articles:" << endl;
+                    for (int i = 0; i < matchCountText; i++) {
+                        int idx = textIndices[i];
+                        cout << "Title: " << articles[idx].title << ", Date: " << articles[idx].date;
+                        if (textScores)
+                            cout << ", Score: " << fixed << setprecision(4) << textScores[i];
+                        cout << endl;
+                    }
+                }
+                cout << "Full-Text Search Time: " << timeText << " µs" << endl;
+                delete[] textIndices;
+                delete[] textScores;
+                continue;
+            } else if (searchChoice == 5) {
+                string watchlistFile;
+                cout << "Enter watchlist file (one phrase per line): ";
+                cin >> ws;
+                getline(cin, watchlistFile);
+                int phraseCount = 0;
+                string* phrases = loadWatchlist(watchlistFile, phraseCount);
+                if (phraseCount == 0) {
+                    cout << "No phrases loaded." << endl;
+                    delete[] phrases;
+                    continue;
+                }
+                long long timeScan = measureEfficiency("Watchlist Scan", scanWatchlist, articles, count, phrases, phraseCount);
+                cout << "Watchlist Scan Time: " << timeScan << " µs" << endl;
+                delete[] phrases;
+                continue;
+            } else if (searchChoice == 6) {
+                string expression, error;
+                cout << "Enter filter expression: ";
+                cin >> ws;
+                getline(cin, expression);
+                QueryNode* root = parseQuery(expression, error);
+                if (!root) {
+                    cout << "Invalid expression: " << error << endl;
+                    continue;
+                }
+                QueryPlan plan = compileQuery(root, table);
+                printQueryPlan(plan);
+
+                int matchCountRows = 0;
+                auto startRows = high_resolution_clock::now();
+                int* rowMatches = queryArticlesRowByRow(articles, count, root, matchCountRows);
+                auto endRows = high_resolution_clock::now();
+                long long timeRows = duration_cast<microseconds>(endRows - startRows).count();
+
+                int matchCountPlan = 0;
+                auto startPlan = high_resolution_clock::now();
+                int* planMatches = runQueryPlan(plan, articles, table, matchCountPlan);
+                auto endPlan = high_resolution_clock::now();
+                long long timePlan = duration_cast<microseconds>(endPlan - startPlan).count();
+
+                cout << "\n=== Filter Expression Results ===" << endl;
+                if (matchCountPlan == 0) {
+                    cout << "No articles match \"" << expression << "\"" << endl;
+                } else {
+                    int fakeMatches = 0;
+                    for (int i = 0; i < matchCountPlan; i++)
+                        fakeMatches += !articles[planMatches[i]].isTrue;
+                    cout << "Found " << matchCountPlan << " articles (" << fakeMatches << " FAKE):" << endl;
+                    for (int i = 0; i < matchCountPlan; i++) {
+                        int idx = planMatches[i];
+                        cout << "Title: " << articles[idx].title << ", Date: " << articles[idx].date
+                             << ", Subject: " << articles[idx].subject << endl;
+                    }
+                }
+                cout << "Row-at-a-time Evaluation: " << matchCountRows << " matches, " << timeRows << " µs" << endl;
+                cout << "Compiled Plan Evaluation: " << matchCountPlan << " matches, " << timePlan << " µs" << endl;
+                delete[] rowMatches;
+                delete[] planMatches;
+                freeQueryPlan(plan);
+                freeQueryNode(root);
+                continue;
+            } else if (searchChoice != 1) {
+                cout << "Invalid search option." << endl;
+                continue;
+            }
+
+            // Match counts per year come straight from the index offsets.
+            cout << "\nArticles per year:" << endl;
+            for (int y = yearIndex.minYear; y <= yearIndex.maxYear; y++) {
+                int begin, end;
+                int yearCount = lookupYear(yearIndex, y, begin, end);
+                if (yearCount > 0)
+                    cout << "  " << y << ": " << yearCount << endl;
+            }
+
+            int targetYear;
+            cout << "Enter the year to search for: ";
             cin >> targetYear;
             
             // Linear Search
             cout << "\n=== Linear Search Results ===" << endl;
             int matchCountLinear = 0;
             auto startLinear = high_resolution_clock::now();
-            int* linearIndices = linearSearchByYear(articles, count, targetYear, matchCountLinear);
+            int* linearIndices = linearSearchByYear(table, targetYear, matchCountLinear);
             auto endLinear = high_resolution_clock::now();
             long long timeLinear = duration_cast<microseconds>(endLinear - startLinear).count();
             if (matchCountLinear == 0) {
@@ -544,59 +4219,117 @@ int main() {
             }
             cout << "Linear Search Time: " << timeLinear << " µs" << endl;
             delete[] linearIndices;
+
             
-            // Binary Search (requires sorted copy)
-            News *articlesSorted = new News[count];
-            for (int i = 0; i < count; i++)
-                articlesSorted[i] = articles[i];
-            recursionDepth = 0;
-            quickSort(articlesSorted, 0, count - 1);
-            auto startBinary = high_resolution_clock::now();
-            int foundIndex = binarySearchByYear(articlesSorted, 0, count - 1, targetYear);
-            auto endBinary = high_resolution_clock::now();
-            long long timeBinary = duration_cast<microseconds>(endBinary - startBinary).count();
-            if (foundIndex == -1) {
-                cout << "\n=== Binary Search Results (on sorted array) ===" << endl;
+            // Year Index Lookup (built at load time, no copy or sort per query)
+            int begin = 0, end = 0;
+            auto startIndex = high_resolution_clock::now();
+            int matchCountIndex = lookupYear(yearIndex, targetYear, begin, end);
+            auto endIndex = high_resolution_clock::now();
+            long long timeIndexLookup = duration_cast<nanoseconds>(endIndex - startIndex).count();
+            cout << "\n=== Year Index Lookup Results ===" << endl;
+            if (matchCountIndex == 0) {
                 cout << "No articles found for year " << targetYear << endl;
             } else {
-                int left = foundIndex;
-                while (left >= 0 && articlesSorted[left].year == targetYear)
-                    left--;
-                left++;
-                int right = foundIndex;
-                while (right < count && articlesSorted[right].year == targetYear)
-                    right++;
-                int matchCountBinary = right - left;
-                int* binaryIndices = new int[matchCountBinary];
-                for (int i = 0; i < matchCountBinary; i++) {
-                    binaryIndices[i] = left + i;
-                }
-                cout << "\n=== Binary Search Results (on sorted array) ===" << endl;
-                cout << "Found " << matchCountBinary << " articles:" << endl;
-                for (int i = 0; i < matchCountBinary; i++) {
-                    int idx = binaryIndices[i];
-                    cout << "Title: " << articlesSorted[idx].title << ", Year: " << articlesSorted[idx].year << endl;
+                cout << "Found " << matchCountIndex << " articles:" << endl;
+                for (int i = begin; i < end; i++) {
+                    int idx = yearIndex.order[i];
+                    cout << "Title: " << articles[idx].title << ", Year: " << articles[idx].year << endl;
                 }
-                cout << "Binary Search Time: " << timeBinary << " µs" << endl;
-                cout << "Linear Search Time: " << timeLinear << " µs" << endl;
-                delete[] binaryIndices;
             }
-            delete[] articlesSorted;
+            cout << "Year Index Lookup Time: " << timeIndexLookup << " ns" << endl;
+            cout << "Linear Search Time: " << timeLinear << " µs" << endl;
             
         } else if (mainChoice == 4) {
-            long long timeLinear = measureEfficiency("Percentage by Month (Linear)", percentageByMonthLinear, articles, count);
-            long long timeSorting = measureEfficiency("Percentage by Month (Sorting)", percentageByMonthSorting, articles, count);
-            cout << "\nTime Taken (Linear Scan): " << timeLinear << " µs" << endl;
-            cout << "Time Taken (Sorting & Grouping): " << timeSorting << " µs" << endl;
+            long long timeCube = measureEfficiency("Percentage by Month (Cube)", percentageByMonthCube, std::cref(cube));
+            long long timeLinear = measureEfficiency("Percentage by Month (Linear)", percentageByMonthLinear, std::ref(pool), std::cref(table));
+            cout << "\nTime Taken (Aggregate Cube): " << timeCube << " µs" << endl;
+            cout << "Time Taken (Baseline Linear Scan): " << timeLinear << " µs" << endl;
             
         } else if (mainChoice == 5) {
+            int granularity = 0, seriesChoice = 0, window = 0;
+            cout << "\n--- Fake News Share Time Series ---" << endl;
+            cout << "1. Monthly" << endl;
+            cout << "2. Weekly" << endl;
+            cout << "Enter your choice: ";
+            cin >> granularity;
+            if (granularity != 1 && granularity != 2) {
+                cout << "Invalid option." << endl;
+                continue;
+            }
+            cout << "0. All subjects" << endl;
+            for (int s = 0; s < table.subjectCount; s++)
+                cout << s + 1 << ". " << table.subjectNames[s] << endl;
+            cout << "Series to plot: ";
+            cin >> seriesChoice;
+            if (seriesChoice < 0 || seriesChoice > table.subjectCount) {
+                cout << "Invalid option." << endl;
+                continue;
+            }
+            cout << "Rolling window (" << (granularity == 1 ? "months" : "weeks") << "): ";
+            cin >> window;
+            if (window < 1)
+                window = 1;
+
+            // Both granularities come out of the same pass.
+            TimeSeries monthly, weekly;
+            long long timeSeries = measureEfficiency("Time Series Build (Monthly + Weekly)", buildTimeSeries, std::cref(table), std::ref(monthly), std::ref(weekly));
+            const TimeSeries &series = (granularity == 1) ? monthly : weekly;
+            int seriesIndex = (seriesChoice == 0) ? table.subjectCount : seriesChoice - 1;
+            displayTimeSeries(series, table, seriesIndex, window);
+            string csvFile = (granularity == 1) ? "FakeShareMonthly.csv" : "FakeShareWeekly.csv";
+            if (writeTimeSeriesCsv(series, table, window, csvFile))
+                cout << "\nAll subjects written to " << csvFile << endl;
+            else
+                cout << "\nCould not write " << csvFile << endl;
+            cout << "Time Series: " << monthly.periodCount << " months, " << weekly.periodCount
+                 << " weeks, built in " << timeSeries << " µs" << endl;
+            freeTimeSeries(monthly);
+            freeTimeSeries(weekly);
+
+        } else if (mainChoice == 6) {
+            // Only the new articles go through the indexes; nothing is rebuilt.
+            int first = count;
+            auto startRefresh = high_resolution_clock::now();
+            int added = loadNewArticles(feed, articles);
+            if (added > 0) {
+                count = feed.rowCount;
+                addToYearIndex(articles, first, count, yearIndex);
+                addToDateIndex(articles, first, count, dateIndex);
+                addToInvertedIndex(articles, first, count, textIndex);
+                addToFacetIndex(articles, first, count, facetIndex);
+                addToAggregateCube(articles, first, count, cube);
+                addToArticleTable(articles, first, count, table);
+            }
+            auto endRefresh = high_resolution_clock::now();
+
+            if (added < 0) {
+                cout << feed.filename << " is missing or shorter than before; restart the program to reload it." << endl;
+                continue;
+            }
+            cout << "\n=== Refresh ===" << endl;
+            cout << "New articles: " << added << ", Total articles: " << count << endl;
+            if (count == MAX_ARTICLES)
+                cout << "The article array is full (" << MAX_ARTICLES << "); later articles are not loaded." << endl;
+            else if (feed.pendingBytes > 0)
+                cout << "Last record is not complete yet (" << feed.pendingBytes << " bytes); it will be loaded once it is." << endl;
+            cout << "Time Taken: " << duration_cast<microseconds>(endRefresh - startRefresh).count() << " µs" << endl;
+
+        } else if (mainChoice == 7) {
             cout << "Exiting program." << endl;
         } else {
             cout << "Invalid option. Please try again." << endl;
         }
         
-    } while (mainChoice != 5);
+    }
     
+    delete[] job.ops;
+    freeArticleTable(table);
+    freeAggregateCube(cube);
+    freeFacetIndex(facetIndex);
+    freeInvertedIndex(textIndex);
+    freeDateIndex(dateIndex);
+    freeYearIndex(yearIndex);
     delete[] articles;
-    return 0;
+    return failed > 0 ? 1 : 0;
 }
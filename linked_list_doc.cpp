@@ -2,7 +2,11 @@
 #include <fstream>
 #include <sstream>
 #include <cstring>
+#include <cstdio>
+#include <cmath>
+#include <string_view>
 #include <chrono>
+#include <thread>
 #include <windows.h>
 #include <psapi.h>
 
@@ -42,36 +46,485 @@ struct WordNode {
     WordNode(string w, int f) : word(w), frequency(f), next(nullptr) {}
 };
 
+/**
+ * FNV-1a hash of a word
+ */
+unsigned int hashWord(string_view word) {
+    unsigned int h = 2166136261u;
+    for (unsigned char c : word) {
+        h ^= c;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+/**
+ * Adaptive radix tree (ART) over the words of a WordList
+ * Inner nodes grow from 4 to 16, 48 and 256 children as they fill, and each
+ * one stores the bytes its subtree has in common (path compression) as a view
+ * into the word of one leaf below it. A word's key is its bytes followed by a
+ * 0 terminator, so a word sorts before every longer word it is a prefix of and
+ * an in-order walk visits the words alphabetically. WordNodes are never moved
+ * or freed before the tree, so the views stay valid.
+ */
+const int ART_LEAF = 0;
+const int ART_NODE4 = 1;
+const int ART_NODE16 = 2;
+const int ART_NODE48 = 3;
+const int ART_NODE256 = 4;
+
+struct ArtNode {
+    int type;
+    int childCount = 0;
+    const char* prefix = nullptr;   // compressed path below the parent's key byte
+    int prefixLength = 0;
+    explicit ArtNode(int t) : type(t) {}
+};
+
+struct ArtLeaf : ArtNode {
+    WordNode* word;
+    explicit ArtLeaf(WordNode* w) : ArtNode(ART_LEAF), word(w) {}
+};
+
+struct ArtNode4 : ArtNode {
+    unsigned char keys[4];          // sorted
+    ArtNode* children[4];
+    ArtNode4() : ArtNode(ART_NODE4) {}
+};
+
+struct ArtNode16 : ArtNode {
+    unsigned char keys[16];         // sorted
+    ArtNode* children[16];
+    ArtNode16() : ArtNode(ART_NODE16) {}
+};
+
+struct ArtNode48 : ArtNode {
+    unsigned char childIndex[256];  // slot + 1 in children, 0 = no child
+    ArtNode* children[48];
+    ArtNode48() : ArtNode(ART_NODE48), childIndex{} {}
+};
+
+struct ArtNode256 : ArtNode {
+    ArtNode* children[256];
+    ArtNode256() : ArtNode(ART_NODE256), children{} {}
+};
+
+class WordTree {
+    private:
+        ArtNode* root;
+        int innerCounts[5];     // nodes of each type, for the memory report
+
+        // Byte 'depth' of a word's key: its characters, then the 0 terminator
+        static unsigned char keyByte(string_view word, int depth) {
+            return depth < static_cast<int>(word.size()) ? static_cast<unsigned char>(word[depth]) : 0;
+        }
+
+        static ArtNode** findChild(ArtNode* node, unsigned char key) {
+            switch (node -> type) {
+                case ART_NODE4: {
+                    ArtNode4* n = static_cast<ArtNode4*>(node);
+                    for (int i = 0; i < n -> childCount; i++)
+                        if (n -> keys[i] == key) return &n -> children[i];
+                    return nullptr;
+                }
+                case ART_NODE16: {
+                    ArtNode16* n = static_cast<ArtNode16*>(node);
+                    int low = 0, high = n -> childCount - 1;
+                    while (low <= high) {
+                        int mid = (low + high) / 2;
+                        if (n -> keys[mid] == key) return &n -> children[mid];
+                        if (n -> keys[mid] < key) low = mid + 1;
+                        else high = mid - 1;
+                    }
+                    return nullptr;
+                }
+                case ART_NODE48: {
+                    ArtNode48* n = static_cast<ArtNode48*>(node);
+                    return n -> childIndex[key] ? &n -> children[n -> childIndex[key] - 1] : nullptr;
+                }
+                case ART_NODE256: {
+                    ArtNode256* n = static_cast<ArtNode256*>(node);
+                    return n -> children[key] ? &n -> children[key] : nullptr;
+                }
+            }
+            return nullptr;
+        }
+
+        // Insert into a sorted key array of a Node4 or Node16 that has room
+        static void insertSorted(unsigned char* keys, ArtNode** children, int& count, unsigned char key, ArtNode* child) {
+            int pos = count;
+            while (pos > 0 && keys[pos - 1] > key) {
+                keys[pos] = keys[pos - 1];
+                children[pos] = children[pos - 1];
+                pos--;
+            }
+            keys[pos] = key;
+            children[pos] = child;
+            count++;
+        }
+
+        static void copyHeader(ArtNode* to, const ArtNode* from) {
+            to -> childCount = from -> childCount;
+            to -> prefix = from -> prefix;
+            to -> prefixLength = from -> prefixLength;
+        }
+
+        /**
+         * Add a child under a new key byte, replacing the node with the next
+         * larger type when it is full
+         * @param ref Where the node is linked from
+         */
+        void addChild(ArtNode** ref, unsigned char key, ArtNode* child) {
+            ArtNode* node = *ref;
+            switch (node -> type) {
+                case ART_NODE4: {
+                    ArtNode4* n = static_cast<ArtNode4*>(node);
+                    if (n -> childCount < 4) {
+                        insertSorted(n -> keys, n -> children, n -> childCount, key, child);
+                        return;
+                    }
+                    ArtNode16* grown = new ArtNode16;
+                    copyHeader(grown, n);
+                    for (int i = 0; i < 4; i++) {
+                        grown -> keys[i] = n -> keys[i];
+                        grown -> children[i] = n -> children[i];
+                    }
+                    insertSorted(grown -> keys, grown -> children, grown -> childCount, key, child);
+                    *ref = grown;
+                    innerCounts[ART_NODE4]--;
+                    innerCounts[ART_NODE16]++;
+                    delete n;
+                    return;
+                }
+                case ART_NODE16: {
+                    ArtNode16* n = static_cast<ArtNode16*>(node);
+                    if (n -> childCount < 16) {
+                        insertSorted(n -> keys, n -> children, n -> childCount, key, child);
+                        return;
+                    }
+                    ArtNode48* grown = new ArtNode48;
+                    copyHeader(grown, n);
+                    for (int i = 0; i < 16; i++) {
+                        grown -> children[i] = n -> children[i];
+                        grown -> childIndex[n -> keys[i]] = static_cast<unsigned char>(i + 1);
+                    }
+                    grown -> children[16] = child;
+                    grown -> childIndex[key] = 17;
+                    grown -> childCount++;
+                    *ref = grown;
+                    innerCounts[ART_NODE16]--;
+                    innerCounts[ART_NODE48]++;
+                    delete n;
+                    return;
+                }
+                case ART_NODE48: {
+                    ArtNode48* n = static_cast<ArtNode48*>(node);
+                    if (n -> childCount < 48) {
+                        n -> children[n -> childCount] = child;
+                        n -> childIndex[key] = static_cast<unsigned char>(++n -> childCount);
+                        return;
+                    }
+                    ArtNode256* grown = new ArtNode256;
+                    copyHeader(grown, n);
+                    for (int k = 0; k < 256; k++)
+                        if (n -> childIndex[k]) grown -> children[k] = n -> children[n -> childIndex[k] - 1];
+                    grown -> children[key] = child;
+                    grown -> childCount++;
+                    *ref = grown;
+                    innerCounts[ART_NODE48]--;
+                    innerCounts[ART_NODE256]++;
+                    delete n;
+                    return;
+                }
+                case ART_NODE256: {
+                    ArtNode256* n = static_cast<ArtNode256*>(node);
+                    n -> children[key] = child;
+                    n -> childCount++;
+                    return;
+                }
+            }
+        }
+
+        ArtNode* newNode4(const char* prefix, int prefixLength) {
+            ArtNode4* n = new ArtNode4;
+            n -> prefix = prefix;
+            n -> prefixLength = prefixLength;
+            innerCounts[ART_NODE4]++;
+            return n;
+        }
+
+        // Visit every word below a node in alphabetical order
+        template <typename Callback>
+        static void visit(ArtNode* node, Callback& callback) {
+            switch (node -> type) {
+                case ART_LEAF:
+                    callback(static_cast<ArtLeaf*>(node) -> word);
+                    return;
+                case ART_NODE4: {
+                    ArtNode4* n = static_cast<ArtNode4*>(node);
+                    for (int i = 0; i < n -> childCount; i++) visit(n -> children[i], callback);
+                    return;
+                }
+                case ART_NODE16: {
+                    ArtNode16* n = static_cast<ArtNode16*>(node);
+                    for (int i = 0; i < n -> childCount; i++) visit(n -> children[i], callback);
+                    return;
+                }
+                case ART_NODE48: {
+                    ArtNode48* n = static_cast<ArtNode48*>(node);
+                    for (int k = 0; k < 256; k++)
+                        if (n -> childIndex[k]) visit(n -> children[n -> childIndex[k] - 1], callback);
+                    return;
+                }
+                case ART_NODE256: {
+                    ArtNode256* n = static_cast<ArtNode256*>(node);
+                    for (int k = 0; k < 256; k++)
+                        if (n -> children[k]) visit(n -> children[k], callback);
+                    return;
+                }
+            }
+        }
+
+        static void freeNode(ArtNode* node) {
+            if (!node) return;
+            switch (node -> type) {
+                case ART_LEAF: delete static_cast<ArtLeaf*>(node); return;
+                case ART_NODE4: {
+                    ArtNode4* n = static_cast<ArtNode4*>(node);
+                    for (int i = 0; i < n -> childCount; i++) freeNode(n -> children[i]);
+                    delete n;
+                    return;
+                }
+                case ART_NODE16: {
+                    ArtNode16* n = static_cast<ArtNode16*>(node);
+                    for (int i = 0; i < n -> childCount; i++) freeNode(n -> children[i]);
+                    delete n;
+                    return;
+                }
+                case ART_NODE48: {
+                    ArtNode48* n = static_cast<ArtNode48*>(node);
+                    for (int i = 0; i < n -> childCount; i++) freeNode(n -> children[i]);
+                    delete n;
+                    return;
+                }
+                case ART_NODE256: {
+                    ArtNode256* n = static_cast<ArtNode256*>(node);
+                    for (int k = 0; k < 256; k++) freeNode(n -> children[k]);
+                    delete n;
+                    return;
+                }
+            }
+        }
+
+    public:
+        WordTree() : root(nullptr), innerCounts{} {}
+        WordTree(const WordTree&) = delete;
+        WordTree& operator=(const WordTree&) = delete;
+        ~WordTree() { freeNode(root); }
+
+        // Free the tree nodes (the WordNodes are not touched)
+        void clear() {
+            freeNode(root);
+            root = nullptr;
+            for (int& count : innerCounts) count = 0;
+        }
+
+        WordNode* find(string_view word) const {
+            ArtNode* node = root;
+            int depth = 0;
+            while (node) {
+                if (node -> type == ART_LEAF) {
+                    WordNode* leafWord = static_cast<ArtLeaf*>(node) -> word;
+                    return leafWord -> word == word ? leafWord : nullptr;
+                }
+                for (int i = 0; i < node -> prefixLength; i++)
+                    if (static_cast<unsigned char>(node -> prefix[i]) != keyByte(word, depth + i)) return nullptr;
+                depth += node -> prefixLength;
+                ArtNode** child = findChild(node, keyByte(word, depth));
+                node = child ? *child : nullptr;
+                depth++;
+            }
+            return nullptr;
+        }
+
+        /**
+         * Add a word that is not in the tree yet
+         * @param wordNode Node holding the word; the tree keeps a pointer to it
+         */
+        void insert(WordNode* wordNode) {
+            string_view word = wordNode -> word;
+            ArtNode** ref = &root;
+            int depth = 0;
+            while (true) {
+                ArtNode* node = *ref;
+                if (!node) {
+                    *ref = new ArtLeaf(wordNode);
+                    return;
+                }
+                if (node -> type == ART_LEAF) {
+                    // Split the leaf: a Node4 holding both words below their common bytes
+                    string_view other = static_cast<ArtLeaf*>(node) -> word -> word;
+                    int common = depth;
+                    while (keyByte(other, common) == keyByte(word, common)) {
+                        if (keyByte(word, common) == 0) return;     // already present
+                        common++;
+                    }
+                    ArtNode* parent = newNode4(word.data() + depth, common - depth);
+                    addChild(&parent, keyByte(other, common), node);
+                    addChild(&parent, keyByte(word, common), new ArtLeaf(wordNode));
+                    *ref = parent;
+                    return;
+                }
+                int matched = 0;
+                while (matched < node -> prefixLength &&
+                       static_cast<unsigned char>(node -> prefix[matched]) == keyByte(word, depth + matched))
+                    matched++;
+                if (matched < node -> prefixLength) {
+                    // Split the compressed path where the word leaves it
+                    ArtNode* parent = newNode4(node -> prefix, matched);
+                    unsigned char nodeKey = static_cast<unsigned char>(node -> prefix[matched]);
+                    node -> prefix += matched + 1;
+                    node -> prefixLength -= matched + 1;
+                    addChild(&parent, nodeKey, node);
+                    addChild(&parent, keyByte(word, depth + matched), new ArtLeaf(wordNode));
+                    *ref = parent;
+                    return;
+                }
+                depth += node -> prefixLength;
+                unsigned char key = keyByte(word, depth);
+                ArtNode** child = findChild(node, key);
+                if (!child) {
+                    addChild(ref, key, new ArtLeaf(wordNode));
+                    return;
+                }
+                ref = child;
+                depth++;
+            }
+        }
+
+        /**
+         * Visit the words that start with a prefix in alphabetical order
+         * @param prefix Prefix to match ("" visits every word)
+         * @param callback Called with each WordNode
+         */
+        template <typename Callback>
+        void forEachPrefix(string_view prefix, Callback callback) const {
+            ArtNode* node = root;
+            int depth = 0;
+            int length = static_cast<int>(prefix.size());
+            while (node && depth < length) {
+                if (node -> type == ART_LEAF) {
+                    WordNode* leafWord = static_cast<ArtLeaf*>(node) -> word;
+                    if (leafWord -> word.compare(0, prefix.size(), prefix) == 0)
+                        callback(leafWord);
+                    return;
+                }
+                for (int i = 0; i < node -> prefixLength && depth + i < length; i++)
+                    if (node -> prefix[i] != prefix[depth + i]) return;
+                depth += node -> prefixLength;
+                if (depth >= length)
+                    break;
+                ArtNode** child = findChild(node, static_cast<unsigned char>(prefix[depth]));
+                node = child ? *child : nullptr;
+                depth++;
+            }
+            if (node)
+                visit(node, callback);
+        }
+
+        template <typename Callback>
+        void forEach(Callback callback) const {
+            forEachPrefix("", callback);
+        }
+
+        // Bytes used by the tree nodes
+        size_t memoryUsed(int& leafCount) const {
+            leafCount = 0;
+            forEach([&leafCount](WordNode*) { leafCount++; });
+            return leafCount * sizeof(ArtLeaf) + innerCounts[ART_NODE4] * sizeof(ArtNode4)
+                 + innerCounts[ART_NODE16] * sizeof(ArtNode16) + innerCounts[ART_NODE48] * sizeof(ArtNode48)
+                 + innerCounts[ART_NODE256] * sizeof(ArtNode256);
+        }
+
+        // Inner nodes of each type, indexed by ART_NODE4 .. ART_NODE256
+        int innerCount(int type) const { return innerCounts[type]; }
+};
+
 /**
  * Linked List for Word Frequency
  */
 class WordList {
+    private:
+        WordTree index;     // word -> node, in alphabetical order
+
     public:
         WordNode* head;
         WordList() : head(nullptr) {}
+        WordList(const WordList&) = delete;
+        WordList& operator=(const WordList&) = delete;
 
-        WordNode* find(const string &word) {
-            WordNode* current = head;
-            while (current) {
-                if (current -> word == word) {
-                    return current;
-                }
-                current = current -> next;
-            }
-            return nullptr;
+        WordNode* find(string_view word) const {
+            return index.find(word);
         }
 
-        void insertOrUpdate(const string &word) {
-            WordNode* node = find(word);
+        /**
+         * Add 'amount' occurrences of a word
+         */
+        void insertOrUpdate(string_view word, int amount = 1) {
+            WordNode* node = index.find(word);
             if (node) {
-                node -> frequency++;
+                node -> frequency += amount;
             } else {
-                WordNode* newNode = new WordNode(word, 1);
+                WordNode* newNode = new WordNode(string(word), amount);
                 newNode -> next = head;
                 head = newNode;
+                index.insert(newNode);
             }
         }
 
+        /**
+         * Add every word count of another list to this one
+         * @param other List to read from (left unchanged)
+         */
+        void addAll(const WordList& other) {
+            for (WordNode* cur = other.head; cur; cur = cur -> next)
+                insertOrUpdate(cur -> word, cur -> frequency);
+        }
+
+        /**
+         * Move all nodes of another list into this one without copying them.
+         * Only valid when the two lists share no words.
+         * @param other List to take the nodes from (left empty)
+         */
+        void absorb(WordList& other) {
+            WordNode* cur = other.head;
+            while (cur) {
+                WordNode* next = cur -> next;
+                cur -> next = head;
+                head = cur;
+                index.insert(cur);
+                cur = next;
+            }
+            other.index.clear();
+            other.head = nullptr;
+        }
+
+        /**
+         * Print the words that start with a prefix in alphabetical order
+         * @param prefix Prefix to match ("" prints every word)
+         * @return Number of words printed
+         */
+        int displayPrefix(string_view prefix) const {
+            int count = 0;
+            index.forEachPrefix(prefix, [&count](WordNode* node) {
+                cout << node -> word << ": " << node -> frequency << endl;
+                count++;
+            });
+            return count;
+        }
+
+        const WordTree& tree() const { return index; }
+
         // Helper function: Get the tail of a linked list starting at 'cur'
         WordNode* getTail(WordNode* cur) {
             while (cur && cur -> next)
@@ -117,58 +570,1601 @@ class WordList {
             if (!head || head == end)
                 return head;
 
-            WordNode *newHead = nullptr, *newEnd = nullptr;
-            // Partition the list and get the pivot.
-            WordNode* pivot = partition_word_freq(head, end, &newHead, &newEnd);
+            WordNode *newHead = nullptr, *newEnd = nullptr;
+            // Partition the list and get the pivot.
+            WordNode* pivot = partition_word_freq(head, end, &newHead, &newEnd);
+
+            // If pivot is not the smallest element, recursively sort the left part.
+            if (newHead != pivot) {
+                WordNode* tmp = newHead;
+                while (tmp -> next != pivot)
+                    tmp = tmp -> next;
+                tmp -> next = nullptr; // Disconnect left sublist
+
+                newHead = quickSortRecur(newHead, tmp);
+
+                // Reconnect pivot
+                tmp = getTail(newHead);
+                tmp -> next = pivot;
+            }
+
+            // Recursively sort the list after the pivot.
+            pivot -> next = quickSortRecur(pivot -> next, newEnd);
+            return newHead;
+        }
+
+        // Add this member function to your WordList class:
+        void quickSort_word_freq() {
+            head = quickSortRecur(head, getTail(head));
+        }
+
+        // Counting (bucket) sort by frequency, descending, ties alphabetical.
+        // Frequencies are small bounded integers, so every node goes into the bucket for
+        // its frequency and the buckets are chained from the highest frequency down. The
+        // buckets are filled from an alphabetical walk of the word tree rather than from
+        // the list, so each bucket is already in word order and needs no sort of its own:
+        // O(n + maxFreq) in all.
+        void countingSort_word_freq() {
+            if (!head || !head -> next)
+                return;
+
+            int maxFreq = 0;
+            for (WordNode* cur = head; cur; cur = cur -> next) {
+                if (cur -> frequency > maxFreq)
+                    maxFreq = cur -> frequency;
+            }
+
+            // One bucket per frequency value
+            WordNode** bucketHead = new WordNode*[maxFreq + 1]();
+            WordNode** bucketTail = new WordNode*[maxFreq + 1]();
+            index.forEach([bucketHead, bucketTail](WordNode* node) {
+                int f = node -> frequency > 0 ? node -> frequency : 0;
+                node -> next = nullptr;
+                if (bucketTail[f])
+                    bucketTail[f] -> next = node;
+                else
+                    bucketHead[f] = node;
+                bucketTail[f] = node;
+            });
+
+            // Chain buckets from highest to lowest frequency
+            WordNode dummy("", 0);
+            WordNode* tail = &dummy;
+            for (int f = maxFreq; f >= 0; f--) {
+                if (!bucketHead[f])
+                    continue;
+                tail -> next = bucketHead[f];
+                tail = bucketTail[f];
+            }
+            head = dummy.next;
+
+            delete[] bucketHead;
+            delete[] bucketTail;
+        }
+
+        // Ordering used for the top-K report: higher frequency first, ties alphabetical.
+        static bool ranksHigher(const WordNode* a, const WordNode* b) {
+            if (a -> frequency != b -> frequency)
+                return a -> frequency > b -> frequency;
+            return a -> word < b -> word;
+        }
+
+        // Restore the min-heap property (weakest node at the root) below index i.
+        static void heapSiftDown(WordNode** heap, int heapSize, int i) {
+            while (true) {
+                int weakest = i;
+                int left = 2 * i + 1, right = 2 * i + 2;
+                if (left < heapSize && ranksHigher(heap[weakest], heap[left]))
+                    weakest = left;
+                if (right < heapSize && ranksHigher(heap[weakest], heap[right]))
+                    weakest = right;
+                if (weakest == i)
+                    return;
+                WordNode* tmp = heap[i];
+                heap[i] = heap[weakest];
+                heap[weakest] = tmp;
+                i = weakest;
+            }
+        }
+
+        // Select the k most frequent words in one pass over the list using a size-k min-heap.
+        // The list itself is left untouched. Returns an array of node pointers in descending
+        // order (caller must delete[] it), or nullptr if there is nothing to show.
+        WordNode** topK(int k, int &resultCount) {
+            resultCount = 0;
+            if (k <= 0 || !head)
+                return nullptr;
+
+            // Never allocate more slots than there are words.
+            int wordCount = 0;
+            for (WordNode* cur = head; cur && wordCount < k; cur = cur -> next)
+                wordCount++;
+            k = wordCount;
+
+            WordNode** heap = new WordNode*[k];
+            for (WordNode* cur = head; cur; cur = cur -> next) {
+                if (resultCount < k) {
+                    heap[resultCount++] = cur;
+                    if (resultCount == k) {
+                        for (int i = k / 2 - 1; i >= 0; i--)
+                            heapSiftDown(heap, k, i);
+                    }
+                } else if (ranksHigher(cur, heap[0])) {
+                    heap[0] = cur;
+                    heapSiftDown(heap, k, 0);
+                }
+            }
+            // Fewer than k words: the heap was never built, so build it now.
+            if (resultCount < k) {
+                for (int i = resultCount / 2 - 1; i >= 0; i--)
+                    heapSiftDown(heap, resultCount, i);
+            }
+
+            // Pop the weakest to the back repeatedly: leaves the array in descending order.
+            for (int end = resultCount - 1; end > 0; end--) {
+                WordNode* tmp = heap[0];
+                heap[0] = heap[end];
+                heap[end] = tmp;
+                heapSiftDown(heap, end, 0);
+            }
+            return heap;
+        }
+
+        // Print every word in alphabetical order
+        void display() const {
+            displayPrefix("");
+        }
+
+        ~WordList() {
+            WordNode* current = head;
+            while (current) {
+                WordNode* tmp = current;
+                current = current -> next;
+                delete tmp;
+            }
+        }
+};
+
+/**
+ * Streaming tokenizer
+ * A token is a whitespace-separated run of characters with only its letters
+ * and digits kept, lowercased. DataCleaning builds WordIndex.bin with the same
+ * rule. The text is read 8 bytes at a time into a 64-bit word and classified
+ * with SWAR arithmetic: each class test sets the top bit of every byte in the
+ * class, and adding the uppercase mask shifted down to 0x20 lowercases A-Z in
+ * the register. A block of 8 letters and digits is appended whole; other blocks
+ * are walked byte by byte using the masks. Tokens are passed to the callback as
+ * string_views into a reusable buffer, so nothing is allocated per token. A
+ * view is only valid during its callback.
+ */
+const unsigned long long SWAR_ONES = 0x0101010101010101ULL;
+const unsigned long long SWAR_HIGH_BITS = 0x8080808080808080ULL;
+const unsigned long long SWAR_LOW_BITS = 0x7F7F7F7F7F7F7F7FULL;
+
+/**
+ * Bytes of a word that lie in [lo, hi]. Both sums stay inside their byte, so
+ * no carry crosses into the next one
+ * @param word 8 bytes of text
+ * @param lo Lowest byte value of the class, below 0x80
+ * @param hi Highest byte value of the class, below 0x80
+ * @return word with the top bit set in each byte of the class
+ */
+inline unsigned long long swarInRange(unsigned long long word, unsigned char lo, unsigned char hi) {
+    unsigned long long low = word & SWAR_LOW_BITS;
+    unsigned long long atLeastLo = low + SWAR_ONES * (0x80 - lo);
+    unsigned long long atMostHi = SWAR_ONES * (0x80 + hi) - low;
+    return atLeastLo & atMostHi & ~word & SWAR_HIGH_BITS;
+}
+
+/**
+ * Call onToken for every token of a text
+ * @param text Text to split
+ * @param onToken Callable taking a string_view
+ */
+template<typename Callback>
+void forEachToken(string_view text, Callback onToken) {
+    char localBuffer[256];
+    char* buffer = localBuffer;
+    size_t bufferSize = sizeof(localBuffer);
+    size_t length = 0;
+    for (size_t i = 0; i < text.size(); i += 8) {
+        size_t blockSize = text.size() - i < 8 ? text.size() - i : 8;
+        unsigned long long word = 0;                    // A short last block is zero padded
+        memcpy(&word, text.data() + i, blockSize);
+        unsigned long long upper = swarInRange(word, 'A', 'Z');
+        unsigned long long alnum = upper | swarInRange(word, 'a', 'z') | swarInRange(word, '0', '9');
+        unsigned long long space = swarInRange(word, '\t', '\r') | swarInRange(word, ' ', ' ');
+        word += upper >> 2;                             // 0x80 >> 2 == 'a' - 'A'
+        if (length + 8 > bufferSize) {
+            // Only tokens longer than the local buffer reach the heap
+            char* larger = new char[bufferSize * 2];
+            for (size_t j = 0; j < length; j++)
+                larger[j] = buffer[j];
+            if (buffer != localBuffer)
+                delete[] buffer;
+            buffer = larger;
+            bufferSize *= 2;
+        }
+        if (alnum == SWAR_HIGH_BITS) {
+            memcpy(buffer + length, &word, 8);
+            length += 8;
+            continue;
+        }
+        unsigned char bytes[8], alnumBytes[8], spaceBytes[8];
+        memcpy(bytes, &word, 8);
+        memcpy(alnumBytes, &alnum, 8);
+        memcpy(spaceBytes, &space, 8);
+        for (size_t j = 0; j < blockSize; j++) {
+            if (alnumBytes[j]) {
+                buffer[length++] = static_cast<char>(bytes[j]);
+            } else if (spaceBytes[j] && length > 0) {
+                onToken(string_view(buffer, length));
+                length = 0;
+            }
+        }
+    }
+    if (length > 0)
+        onToken(string_view(buffer, length));
+    if (buffer != localBuffer)
+        delete[] buffer;
+}
+
+/**
+ * Stopword filter
+ * The 144 stopwords are placed in a table at compile time with a hash seed
+ * that gives every stopword its own slot (a perfect hash), so a lookup is one
+ * hash, one slot and at most one comparison. The seed is found offline and
+ * kept in STOPWORD_SEED, so the compiler only places the words once instead
+ * of searching (MSVC stops constant evaluation after 100000 steps);
+ * buildStopwordTable still searches onwards if the list is edited, and the
+ * static_assert then asks for the new seed.
+ * filterStopwords is switched on and off from the menu.
+ */
+constexpr string_view STOPWORDS[] = {
+    "a", "about", "above", "after", "again", "against", "all", "also", "am", "an",
+    "and", "any", "are", "arent", "as", "at", "be", "because", "been", "before",
+    "being", "below", "between", "both", "but", "by", "can", "cant", "could", "couldnt",
+    "did", "didnt", "do", "does", "doesnt", "doing", "dont", "down", "during", "each",
+    "few", "for", "from", "further", "had", "hadnt", "has", "hasnt", "have", "havent",
+    "having", "he", "her", "here", "hers", "herself", "him", "himself", "his", "how",
+    "i", "if", "in", "into", "is", "isnt", "it", "its", "itself", "just",
+    "me", "more", "most", "my", "myself", "no", "nor", "not", "now", "of",
+    "off", "on", "once", "only", "or", "other", "our", "ours", "ourselves", "out",
+    "over", "own", "s", "said", "same", "she", "should", "so", "some", "such",
+    "t", "than", "that", "thats", "the", "their", "theirs", "them", "themselves", "then",
+    "there", "these", "they", "this", "those", "through", "to", "too", "under", "until",
+    "up", "very", "was", "wasnt", "we", "were", "werent", "what", "when", "where",
+    "which", "while", "who", "whom", "why", "will", "with", "wont", "would", "you",
+    "your", "yours", "yourself", "yourselves"
+};
+constexpr int STOPWORD_COUNT = sizeof(STOPWORDS) / sizeof(STOPWORDS[0]);
+constexpr int STOPWORD_TABLE_SIZE = 2048;   // power of two
+constexpr unsigned int STOPWORD_SEED = 53;  // first collision-free seed for this list
+static_assert(STOPWORD_COUNT < 256, "stopword slots are stored in one byte");
+
+struct StopwordTable {
+    unsigned int seed = 0;
+    size_t maxLength = 0;
+    unsigned char slot[STOPWORD_TABLE_SIZE] = {};   // stopword index + 1, 0 = empty
+};
+
+constexpr unsigned int stopwordHash(string_view word, unsigned int seed) {
+    unsigned int h = 2166136261u ^ (seed * 0x9E3779B1u);
+    for (size_t i = 0; i < word.size(); i++) {
+        h ^= static_cast<unsigned char>(word[i]);
+        h *= 16777619u;
+    }
+    return h;
+}
+
+constexpr StopwordTable buildStopwordTable() {
+    StopwordTable table;
+    for (int w = 0; w < STOPWORD_COUNT; w++)
+        if (STOPWORDS[w].size() > table.maxLength)
+            table.maxLength = STOPWORDS[w].size();
+    for (unsigned int seed = STOPWORD_SEED; ; seed++) {
+        int placed = 0;
+        while (placed < STOPWORD_COUNT) {
+            unsigned int pos = stopwordHash(STOPWORDS[placed], seed) & (STOPWORD_TABLE_SIZE - 1);
+            if (table.slot[pos] != 0)
+                break;
+            table.slot[pos] = static_cast<unsigned char>(placed + 1);
+            placed++;
+        }
+        if (placed == STOPWORD_COUNT) {
+            table.seed = seed;
+            return table;
+        }
+        for (int w = 0; w < placed; w++)     // Clear only the slots this seed used
+            table.slot[stopwordHash(STOPWORDS[w], seed) & (STOPWORD_TABLE_SIZE - 1)] = 0;
+    }
+}
+
+constexpr StopwordTable stopwordTable = buildStopwordTable();
+static_assert(stopwordTable.seed == STOPWORD_SEED, "stopword list changed: set STOPWORD_SEED to stopwordTable.seed");
+
+bool filterStopwords = true;
+
+bool isStopword(string_view word) {
+    if (word.size() > stopwordTable.maxLength)
+        return false;
+    unsigned char index = stopwordTable.slot[stopwordHash(word, stopwordTable.seed) & (STOPWORD_TABLE_SIZE - 1)];
+    return index != 0 && STOPWORDS[index - 1] == word;
+}
+
+/**
+ * forEachToken for word counting; drops stopwords while the filter is on
+ * @param text Text to split
+ * @param onWord Callable taking a string_view
+ */
+template<typename Callback>
+void forEachWord(string_view text, Callback onWord) {
+    forEachToken(text, [&onWord](string_view token) {
+        if (!(filterStopwords && isStopword(token)))
+            onWord(token);
+    });
+}
+
+/**
+ * Parallel word count (map-reduce)
+ * Map: each thread counts every threadCount-th article into its own
+ * WORD_PARTITIONS lists, picking the list from the top bits of the word hash.
+ * Reduce: each thread merges one partition from every map thread; partitions
+ * hold disjoint words, so they are spliced together without a final merge.
+ */
+const int WORD_PARTITION_BITS = 6;
+const int WORD_PARTITIONS = 1 << WORD_PARTITION_BITS;
+
+bool isFakeGovernmentNews(News* news) {
+    string subjectLower;
+    for (char c : news -> subject)
+        subjectLower.push_back(tolower(c));
+    return news -> identify == "FAKE" && subjectLower.find("government") != string::npos;
+}
+
+/**
+ * Count the words of the title and text of every step-th article
+ * @param articles Matching articles
+ * @param articleCount Number of articles
+ * @param first Index of the first article for this thread
+ * @param step Number of threads
+ * @param partitions WORD_PARTITIONS lists owned by this thread
+ */
+void countWordsMap(News** articles, int articleCount, int first, int step, WordList* partitions) {
+    for (int i = first; i < articleCount; i += step) {
+        const string* fields[2] = { &articles[i] -> title, &articles[i] -> text };
+        for (const string* field : fields) {
+            forEachWord(*field, [partitions](string_view token) {
+                unsigned int hash = hashWord(token);
+                partitions[hash >> (32 - WORD_PARTITION_BITS)].insertOrUpdate(token);
+            });
+        }
+    }
+}
+
+/**
+ * Merge every step-th partition from all map threads
+ * @param mapLists threadCount * WORD_PARTITIONS lists from the map step
+ * @param threadCount Number of map threads
+ * @param first First partition for this thread
+ * @param step Number of reduce threads
+ * @param merged WORD_PARTITIONS result lists
+ */
+void countWordsReduce(WordList* mapLists, int threadCount, int first, int step, WordList* merged) {
+    for (int p = first; p < WORD_PARTITIONS; p += step) {
+        for (int t = 0; t < threadCount; t++)
+            merged[p].addAll(mapLists[t * WORD_PARTITIONS + p]);
+    }
+}
+
+/**
+ * Count the words of fake government news using several threads
+ * @param newsBook Head of the news list
+ * @param result Empty word list that receives the counts
+ * @param threadCount Number of worker threads
+ */
+void countWordsParallel(News* newsBook, WordList& result, int threadCount) {
+    if (threadCount <= 0) threadCount = 1;
+
+    // Collect the matching articles so they can be split by index
+    int articleCount = 0;
+    for (News* cur = newsBook; cur; cur = cur -> next)
+        if (isFakeGovernmentNews(cur)) articleCount++;
+    News** articles = new News*[articleCount > 0 ? articleCount : 1];
+    articleCount = 0;
+    for (News* cur = newsBook; cur; cur = cur -> next)
+        if (isFakeGovernmentNews(cur)) articles[articleCount++] = cur;
+
+    WordList* mapLists = new WordList[threadCount * WORD_PARTITIONS];
+    WordList* merged = new WordList[WORD_PARTITIONS];
+    thread* workers = new thread[threadCount];
+
+    for (int t = 0; t < threadCount; t++)
+        workers[t] = thread(countWordsMap, articles, articleCount, t, threadCount, mapLists + t * WORD_PARTITIONS);
+    for (int t = 0; t < threadCount; t++)
+        workers[t].join();
+
+    for (int t = 0; t < threadCount; t++)
+        workers[t] = thread(countWordsReduce, mapLists, threadCount, t, threadCount, merged);
+    for (int t = 0; t < threadCount; t++)
+        workers[t].join();
+
+    for (int p = 0; p < WORD_PARTITIONS; p++)
+        result.absorb(merged[p]);
+
+    delete[] workers;
+    delete[] merged;
+    delete[] mapLists;
+    delete[] articles;
+}
+
+/**
+ * Add every word (stopwords included) of the fake government news from
+ * 'first' to the end of the list to a running count. The live count is
+ * kept across refreshes, so only new articles are tokenized; stopwords are
+ * left out when it is read.
+ * @param words The running count
+ * @param first The first article to add
+ */
+void addLiveWords(WordList& words, News* first) {
+    for (News* cur = first; cur; cur = cur -> next) {
+        if (!isFakeGovernmentNews(cur)) continue;
+        forEachToken(cur -> title, [&words](string_view token) { words.insertOrUpdate(token); });
+        forEachToken(cur -> text, [&words](string_view token) { words.insertOrUpdate(token); });
+    }
+}
+
+/**
+ * Count-Min sketch: depth rows of width counters. A word's estimate is the
+ * smallest of its counters; it is never below the true count and at most
+ * epsilon * N above it with probability 1 - delta. Updates are conservative
+ * (only the smallest counters are raised), which keeps the estimates tighter.
+ */
+struct CountMinSketch {
+    int depth = 0;
+    int width = 0;
+    long long* table = nullptr;
+};
+
+void buildSketch(CountMinSketch& sketch, double epsilon, double delta) {
+    sketch.width = static_cast<int>(ceil(exp(1.0) / epsilon));
+    sketch.depth = static_cast<int>(ceil(log(1.0 / delta)));
+    if (sketch.depth < 1) sketch.depth = 1;
+    sketch.table = new long long[static_cast<size_t>(sketch.depth) * sketch.width]();
+}
+
+/**
+ * Column of a word in a row, by double hashing of its FNV-1a hash
+ */
+int sketchColumn(const CountMinSketch& sketch, unsigned int hash, int row) {
+    unsigned int step = ((hash * 0x9E3779B1u) ^ (hash >> 15)) | 1u;
+    return static_cast<int>((hash + static_cast<unsigned int>(row) * step) % static_cast<unsigned int>(sketch.width));
+}
+
+/**
+ * Count one occurrence of a word
+ * @return The word's new estimate
+ */
+long long sketchAdd(CountMinSketch& sketch, unsigned int hash) {
+    long long estimate = -1;
+    for (int row = 0; row < sketch.depth; row++) {
+        long long value = sketch.table[static_cast<size_t>(row) * sketch.width + sketchColumn(sketch, hash, row)];
+        if (estimate < 0 || value < estimate) estimate = value;
+    }
+    estimate++;
+    for (int row = 0; row < sketch.depth; row++) {
+        long long& value = sketch.table[static_cast<size_t>(row) * sketch.width + sketchColumn(sketch, hash, row)];
+        if (value < estimate) value = estimate;
+    }
+    return estimate;
+}
+
+/**
+ * Space-Saving counters kept in a Stream-Summary: a doubly linked list of
+ * buckets in ascending count order, each holding a linked list of the
+ * counters with that count, so counting a tracked word and finding the
+ * smallest count both take O(1). Without a sketch a new word starts one
+ * above the smallest count and is placed in O(1) as well; a sketch estimate
+ * can fall anywhere, so placing it walks up the buckets from the smallest.
+ */
+struct CountBucket;
+
+struct SummaryCounter {
+    string word;
+    unsigned int hash = 0;
+    long long error = 0;
+    CountBucket* bucket = nullptr;
+    SummaryCounter *prev = nullptr, *next = nullptr;
+};
+
+struct CountBucket {
+    long long count;
+    SummaryCounter* counters;
+    CountBucket *prev, *next;
+    CountBucket(long long c) : count(c), counters(nullptr), prev(nullptr), next(nullptr) {}
+};
+
+/**
+ * Approximate word counts in memory fixed by an error bound epsilon.
+ * There are ceil(1 / epsilon) counters. A new word takes over a counter with
+ * the smallest count c and starts at c + 1 with error c, so every word's true
+ * count lies in [count - error, count], the error is at most N / counters,
+ * and any word seen more than epsilon * N times is always kept. With a
+ * Count-Min sketch, a new word starts at its sketch estimate instead, which
+ * is usually far below c + 1 for rare words. The number of counters is
+ * capped at MAX_SUMMARY_COUNTERS, which raises a smaller error bound.
+ */
+const int MAX_SUMMARY_COUNTERS = 1 << 20;
+
+class StreamSummary {
+    private:
+        SummaryCounter* counters;
+        int capacity;
+        int size;
+        CountBucket* minBucket;
+        CountBucket* maxBucket;
+        SummaryCounter** slots;     // open addressing on the word hash
+        int slotMask;
+        bool useSketch;
+        CountMinSketch sketch;
+
+        /**
+         * Slot holding the word, or the empty slot where it would go
+         */
+        int probe(string_view word, unsigned int hash) {
+            int pos = hash & slotMask;
+            while (slots[pos] && !(slots[pos] -> hash == hash && slots[pos] -> word == word))
+                pos = (pos + 1) & slotMask;
+            return pos;
+        }
+
+        /**
+         * Remove a word's slot, shifting later entries of the probe run back
+         */
+        void unlinkSlot(int pos) {
+            slots[pos] = nullptr;
+            int next = (pos + 1) & slotMask;
+            while (slots[next]) {
+                int home = slots[next] -> hash & slotMask;
+                bool stays = (pos <= next) ? (pos < home && home <= next) : (pos < home || home <= next);
+                if (!stays) {
+                    slots[pos] = slots[next];
+                    slots[next] = nullptr;
+                    pos = next;
+                }
+                next = (next + 1) & slotMask;
+            }
+        }
+
+        CountBucket* insertBucketAfter(CountBucket* after, long long count) {
+            CountBucket* bucket = new CountBucket(count);
+            bucket -> prev = after;
+            bucket -> next = after ? after -> next : minBucket;
+            if (bucket -> next) bucket -> next -> prev = bucket;
+            else maxBucket = bucket;
+            if (after) after -> next = bucket;
+            else minBucket = bucket;
+            return bucket;
+        }
+
+        void addToBucket(SummaryCounter* counter, CountBucket* bucket) {
+            counter -> bucket = bucket;
+            counter -> prev = nullptr;
+            counter -> next = bucket -> counters;
+            if (bucket -> counters) bucket -> counters -> prev = counter;
+            bucket -> counters = counter;
+        }
+
+        /**
+         * Take a counter out of its bucket, deleting the bucket if it empties
+         */
+        void removeFromBucket(SummaryCounter* counter) {
+            CountBucket* bucket = counter -> bucket;
+            if (counter -> prev) counter -> prev -> next = counter -> next;
+            else bucket -> counters = counter -> next;
+            if (counter -> next) counter -> next -> prev = counter -> prev;
+            counter -> bucket = nullptr;
+            if (!bucket -> counters) {
+                if (bucket -> prev) bucket -> prev -> next = bucket -> next;
+                else minBucket = bucket -> next;
+                if (bucket -> next) bucket -> next -> prev = bucket -> prev;
+                else maxBucket = bucket -> prev;
+                delete bucket;
+            }
+        }
+
+        /**
+         * Put a detached counter into the bucket for 'count', scanning up from
+         * the smallest bucket: at most two steps for smallest count + 1, one
+         * step per smaller bucket for a sketch estimate
+         */
+        void placeCounter(SummaryCounter* counter, long long count) {
+            CountBucket* after = nullptr;
+            CountBucket* cur = minBucket;
+            while (cur && cur -> count <= count) {
+                after = cur;
+                cur = cur -> next;
+            }
+            if (after && after -> count == count) addToBucket(counter, after);
+            else addToBucket(counter, insertBucketAfter(after, count));
+        }
+
+        /**
+         * Move a counter up by one count in O(1)
+         */
+        void increment(SummaryCounter* counter) {
+            CountBucket* bucket = counter -> bucket;
+            long long count = bucket -> count + 1;
+            if (!bucket -> counters -> next && (!bucket -> next || bucket -> next -> count > count)) {
+                bucket -> count = count;    // only counter in its bucket
+                return;
+            }
+            CountBucket* target = bucket -> next;
+            if (!target || target -> count != count)
+                target = insertBucketAfter(bucket, count);
+            removeFromBucket(counter);
+            addToBucket(counter, target);
+        }
+
+    public:
+        long long total;        // words seen
+        long long maxEvicted;   // bound on the count of any word not kept
+
+        StreamSummary(double epsilon, bool withSketch)
+        : size(0), minBucket(nullptr), maxBucket(nullptr), useSketch(withSketch), total(0), maxEvicted(0) {
+            if (epsilon < 1.0 / MAX_SUMMARY_COUNTERS) epsilon = 1.0 / MAX_SUMMARY_COUNTERS;
+            capacity = static_cast<int>(ceil(1.0 / epsilon));
+            counters = new SummaryCounter[capacity];
+            int slotCount = 1;
+            while (slotCount < capacity * 2)
+                slotCount *= 2;
+            slots = new SummaryCounter*[slotCount]();
+            slotMask = slotCount - 1;
+            if (useSketch)
+                buildSketch(sketch, epsilon, 0.01);
+        }
+        StreamSummary(const StreamSummary&) = delete;
+        StreamSummary& operator=(const StreamSummary&) = delete;
+
+        /**
+         * Count one occurrence of a word
+         * @param word Word to count
+         */
+        void add(string_view word) {
+            unsigned int hash = hashWord(word);
+            total++;
+            long long estimate = useSketch ? sketchAdd(sketch, hash) : -1;
+            int pos = probe(word, hash);
+            if (slots[pos]) {
+                increment(slots[pos]);
+                return;
+            }
+            SummaryCounter* counter;
+            long long count = 1;
+            if (size < capacity) {
+                counter = &counters[size++];
+            } else {
+                // Take over a counter with the smallest count; with a sketch
+                // the estimate also bounds counts lost to earlier evictions
+                counter = minBucket -> counters;
+                long long minCount = minBucket -> count;
+                if (minCount > maxEvicted) maxEvicted = minCount;
+                count = (estimate >= 0) ? estimate : minCount + 1;
+                unlinkSlot(probe(counter -> word, counter -> hash));
+                removeFromBucket(counter);
+                pos = probe(word, hash);
+            }
+            counter -> word.assign(word.data(), word.size());
+            counter -> hash = hash;
+            counter -> error = count - 1;   // the word has been seen at least once
+            slots[pos] = counter;
+            placeCounter(counter, count);
+        }
+
+        /**
+         * Display the k largest counts with the range guaranteed to hold each
+         * true count; a '*' marks words that are certainly in the top k
+         * @param k Number of words to display
+         */
+        void displayTop(int k) {
+            SummaryCounter** ranked = new SummaryCounter*[size > 0 ? size : 1];
+            int rankedCount = 0;
+            long long nextCount = maxEvicted;
+            for (CountBucket* bucket = maxBucket; bucket; bucket = bucket -> prev) {
+                if (rankedCount >= k) {
+                    if (bucket -> count > nextCount) nextCount = bucket -> count;
+                    break;
+                }
+                // Order each bucket alphabetically
+                int first = rankedCount;
+                for (SummaryCounter* c = bucket -> counters; c; c = c -> next) {
+                    int j = rankedCount++;
+                    while (j > first && ranked[j - 1] -> word > c -> word) {
+                        ranked[j] = ranked[j - 1];
+                        j--;
+                    }
+                    ranked[j] = c;
+                }
+                if (rankedCount > k && bucket -> count > nextCount)
+                    nextCount = bucket -> count;
+            }
+            int shown = (rankedCount < k) ? rankedCount : k;
+            for (int i = 0; i < shown; i++) {
+                long long count = ranked[i] -> bucket -> count;
+                long long lower = count - ranked[i] -> error;
+                cout << (lower > nextCount ? "* " : "  ") << i + 1 << ". " << ranked[i] -> word << " ("
+                    << count << " times, true count " << lower << " - " << count << ")" << endl;
+            }
+            delete[] ranked;
+        }
+
+        int counterCount() const { return capacity; }
+
+        size_t memoryUsed() const {
+            size_t bytes = capacity * sizeof(SummaryCounter) + (slotMask + 1) * sizeof(SummaryCounter*);
+            for (int i = 0; i < size; i++)
+                bytes += counters[i].word.capacity();
+            for (CountBucket* bucket = minBucket; bucket; bucket = bucket -> next)
+                bytes += sizeof(CountBucket);
+            if (useSketch)
+                bytes += static_cast<size_t>(sketch.depth) * sketch.width * sizeof(long long);
+            return bytes;
+        }
+
+        ~StreamSummary() {
+            while (minBucket) {
+                CountBucket* next = minBucket -> next;
+                delete minBucket;
+                minBucket = next;
+            }
+            delete[] counters;
+            delete[] slots;
+            delete[] sketch.table;
+        }
+};
+
+/**
+ * Gives each distinct word a dense id (0, 1, 2, ...) with a Robin Hood
+ * table of hashes and ids; the words themselves are kept once in 'words'
+ */
+struct InternSlot {
+    unsigned int hash = 0;
+    int id = 0;
+    int distance = -1;      // probes from the home slot, -1 = empty
+};
+
+class TokenInterner {
+    private:
+        InternSlot* slots;
+        int capacity;       // power of two
+
+        void placeSlot(InternSlot entry) {
+            int mask = capacity - 1;
+            int pos = entry.hash & mask;
+            entry.distance = 0;
+            while (slots[pos].distance >= 0) {
+                if (slots[pos].distance < entry.distance)
+                    swap(slots[pos], entry);
+                pos = (pos + 1) & mask;
+                entry.distance++;
+            }
+            slots[pos] = entry;
+        }
+
+        void growSlots() {
+            InternSlot* old = slots;
+            int oldCapacity = capacity;
+            capacity = oldCapacity ? oldCapacity * 2 : 1024;
+            slots = new InternSlot[capacity];
+            for (int i = 0; i < oldCapacity; i++) {
+                if (old[i].distance >= 0)
+                    placeSlot(old[i]);
+            }
+            delete[] old;
+        }
+
+    public:
+        string* words;
+        int size;
+        int wordCapacity;
+
+        TokenInterner() : slots(nullptr), capacity(0), words(nullptr), size(0), wordCapacity(0) {}
+        TokenInterner(const TokenInterner&) = delete;
+        TokenInterner& operator=(const TokenInterner&) = delete;
+
+        /**
+         * Id of a word, assigning the next id to a new word
+         * @param word Word to look up
+         */
+        int intern(string_view word) {
+            unsigned int hash = hashWord(word);
+            if (capacity > 0) {
+                int mask = capacity - 1;
+                int pos = hash & mask;
+                for (int distance = 0; slots[pos].distance >= distance; distance++) {
+                    if (slots[pos].hash == hash && words[slots[pos].id] == word)
+                        return slots[pos].id;
+                    pos = (pos + 1) & mask;
+                }
+            }
+            if (size == wordCapacity) {
+                wordCapacity = wordCapacity ? wordCapacity * 2 : 1024;
+                string* larger = new string[wordCapacity];
+                for (int i = 0; i < size; i++)
+                    larger[i].swap(words[i]);
+                delete[] words;
+                words = larger;
+            }
+            words[size].assign(word.data(), word.size());
+            if ((size + 1) * 5 > capacity * 4)
+                growSlots();
+            InternSlot entry;
+            entry.hash = hash;
+            entry.id = size;
+            placeSlot(entry);
+            return size++;
+        }
+
+        size_t memoryUsed() const {
+            size_t bytes = capacity * sizeof(InternSlot) + wordCapacity * sizeof(string);
+            for (int i = 0; i < size; i++)
+                bytes += words[i].capacity();
+            return bytes;
+        }
+
+        ~TokenInterner() {
+            delete[] slots;
+            delete[] words;
+        }
+};
+
+/**
+ * N-gram (n = 2 or 3) counts keyed by the token ids packed into one 64-bit
+ * key, NGRAM_ID_BITS per id, so no phrase strings are built. Ids are stored
+ * plus one, which keeps key 0 free to mark empty slots. Open addressing with
+ * linear probing, doubled at 70% load.
+ */
+const int NGRAM_ID_BITS = 21;
+const unsigned long long NGRAM_ID_LIMIT = (1ULL << NGRAM_ID_BITS) - 1;
+
+struct NgramSlot {
+    unsigned long long key = 0;
+    int count = 0;
+};
+
+class NgramTable {
+    private:
+        NgramSlot* slots;
+        int capacity;       // power of two
+
+        /**
+         * Mix the key bits so that neighbouring ids spread over the table
+         */
+        static unsigned long long hashKey(unsigned long long key) {
+            key ^= key >> 33;
+            key *= 0xff51afd7ed558ccdULL;
+            key ^= key >> 33;
+            key *= 0xc4ceb9fe1a85ec53ULL;
+            key ^= key >> 33;
+            return key;
+        }
+
+        void grow() {
+            NgramSlot* old = slots;
+            int oldCapacity = capacity;
+            capacity = oldCapacity ? oldCapacity * 2 : 4096;
+            slots = new NgramSlot[capacity];
+            int mask = capacity - 1;
+            for (int i = 0; i < oldCapacity; i++) {
+                if (old[i].key == 0)
+                    continue;
+                int pos = static_cast<int>(hashKey(old[i].key) & mask);
+                while (slots[pos].key != 0)
+                    pos = (pos + 1) & mask;
+                slots[pos] = old[i];
+            }
+            delete[] old;
+        }
+
+        static bool ranksHigher(const NgramSlot& a, const NgramSlot& b) {
+            if (a.count != b.count)
+                return a.count > b.count;
+            return a.key < b.key;
+        }
+
+        static void heapSiftDown(NgramSlot* heap, int heapSize, int i) {
+            while (true) {
+                int weakest = i;
+                int left = 2 * i + 1, right = 2 * i + 2;
+                if (left < heapSize && ranksHigher(heap[weakest], heap[left]))
+                    weakest = left;
+                if (right < heapSize && ranksHigher(heap[weakest], heap[right]))
+                    weakest = right;
+                if (weakest == i)
+                    return;
+                swap(heap[i], heap[weakest]);
+                i = weakest;
+            }
+        }
+
+    public:
+        int size;
+
+        NgramTable() : slots(nullptr), capacity(0), size(0) {}
+        NgramTable(const NgramTable&) = delete;
+        NgramTable& operator=(const NgramTable&) = delete;
+
+        void add(unsigned long long key) {
+            if ((size + 1) * 10 > capacity * 7)
+                grow();
+            int mask = capacity - 1;
+            int pos = static_cast<int>(hashKey(key) & mask);
+            while (slots[pos].key != 0 && slots[pos].key != key)
+                pos = (pos + 1) & mask;
+            if (slots[pos].key == 0) {
+                slots[pos].key = key;
+                size++;
+            }
+            slots[pos].count++;
+        }
+
+        /**
+         * Display the k most frequent n-grams, selected with a size-k min-heap
+         * @param k Number of n-grams to display
+         * @param interner Interner that assigned the ids
+         * @param n Tokens per n-gram
+         */
+        void displayTop(int k, const TokenInterner& interner, int n) {
+            int resultCount = (k < size) ? k : size;
+            if (resultCount <= 0)
+                return;
+            NgramSlot* heap = new NgramSlot[resultCount];
+            int filled = 0;
+            for (int i = 0; i < capacity; i++) {
+                if (slots[i].key == 0)
+                    continue;
+                if (filled < resultCount) {
+                    heap[filled++] = slots[i];
+                    if (filled == resultCount) {
+                        for (int j = resultCount / 2 - 1; j >= 0; j--)
+                            heapSiftDown(heap, resultCount, j);
+                    }
+                } else if (ranksHigher(slots[i], heap[0])) {
+                    heap[0] = slots[i];
+                    heapSiftDown(heap, resultCount, 0);
+                }
+            }
+            for (int end = resultCount - 1; end > 0; end--) {
+                swap(heap[0], heap[end]);
+                heapSiftDown(heap, end, 0);
+            }
+            for (int i = 0; i < resultCount; i++) {
+                cout << i + 1 << ". ";
+                for (int t = n - 1; t >= 0; t--) {
+                    unsigned long long id = (heap[i].key >> (t * NGRAM_ID_BITS)) & NGRAM_ID_LIMIT;
+                    cout << interner.words[id - 1] << (t > 0 ? " " : "");
+                }
+                cout << " (" << heap[i].count << " times)" << endl;
+            }
+            delete[] heap;
+        }
+
+        size_t memoryUsed() const { return capacity * sizeof(NgramSlot); }
+
+        ~NgramTable() { delete[] slots; }
+};
+
+/**
+ * Count the n-grams of the title and text of fake government news.
+ * An n-gram never spans two fields or two articles, nor a stopword dropped
+ * by the filter: the window restarts after one.
+ * @param newsBook Head of the news list
+ * @param n Tokens per n-gram (2 or 3)
+ * @param interner Receives the token ids
+ * @param table Receives the counts
+ */
+void countPhrases(News* newsBook, int n, TokenInterner& interner, NgramTable& table) {
+    unsigned long long keyMask = (1ULL << (n * NGRAM_ID_BITS)) - 1;
+    for (News* cur = newsBook; cur; cur = cur -> next) {
+        if (!isFakeGovernmentNews(cur))
+            continue;
+        const string* fields[2] = { &cur -> title, &cur -> text };
+        for (const string* field : fields) {
+            unsigned long long window = 0;
+            int filled = 0;
+            forEachToken(*field, [&](string_view token) {
+                if (filterStopwords && isStopword(token)) {
+                    filled = 0;     // a phrase does not bridge a dropped stopword
+                    return;
+                }
+                unsigned long long id = static_cast<unsigned long long>(interner.intern(token)) + 1;
+                if (id > NGRAM_ID_LIMIT) {
+                    filled = 0;     // id does not fit in the key; restart the window
+                    return;
+                }
+                window = ((window << NGRAM_ID_BITS) | id) & keyMask;
+                if (++filled >= n)
+                    table.add(window);
+            });
+        }
+    }
+}
+
+/**
+ * Word count index written by DataCleaning ("WordIndex.bin")
+ * Token counts per (subject, label, year-month, field) group, with a sorted
+ * term dictionary and varint-compressed (term id gap, count) postings per
+ * group. The file is read into one buffer and used in place; the layout is
+ * described in DataCleaning.cpp.
+ */
+const char WORD_INDEX_MAGIC[8] = { 'W', 'C', 'I', 'D', 'X', '0', '2', '\0' };
+const int WORD_INDEX_GROUP_FIELDS = 8;  // subject, label, field, YYYYMM, entries, offset, length, tokens
+
+class WordCountIndex {
+    public:
+        // Which groups to add up; an empty subject, label -1 or month 0 means any
+        struct Filter {
+            string subject;             // case-insensitive substring of the subject
+            int label = -1;             // 0 FAKE, 1 TRUE
+            unsigned int fromMonth = 0; // YYYYMM, inclusive
+            unsigned int toMonth = 0;
+        };
+
+        WordCountIndex() : data(nullptr), size(0), indexedBytes(0), termCount(0), subjectCount(0), groupCount(0),
+                           termOffsets(nullptr), subjects(nullptr), pool(nullptr), groups(nullptr), postings(nullptr),
+                           postingsSize(0) {}
+        WordCountIndex(const WordCountIndex&) = delete;
+        WordCountIndex& operator=(const WordCountIndex&) = delete;
+        ~WordCountIndex() { delete[] data; }
+
+        bool loaded() const { return data != nullptr; }
+        unsigned int terms() const { return termCount; }
+        unsigned long long coveredBytes() const { return indexedBytes; }
+
+        /**
+         * Load the index if it exists and was built from the source file or
+         * from an earlier, shorter version of it: the first indexed bytes of
+         * the source must hash to the fingerprint in the header. The file is
+         * only ever appended to, so the index covers its first coveredBytes()
+         * bytes and the articles after that are counted separately. Every
+         * table is checked (see validate()), so a damaged index is rejected
+         * and the caller counts the articles directly.
+         * @param filename Index file
+         * @param sourceFile Cleaned CSV the index was built from
+         * @return True if the index can be used
+         */
+        bool load(const string& filename, const string& sourceFile) {
+            ifstream source(sourceFile, ios::binary | ios::ate);
+            ifstream file(filename, ios::binary | ios::ate);
+            if (!source || !file)
+                return false;
+            unsigned long long sourceSize = static_cast<unsigned long long>(source.tellg());
+            size_t fileSize = static_cast<size_t>(file.tellg());
+            const size_t headerSize = 8 + 8 + 8 + 8 * 4;
+            if (fileSize < headerSize)
+                return false;
+            char* buffer = new char[fileSize];
+            file.seekg(0);
+            file.read(buffer, fileSize);
+
+            unsigned long long indexedSize = 0, indexedHash = 0, sourceHash = 0;
+            unsigned int header[8];
+            memcpy(&indexedSize, buffer + 8, sizeof(indexedSize));
+            memcpy(&indexedHash, buffer + 16, sizeof(indexedHash));
+            memcpy(header, buffer + 24, sizeof(header));
+            // header: termCount, subjectCount, groupCount, termTablePos, poolPos, subjectTablePos, groupTablePos, postingsPos
+            bool valid = file && memcmp(buffer, WORD_INDEX_MAGIC, sizeof(WORD_INDEX_MAGIC)) == 0 && indexedSize <= sourceSize
+                      && (header[3] | header[4] | header[5] | header[6] | header[7]) % 4 == 0
+                      && header[3] >= headerSize && header[4] >= headerSize && header[5] >= headerSize && header[6] >= headerSize
+                      && header[3] + (header[0] + 1ULL) * 4 <= fileSize && header[5] + header[1] * 8ULL <= fileSize
+                      && header[6] + header[2] * 32ULL <= fileSize && header[4] <= header[6] && header[7] <= fileSize
+                      && hashPrefix(source, indexedSize, sourceHash) && sourceHash == indexedHash;
+            if (!valid) {
+                delete[] buffer;
+                return false;
+            }
+            delete[] data;
+            data = buffer;
+            size = fileSize;
+            indexedBytes = indexedSize;
+            termCount = header[0];
+            subjectCount = header[1];
+            groupCount = header[2];
+            termOffsets = reinterpret_cast<const unsigned int*>(data + header[3]);
+            pool = data + header[4];
+            subjects = reinterpret_cast<const unsigned int*>(data + header[5]);
+            groups = reinterpret_cast<const unsigned int*>(data + header[6]);
+            postings = reinterpret_cast<const unsigned char*>(data + header[7]);
+            postingsSize = fileSize - header[7];
+            if (!validate(header[6] - header[4])) {
+                delete[] data;
+                data = nullptr;
+                size = 0;
+                indexedBytes = 0;
+                termCount = subjectCount = groupCount = 0;
+                postingsSize = 0;
+                return false;
+            }
+            return true;
+        }
+
+        string_view term(unsigned int id) const {
+            return string_view(pool + termOffsets[id], termOffsets[id + 1] - termOffsets[id]);
+        }
+
+        string_view subject(unsigned int id) const {
+            return string_view(pool + subjects[id * 2], subjects[id * 2 + 1]);
+        }
+
+        /**
+         * Add up the title and text counts of every group that matches the
+         * filter into a word list, leaving out stopwords while the filter is on
+         * @param filter Groups to include
+         * @param wordList Receives the counts
+         * @return Number of groups used
+         */
+        int query(const Filter& filter, WordList& wordList) const {
+            long long* counts = new long long[termCount > 0 ? termCount : 1]();
+            int groupsUsed = 0;
+            for (unsigned int g = 0; g < groupCount; g++) {
+                const unsigned int* group = groups + g * WORD_INDEX_GROUP_FIELDS;
+                if (filter.label >= 0 && group[1] != static_cast<unsigned int>(filter.label))
+                    continue;
+                if (filter.fromMonth != 0 && (group[3] < filter.fromMonth || group[3] > filter.toMonth))
+                    continue;
+                if (!filter.subject.empty() && !containsIgnoreCase(subject(group[0]), filter.subject))
+                    continue;
+                groupsUsed++;
+                const unsigned char* p = postings + group[5];
+                const unsigned char* end = p + group[6];
+                unsigned int id = 0, gap = 0, count = 0;
+                for (unsigned int e = 0; e < group[4] && readVarint(p, end, gap) && readVarint(p, end, count); e++) {
+                    id += gap;
+                    counts[id] += count;
+                }
+            }
+            for (unsigned int id = 0; id < termCount; id++) {
+                string_view word = term(id);
+                if (counts[id] > 0 && !(filterStopwords && isStopword(word)))
+                    wordList.insertOrUpdate(word, static_cast<int>(counts[id]));
+            }
+            delete[] counts;
+            return groupsUsed;
+        }
+
+        static bool containsIgnoreCase(string_view text, const string& part) {
+            for (size_t start = 0; start + part.size() <= text.size(); start++) {
+                size_t i = 0;
+                while (i < part.size() && tolower(static_cast<unsigned char>(text[start + i])) ==
+                                          tolower(static_cast<unsigned char>(part[i])))
+                    i++;
+                if (i == part.size())
+                    return true;
+            }
+            return false;
+        }
+
+    private:
+        char* data;
+        size_t size;
+        unsigned long long indexedBytes;    // length of the CSV prefix the index was built from
+        unsigned int termCount;
+        unsigned int subjectCount;
+        unsigned int groupCount;
+        const unsigned int* termOffsets;    // termCount + 1, into pool
+        const unsigned int* subjects;       // (pool offset, length) pairs
+        const char* pool;
+        const unsigned int* groups;         // WORD_INDEX_GROUP_FIELDS per group
+        const unsigned char* postings;
+        size_t postingsSize;
+
+        /**
+         * Decode one varint at p, advancing p
+         * @return False instead of reading past 'end' or decoding more than 32 bits
+         */
+        static bool readVarint(const unsigned char*& p, const unsigned char* end, unsigned int& value) {
+            value = 0;
+            for (int shift = 0; shift < 35 && p < end; shift += 7) {
+                unsigned char byte = *p++;
+                value |= static_cast<unsigned int>(byte & 0x7F) << shift;
+                if (!(byte & 0x80)) return shift < 28 || byte < 0x10;
+            }
+            return false;
+        }
+
+        /**
+         * 64-bit FNV-1a hash of the first 'length' bytes of a file, the
+         * fingerprint DataCleaning stores in the header
+         * @return False if the file is shorter than 'length'
+         */
+        static bool hashPrefix(ifstream& file, unsigned long long length, unsigned long long& hash) {
+            hash = 14695981039346656037ULL;
+            char buffer[65536];
+            file.seekg(0);
+            while (length > 0) {
+                streamsize chunk = static_cast<streamsize>(length < sizeof(buffer) ? length : sizeof(buffer));
+                if (!file.read(buffer, chunk)) return false;
+                for (streamsize i = 0; i < chunk; i++) {
+                    hash ^= static_cast<unsigned char>(buffer[i]);
+                    hash *= 1099511628211ULL;
+                }
+                length -= static_cast<unsigned long long>(chunk);
+            }
+            return true;
+        }
+
+        /**
+         * Check the tables of a just loaded index: term and subject strings
+         * inside the pool, every group's subject, label and field in range
+         * and its postings inside the postings section, and every posting
+         * decoding to a term id below termCount, so query() can trust them
+         * @param poolSize Bytes between the pool and the group table
+         */
+        bool validate(size_t poolSize) const {
+            for (unsigned int t = 0; t < termCount; t++)
+                if (termOffsets[t] > termOffsets[t + 1]) return false;
+            if (termCount > 0 && (termOffsets[0] != 0 || termOffsets[termCount] > poolSize))
+                return false;
+            for (unsigned int s = 0; s < subjectCount; s++)
+                if (static_cast<unsigned long long>(subjects[s * 2]) + subjects[s * 2 + 1] > poolSize) return false;
+            for (unsigned int g = 0; g < groupCount; g++) {
+                const unsigned int* group = groups + g * WORD_INDEX_GROUP_FIELDS;
+                if (group[0] >= subjectCount || group[1] > 1 || group[2] > 1
+                    || static_cast<unsigned long long>(group[5]) + group[6] > postingsSize)
+                    return false;
+                const unsigned char* p = postings + group[5];
+                const unsigned char* end = p + group[6];
+                unsigned long long id = 0;
+                unsigned int gap = 0, count = 0;
+                for (unsigned int e = 0; e < group[4]; e++) {
+                    if (!readVarint(p, end, gap) || !readVarint(p, end, count)) return false;
+                    id += gap;
+                    if (id >= termCount) return false;
+                }
+            }
+            return true;
+        }
+
+};
+
+/**
+ * Ask for a word count index filter
+ * Subject is a word of the subject or "all"; label is FAKE, TRUE or ALL;
+ * month is YYYY-MM, YYYY or "all"
+ * @param filter Receives the filter
+ */
+void readWordCountFilter(WordCountIndex::Filter& filter) {
+    string subject, label, month;
+    cout << "Subject contains (e.g. government, or all): ";
+    cin >> subject;
+    cout << "Label (FAKE, TRUE or ALL): ";
+    cin >> label;
+    cout << "Month (YYYY-MM, YYYY or all): ";
+    cin >> month;
+
+    filter.subject = (subject == "all" || subject == "ALL") ? "" : subject;
+    for (char& c : label) c = static_cast<char>(toupper(static_cast<unsigned char>(c)));
+    filter.label = (label == "FAKE") ? 0 : (label == "TRUE") ? 1 : -1;
+    filter.fromMonth = filter.toMonth = 0;
+    bool validYear = month.size() >= 4 && isdigit(month[0]) && isdigit(month[1]) && isdigit(month[2]) && isdigit(month[3]);
+    if (validYear && month.size() == 4) {
+        filter.fromMonth = stoi(month) * 100 + 1;
+        filter.toMonth = stoi(month) * 100 + 12;
+    } else if (validYear && month.size() == 7 && month[4] == '-' && isdigit(month[5]) && isdigit(month[6])) {
+        filter.fromMonth = filter.toMonth = stoi(month.substr(0, 4)) * 100 + stoi(month.substr(5, 2));
+    }
+}
+
+/**
+ * Id of a subject in a name table, adding it if it is new. The table
+ * doubles when it is full, so every distinct subject keeps its own id.
+ * @param names Subject names, reallocated when the table grows
+ * @param count Number of names in use
+ * @param capacity Number of names allocated
+ * @param subject Subject to look up
+ */
+int internSubject(string*& names, int& count, int& capacity, const string& subject) {
+    for (int s = 0; s < count; s++)
+        if (names[s] == subject) return s;
+    if (count == capacity) {
+        int newCapacity = capacity ? capacity * 2 : 16;
+        string* grown = new string[newCapacity];
+        for (int s = 0; s < count; s++) grown[s].swap(names[s]);
+        delete[] names;
+        names = grown;
+        capacity = newCapacity;
+    }
+    names[count] = subject;
+    return count++;
+}
+
+/**
+ * Term statistics for the distinctive terms report
+ * One pass over all articles gathers, for every term, its count in FAKE and
+ * TRUE articles, the number of FAKE and TRUE articles containing it, and its
+ * count in every subject. Worker threads take every threadCount-th article
+ * into their own TermCorpus; the corpora are then added together by term.
+ */
+const int TERM_TF_FAKE = 0;
+const int TERM_TF_TRUE = 1;
+const int TERM_DF_FAKE = 2;
+const int TERM_DF_TRUE = 3;
+const int TERM_TF_SUBJECT = 4;  // first of subjectCount subject counts
+
+class TermCorpus {
+    public:
+        TokenInterner terms;
+        int stride;             // ints per term: 4 + subjectCount
+        int* stats;             // [term * stride + TERM_...]
+        int* lastDoc;           // last article counted in the term's df
+        int capacity;
+        int subjectCount;
+        int subjectCapacity;
+        string* subjectNames;
+        long long labelTokens[2];       // [0] FAKE, [1] TRUE
+        int labelDocs[2];
+        long long* subjectTokens;       // [subject], subjectCount entries
+        int* subjectDocs;
+
+        TermCorpus() : stride(TERM_TF_SUBJECT), stats(nullptr), lastDoc(nullptr), capacity(0), subjectCount(0),
+                       subjectCapacity(0), subjectNames(nullptr), labelTokens{0, 0}, labelDocs{0, 0},
+                       subjectTokens(nullptr), subjectDocs(nullptr) {}
+        TermCorpus(const TermCorpus&) = delete;
+        TermCorpus& operator=(const TermCorpus&) = delete;
+
+        /**
+         * Size the per-subject counts for 'count' subjects; call before
+         * the first row is added, since it also sets the stride
+         * @param count Number of subjects
+         */
+        void sizeSubjects(int count) {
+            delete[] subjectTokens;
+            delete[] subjectDocs;
+            subjectTokens = new long long[count > 0 ? count : 1]();
+            subjectDocs = new int[count > 0 ? count : 1]();
+            stride = TERM_TF_SUBJECT + count;
+        }
+
+        /**
+         * Id of a term, adding a zeroed row for a new term
+         * @param word Term to look up
+         */
+        int row(string_view word) {
+            int id = terms.intern(word);
+            if (id >= capacity) {
+                int newCapacity = capacity ? capacity * 2 : 1024;
+                int* newStats = new int[static_cast<size_t>(newCapacity) * stride]();
+                int* newLastDoc = new int[newCapacity];
+                for (size_t i = 0; i < static_cast<size_t>(capacity) * stride; i++)
+                    newStats[i] = stats[i];
+                for (int i = 0; i < newCapacity; i++)
+                    newLastDoc[i] = (i < capacity) ? lastDoc[i] : -1;
+                delete[] stats;
+                delete[] lastDoc;
+                stats = newStats;
+                lastDoc = newLastDoc;
+                capacity = newCapacity;
+            }
+            return id;
+        }
+
+        const int* statsOf(int id) const { return stats + static_cast<size_t>(id) * stride; }
+
+        ~TermCorpus() {
+            delete[] stats;
+            delete[] lastDoc;
+            delete[] subjectNames;
+            delete[] subjectTokens;
+            delete[] subjectDocs;
+        }
+};
+
+/**
+ * Gather the term statistics of every step-th article
+ * @param articles All articles
+ * @param articleCount Number of articles
+ * @param first Index of the first article for this thread
+ * @param step Number of threads
+ * @param subjectIds Dense subject id of each article
+ * @param local Corpus owned by this thread
+ */
+void termStatsMap(News** articles, int articleCount, int first, int step, const int* subjectIds, TermCorpus* local) {
+    for (int i = first; i < articleCount; i += step) {
+        int label = (articles[i] -> identify == "FAKE") ? 0 : 1;
+        int subject = subjectIds[i];
+        local -> labelDocs[label]++;
+        local -> subjectDocs[subject]++;
+        const string* fields[2] = { &articles[i] -> title, &articles[i] -> text };
+        for (const string* field : fields) {
+            forEachWord(*field, [&](string_view token) {
+                int id = local -> row(token);
+                int* stats = local -> stats + static_cast<size_t>(id) * local -> stride;
+                stats[TERM_TF_FAKE + label]++;
+                stats[TERM_TF_SUBJECT + subject]++;
+                if (local -> lastDoc[id] != i) {
+                    local -> lastDoc[id] = i;
+                    stats[TERM_DF_FAKE + label]++;
+                }
+                local -> labelTokens[label]++;
+                local -> subjectTokens[subject]++;
+            });
+        }
+    }
+}
+
+/**
+ * Gather the term statistics of all articles with several threads
+ * @param newsBook Head of the news list
+ * @param threadCount Number of worker threads
+ * @param corpus Empty corpus that receives the statistics
+ */
+void buildTermCorpus(News* newsBook, int threadCount, TermCorpus& corpus) {
+    if (threadCount <= 0) threadCount = 1;
+    int articleCount = 0;
+    for (News* cur = newsBook; cur; cur = cur -> next)
+        articleCount++;
+    News** articles = new News*[articleCount > 0 ? articleCount : 1];
+    int* subjectIds = new int[articleCount > 0 ? articleCount : 1];
+    articleCount = 0;
+    for (News* cur = newsBook; cur; cur = cur -> next) {
+        subjectIds[articleCount] = internSubject(corpus.subjectNames, corpus.subjectCount, corpus.subjectCapacity, cur -> subject);
+        articles[articleCount++] = cur;
+    }
+    corpus.sizeSubjects(corpus.subjectCount);
 
-            // If pivot is not the smallest element, recursively sort the left part.
-            if (newHead != pivot) {
-                WordNode* tmp = newHead;
-                while (tmp -> next != pivot)
-                    tmp = tmp -> next;
-                tmp -> next = nullptr; // Disconnect left sublist
+    TermCorpus* partial = new TermCorpus[threadCount];
+    thread* workers = new thread[threadCount];
+    for (int t = 0; t < threadCount; t++) {
+        partial[t].sizeSubjects(corpus.subjectCount);
+        workers[t] = thread(termStatsMap, articles, articleCount, t, threadCount, subjectIds, partial + t);
+    }
+    for (int t = 0; t < threadCount; t++)
+        workers[t].join();
 
-                newHead = quickSortRecur(newHead, tmp);
+    // Add the per-thread corpora together; each article was seen by one thread only
+    for (int t = 0; t < threadCount; t++) {
+        for (int id = 0; id < partial[t].terms.size; id++) {
+            int row = corpus.row(partial[t].terms.words[id]);
+            const int* local = partial[t].statsOf(id);
+            for (int k = 0; k < corpus.stride; k++)
+                corpus.stats[static_cast<size_t>(row) * corpus.stride + k] += local[k];
+        }
+        for (int label = 0; label < 2; label++) {
+            corpus.labelTokens[label] += partial[t].labelTokens[label];
+            corpus.labelDocs[label] += partial[t].labelDocs[label];
+        }
+        for (int s = 0; s < corpus.subjectCount; s++) {
+            corpus.subjectTokens[s] += partial[t].subjectTokens[s];
+            corpus.subjectDocs[s] += partial[t].subjectDocs[s];
+        }
+    }
+    delete[] workers;
+    delete[] partial;
+    delete[] subjectIds;
+    delete[] articles;
+}
 
-                // Reconnect pivot
-                tmp = getTail(newHead);
-                tmp -> next = pivot;
-            }
+struct TermScore {
+    const string* word;
+    double score;
+    int count;      // supporting count shown next to the score
+};
 
-            // Recursively sort the list after the pivot.
-            pivot -> next = quickSortRecur(pivot -> next, newEnd);
-            return newHead;
+/**
+ * Display the topCount highest scores, selected with a size-topCount min-heap
+ */
+void displayTermScores(TermScore* scores, int scoreCount, int topCount, const string& heading) {
+    auto ranksHigher = [](const TermScore& a, const TermScore& b) {
+        if (a.score != b.score)
+            return a.score > b.score;
+        return *a.word < *b.word;
+    };
+    auto siftDown = [&](TermScore* heap, int heapSize, int i) {
+        while (true) {
+            int weakest = i;
+            int left = 2 * i + 1, right = 2 * i + 2;
+            if (left < heapSize && ranksHigher(heap[weakest], heap[left]))
+                weakest = left;
+            if (right < heapSize && ranksHigher(heap[weakest], heap[right]))
+                weakest = right;
+            if (weakest == i)
+                return;
+            swap(heap[i], heap[weakest]);
+            i = weakest;
         }
-
-        // Add this member function to your WordList class:
-        void quickSort_word_freq() {
-            head = quickSortRecur(head, getTail(head));
+    };
+    int resultCount = (topCount < scoreCount) ? topCount : scoreCount;
+    cout << heading << endl;
+    if (resultCount <= 0)
+        return;
+    TermScore* heap = new TermScore[resultCount];
+    for (int i = 0; i < resultCount; i++)
+        heap[i] = scores[i];
+    for (int i = resultCount / 2 - 1; i >= 0; i--)
+        siftDown(heap, resultCount, i);
+    for (int i = resultCount; i < scoreCount; i++) {
+        if (ranksHigher(scores[i], heap[0])) {
+            heap[0] = scores[i];
+            siftDown(heap, resultCount, 0);
         }
+    }
+    for (int end = resultCount - 1; end > 0; end--) {
+        swap(heap[0], heap[end]);
+        siftDown(heap, end, 0);
+    }
+    for (int i = 0; i < resultCount; i++)
+        cout << i + 1 << ". " << *heap[i].word << ": " << heap[i].score << " (" << heap[i].count << " times)" << endl;
+    delete[] heap;
+}
 
-        void display() {
-            WordNode* current = head;
-            while (current) {
-                cout << current -> word << ": " << current -> frequency << endl;
-                current = current -> next;
+/**
+ * Rank the terms that set FAKE apart from TRUE articles
+ *   metric 1: TF-IDF with each label as one document,
+ *             (tf in label / words in label) * log(articles / df)
+ *   metric 2: log-odds ratio with an informative Dirichlet prior (the pooled
+ *             counts), shown as a z-score; positive leans FAKE, negative TRUE
+ *   metric 3: TF-IDF with each subject as one document
+ * @param corpus Term statistics from buildTermCorpus
+ * @param metric Ranking to show
+ * @param topCount Number of terms per list
+ * @param minCount Terms seen fewer times are skipped
+ */
+void reportDistinctiveTerms(const TermCorpus& corpus, int metric, int topCount, int minCount) {
+    int termCount = corpus.terms.size;
+    int documents = corpus.labelDocs[0] + corpus.labelDocs[1];
+    TermScore* scores = new TermScore[termCount > 0 ? termCount : 1];
+    double* idf = new double[termCount > 0 ? termCount : 1];
+    for (int id = 0; id < termCount; id++) {
+        const int* stats = corpus.statsOf(id);
+        idf[id] = log(static_cast<double>(documents) / (stats[TERM_DF_FAKE] + stats[TERM_DF_TRUE]));
+    }
+
+    if (metric == 2) {
+        double total = static_cast<double>(corpus.labelTokens[0] + corpus.labelTokens[1]);
+        for (int side = 0; side < 2; side++) {
+            int scored = 0;
+            for (int id = 0; id < termCount; id++) {
+                const int* stats = corpus.statsOf(id);
+                double fake = stats[TERM_TF_FAKE], real = stats[TERM_TF_TRUE];
+                if (fake + real < minCount)
+                    continue;
+                double prior = fake + real;     // alpha_w, with alpha_0 = total
+                double delta = log((fake + prior) / (corpus.labelTokens[0] + total - fake - prior))
+                             - log((real + prior) / (corpus.labelTokens[1] + total - real - prior));
+                double z = delta / sqrt(1.0 / (fake + prior) + 1.0 / (real + prior));
+                scores[scored++] = { &corpus.terms.words[id], side == 0 ? z : -z, static_cast<int>(side == 0 ? fake : real) };
             }
+            displayTermScores(scores, scored, topCount, side == 0 ? "\nMost FAKE-leaning terms (log-odds z-score):"
+                                                                  : "\nMost TRUE-leaning terms (log-odds z-score):");
         }
-
-        ~WordList() {
-            WordNode* current = head;
-            while (current) {
-                WordNode* tmp = current;
-                current = current -> next;
-                delete tmp;
+    } else if (metric == 3) {
+        for (int s = 0; s < corpus.subjectCount; s++) {
+            int scored = 0;
+            for (int id = 0; id < termCount; id++) {
+                int tf = corpus.statsOf(id)[TERM_TF_SUBJECT + s];
+                if (tf < minCount || corpus.subjectTokens[s] == 0)
+                    continue;
+                scores[scored++] = { &corpus.terms.words[id], tf / static_cast<double>(corpus.subjectTokens[s]) * idf[id], tf };
             }
+            displayTermScores(scores, scored, topCount, "\nTop TF-IDF terms for subject \"" + corpus.subjectNames[s] + "\":");
+        }
+    } else {
+        for (int label = 0; label < 2; label++) {
+            int scored = 0;
+            for (int id = 0; id < termCount; id++) {
+                int tf = corpus.statsOf(id)[TERM_TF_FAKE + label];
+                if (tf < minCount || corpus.labelTokens[label] == 0)
+                    continue;
+                scores[scored++] = { &corpus.terms.words[id], tf / static_cast<double>(corpus.labelTokens[label]) * idf[id], tf };
+            }
+            displayTermScores(scores, scored, topCount, label == 0 ? "\nTop TF-IDF terms in FAKE articles:"
+                                                                   : "\nTop TF-IDF terms in TRUE articles:");
         }
-};
-
-string cleanWord(const string &word) {
-    string cleaned;
-    for (char c : word) {
-        if (isalnum(c)) cleaned.push_back(tolower(c));
     }
-    return cleaned;
+    cout << "\nArticles: " << corpus.labelDocs[0] << " FAKE, " << corpus.labelDocs[1] << " TRUE; Terms: " << termCount << endl;
+
+    delete[] idf;
+    delete[] scores;
 }
 
 bool parseAllCSVLine(const string &line, string &title, string &text, string &subject, string &date, string &identify) {
@@ -269,18 +2265,83 @@ void parseCSVLine(const string &line, string &title, string &text, string &subje
 }
 
 /**
- * Preload News into Linked List
- * @param infile The input file stream
+ * Position in the news feed. DataCleaned.csv is only ever appended to, so
+ * everything before 'offset' is already in the list; a refresh reads from
+ * there and hands the new nodes to the aggregates. Articles at or after
+ * 'indexedBytes' are not in WordIndex.bin and are kept in 'unindexed'.
+ */
+struct FeedState {
+    string filename;
+    unsigned long long offset = 0;      // bytes consumed, including the header
+    News* tail = nullptr;               // last node (nullptr = find it again)
+    int rowCount = 0;
+    unsigned long long indexedBytes = 0;
+    News** unindexed = nullptr;
+    int unindexedCount = 0;
+    int unindexedCapacity = 0;
+    unsigned long long pendingBytes = 0; // unterminated line held back by the last load
+};
+
+/**
+ * Load the articles appended to the feed since the last call (the whole
+ * file on the first call) onto the end of the list. DataCleaning ends every
+ * row with a newline, so a last line without one is a record that is still
+ * being written: it is held back (see 'pendingBytes') and read again next
+ * time, once it is complete.
+ * @param feed The feed position, advanced past the new lines
  * @param newsBook The linked list of news
+ * @param firstNew Set to the first new node (nullptr if there are none)
+ * @return Number of new articles, or -1 if the file is missing or shorter than the offset
  */
-void preloadNews(ifstream& infile, News*& newsBook) {
+int loadNewRecords(FeedState& feed, News*& newsBook, News*& firstNew) {
+    firstNew = nullptr;
+    feed.pendingBytes = 0;
+    ifstream infile(feed.filename, ios::binary | ios::ate);
+    if (!infile) return -1;
+    unsigned long long fileSize = static_cast<unsigned long long>(infile.tellg());
+    if (fileSize < feed.offset) return -1;
+    infile.seekg(static_cast<streamoff>(feed.offset));
+
+    if (!feed.tail) {
+        feed.tail = newsBook;
+        while (feed.tail && feed.tail -> next) feed.tail = feed.tail -> next;
+    }
+
+    int added = 0;
     string line;
-    getline(infile, line); // Skip the header line
     while (getline(infile, line)) {
-        string title, news, subject, date, identify;
-        parseCSVLine(line, title, news, subject, date, identify);
-        insertAtEnd(&newsBook, title, news, subject, date, identify);
+        if (infile.eof()) {
+            feed.pendingBytes = line.size();
+            break;
+        }
+        unsigned long long start = feed.offset;
+        feed.offset += line.size() + 1;
+        if (start == 0) continue; // Skip the header line
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+
+        string title, text, subject, date, identify;
+        parseCSVLine(line, title, text, subject, date, identify);
+        News* node = new News(title, text, subject, date, identify);
+        if (feed.tail) feed.tail -> next = node;
+        else newsBook = node;
+        feed.tail = node;
+        if (!firstNew) firstNew = node;
+        added++;
+
+        if (feed.indexedBytes > 0 && start >= feed.indexedBytes) {
+            if (feed.unindexedCount == feed.unindexedCapacity) {
+                int capacity = feed.unindexedCapacity ? feed.unindexedCapacity * 2 : 64;
+                News** larger = new News*[capacity];
+                for (int i = 0; i < feed.unindexedCount; i++) larger[i] = feed.unindexed[i];
+                delete[] feed.unindexed;
+                feed.unindexed = larger;
+                feed.unindexedCapacity = capacity;
+            }
+            feed.unindexed[feed.unindexedCount++] = node;
+        }
     }
+    feed.rowCount += added;
+    return added;
 }
 
 /**
@@ -387,75 +2448,785 @@ News* quickSortRec(News* head, News* end) {
         while (tmp -> next) tmp = tmp -> next;
         tmp -> next = pivot;
     }
-    pivot -> next = quickSortRec(pivot -> next, newEnd);
-    return newHead;
+    pivot -> next = quickSortRec(pivot -> next, newEnd);
+    return newHead;
+}
+
+/**
+ * QuickSort driver function
+ * @param headRef The head of the linked list
+ */
+void quickSort(News** headRef) {
+    if (!headRef || !(*headRef) || !(*headRef) -> next) return;
+    
+    News* last = *headRef;
+    while (last -> next) last = last -> next; // Find the last node
+
+    *headRef = quickSortRec(*headRef, last);
+}
+
+/**
+ * Whether an article counts as political news. The list baseline, the cube
+ * slice and the facet bitmaps all use this exact set, so they agree
+ * @param subject The article's subject
+ * @return true for "politics" and "politicsNews"
+ */
+bool isPoliticalSubject(const string& subject) {
+    return subject == "politics" || subject == "politicsNews";
+}
+
+/**
+ * Calculate Total Number of Political News by walking the whole list; the
+ * baseline for countPoliticNewsCube
+ * @param news The linked list of news
+ */
+void countPoliticNews(News** news) {
+    News* currentNews = *news;
+    // Initialize variables
+    double totalPoliticalNews = 0;
+    double fakePoliticalNews2016 = 0;
+
+    // Read through each line
+    while (currentNews != nullptr) {
+        stringstream ss(currentNews -> date);
+        // Trim the date
+        string day, month, year;
+        getline(ss, day, '-');
+        getline(ss, month, '-');
+        getline(ss, year);
+        
+        // If subject is politics and year is 2016
+        if (isPoliticalSubject(currentNews -> subject) && year == "2016") {
+            // If identify is TRUE
+            if (currentNews -> identify == "FAKE") {
+                fakePoliticalNews2016++;
+            }
+            totalPoliticalNews++;
+        }
+        currentNews = currentNews -> next;
+    }
+    // Print the results
+    cout << "Total number of political news articles: " << totalPoliticalNews << endl;
+    cout << "Total number of political news articles in 2016: " << fakePoliticalNews2016 << endl;
+    // If total news is greater than 0
+    if (totalPoliticalNews > 0) {
+        // Calculate the percentage of fake news articles in 2016
+        double percentage = (fakePoliticalNews2016 / totalPoliticalNews) * 100;
+        cout << "Percentage of fake news articles in 2016: " << percentage << "%" << endl;
+    } else { // No political news articles found
+        cout << "No political news articles found" << endl;
+    }
+}
+
+/**
+ * Convert a dd-mm-yyyy date into a sortable YYYYMMDD integer
+ * @param date The date string to pack
+ * @return the packed date, or 0 if the date is not well formed
+ */
+int packDate(const string& date) {
+    if (date.size() != 10 || date[2] != '-' || date[5] != '-') return 0;
+    for (int i = 0; i < 10; i++) {
+        if (i != 2 && i != 5 && !isdigit(static_cast<unsigned char>(date[i]))) return 0;
+    }
+    int day = (date[0] - '0') * 10 + (date[1] - '0');
+    int month = (date[3] - '0') * 10 + (date[4] - '0');
+    int year = (date[6] - '0') * 1000 + (date[7] - '0') * 100 + (date[8] - '0') * 10 + (date[9] - '0');
+    if (day < 1 || day > 31 || month < 1 || month > 12) return 0;
+    return year * 10000 + month * 100 + day;
+}
+
+/**
+ * Add the words of the articles WordIndex.bin does not cover yet, with the
+ * same filter as WordCountIndex::query, so that the index plus this delta
+ * gives the count for the whole list
+ * @param feed The feed (its unindexed articles)
+ * @param filter Articles to include
+ * @param wordList Receives the counts
+ * @return Number of articles counted
+ */
+int countUnindexedWords(const FeedState& feed, const WordCountIndex::Filter& filter, WordList& wordList) {
+    int used = 0;
+    for (int i = 0; i < feed.unindexedCount; i++) {
+        News* cur = feed.unindexed[i];
+        if (filter.label >= 0 && (cur -> identify == "FAKE" ? 0 : 1) != filter.label) continue;
+        unsigned int yearMonth = static_cast<unsigned int>(packDate(cur -> date) / 100);
+        if (filter.fromMonth != 0 && (yearMonth < filter.fromMonth || yearMonth > filter.toMonth)) continue;
+        if (!filter.subject.empty() && !WordCountIndex::containsIgnoreCase(cur -> subject, filter.subject)) continue;
+        used++;
+        forEachWord(cur -> title, [&wordList](string_view token) { wordList.insertOrUpdate(token); });
+        forEachWord(cur -> text, [&wordList](string_view token) { wordList.insertOrUpdate(token); });
+    }
+    return used;
+}
+
+/**
+ * Roaring-style compressed bitmap of row ids.
+ * Rows are split into chunks of 65536 by their high 16 bits. A sparse
+ * chunk stores its sorted low 16 bits in an array; once it holds more
+ * than 4096 rows it switches to a plain 65536-bit bitmap.
+ */
+const int ROARING_ARRAY_MAX = 4096;
+const int ROARING_WORDS = 1024;     // 65536 bits
+
+struct RoaringContainer {
+    int key = 0;                            // high 16 bits of the rows
+    int cardinality = 0;
+    int arrayCapacity = 0;
+    unsigned short* array = nullptr;        // sorted low bits (sparse chunk)
+    unsigned long long* bits = nullptr;     // 1024 words (dense chunk)
+};
+
+struct RoaringBitmap {
+    RoaringContainer* containers = nullptr;
+    int containerCount = 0;
+    int capacity = 0;
+};
+
+// Portable 64-bit population count.
+int popcount64(unsigned long long x) {
+    x = x - ((x >> 1) & 0x5555555555555555ULL);
+    x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+    x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return static_cast<int>((x * 0x0101010101010101ULL) >> 56);
+}
+
+RoaringContainer& roaringAppendContainer(RoaringBitmap& bm, int key) {
+    if (bm.containerCount == bm.capacity) {
+        int newCapacity = bm.capacity ? bm.capacity * 2 : 4;
+        RoaringContainer* grown = new RoaringContainer[newCapacity];
+        for (int i = 0; i < bm.containerCount; i++)
+            grown[i] = bm.containers[i];
+        delete[] bm.containers;
+        bm.containers = grown;
+        bm.capacity = newCapacity;
+    }
+    RoaringContainer& c = bm.containers[bm.containerCount++];
+    c = RoaringContainer();
+    c.key = key;
+    return c;
+}
+
+// Switch a sparse chunk to a dense bitmap.
+void roaringToBitmap(RoaringContainer& c) {
+    c.bits = new unsigned long long[ROARING_WORDS]();
+    for (int i = 0; i < c.cardinality; i++)
+        c.bits[c.array[i] >> 6] |= 1ULL << (c.array[i] & 63);
+    delete[] c.array;
+    c.array = nullptr;
+    c.arrayCapacity = 0;
+}
+
+/**
+ * Add a row id. Rows must be added in increasing order,
+ * which is how every index here is built (one pass over the rows).
+ */
+void roaringAdd(RoaringBitmap& bm, int row) {
+    int key = row >> 16;
+    unsigned short low = static_cast<unsigned short>(row & 0xFFFF);
+    RoaringContainer& c = (bm.containerCount > 0 && bm.containers[bm.containerCount - 1].key == key)
+                          ? bm.containers[bm.containerCount - 1]
+                          : roaringAppendContainer(bm, key);
+    if (c.bits) {
+        c.bits[low >> 6] |= 1ULL << (low & 63);
+        c.cardinality++;
+        return;
+    }
+    if (c.cardinality == ROARING_ARRAY_MAX) {
+        roaringToBitmap(c);
+        c.bits[low >> 6] |= 1ULL << (low & 63);
+        c.cardinality++;
+        return;
+    }
+    if (c.cardinality == c.arrayCapacity) {
+        int newCapacity = c.arrayCapacity ? c.arrayCapacity * 2 : 16;
+        unsigned short* grown = new unsigned short[newCapacity];
+        for (int i = 0; i < c.cardinality; i++)
+            grown[i] = c.array[i];
+        delete[] c.array;
+        c.array = grown;
+        c.arrayCapacity = newCapacity;
+    }
+    c.array[c.cardinality++] = low;
+}
+
+int roaringCount(const RoaringBitmap& bm) {
+    int total = 0;
+    for (int i = 0; i < bm.containerCount; i++)
+        total += bm.containers[i].cardinality;
+    return total;
+}
+
+// AND of two chunks with the same key, written into 'out' (already keyed).
+void roaringAndContainer(const RoaringContainer& a, const RoaringContainer& b, RoaringContainer& out) {
+    if (a.bits && b.bits) {
+        int card = 0;
+        for (int w = 0; w < ROARING_WORDS; w++)
+            card += popcount64(a.bits[w] & b.bits[w]);
+        out.cardinality = card;
+        if (card > ROARING_ARRAY_MAX) {
+            out.bits = new unsigned long long[ROARING_WORDS];
+            for (int w = 0; w < ROARING_WORDS; w++)
+                out.bits[w] = a.bits[w] & b.bits[w];
+        } else {
+            out.array = new unsigned short[card > 0 ? card : 1];
+            out.arrayCapacity = card;
+            int n = 0;
+            for (int w = 0; w < ROARING_WORDS; w++) {
+                unsigned long long word = a.bits[w] & b.bits[w];
+                while (word) {
+                    int bit = popcount64((word & (~word + 1)) - 1);
+                    out.array[n++] = static_cast<unsigned short>(w * 64 + bit);
+                    word &= word - 1;
+                }
+            }
+        }
+        return;
+    }
+    // At least one side is sparse: the result fits in an array.
+    const RoaringContainer& sparse = a.bits ? b : a;
+    const RoaringContainer& other = a.bits ? a : b;
+    out.array = new unsigned short[sparse.cardinality > 0 ? sparse.cardinality : 1];
+    out.arrayCapacity = sparse.cardinality;
+    int n = 0;
+    if (other.bits) {
+        for (int i = 0; i < sparse.cardinality; i++) {
+            unsigned short v = sparse.array[i];
+            if (other.bits[v >> 6] & (1ULL << (v & 63)))
+                out.array[n++] = v;
+        }
+    } else {
+        int i = 0, j = 0;
+        while (i < sparse.cardinality && j < other.cardinality) {
+            if (sparse.array[i] < other.array[j]) i++;
+            else if (sparse.array[i] > other.array[j]) j++;
+            else { out.array[n++] = sparse.array[i]; i++; j++; }
+        }
+    }
+    out.cardinality = n;
+}
+
+/**
+ * Intersection of two bitmaps (new bitmap).
+ */
+RoaringBitmap roaringAnd(const RoaringBitmap& a, const RoaringBitmap& b) {
+    RoaringBitmap out;
+    int i = 0, j = 0;
+    while (i < a.containerCount && j < b.containerCount) {
+        if (a.containers[i].key < b.containers[j].key) i++;
+        else if (a.containers[i].key > b.containers[j].key) j++;
+        else {
+            RoaringContainer& c = roaringAppendContainer(out, a.containers[i].key);
+            roaringAndContainer(a.containers[i], b.containers[j], c);
+            if (c.cardinality == 0) {
+                delete[] c.array;
+                delete[] c.bits;
+                out.containerCount--;
+            }
+            i++;
+            j++;
+        }
+    }
+    return out;
+}
+
+/**
+ * Union of two bitmaps (new bitmap). Chunks are merged as
+ * dense bitmaps and shrunk back to arrays when they are sparse.
+ */
+RoaringBitmap roaringOr(const RoaringBitmap& a, const RoaringBitmap& b) {
+    RoaringBitmap out;
+    int i = 0, j = 0;
+    while (i < a.containerCount || j < b.containerCount) {
+        int key;
+        if (j >= b.containerCount || (i < a.containerCount && a.containers[i].key < b.containers[j].key))
+            key = a.containers[i].key;
+        else
+            key = b.containers[j].key;
+        RoaringContainer& c = roaringAppendContainer(out, key);
+        c.bits = new unsigned long long[ROARING_WORDS]();
+        const RoaringContainer* sides[2] = {
+            (i < a.containerCount && a.containers[i].key == key) ? &a.containers[i++] : nullptr,
+            (j < b.containerCount && b.containers[j].key == key) ? &b.containers[j++] : nullptr
+        };
+        for (int s = 0; s < 2; s++) {
+            const RoaringContainer* side = sides[s];
+            if (!side) continue;
+            if (side->bits) {
+                for (int w = 0; w < ROARING_WORDS; w++)
+                    c.bits[w] |= side->bits[w];
+            } else {
+                for (int k = 0; k < side->cardinality; k++)
+                    c.bits[side->array[k] >> 6] |= 1ULL << (side->array[k] & 63);
+            }
+        }
+        c.cardinality = 0;
+        for (int w = 0; w < ROARING_WORDS; w++)
+            c.cardinality += popcount64(c.bits[w]);
+        if (c.cardinality <= ROARING_ARRAY_MAX) {
+            unsigned long long* bits = c.bits;
+            c.bits = nullptr;
+            c.array = new unsigned short[c.cardinality > 0 ? c.cardinality : 1];
+            c.arrayCapacity = c.cardinality;
+            int n = 0;
+            for (int w = 0; w < ROARING_WORDS; w++) {
+                for (unsigned long long word = bits[w]; word; word &= word - 1)
+                    c.array[n++] = static_cast<unsigned short>(w * 64 + popcount64((word & (~word + 1)) - 1));
+            }
+            delete[] bits;
+        }
+    }
+    return out;
+}
+
+/**
+ * Size of the intersection without building it.
+ */
+int roaringAndCount(const RoaringBitmap& a, const RoaringBitmap& b) {
+    int total = 0;
+    int i = 0, j = 0;
+    while (i < a.containerCount && j < b.containerCount) {
+        if (a.containers[i].key < b.containers[j].key) { i++; continue; }
+        if (a.containers[i].key > b.containers[j].key) { j++; continue; }
+        const RoaringContainer& x = a.containers[i++];
+        const RoaringContainer& y = b.containers[j++];
+        if (x.bits && y.bits) {
+            for (int w = 0; w < ROARING_WORDS; w++)
+                total += popcount64(x.bits[w] & y.bits[w]);
+        } else if (x.bits || y.bits) {
+            const RoaringContainer& sparse = x.bits ? y : x;
+            const RoaringContainer& dense = x.bits ? x : y;
+            for (int k = 0; k < sparse.cardinality; k++) {
+                unsigned short v = sparse.array[k];
+                if (dense.bits[v >> 6] & (1ULL << (v & 63)))
+                    total++;
+            }
+        } else {
+            int p = 0, q = 0;
+            while (p < x.cardinality && q < y.cardinality) {
+                if (x.array[p] < y.array[q]) p++;
+                else if (x.array[p] > y.array[q]) q++;
+                else { total++; p++; q++; }
+            }
+        }
+    }
+    return total;
+}
+
+void freeRoaring(RoaringBitmap& bm) {
+    for (int i = 0; i < bm.containerCount; i++) {
+        delete[] bm.containers[i].array;
+        delete[] bm.containers[i].bits;
+    }
+    delete[] bm.containers;
+    bm = RoaringBitmap();
+}
+
+/**
+ * Facet bitmaps built at load time: one bitmap per subject, per
+ * label and per year-month. Row ids are load positions.
+ */
+struct FacetIndex {
+    int rowCount = 0;
+    int subjectCount = 0;
+    int subjectCapacity = 0;
+    string* subjectNames = nullptr;
+    RoaringBitmap* subjects = nullptr;  // [subject], subjectCapacity entries
+    RoaringBitmap fake;
+    RoaringBitmap real;
+    int minYear = 0;
+    int yearCount = 0;
+    RoaringBitmap* years = nullptr;     // [year - minYear]
+    RoaringBitmap* months = nullptr;    // [(year - minYear) * 12 + month - 1]
+};
+
+/**
+ * Union of every subject bitmap whose name contains
+ * 'subject', or passes subjectFilter when one is given (new bitmap).
+ */
+RoaringBitmap facetSubjectUnion(const FacetIndex& index, const string& subject, bool (*subjectFilter)(const string&)) {
+    RoaringBitmap result;
+    for (int s = 0; s < index.subjectCount; s++) {
+        const string& name = index.subjectNames[s];
+        if (subjectFilter ? !subjectFilter(name) : name.find(subject) == string::npos)
+            continue;
+        RoaringBitmap merged = roaringOr(result, index.subjects[s]);
+        freeRoaring(result);
+        result = merged;
+    }
+    return result;
+}
+
+/**
+ * Generic facet query. Counts rows whose subject contains
+ * 'subject' ("" = any) or passes subjectFilter when one is given, with the
+ * given label (-1 = any, 0 = FAKE, 1 = TRUE), year (0 = any) and month
+ * (0 = any).
+ */
+int facetCount(const FacetIndex& index, const string& subject, int label, int year, int month,
+               bool (*subjectFilter)(const string&) = nullptr) {
+    // Time facet first: it is the most selective for the reports.
+    const RoaringBitmap* timeFacet = nullptr;
+    if (year != 0) {
+        if (year < index.minYear || year >= index.minYear + index.yearCount)
+            return 0;
+        if (month >= 1 && month <= 12)
+            timeFacet = &index.months[(year - index.minYear) * 12 + month - 1];
+        else
+            timeFacet = &index.years[year - index.minYear];
+    }
+    const RoaringBitmap* labelFacet = (label == 0) ? &index.fake : (label == 1) ? &index.real : nullptr;
+
+    bool anySubject = subject.empty() && !subjectFilter;
+    RoaringBitmap subjectFacet;
+    if (!anySubject)
+        subjectFacet = facetSubjectUnion(index, subject, subjectFilter);
+
+    const RoaringBitmap* facets[3];
+    int facetTotal = 0;
+    if (timeFacet) facets[facetTotal++] = timeFacet;
+    if (!anySubject) facets[facetTotal++] = &subjectFacet;
+    if (labelFacet) facets[facetTotal++] = labelFacet;
+
+    int result;
+    if (facetTotal == 0) {
+        result = index.rowCount;
+    } else if (facetTotal == 1) {
+        result = roaringCount(*facets[0]);
+    } else if (facetTotal == 2) {
+        result = roaringAndCount(*facets[0], *facets[1]);
+    } else {
+        RoaringBitmap pair = roaringAnd(*facets[0], *facets[1]);
+        result = roaringAndCount(pair, *facets[2]);
+        freeRoaring(pair);
+    }
+    freeRoaring(subjectFacet);
+    return result;
+}
+
+void freeFacetIndex(FacetIndex& index) {
+    for (int s = 0; s < index.subjectCount; s++)
+        freeRoaring(index.subjects[s]);
+    freeRoaring(index.fake);
+    freeRoaring(index.real);
+    for (int y = 0; y < index.yearCount; y++)
+        freeRoaring(index.years[y]);
+    for (int m = 0; m < index.yearCount * 12; m++)
+        freeRoaring(index.months[m]);
+    delete[] index.subjects;
+    delete[] index.subjectNames;
+    delete[] index.years;
+    delete[] index.months;
+    index.subjects = nullptr;
+    index.subjectNames = nullptr;
+    index.years = index.months = nullptr;
+    index.subjectCount = index.subjectCapacity = index.yearCount = index.rowCount = 0;
+}
+
+/**
+ * Widen the year range to include 'year'. The bitmaps are plain structs, so
+ * the existing ones are moved into the larger arrays without copying rows.
+ */
+void growFacetYears(FacetIndex& index, int year) {
+    int minYear = (index.yearCount == 0 || year < index.minYear) ? year : index.minYear;
+    int maxYear = (index.yearCount == 0 || year > index.minYear + index.yearCount - 1) ? year : index.minYear + index.yearCount - 1;
+    int yearCount = maxYear - minYear + 1;
+    RoaringBitmap* years = new RoaringBitmap[yearCount];
+    RoaringBitmap* months = new RoaringBitmap[yearCount * 12];
+    int shift = index.minYear - minYear;
+    for (int y = 0; y < index.yearCount; y++) {
+        years[y + shift] = index.years[y];
+        for (int m = 0; m < 12; m++) months[(y + shift) * 12 + m] = index.months[y * 12 + m];
+    }
+    delete[] index.years;
+    delete[] index.months;
+    index.years = years;
+    index.months = months;
+    index.minYear = minYear;
+    index.yearCount = yearCount;
+}
+
+/**
+ * Append the articles from 'first' to the end of the list to the facet
+ * bitmaps, numbering them on from index.rowCount. Used for the initial build
+ * and for the articles a refresh loads.
+ * @param index The index to update
+ * @param first The first article to add
+ */
+void addToFacetIndex(FacetIndex& index, News* first) {
+    int row = index.rowCount;
+    for (News* cur = first; cur; cur = cur -> next, row++) {
+        int oldCapacity = index.subjectCapacity;
+        int s = internSubject(index.subjectNames, index.subjectCount, index.subjectCapacity, cur -> subject);
+        if (index.subjectCapacity != oldCapacity) {
+            // The bitmaps are plain structs: move them across without copying rows
+            RoaringBitmap* subjects = new RoaringBitmap[index.subjectCapacity];
+            for (int i = 0; i < oldCapacity; i++) subjects[i] = index.subjects[i];
+            delete[] index.subjects;
+            index.subjects = subjects;
+        }
+        roaringAdd(index.subjects[s], row);
+
+        roaringAdd(cur -> identify == "FAKE" ? index.fake : index.real, row);
+
+        int packed = packDate(cur -> date);
+        if (packed != 0) {
+            int year = packed / 10000;
+            if (index.yearCount == 0 || year < index.minYear || year >= index.minYear + index.yearCount)
+                growFacetYears(index, year);
+            int y = year - index.minYear;
+            roaringAdd(index.years[y], row);
+            roaringAdd(index.months[y * 12 + packed / 100 % 100 - 1], row);
+        }
+    }
+    index.rowCount = row;
+}
+
+/**
+ * Build the facet bitmaps in one pass over the list, appending each row id
+ * (load position) to its subject, label, year and year-month bitmaps
+ * @param head The head of the linked list
+ * @param index The index to fill
+ */
+void buildFacetIndex(News* head, FacetIndex& index) {
+    int maxYear = 0;
+    index.minYear = 0;
+    for (News* cur = head; cur; cur = cur -> next) {
+        int packed = packDate(cur -> date);
+        if (packed == 0) continue;
+        int year = packed / 10000;
+        if (index.minYear == 0 || year < index.minYear) index.minYear = year;
+        if (year > maxYear) maxYear = year;
+    }
+    index.yearCount = (index.minYear > 0) ? maxYear - index.minYear + 1 : 0;
+    index.years = new RoaringBitmap[index.yearCount > 0 ? index.yearCount : 1];
+    index.months = new RoaringBitmap[index.yearCount > 0 ? index.yearCount * 12 : 1];
+    index.rowCount = 0;
+    addToFacetIndex(index, head);
+}
+
+/**
+ * Aggregate cube built at load time: article counts by (year, month,
+ * subject, label) in one dense array. Its size depends only on the number
+ * of distinct years and subjects, so every count below reads a fixed
+ * number of cells however long the list is. The last year slot holds
+ * articles without a valid date; month 0 is unused for dated articles.
+ */
+const int CUBE_MONTHS = 13;         // 0 = unknown, 1..12
+
+// Dimensions for cubeBreakdown
+const int CUBE_BY_YEAR = 0;
+const int CUBE_BY_MONTH = 1;
+const int CUBE_BY_SUBJECT = 2;
+const int CUBE_BY_LABEL = 3;
+
+struct AggregateCube {
+    int total = 0;
+    int minYear = 0;
+    int yearCount = 0;                  // year slots = yearCount + 1
+    int subjectCount = 0;
+    int subjectCapacity = 0;            // subject stride of cells
+    string* subjectNames = nullptr;
+    int* cells = nullptr;               // [((yearSlot * 13 + month) * subjectCapacity + subject) * 2 + label]
+};
+
+// A sub-cube: every field left at its default matches everything
+struct CubeSlice {
+    string subject;                     // substring of the subject name
+    bool (*subjectFilter)(const string&) = nullptr;    // if set, used instead of 'subject'
+    int label = -1;                     // 0 = FAKE, 1 = TRUE
+    int fromYear = 0, toYear = 0;       // inclusive
+    int fromMonth = 0, toMonth = 0;     // inclusive, 1..12
+};
+
+int cubeCell(const AggregateCube& cube, int yearSlot, int month, int subject, int label) {
+    return ((yearSlot * CUBE_MONTHS + month) * cube.subjectCapacity + subject) * 2 + label;
+}
+
+/**
+ * Widen the year dimension to include 'year', moving every year slot (and
+ * the "no year" slot, which stays last) to its place in the larger array
+ */
+void growCubeYears(AggregateCube& cube, int year) {
+    int minYear = (cube.yearCount == 0 || year < cube.minYear) ? year : cube.minYear;
+    int maxYear = (cube.yearCount == 0 || year > cube.minYear + cube.yearCount - 1) ? year : cube.minYear + cube.yearCount - 1;
+    int yearCount = maxYear - minYear + 1;
+    int slotSize = CUBE_MONTHS * cube.subjectCapacity * 2;
+    int* cells = new int[(yearCount + 1) * slotSize]();
+    int shift = (cube.yearCount == 0) ? 0 : cube.minYear - minYear;
+    for (int slot = 0; slot <= cube.yearCount; slot++) {
+        int target = (slot == cube.yearCount) ? yearCount : slot + shift;
+        for (int i = 0; i < slotSize; i++) cells[target * slotSize + i] = cube.cells[slot * slotSize + i];
+    }
+    delete[] cube.cells;
+    cube.cells = cells;
+    cube.minYear = minYear;
+    cube.yearCount = yearCount;
 }
 
 /**
- * QuickSort driver function
- * @param headRef The head of the linked list
+ * Widen the subject stride after the name table grew from oldCapacity,
+ * moving every (year, month) row of subject cells to its larger row
  */
-void quickSort(News** headRef) {
-    if (!headRef || !(*headRef) || !(*headRef) -> next) return;
-    
-    News* last = *headRef;
-    while (last -> next) last = last -> next; // Find the last node
+void growCubeSubjects(AggregateCube& cube, int oldCapacity) {
+    int rows = (cube.yearCount + 1) * CUBE_MONTHS;
+    int* cells = new int[rows * cube.subjectCapacity * 2]();
+    for (int r = 0; r < rows; r++)
+        for (int i = 0; i < oldCapacity * 2; i++) cells[r * cube.subjectCapacity * 2 + i] = cube.cells[r * oldCapacity * 2 + i];
+    delete[] cube.cells;
+    cube.cells = cells;
+}
 
-    *headRef = quickSortRec(*headRef, last);
+/**
+ * Add the articles from 'first' to the end of the list to their cells.
+ * Used for the initial build and for the articles a refresh loads.
+ * @param cube The cube to update
+ * @param first The first article to add
+ */
+void addToAggregateCube(AggregateCube& cube, News* first) {
+    for (News* cur = first; cur; cur = cur -> next) {
+        int oldCapacity = cube.subjectCapacity;
+        int s = internSubject(cube.subjectNames, cube.subjectCount, cube.subjectCapacity, cur -> subject);
+        if (cube.subjectCapacity != oldCapacity) growCubeSubjects(cube, oldCapacity);
+
+        int packed = packDate(cur -> date);
+        if (packed != 0 && (cube.yearCount == 0 || packed / 10000 < cube.minYear || packed / 10000 >= cube.minYear + cube.yearCount))
+            growCubeYears(cube, packed / 10000);
+        int yearSlot = (packed != 0) ? packed / 10000 - cube.minYear : cube.yearCount;
+        int month = (packed != 0) ? packed / 100 % 100 : 0;
+        cube.cells[cubeCell(cube, yearSlot, month, s, cur -> identify == "FAKE" ? 0 : 1)]++;
+        cube.total++;
+    }
 }
 
 /**
- * Iterative function to count news articles
+ * Add every article to its cell in one pass over the list (after a pass
+ * over the dates and subjects to size the year and subject dimensions)
  * @param head The head of the linked list
+ * @param cube The cube to fill
  */
-void iterativeCount(News* head) {
-    int count = 0;
-    News* current = head;
-    while (current != nullptr) {
-        count++;
-        current = current -> next;
+void buildAggregateCube(News* head, AggregateCube& cube) {
+    int maxYear = 0;
+    cube.minYear = 0;
+    for (News* cur = head; cur; cur = cur -> next) {
+        internSubject(cube.subjectNames, cube.subjectCount, cube.subjectCapacity, cur -> subject);
+        int packed = packDate(cur -> date);
+        if (packed == 0) continue;
+        int year = packed / 10000;
+        if (cube.minYear == 0 || year < cube.minYear) cube.minYear = year;
+        if (year > maxYear) maxYear = year;
     }
-    cout << "Total news articles: " << count << endl;
+    cube.yearCount = (cube.minYear > 0) ? maxYear - cube.minYear + 1 : 0;
+    cube.cells = new int[(cube.yearCount + 1) * CUBE_MONTHS * cube.subjectCapacity * 2]();
+    addToAggregateCube(cube, head);
+}
+
+void freeAggregateCube(AggregateCube& cube) {
+    delete[] cube.cells;
+    delete[] cube.subjectNames;
+    cube = AggregateCube();
 }
 
 /**
- * Calculate Total Number of Political News
- * @param news The linked list of news
+ * Number of entries cubeBreakdown writes for a dimension
  */
-void countPoliticNews(News** news) {
-    News* currentNews = *news;
-    // Initialize variables
-    double totalPoliticalNews = 0;
-    double fakePoliticalNews2016 = 0;
+int cubeDimensionSize(const AggregateCube& cube, int dimension) {
+    switch (dimension) {
+        case CUBE_BY_YEAR: return cube.yearCount + 1;
+        case CUBE_BY_MONTH: return CUBE_MONTHS;
+        case CUBE_BY_SUBJECT: return cube.subjectCount;
+        default: return 2;
+    }
+}
 
-    // Read through each line
-    while (currentNews != nullptr) {
-        stringstream ss(currentNews -> date);
-        // Trim the date
-        string day, month, year;
-        getline(ss, day, '-');
-        getline(ss, month, '-');
-        getline(ss, year);
-        
-        // If subject is politics and year is 2016
-        if ((currentNews -> subject == "politics" || currentNews -> subject == "politicsNews") && year == "2016") {
-            // If identify is TRUE
-            if (currentNews -> identify == "FAKE") {
-                fakePoliticalNews2016++;
+/**
+ * Totals of a slice along one dimension
+ * @param cube The aggregate cube
+ * @param slice Cells to add up
+ * @param dimension CUBE_BY_YEAR ([year - minYear], last entry = no date),
+ *        CUBE_BY_MONTH ([month]), CUBE_BY_SUBJECT ([subject id]) or
+ *        CUBE_BY_LABEL ([0] FAKE, [1] TRUE)
+ * @param totals Receives cubeDimensionSize entries
+ */
+void cubeBreakdown(const AggregateCube& cube, const CubeSlice& slice, int dimension, int* totals) {
+    for (int i = 0; i < cubeDimensionSize(cube, dimension); i++) totals[i] = 0;
+
+    // Year slots in the slice; a year filter never matches the no-date slot
+    int firstSlot = 0, lastSlot = cube.yearCount;
+    if (slice.fromYear != 0 || slice.toYear != 0) {
+        int fromYear = slice.fromYear != 0 ? slice.fromYear : cube.minYear;
+        int toYear = slice.toYear != 0 ? slice.toYear : cube.minYear + cube.yearCount - 1;
+        firstSlot = max(fromYear - cube.minYear, 0);
+        lastSlot = min(toYear - cube.minYear, cube.yearCount - 1);
+    }
+    int firstMonth = 0, lastMonth = CUBE_MONTHS - 1;
+    if (slice.fromMonth != 0 || slice.toMonth != 0) {
+        firstMonth = max(slice.fromMonth, 1);
+        lastMonth = min(slice.toMonth != 0 ? slice.toMonth : 12, 12);
+    }
+    bool* subjectMatches = new bool[cube.subjectCount > 0 ? cube.subjectCount : 1];
+    for (int s = 0; s < cube.subjectCount; s++)
+        subjectMatches[s] = slice.subjectFilter ? slice.subjectFilter(cube.subjectNames[s])
+                          : slice.subject.empty() || cube.subjectNames[s].find(slice.subject) != string::npos;
+    int firstLabel = (slice.label == 1) ? 1 : 0;
+    int lastLabel = (slice.label == 0) ? 0 : 1;
+
+    for (int y = firstSlot; y <= lastSlot; y++) {
+        for (int m = firstMonth; m <= lastMonth; m++) {
+            for (int s = 0; s < cube.subjectCount; s++) {
+                if (!subjectMatches[s]) continue;
+                for (int l = firstLabel; l <= lastLabel; l++) {
+                    int cell = cube.cells[cubeCell(cube, y, m, s, l)];
+                    switch (dimension) {
+                        case CUBE_BY_YEAR: totals[y] += cell; break;
+                        case CUBE_BY_MONTH: totals[m] += cell; break;
+                        case CUBE_BY_SUBJECT: totals[s] += cell; break;
+                        default: totals[l] += cell; break;
+                    }
+                }
             }
-            totalPoliticalNews++;
         }
-        currentNews = currentNews -> next;
-    }
-    // Print the results
+    }    delete[] subjectMatches;
+}
+
+/**
+ * Number of articles in a slice
+ */
+int cubeCount(const AggregateCube& cube, const CubeSlice& slice) {
+    int labels[2];
+    cubeBreakdown(cube, slice, CUBE_BY_LABEL, labels);
+    return labels[0] + labels[1];
+}
+
+/**
+ * Count news articles from the aggregate cube without walking the list
+ * @param cube The aggregate cube
+ */
+void countNewsCube(const AggregateCube& cube) {
+    int labels[2];
+    cubeBreakdown(cube, CubeSlice(), CUBE_BY_LABEL, labels);
+    cout << "Total news articles: " << cube.total << " (FAKE: " << labels[0] << ", TRUE: " << labels[1] << ")" << endl;
+}
+
+/**
+ * Calculate Total Number of Political News from the aggregate cube
+ * (politics in 2016 broken down by label)
+ * @param cube The aggregate cube
+ */
+void countPoliticNewsCube(const AggregateCube& cube) {
+    CubeSlice politics2016;
+    politics2016.subjectFilter = isPoliticalSubject;
+    politics2016.fromYear = politics2016.toYear = 2016;
+    int labels[2];
+    cubeBreakdown(cube, politics2016, CUBE_BY_LABEL, labels);
+    double totalPoliticalNews = labels[0] + labels[1];
+    double fakePoliticalNews2016 = labels[0];
+
     cout << "Total number of political news articles: " << totalPoliticalNews << endl;
     cout << "Total number of political news articles in 2016: " << fakePoliticalNews2016 << endl;
-    // If total news is greater than 0
     if (totalPoliticalNews > 0) {
-        // Calculate the percentage of fake news articles in 2016
         double percentage = (fakePoliticalNews2016 / totalPoliticalNews) * 100;
         cout << "Percentage of fake news articles in 2016: " << percentage << "%" << endl;
-    } else { // No political news articles found
+    } else {
         cout << "No political news articles found" << endl;
     }
 }
@@ -527,19 +3298,334 @@ void displayMemoryStats(const MemoryStats& stats, const string& operationName, s
     cout << "----------------------------------------" << endl;
 }
 
+/**
+ * Script mode: run a list of operations against one loaded dataset without
+ * the menu and print the results and timings as JSON. Operations come from
+ * the command line (--run "top 10") or a script file (--script FILE, one per
+ * line, '#' starts a comment); --out FILE writes the JSON to a file instead
+ * of standard output.
+ *   sort quick|insertion          sort the list by date, starting from the load order
+ *   search YEAR                   articles published in YEAR
+ *   percentage [YEAR] [SUBJECT]   fake share of SUBJECT in YEAR by month (default 2016, politics + politicsNews)
+ *   top N                         N most frequent words in fake government news
+ *   stopwords on|off              stopword filter for the word counts
+ */
+struct BatchJob {
+    string* ops = nullptr;
+    int opCount = 0;
+    int opCapacity = 0;
+    string outFile;     // empty = standard output
+};
+
+void addBatchOp(BatchJob& job, const string& op) {
+    if (job.opCount == job.opCapacity) {
+        int capacity = job.opCapacity ? job.opCapacity * 2 : 16;
+        string* larger = new string[capacity];
+        for (int i = 0; i < job.opCount; i++) larger[i] = job.ops[i];
+        delete[] job.ops;
+        job.ops = larger;
+        job.opCapacity = capacity;
+    }
+    job.ops[job.opCount++] = op;
+}
+
+/**
+ * Collect the operations from the command line and script files
+ * @param job Receives the operations and the output file
+ * @param error Set when the arguments are rejected
+ * @return false on a bad argument or an unreadable script
+ */
+bool parseBatchArgs(int argc, char const *argv[], BatchJob& job, string& error) {
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if ((arg == "--run" || arg == "--script" || arg == "--out") && i + 1 >= argc) {
+            error = arg + " needs a value";
+            return false;
+        }
+        if (arg == "--run") {
+            addBatchOp(job, argv[++i]);
+        } else if (arg == "--out") {
+            job.outFile = argv[++i];
+        } else if (arg == "--script") {
+            ifstream script(argv[++i]);
+            if (!script) { error = string("Cannot open script ") + argv[i]; return false; }
+            string line;
+            while (getline(script, line)) {
+                size_t hash = line.find('#');
+                if (hash != string::npos) line.erase(hash);
+                size_t first = line.find_first_not_of(" \t\r");
+                if (first == string::npos) continue;
+                addBatchOp(job, line.substr(first, line.find_last_not_of(" \t\r") - first + 1));
+            }
+        } else {
+            error = "Unknown argument: " + arg;
+            return false;
+        }
+    }
+    if (job.opCount == 0) { error = "No operations given"; return false; }
+    return true;
+}
+
+string jsonEscape(const string& text) {
+    string out;
+    for (unsigned char c : text) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += static_cast<char>(c);
+        } else if (c < 0x20) {
+            char code[8];
+            snprintf(code, sizeof(code), "\\u%04x", c);
+            out += code;
+        } else {
+            out += static_cast<char>(c);
+        }
+    }
+    return out;
+}
+
+/**
+ * Fake share as a JSON number with 4 decimals, or null when there are no articles
+ */
+string jsonShare(int fake, int total) {
+    if (total == 0) return "null";
+    char number[32];
+    snprintf(number, sizeof(number), "%.4f", 100.0 * fake / total);
+    return number;
+}
+
+/**
+ * Run one operation and write its JSON object
+ * @param op The operation, e.g. "search 2016"
+ * @param newsBook The linked list of news (relinked by the sorts)
+ * @param loadOrder The nodes in load order
+ * @param rowCount Number of nodes
+ * @param json Receives the result
+ * @return false if the operation could not be run
+ */
+bool runBatchOp(const string& op, News*& newsBook, News** loadOrder, int rowCount, const AggregateCube& cube, ostream& json) {
+    istringstream words(op);
+    string name;
+    words >> name;
+    json << "    {\"op\": \"" << jsonEscape(op) << "\", ";
+
+    if (name == "sort") {
+        string algorithm;
+        words >> algorithm;
+        if (algorithm != "quick") { json << "\"error\": \"algorithm must be quick\"}"; return false; }
+        // Relink the nodes in load order so every sort starts from the same list
+        for (int i = 0; i < rowCount; i++)
+            loadOrder[i] -> next = (i + 1 < rowCount) ? loadOrder[i + 1] : nullptr;
+        newsBook = rowCount > 0 ? loadOrder[0] : nullptr;
+
+        auto start = chrono::high_resolution_clock::now();
+        quickSort(&newsBook);
+        auto end = chrono::high_resolution_clock::now();
+
+        int articles = 0, lastDate = 0;
+        bool sorted = true;
+        for (News* cur = newsBook; cur; cur = cur -> next) {
+            articles++;
+            int date = packDate(cur -> date);
+            if (date == 0) continue;
+            if (date < lastDate) sorted = false;
+            lastDate = date;
+        }
+        json << "\"time_us\": " << chrono::duration_cast<chrono::microseconds>(end - start).count()
+            << ", \"result\": {\"algorithm\": \"" << algorithm << "\", \"articles\": " << articles
+            << ", \"sorted\": " << (sorted ? "true" : "false") << "}}";
+        return true;
+    }
+
+    if (name == "search") {
+        int year = 0;
+        if (!(words >> year)) { json << "\"error\": \"usage: search YEAR\"}"; return false; }
+        auto start = chrono::high_resolution_clock::now();
+        int matches = 0, fake = 0;
+        for (News* cur = newsBook; cur; cur = cur -> next) {
+            if (packDate(cur -> date) / 10000 == year) {
+                matches++;
+                if (cur -> identify == "FAKE") fake++;
+            }
+        }
+        auto end = chrono::high_resolution_clock::now();
+        json << "\"time_us\": " << chrono::duration_cast<chrono::microseconds>(end - start).count()
+            << ", \"result\": {\"year\": " << year << ", \"matches\": " << matches
+            << ", \"fake\": " << fake << ", \"true\": " << matches - fake << "}}";
+        return true;
+    }
+
+    if (name == "percentage") {
+        int year = 2016;
+        string subject = "politics", word;
+        bool politicalSubjects = true;      // no SUBJECT given: the same set as countPoliticNews
+        while (words >> word) {
+            bool digits = word.size() <= 9;
+            for (char c : word) digits = digits && isdigit(static_cast<unsigned char>(c));
+            if (digits) year = stoi(word);
+            else { subject = word; politicalSubjects = false; }
+        }
+        CubeSlice slice;
+        if (politicalSubjects) slice.subjectFilter = isPoliticalSubject;
+        else slice.subject = subject;
+        slice.fromYear = slice.toYear = year;
+        int monthTotals[CUBE_MONTHS], monthFake[CUBE_MONTHS];
+        auto start = chrono::high_resolution_clock::now();
+        cubeBreakdown(cube, slice, CUBE_BY_MONTH, monthTotals);
+        slice.label = 0;
+        cubeBreakdown(cube, slice, CUBE_BY_MONTH, monthFake);
+        auto end = chrono::high_resolution_clock::now();
+        int total = 0, fake = 0;
+        for (int m = 0; m < CUBE_MONTHS; m++) {
+            total += monthTotals[m];
+            fake += monthFake[m];
+        }
+        json << "\"time_us\": " << chrono::duration_cast<chrono::microseconds>(end - start).count()
+            << ", \"result\": {\"year\": " << year << ", \"subject\": \"" << jsonEscape(subject)
+            << "\", \"total\": " << total << ", \"fake\": " << fake << ", \"percentage\": " << jsonShare(fake, total)
+            << ", \"by_month\": [";
+        for (int m = 1; m <= 12; m++) {
+            json << (m > 1 ? ", " : "") << "{\"month\": " << m << ", \"total\": " << monthTotals[m]
+                << ", \"fake\": " << monthFake[m] << ", \"percentage\": " << jsonShare(monthFake[m], monthTotals[m]) << "}";
+        }
+        json << "]}}";
+        return true;
+    }
+
+    if (name == "top") {
+        int topN = 0;
+        if (!(words >> topN) || topN < 1) { json << "\"error\": \"usage: top N\"}"; return false; }
+        auto start = chrono::high_resolution_clock::now();
+        WordList wordList;
+        for (News* newsPtr = newsBook; newsPtr; newsPtr = newsPtr -> next) {
+            if (isFakeGovernmentNews(newsPtr)) {
+                forEachWord(newsPtr -> title, [&wordList](string_view token) { wordList.insertOrUpdate(token); });
+                forEachWord(newsPtr -> text, [&wordList](string_view token) { wordList.insertOrUpdate(token); });
+            }
+        }
+        int resultCount = 0;
+        WordNode** topWords = wordList.topK(topN, resultCount);
+        auto end = chrono::high_resolution_clock::now();
+        int vocabulary = 0;
+        for (WordNode* cur = wordList.head; cur; cur = cur -> next) vocabulary++;
+        json << "\"time_us\": " << chrono::duration_cast<chrono::microseconds>(end - start).count()
+            << ", \"result\": {\"vocabulary\": " << vocabulary << ", \"stopwords_filtered\": "
+            << (filterStopwords ? "true" : "false") << ", \"words\": [";
+        for (int i = 0; i < resultCount; i++) {
+            json << (i > 0 ? ", " : "") << "{\"word\": \"" << jsonEscape(topWords[i] -> word)
+                << "\", \"count\": " << topWords[i] -> frequency << "}";
+        }
+        json << "]}}";
+        delete[] topWords;
+        return true;
+    }
+
+    if (name == "stopwords") {
+        string setting;
+        words >> setting;
+        if (setting != "on" && setting != "off") { json << "\"error\": \"usage: stopwords on|off\"}"; return false; }
+        filterStopwords = (setting == "on");
+        json << "\"time_us\": 0, \"result\": {\"stopwords_filtered\": " << (filterStopwords ? "true" : "false") << "}}";
+        return true;
+    }
+
+    json << "\"error\": \"unknown operation\"}";
+    return false;
+}
+
+/**
+ * Run every operation of the job and write the JSON report
+ * @param loadTime Microseconds spent loading the file and building the indexes
+ * @return the number of operations that failed
+ */
+int runBatch(const BatchJob& job, News*& newsBook, const AggregateCube& cube, long long loadTime, ostream& json) {
+    int rowCount = 0;
+    for (News* cur = newsBook; cur; cur = cur -> next) rowCount++;
+    News** loadOrder = new News*[rowCount > 0 ? rowCount : 1];
+    rowCount = 0;
+    for (News* cur = newsBook; cur; cur = cur -> next) loadOrder[rowCount++] = cur;
+
+    int failed = 0;
+    json << "{\n  \"program\": \"linked_list_doc\",\n  \"dataset\": \"DataCleaned.csv\",\n"
+        << "  \"articles\": " << rowCount << ",\n  \"load_us\": " << loadTime << ",\n  \"operations\": [\n";
+    for (int i = 0; i < job.opCount; i++) {
+        if (!runBatchOp(job.ops[i], newsBook, loadOrder, rowCount, cube, json)) failed++;
+        json << (i + 1 < job.opCount ? ",\n" : "\n");
+    }
+    json << "  ],\n  \"failed\": " << failed << "\n}" << endl;
+    delete[] loadOrder;
+    return failed;
+}
+
 int main(int argc, char const *argv[]) {
+    // Operations on the command line switch to script mode
+    BatchJob job;
+    if (argc > 1) {
+        string error;
+        if (!parseBatchArgs(argc, argv, job, error)) {
+            cerr << error << endl;
+            cerr << "Usage: linked_list_doc [--script FILE] [--run \"OPERATION\"]... [--out FILE]" << endl;
+            delete[] job.ops;
+            return 2;
+        }
+    }
+    // In script mode only the JSON report is printed
+    streambuf* stdoutBuffer = cout.rdbuf();
+    if (job.opCount > 0) cout.rdbuf(nullptr);
+    auto loadStart = chrono::high_resolution_clock::now();
+
     News* newsBook = nullptr;
     News* news = new News;
 
-    ifstream infile("DataCleaned.csv"); // Open file for reading
+    // Load the word count index written by DataCleaning; it may cover only
+    // the start of the file if articles were appended since
+    WordCountIndex wordIndex;
+    wordIndex.load("WordIndex.bin", "DataCleaned.csv");
 
-    // Check the file open successfully
-    if (!infile) { cerr << "Error opening file" << endl; return 1; }
+    // The feed remembers how far the file has been read, so a refresh only
+    // loads the articles appended after that
+    FeedState feed;
+    feed.filename = "DataCleaned.csv";
+    feed.indexedBytes = wordIndex.coveredBytes();
 
     cout << "Loading news into Linked List..." << endl;
-    preloadNews(infile, newsBook); // Preload news into linked list
+    News* firstNew = nullptr;
+    if (loadNewRecords(feed, newsBook, firstNew) < 0) {
+        cout.rdbuf(stdoutBuffer);
+        cerr << "Error opening file" << endl;
+        delete[] job.ops;
+        return 1;
+    }
     cout << "News loaded successfully!\n" << endl;
-    infile.close(); // Close the file
+    if (feed.pendingBytes > 0)
+        cout << "Last line has no newline yet (" << feed.pendingBytes << " bytes); option 8 loads it once complete\n" << endl;
+
+    // Build the subject / label / year-month bitmaps once at load time
+    FacetIndex facetIndex;
+    buildFacetIndex(newsBook, facetIndex);
+
+    // Build the (year, month, subject, label) count cube once at load time
+    AggregateCube cube;
+    buildAggregateCube(newsBook, cube);
+
+    // Running word count of fake government news, built on first use
+    WordList liveWords;
+    bool liveWordsReady = false;
+
+    bool running = true;
+    int failed = 0;
+    if (job.opCount > 0) {
+        long long loadTime = chrono::duration_cast<chrono::microseconds>(chrono::high_resolution_clock::now() - loadStart).count();
+        if (job.outFile.empty()) {
+            ostream json(stdoutBuffer);
+            failed = runBatch(job, newsBook, cube, loadTime, json);
+        } else {
+            ofstream json(job.outFile);
+            if (json) failed = runBatch(job, newsBook, cube, loadTime, json);
+            if (!json) { cerr << "Cannot write " << job.outFile << endl; failed = job.opCount; }
+        }
+        cout.rdbuf(stdoutBuffer);
+        running = false;
+    }
 
 /**
  * 1. How can you efficiently sort the news articles by year and display the total number of articles in both datasets?
@@ -549,13 +3635,17 @@ int main(int argc, char const *argv[]) {
     (Hint: You are required to extract the most common words from these articles, sort them by frequency, and present the results.)
  */
 
-    bool running = true;
     while (running) {
         // User Menu
         cout << "<<< User Menu >>>" << endl;
         cout << "1. Sort By Year and display the total number of articles in both datasets" << endl;
         cout << "2. Percentage of political news article (including fake and true news) from year 2016 are fake" << endl;
         cout << "3. Most frequently word used in fake news article related to government topics" << endl;
+        cout << "4. Toggle stopword filter (currently " << (filterStopwords ? "ON" : "OFF") << ")" << endl;
+        cout << "5. Most frequent phrases (bigrams / trigrams) in fake news article related to government topics" << endl;
+        cout << "6. Terms that distinguish fake from true news (TF-IDF / log-odds)" << endl;
+        cout << "7. Words starting with a prefix in fake news article related to government topics" << endl;
+        cout << "8. Refresh: load articles appended to " << feed.filename << endl;
 
         // User Input
         int choice;
@@ -575,8 +3665,9 @@ int main(int argc, char const *argv[]) {
                 
                 auto timeStart_sort = chrono::high_resolution_clock::now();
                 quickSort(&newsBook);
+                feed.tail = nullptr;    // The last node has changed
                 cout << "Done sorting" << endl;
-                iterativeCount(newsBook);
+                countNewsCube(cube);
                 auto timeEnd_sort = chrono::high_resolution_clock::now();
                 
                 // Get memory usage after the function call
@@ -603,7 +3694,7 @@ int main(int argc, char const *argv[]) {
                 SIZE_T memoryBefore = pmc.WorkingSetSize;
                 
                 auto timeStart_calcPol = chrono::high_resolution_clock::now();
-                countPoliticNews(&newsBook);
+                countPoliticNewsCube(cube);
                 auto timeEnd_calcPol = chrono::high_resolution_clock::now();
                 
                 if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) {
@@ -615,11 +3706,99 @@ int main(int argc, char const *argv[]) {
                 MemoryStats stats_calcPol = calculateDetailedMemory(newsBook);
                 stats_calcPol.timeElapsed = chrono::duration<double>(timeEnd_calcPol - timeStart_calcPol).count();
                 displayMemoryStats(stats_calcPol, "Political News Calculation", netMemoryUsage);
+
+                // Baseline: the same answer from a walk of the whole list
+                cout << "\nBaseline: walking the whole list..." << endl;
+                auto timeStart_scan = chrono::high_resolution_clock::now();
+                countPoliticNews(&newsBook);
+                auto timeEnd_scan = chrono::high_resolution_clock::now();
+                MemoryStats stats_scan = calculateDetailedMemory(newsBook);
+                stats_scan.timeElapsed = chrono::duration<double>(timeEnd_scan - timeStart_scan).count();
+                displayMemoryStats(stats_scan, "Political News Calculation (Baseline List Scan)");
                 break;
             }
 
             // Most frequently word used in fake news article related to government topics
             case 3: {
+                int countMode;
+                cout << "\nCounting Mode" << endl;
+                cout << "1. Single Thread" << endl;
+                cout << "2. Parallel" << endl;
+                cout << "3. Approximate (Space-Saving)" << endl;
+                cout << "4. Word Index" << endl;
+                cout << "5. Live Count (updated on refresh)" << endl;
+                cout << "\nSelect a counting mode: ";
+                cin >> countMode;
+                int threadCount = static_cast<int>(thread::hardware_concurrency());
+                if (threadCount <= 0) threadCount = 1;
+
+                WordCountIndex::Filter filter;
+                int groupsUsed = 0;
+                int deltaUsed = 0;
+                if (countMode == 4 && !wordIndex.loaded()) {
+                    cout << "WordIndex.bin is missing or out of date; run DataCleaning to rebuild it. Counting directly." << endl;
+                    countMode = 1;
+                } else if (countMode == 4) {
+                    readWordCountFilter(filter);
+                }
+
+                if (countMode == 3) {
+                    double epsilon;
+                    cout << "\nError bound as a fraction of all words (e.g. 0.001): ";
+                    cin >> epsilon;
+                    if (!(epsilon > 0 && epsilon < 1)) {
+                        cout << "Invalid error bound, using 0.001" << endl;
+                        epsilon = 0.001;
+                    } else if (epsilon < 1.0 / MAX_SUMMARY_COUNTERS) {
+                        cout << "Error bound needs more than " << MAX_SUMMARY_COUNTERS << " counters, using " << 1.0 / MAX_SUMMARY_COUNTERS << endl;
+                        epsilon = 1.0 / MAX_SUMMARY_COUNTERS;
+                    }
+                    string sketchChoice;
+                    cout << "Back the counters with a Count-Min sketch? (y/n): ";
+                    cin >> sketchChoice;
+                    int topCount;
+                    cout << "Enter the number of most frequent words to display: ";
+                    cin >> topCount;
+
+                    PROCESS_MEMORY_COUNTERS pmc;
+                    if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) {
+                        cerr << "Failed to get memory info" << endl;
+                    }
+                    SIZE_T memoryBefore = pmc.WorkingSetSize;
+
+                    auto timeStart_approx = chrono::high_resolution_clock::now();
+                    StreamSummary summary(epsilon, sketchChoice == "y" || sketchChoice == "Y");
+                    for (News* newsPtr = newsBook; newsPtr; newsPtr = newsPtr->next) {
+                        if (isFakeGovernmentNews(newsPtr)) {
+                            forEachWord(newsPtr->title, [&summary](string_view token) {
+                                summary.add(token);
+                            });
+                            forEachWord(newsPtr->text, [&summary](string_view token) {
+                                summary.add(token);
+                            });
+                        }
+                    }
+                    auto timeEnd_approx = chrono::high_resolution_clock::now();
+
+                    if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) {
+                        cerr << "Failed to get memory info" << endl;
+                    }
+                    SIZE_T memoryAfter = pmc.WorkingSetSize;
+                    SIZE_T netMemoryUsage = (memoryAfter > memoryBefore) ? (memoryAfter - memoryBefore) : 0;
+
+                    cout << "\nTop " << topCount << " most frequent words (approximate):" << endl;
+                    cout << "------------------------------------------" << endl;
+                    summary.displayTop(topCount);
+                    cout << "Words Seen: " << summary.total << ", Counters: " << summary.counterCount()
+                        << ", Maximum Error: " << static_cast<long long>(ceil(summary.total / static_cast<double>(summary.counterCount())))
+                        << ", Summary Memory: " << summary.memoryUsed() << " B" << endl;
+
+                    MemoryStats stats_approx = calculateDetailedMemory(newsBook);
+                    stats_approx.timeElapsed = chrono::duration<double>(timeEnd_approx - timeStart_approx).count();
+                    displayMemoryStats(stats_approx, "Word Frequency Calculation (Space-Saving)", netMemoryUsage);
+                    break;
+                }
+
                 PROCESS_MEMORY_COUNTERS pmc;
                 if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) {
                     cerr << "Failed to get memory info" << endl;
@@ -629,38 +3808,31 @@ int main(int argc, char const *argv[]) {
                 auto timeStart_wordFreq = chrono::high_resolution_clock::now();
 
                 WordList wordList;
-                News* newsPtr = newsBook;
-                while (newsPtr) {
-                    string subjectLower;
-                    for (char c : newsPtr->subject)
-                        subjectLower.push_back(tolower(c));
-                    if (newsPtr->identify == "FAKE" && (subjectLower.find("government") != string::npos)) {
-                        string titleLower, textLower, subjectLower;
-                        for (char c : newsPtr->title)
-                            titleLower.push_back(tolower(c));
-                        for (char c : newsPtr->text)
-                            textLower.push_back(tolower(c));
-                        for (char c : newsPtr->subject)
-                            subjectLower.push_back(tolower(c));
-                        stringstream ss(titleLower);
-                        string word;
-                        while (ss >> word) {
-                            string cleaned = cleanWord(word);
-                            if (!cleaned.empty()) {
-                                wordList.insertOrUpdate(cleaned);
-                            }
-                        }
-                        stringstream sss(textLower);
-                        while (sss >> word) {
-                            string cleaned = cleanWord(word);
-                            if (!cleaned.empty()) {
-                                wordList.insertOrUpdate(cleaned);
-                            }
+                if (countMode == 4) {
+                    groupsUsed = wordIndex.query(filter, wordList);
+                    deltaUsed = countUnindexedWords(feed, filter, wordList);
+                } else if (countMode == 5) {
+                    if (!liveWordsReady) {
+                        addLiveWords(liveWords, newsBook);
+                        liveWordsReady = true;
+                    }
+                    for (WordNode* cur = liveWords.head; cur; cur = cur -> next)
+                        if (!(filterStopwords && isStopword(cur -> word)))
+                            wordList.insertOrUpdate(cur -> word, cur -> frequency);
+                } else if (countMode == 2) {
+                    countWordsParallel(newsBook, wordList, threadCount);
+                } else {
+                    for (News* newsPtr = newsBook; newsPtr; newsPtr = newsPtr->next) {
+                        if (isFakeGovernmentNews(newsPtr)) {
+                            forEachWord(newsPtr->title, [&wordList](string_view token) {
+                                wordList.insertOrUpdate(token);
+                            });
+                            forEachWord(newsPtr->text, [&wordList](string_view token) {
+                                wordList.insertOrUpdate(token);
+                            });
                         }
                     }
-                    newsPtr = newsPtr->next;
                 }
-                wordList.quickSort_word_freq();
 
                 auto timeEnd_wordFreq = chrono::high_resolution_clock::now();
                 
@@ -678,19 +3850,236 @@ int main(int argc, char const *argv[]) {
                 cin >> topCount;
 
                 if (topCount > 0) {
+                    cout << "\nRanking Method" << endl;
+                    cout << "1. Counting Sort" << endl;
+                    cout << "2. Quick Sort" << endl;
+                    cout << "3. Heap Top-K" << endl;
+                    int rankChoice;
+                    cout << "\nSelect a ranking method: ";
+                    cin >> rankChoice;
+
+                    auto timeStart_rank = chrono::high_resolution_clock::now();
+                    int resultCount = 0;
+                    WordNode** topWords = nullptr;
+                    switch (rankChoice) {
+                        case 2: wordList.quickSort_word_freq(); break;
+                        case 3: topWords = wordList.topK(topCount, resultCount); break;
+                        default: wordList.countingSort_word_freq(); break;
+                    }
+                    auto timeEnd_rank = chrono::high_resolution_clock::now();
+                    stats_wordFreq.timeElapsed += chrono::duration<double>(timeEnd_rank - timeStart_rank).count();
+
                     cout << "\nTop " << topCount << " most frequent words:" << endl;
                     cout << "------------------------------------------" << endl;
-                    int count = 0;
-                    WordNode* wordPtr = wordList.head;
-                    while (wordPtr && count < topCount) {
-                        cout << count + 1 << ". " << wordPtr->word << " (" 
-                            << wordPtr->frequency << " times)" << endl;
-                        wordPtr = wordPtr->next;
-                        count++;
+                    if (topWords) {
+                        for (int i = 0; i < resultCount; i++) {
+                            cout << i + 1 << ". " << topWords[i]->word << " (" 
+                                << topWords[i]->frequency << " times)" << endl;
+                        }
+                        delete[] topWords;
+                    } else {
+                        int count = 0;
+                        WordNode* wordPtr = wordList.head;
+                        while (wordPtr && count < topCount) {
+                            cout << count + 1 << ". " << wordPtr->word << " (" 
+                                << wordPtr->frequency << " times)" << endl;
+                            wordPtr = wordPtr->next;
+                            count++;
+                        }
+                    }
+                }
+
+                string operation = "Word Frequency Calculation";
+                if (countMode == 2)
+                    operation += " (Parallel, " + to_string(threadCount) + (threadCount == 1 ? " thread)" : " threads)");
+                else if (countMode == 4)
+                    operation += " (Word Index, " + to_string(groupsUsed) + " groups + " + to_string(deltaUsed) + " new articles)";
+                else if (countMode == 5)
+                    operation += " (Live Count)";
+                displayMemoryStats(stats_wordFreq, operation, netMemoryUsage);
+                break;
+            }
+
+            // Stopword filter for the word frequency count
+            case 4: {
+                filterStopwords = !filterStopwords;
+                cout << "Stopword filter is now " << (filterStopwords ? "ON" : "OFF") << endl;
+                break;
+            }
+
+            // Most frequent bigrams / trigrams in fake news article related to government topics
+            case 5: {
+                int n;
+                cout << "\nPhrase length (2 = bigrams, 3 = trigrams): ";
+                cin >> n;
+                if (n != 2 && n != 3) {
+                    cout << "Invalid phrase length, using bigrams" << endl;
+                    n = 2;
+                }
+                int topCount;
+                cout << "Enter the number of most frequent phrases to display: ";
+                cin >> topCount;
+
+                PROCESS_MEMORY_COUNTERS pmc;
+                if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) {
+                    cerr << "Failed to get memory info" << endl;
+                }
+                SIZE_T memoryBefore = pmc.WorkingSetSize;
+
+                auto timeStart_phrase = chrono::high_resolution_clock::now();
+                TokenInterner interner;
+                NgramTable phraseTable;
+                countPhrases(newsBook, n, interner, phraseTable);
+                auto timeEnd_phrase = chrono::high_resolution_clock::now();
+
+                if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) {
+                    cerr << "Failed to get memory info" << endl;
+                }
+                SIZE_T memoryAfter = pmc.WorkingSetSize;
+                SIZE_T netMemoryUsage = (memoryAfter > memoryBefore) ? (memoryAfter - memoryBefore) : 0;
+
+                cout << "\nTop " << topCount << (n == 2 ? " bigrams:" : " trigrams:") << endl;
+                cout << "------------------------------------------" << endl;
+                phraseTable.displayTop(topCount, interner, n);
+                cout << "Distinct Phrases: " << phraseTable.size << ", Vocabulary: " << interner.size
+                    << ", Table Memory: " << phraseTable.memoryUsed() + interner.memoryUsed() << " B" << endl;
+
+                MemoryStats stats_phrase = calculateDetailedMemory(newsBook);
+                stats_phrase.timeElapsed = chrono::duration<double>(timeEnd_phrase - timeStart_phrase).count();
+                displayMemoryStats(stats_phrase, n == 2 ? "Bigram Frequency Calculation" : "Trigram Frequency Calculation", netMemoryUsage);
+                break;
+            }
+
+            // Terms that distinguish fake from true news
+            case 6: {
+                int metric;
+                cout << "\nRanking Method" << endl;
+                cout << "1. TF-IDF by label" << endl;
+                cout << "2. Log-odds fake vs true" << endl;
+                cout << "3. TF-IDF by subject" << endl;
+                cout << "\nSelect a ranking method: ";
+                cin >> metric;
+                int topCount;
+                cout << "Enter the number of terms to display per list: ";
+                cin >> topCount;
+                int threadCount = static_cast<int>(thread::hardware_concurrency());
+                if (threadCount <= 0) threadCount = 1;
+
+                PROCESS_MEMORY_COUNTERS pmc;
+                if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) {
+                    cerr << "Failed to get memory info" << endl;
+                }
+                SIZE_T memoryBefore = pmc.WorkingSetSize;
+
+                // One parallel pass over all articles, then rank
+                auto timeStart_terms = chrono::high_resolution_clock::now();
+                TermCorpus corpus;
+                buildTermCorpus(newsBook, threadCount, corpus);
+                reportDistinctiveTerms(corpus, metric, topCount, 5);
+                auto timeEnd_terms = chrono::high_resolution_clock::now();
+
+                if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) {
+                    cerr << "Failed to get memory info" << endl;
+                }
+                SIZE_T memoryAfter = pmc.WorkingSetSize;
+                SIZE_T netMemoryUsage = (memoryAfter > memoryBefore) ? (memoryAfter - memoryBefore) : 0;
+
+                MemoryStats stats_terms = calculateDetailedMemory(newsBook);
+                stats_terms.timeElapsed = chrono::duration<double>(timeEnd_terms - timeStart_terms).count();
+                displayMemoryStats(stats_terms, "Distinctive Terms (" + to_string(threadCount) + (threadCount == 1 ? " thread)" : " threads)"), netMemoryUsage);
+                break;
+            }
+
+            // Words starting with a prefix, in alphabetical order
+            case 7: {
+                string prefix;
+                cout << "\nEnter a prefix (e.g. trump, or * for every word): ";
+                cin >> prefix;
+                if (prefix == "*") prefix.clear();
+                for (char& c : prefix) c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+
+                PROCESS_MEMORY_COUNTERS pmc;
+                if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) {
+                    cerr << "Failed to get memory info" << endl;
+                }
+                SIZE_T memoryBefore = pmc.WorkingSetSize;
+
+                auto timeStart_prefix = chrono::high_resolution_clock::now();
+                WordList wordList;
+                for (News* newsPtr = newsBook; newsPtr; newsPtr = newsPtr -> next) {
+                    if (isFakeGovernmentNews(newsPtr)) {
+                        forEachWord(newsPtr -> title, [&wordList](string_view token) {
+                            wordList.insertOrUpdate(token);
+                        });
+                        forEachWord(newsPtr -> text, [&wordList](string_view token) {
+                            wordList.insertOrUpdate(token);
+                        });
                     }
                 }
+                cout << "\nWords starting with \"" << prefix << "\":" << endl;
+                cout << "------------------------------------------" << endl;
+                int matches = wordList.displayPrefix(prefix);
+                auto timeEnd_prefix = chrono::high_resolution_clock::now();
+
+                if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) {
+                    cerr << "Failed to get memory info" << endl;
+                }
+                SIZE_T memoryAfter = pmc.WorkingSetSize;
+                SIZE_T netMemoryUsage = (memoryAfter > memoryBefore) ? (memoryAfter - memoryBefore) : 0;
+
+                int vocabulary = 0;
+                size_t treeMemory = wordList.tree().memoryUsed(vocabulary);
+                const WordTree& tree = wordList.tree();
+                cout << "Matches: " << matches << " of " << vocabulary << " words, Tree Nodes: "
+                    << tree.innerCount(ART_NODE4) << " x4, " << tree.innerCount(ART_NODE16) << " x16, "
+                    << tree.innerCount(ART_NODE48) << " x48, " << tree.innerCount(ART_NODE256) << " x256"
+                    << ", Tree Memory: " << treeMemory << " B" << endl;
+
+                MemoryStats stats_prefix = calculateDetailedMemory(newsBook);
+                stats_prefix.timeElapsed = chrono::duration<double>(timeEnd_prefix - timeStart_prefix).count();
+                displayMemoryStats(stats_prefix, "Prefix Search (Adaptive Radix Tree)", netMemoryUsage);
+                break;
+            }
+
+            // Load the articles appended since the last load and add them to
+            // the facet bitmaps, the cube and the live word count in place
+            case 8: {
+                cout << "\nLoading new articles from byte " << feed.offset << "..." << endl;
+
+                PROCESS_MEMORY_COUNTERS pmc;
+                if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) {
+                    cerr << "Failed to get memory info" << endl;
+                }
+                SIZE_T memoryBefore = pmc.WorkingSetSize;
+
+                auto timeStart_refresh = chrono::high_resolution_clock::now();
+                int added = loadNewRecords(feed, newsBook, firstNew);
+                if (added > 0) {
+                    addToFacetIndex(facetIndex, firstNew);
+                    addToAggregateCube(cube, firstNew);
+                    if (liveWordsReady) addLiveWords(liveWords, firstNew);
+                }
+                auto timeEnd_refresh = chrono::high_resolution_clock::now();
+
+                if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) {
+                    cerr << "Failed to get memory info" << endl;
+                }
+                SIZE_T memoryAfter = pmc.WorkingSetSize;
+                SIZE_T netMemoryUsage = (memoryAfter > memoryBefore) ? (memoryAfter - memoryBefore) : 0;
+
+                if (added < 0) {
+                    cout << feed.filename << " is missing or shorter than before; restart the program to reload it" << endl;
+                    break;
+                }
+                cout << "New articles: " << added << ", Total articles: " << feed.rowCount
+                    << ", Not in word index: " << feed.unindexedCount << endl;
+                if (feed.pendingBytes > 0)
+                    cout << "Last line has no newline yet (" << feed.pendingBytes << " bytes); it will be loaded once complete" << endl;
+                countNewsCube(cube);
 
-                displayMemoryStats(stats_wordFreq, "Word Frequency Calculation", netMemoryUsage);
+                MemoryStats stats_refresh = calculateDetailedMemory(newsBook);
+                stats_refresh.timeElapsed = chrono::duration<double>(timeEnd_refresh - timeStart_refresh).count();
+                displayMemoryStats(stats_refresh, "Refresh (" + to_string(added) + " new articles)", netMemoryUsage);
                 break;
             }
 
@@ -698,7 +4087,7 @@ int main(int argc, char const *argv[]) {
             default: cout << "Invalid choice" << endl; break;
         }
 
-        if (running && choice >= 1 && choice <= 4) {
+        if (running && choice >= 1 && choice <= 8) {
             cout << "\nPress Enter to return to menu...";
             cin.ignore();   // Ignore newline character
             cin.get();      // Wait for user input
@@ -706,6 +4095,10 @@ int main(int argc, char const *argv[]) {
     }
 
     // Free up memory
+    delete[] job.ops;
+    delete[] feed.unindexed;
+    freeAggregateCube(cube);
+    freeFacetIndex(facetIndex);
     delete news;
-    return 0;
+    return failed > 0 ? 1 : 0;
 }
@@ -5,6 +5,10 @@
 #include <chrono>
 #include <iomanip>
 #include <tuple>
+#include <cmath>
+#include <cstring>
+#include <climits>
+#include <cstdio>
 #include <windows.h>
 #include <psapi.h>
 
@@ -20,6 +24,75 @@ struct News {
         : title(t), text(tx), subject(sub), date(d), identify(id), next(nullptr) {}
 };
 
+/**
+ * Sorted date column with a static B+-tree-style block index on top.
+ * levels[0] is the sorted key column; every level above stores the largest key
+ * of each DATE_BLOCK-sized node of the level below, so a lookup touches one
+ * cache line per level instead of walking the list.
+ */
+const int DATE_BLOCK = 16;      // keys per node (16 ints = one 64-byte cache line)
+const int MAX_DATE_LEVELS = 8;
+struct DateIndex {
+    int count = 0;
+    int* keys = nullptr;        // packed dates (YYYYMMDD), ascending
+    News** nodes = nullptr;     // list node for each key
+    int levelCount = 0;
+    int* levels[MAX_DATE_LEVELS] = {nullptr};
+    int levelSize[MAX_DATE_LEVELS] = {0};
+};
+
+/**
+ * Skip-list overlay ("express lanes") over the sorted News list.
+ * The News list itself is the bottom lane; every lane above keeps one entry
+ * for every SKIP_FACTOR entries of the lane below, so a seek by date key
+ * drops down one lane at a time instead of walking the whole list.
+ */
+const int SKIP_FACTOR = 4;
+struct SkipNode {
+    int key;            // packed date (YYYYMMDD) of 'news'
+    News* news;         // node in the base list this entry points at
+    SkipNode* next;     // next entry in the same lane
+    SkipNode* down;     // same position one lane below (nullptr on the lowest express lane)
+    SkipNode(int k, News* n) : key(k), news(n), next(nullptr), down(nullptr) {}
+};
+
+struct SkipList {
+    SkipNode* top = nullptr;    // first entry of the highest lane
+    int lanes = 0;
+    size_t entries = 0;         // total express-lane entries (for memory reporting)
+};
+
+/**
+ * Inverted index for full-text search over title + text.
+ * Each token maps to a posting list of (article delta, term frequency) pairs,
+ * varint encoded and appended in list order during a single pass.
+ */
+struct PostingList {
+    unsigned char* bytes = nullptr; // varint-encoded (doc delta, tf) pairs
+    int size = 0;
+    int capacity = 0;
+    int docFreq = 0;                // number of articles containing the term
+    int lastDoc = -1;               // last article written (delta base)
+    int pendingDoc = -1;            // article currently being counted
+    int pendingTf = 0;              // occurrences in pendingDoc so far
+};
+
+struct InvertedIndex {
+    int termCount = 0;
+    int termCapacity = 0;
+    string* terms = nullptr;            // term id -> token
+    PostingList* postings = nullptr;    // term id -> posting list
+    int* slots = nullptr;               // open-addressing table of term id + 1 (0 = empty)
+    int slotCapacity = 0;               // power of two
+    int docCount = 0;
+    int docCapacity = 0;
+    News** docNodes = nullptr;          // article id -> list node
+    int* docLength = nullptr;           // tokens per article
+    long long totalLength = 0;
+    double avgDocLength = 0;
+    size_t compressedBytes = 0;
+};
+
 /**
  * Helper functions to calculate memory usage
  */
@@ -33,28 +106,6 @@ struct MemoryStats {
     MemoryStats() : structSize(0), stringSize(0), pointerSize(0), totalSize(0), timeElapsed(0) {}
 };
 
-/**
- * Insert at End of Linked List
- */
-void insertAtEnd(News** head, string title, string text, string subject, string date, string identify) {
-    News* newNews = new News; // Create a new News
-    newNews -> title = title;
-    newNews -> text = text;
-    newNews -> subject = subject;
-    newNews -> date = date;
-    newNews -> identify = identify;
-
-    if (*head == nullptr) {
-        *head = newNews;
-    } else {
-        News* currentNews = *head;
-        while (currentNews -> next != nullptr) {
-            currentNews = currentNews -> next;
-        }
-        currentNews -> next = newNews;
-    }
-}
-
 /**
  * Function to parse a CSV line into its individual columns while correctly handling quoted fields.
  * This function extracts the first four columns: title, text, subject, and date.
@@ -106,19 +157,67 @@ void parseCSVLine(const string &line, string &title, string &text, string &subje
 }
 
 /**
- * Preload News into Linked List
- * @param infile The input file stream
+ * Position in the news feed. DataCleaned.csv is only ever appended to, so
+ * everything before 'offset' is already in the list; a refresh reads from
+ * there and hands the new nodes to the indexes.
+ */
+struct FeedState {
+    string filename;
+    unsigned long long offset = 0;      // bytes consumed, including the header
+    News* tail = nullptr;               // last node (nullptr = find it again)
+    int rowCount = 0;
+    unsigned long long pendingBytes = 0; // unterminated line held back by the last load
+};
+
+/**
+ * Load the articles appended to the feed since the last call (the whole
+ * file on the first call) onto the end of the list. DataCleaning ends every
+ * row with a newline, so a last line without one is a record that is still
+ * being written: it is held back (see 'pendingBytes') and read again next
+ * time, once it is complete.
+ * @param feed The feed position, advanced past the new lines
  * @param newsBook The linked list of news
- * @param news The news object
+ * @param firstNew Set to the first new node (nullptr if there are none)
+ * @return Number of new articles, or -1 if the file is missing or shorter than the offset
  */
-void preloadNews(ifstream& infile, News*& newsBook) {
+int loadNewRecords(FeedState& feed, News*& newsBook, News*& firstNew) {
+    firstNew = nullptr;
+    feed.pendingBytes = 0;
+    ifstream infile(feed.filename, ios::binary | ios::ate);
+    if (!infile) return -1;
+    unsigned long long fileSize = static_cast<unsigned long long>(infile.tellg());
+    if (fileSize < feed.offset) return -1;
+    infile.seekg(static_cast<streamoff>(feed.offset));
+
+    // The sorts relink the list, so the tail is found again after one
+    if (!feed.tail || feed.tail -> next) {
+        feed.tail = newsBook;
+        while (feed.tail && feed.tail -> next) feed.tail = feed.tail -> next;
+    }
+
+    int added = 0;
     string line;
-    getline(infile, line); // Skip the header line
     while (getline(infile, line)) {
-        string title, news, subject, date, identify;
-        parseCSVLine(line, title, news, subject, date, identify);
-        insertAtEnd(&newsBook, title, news, subject, date, identify);
+        if (infile.eof()) {
+            feed.pendingBytes = line.size();
+            break;
+        }
+        unsigned long long start = feed.offset;
+        feed.offset += line.size() + 1;
+        if (start == 0) continue; // Skip the header line
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+
+        string title, text, subject, date, identify;
+        parseCSVLine(line, title, text, subject, date, identify);
+        News* node = new News(title, text, subject, date, identify);
+        if (feed.tail) feed.tail -> next = node;
+        else newsBook = node;
+        feed.tail = node;
+        if (!firstNew) firstNew = node;
+        added++;
     }
+    feed.rowCount += added;
+    return added;
 }
 
 /**
@@ -289,7 +388,8 @@ void insertionSort(News*& head) {
 }
 
 /**
- * Iterative function to count news articles
+ * Iterative function to count news articles by walking the whole list; the
+ * baseline for countNewsCube
  * @param head The head of the linked list
  */
 void iterativeCount(News* head) {
@@ -428,6 +528,796 @@ int binarySearch(News* head, int target) {
     return totalCount;
 }
 
+/**
+ * Convert a dd-mm-yyyy date into a sortable YYYYMMDD integer
+ * @param date The date string to pack
+ * @return the packed date, or 0 if the date is not well formed
+ */
+int packDate(const string& date) {
+    if (date.size() != 10 || date[2] != '-' || date[5] != '-') return 0;
+    for (int i = 0; i < 10; i++) {
+        if (i != 2 && i != 5 && !isdigit(static_cast<unsigned char>(date[i]))) return 0;
+    }
+    int day = (date[0] - '0') * 10 + (date[1] - '0');
+    int month = (date[3] - '0') * 10 + (date[4] - '0');
+    int year = (date[6] - '0') * 1000 + (date[7] - '0') * 100 + (date[8] - '0') * 10 + (date[9] - '0');
+    if (day < 1 || day > 31 || month < 1 || month > 12) return 0;
+    return year * 10000 + month * 100 + day;
+}
+
+/**
+ * Radix sort a date column and its nodes (stable, three 9-bit passes)
+ * @param keys The packed dates
+ * @param nodes The node for each date, moved with it
+ * @param count Number of keys
+ */
+void radixSortDates(int*& keys, News**& nodes, int count) {
+    const int RADIX_BITS = 9;
+    const int BUCKETS = 1 << RADIX_BITS;
+    int* tmpKeys = new int[count > 0 ? count : 1];
+    News** tmpNodes = new News*[count > 0 ? count : 1];
+    int* bucket = new int[BUCKETS];
+    for (int shift = 0; shift < 27; shift += RADIX_BITS) {
+        for (int b = 0; b < BUCKETS; b++) bucket[b] = 0;
+        for (int j = 0; j < count; j++) bucket[(keys[j] >> shift) & (BUCKETS - 1)]++;
+        int sum = 0;
+        for (int b = 0; b < BUCKETS; b++) {
+            int c = bucket[b];
+            bucket[b] = sum;
+            sum += c;
+        }
+        for (int j = 0; j < count; j++) {
+            int pos = bucket[(keys[j] >> shift) & (BUCKETS - 1)]++;
+            tmpKeys[pos] = keys[j];
+            tmpNodes[pos] = nodes[j];
+        }
+        swap(keys, tmpKeys);
+        swap(nodes, tmpNodes);
+    }
+    delete[] tmpKeys;
+    delete[] tmpNodes;
+    delete[] bucket;
+}
+
+/**
+ * (Re)build the block levels above the sorted key column
+ * @param index The date index
+ */
+void buildDateLevels(DateIndex& index) {
+    for (int l = 1; l < index.levelCount; l++) delete[] index.levels[l];
+    // Level 0 is the key column; each level above keeps the max key of every node below
+    index.levels[0] = index.keys;
+    index.levelSize[0] = index.count;
+    index.levelCount = 1;
+    while (index.levelSize[index.levelCount - 1] > DATE_BLOCK && index.levelCount < MAX_DATE_LEVELS) {
+        int below = index.levelCount - 1;
+        int size = (index.levelSize[below] + DATE_BLOCK - 1) / DATE_BLOCK;
+        int* level = new int[size];
+        for (int j = 0; j < size; j++) {
+            int last = min((j + 1) * DATE_BLOCK, index.levelSize[below]);
+            level[j] = index.levels[below][last - 1];
+        }
+        index.levels[index.levelCount] = level;
+        index.levelSize[index.levelCount] = size;
+        index.levelCount++;
+    }
+}
+
+/**
+ * Add the articles from 'first' to the end of the list to the date index:
+ * the new dates are radix sorted on their own and merged into the sorted
+ * column (old keys first on ties, so equal dates stay in load order), then
+ * the block levels are rebuilt. Used for the initial build and for the
+ * articles a refresh loads.
+ * @param index The index to update
+ * @param first The first article to add
+ */
+void addToDateIndex(DateIndex& index, News* first) {
+    int added = 0;
+    for (News* cur = first; cur; cur = cur -> next) added++;
+    if (added == 0 && index.keys) return;
+    int* newKeys = new int[added > 0 ? added : 1];
+    News** newNodes = new News*[added > 0 ? added : 1];
+    int i = 0;
+    for (News* cur = first; cur; cur = cur -> next, i++) {
+        newKeys[i] = packDate(cur -> date);
+        newNodes[i] = cur;
+    }
+    radixSortDates(newKeys, newNodes, added);
+
+    int count = index.count + added;
+    int* keys = new int[count > 0 ? count : 1];
+    News** nodes = new News*[count > 0 ? count : 1];
+    int a = 0, b = 0, out = 0;
+    while (a < index.count && b < added) {
+        if (newKeys[b] < index.keys[a]) { keys[out] = newKeys[b]; nodes[out++] = newNodes[b++]; }
+        else { keys[out] = index.keys[a]; nodes[out++] = index.nodes[a++]; }
+    }
+    while (a < index.count) { keys[out] = index.keys[a]; nodes[out++] = index.nodes[a++]; }
+    while (b < added) { keys[out] = newKeys[b]; nodes[out++] = newNodes[b++]; }
+    delete[] newKeys;
+    delete[] newNodes;
+    delete[] index.keys;
+    delete[] index.nodes;
+    index.keys = keys;
+    index.nodes = nodes;
+    index.count = count;
+    buildDateLevels(index);
+}
+
+/**
+ * Build the date index: radix sort the packed dates of the whole list and
+ * build the block levels above them
+ * @param head The head of the linked list
+ * @param index The index to fill
+ */
+void buildDateIndex(News* head, DateIndex& index) {
+    index.count = 0;
+    addToDateIndex(index, head);
+}
+
+/**
+ * Find a bound in the date index by descending the block levels
+ * @param index The date index
+ * @param key The packed date to search for
+ * @param upper false for the first key >= key, true for the first key > key
+ * @return position in the sorted key column
+ */
+int dateBound(const DateIndex& index, int key, bool upper) {
+    if (index.count == 0) return 0;
+    int node = 0;
+    for (int l = index.levelCount - 1; l >= 0; l--) {
+        int pos = node * DATE_BLOCK;
+        int last = min(pos + DATE_BLOCK, index.levelSize[l]);
+        while (pos < last && (upper ? index.levels[l][pos] <= key : index.levels[l][pos] < key)) pos++;
+        if (pos == last) return index.count; // every key is on the left of the bound
+        node = pos;
+    }
+    return node;
+}
+
+/**
+ * Date range query: all articles dated within [from, to]
+ * @param index The date index
+ * @param from The packed start date
+ * @param to The packed end date (inclusive)
+ * @param subject Only subjects containing this text ("" for any)
+ * @param identify Only this label, "FAKE" or "TRUE" ("" for any)
+ * @param matchCount Number of articles returned
+ * @return array of matching nodes in date order (caller must delete[]), or nullptr
+ */
+News** queryDateRange(const DateIndex& index, int from, int to, const string& subject, const string& identify, int& matchCount) {
+    matchCount = 0;
+    if (from <= 0 || to < from) return nullptr;
+    int begin = dateBound(index, from, false);
+    int end = dateBound(index, to, true);
+    if (begin >= end) return nullptr;
+
+    News** results = new News*[end - begin];
+    for (int i = begin; i < end; i++) {
+        News* node = index.nodes[i];
+        if (!subject.empty() && node -> subject.find(subject) == string::npos) continue;
+        if (!identify.empty() && node -> identify != identify) continue;
+        results[matchCount++] = node;
+    }
+    if (matchCount == 0) {
+        delete[] results;
+        return nullptr;
+    }
+    return results;
+}
+
+/**
+ * Free the memory owned by the date index
+ * @param index The date index
+ */
+void freeDateIndex(DateIndex& index) {
+    for (int l = 1; l < index.levelCount; l++) delete[] index.levels[l]; // levels[0] aliases keys
+    delete[] index.keys;
+    delete[] index.nodes;
+    index.keys = nullptr;
+    index.nodes = nullptr;
+    index.levelCount = 0;
+}
+
+/**
+ * Free every express lane of the skip list
+ * @param skipList The skip list overlay
+ */
+void freeSkipList(SkipList& skipList) {
+    SkipNode* lane = skipList.top;
+    while (lane) {
+        SkipNode* below = lane -> down;
+        while (lane) {
+            SkipNode* tmp = lane;
+            lane = lane -> next;
+            delete tmp;
+        }
+        lane = below;
+    }
+    skipList.top = nullptr;
+    skipList.lanes = 0;
+    skipList.entries = 0;
+}
+
+/**
+ * Build the skip list overlay over a list sorted by date.
+ * Nodes with invalid dates inherit the previous key so the lanes stay in order.
+ * @param head The head of the sorted linked list
+ * @param skipList The skip list overlay to (re)build
+ * @return false if the list is not sorted by date (no overlay is built)
+ */
+bool buildSkipList(News* head, SkipList& skipList) {
+    freeSkipList(skipList);
+    if (!head) return false;
+
+    // Lowest express lane: one entry every SKIP_FACTOR base nodes (always including the head)
+    SkipNode* laneHead = nullptr;
+    SkipNode* laneTail = nullptr;
+    int laneSize = 0;
+    int lastKey = 0;
+    int position = 0;
+    for (News* cur = head; cur; cur = cur -> next, position++) {
+        int key = packDate(cur -> date);
+        if (key == 0) key = lastKey;
+        if (key < lastKey) {
+            // Not sorted: discard what was built so far
+            while (laneHead) {
+                SkipNode* tmp = laneHead;
+                laneHead = laneHead -> next;
+                delete tmp;
+            }
+            return false;
+        }
+        lastKey = key;
+        if (position % SKIP_FACTOR == 0) {
+            SkipNode* entry = new SkipNode(key, cur);
+            if (laneTail) laneTail -> next = entry; else laneHead = entry;
+            laneTail = entry;
+            laneSize++;
+        }
+    }
+    skipList.entries = laneSize;
+    skipList.lanes = 1;
+
+    // Promote every SKIP_FACTOR-th entry until the top lane is short
+    while (laneSize > SKIP_FACTOR) {
+        SkipNode* upperHead = nullptr;
+        SkipNode* upperTail = nullptr;
+        int upperSize = 0;
+        int i = 0;
+        for (SkipNode* entry = laneHead; entry; entry = entry -> next, i++) {
+            if (i % SKIP_FACTOR != 0) continue;
+            SkipNode* promoted = new SkipNode(entry -> key, entry -> news);
+            promoted -> down = entry;
+            if (upperTail) upperTail -> next = promoted; else upperHead = promoted;
+            upperTail = promoted;
+            upperSize++;
+        }
+        laneHead = upperHead;
+        laneSize = upperSize;
+        skipList.entries += upperSize;
+        skipList.lanes++;
+    }
+    skipList.top = laneHead;
+    return true;
+}
+
+/**
+ * Seek the first node whose date is >= key, dropping down the express lanes
+ * @param skipList The skip list overlay
+ * @param key The packed date to seek
+ * @return the first matching node in the base list, or nullptr
+ */
+News* skipListSeek(const SkipList& skipList, int key) {
+    SkipNode* entry = skipList.top;
+    if (!entry) return nullptr;
+    // The head entry is the smallest key; if it already satisfies the key start from it
+    if (entry -> key >= key) return entry -> news;
+    while (true) {
+        while (entry -> next && entry -> next -> key < key) entry = entry -> next;
+        if (!entry -> down) break;
+        entry = entry -> down;
+    }
+    // Finish on the base list: at most SKIP_FACTOR nodes away
+    News* cur = entry -> news;
+    while (cur) {
+        int curKey = packDate(cur -> date);
+        if (curKey != 0 && curKey >= key) return cur;
+        cur = cur -> next;
+    }
+    return nullptr;
+}
+
+/**
+ * Skip list search: seek to the first article of the year and count the matching run
+ * @param skipList The skip list overlay
+ * @param target The target year to search for
+ * @return total article found
+ */
+int skipListSearch(const SkipList& skipList, int target) {
+    int fromKey = target * 10000 + 101;
+    int toKey = target * 10000 + 1231;
+    int totalCount = 0;
+    for (News* cur = skipListSeek(skipList, fromKey); cur; cur = cur -> next) {
+        int key = packDate(cur -> date);
+        if (key == 0) continue; // invalid dates are not part of any year
+        if (key > toKey) break;
+        totalCount++;
+    }
+    return totalCount;
+}
+
+const unsigned long long SWAR_ONES = 0x0101010101010101ULL;
+const unsigned long long SWAR_HIGH_BITS = 0x8080808080808080ULL;
+const unsigned long long SWAR_LOW_BITS = 0x7F7F7F7F7F7F7F7FULL;
+
+/**
+ * Bytes of a word that lie in [lo, hi]. Both sums stay inside their byte, so
+ * no carry crosses into the next one
+ * @param word 8 bytes of text
+ * @param lo Lowest byte value of the class, below 0x80
+ * @param hi Highest byte value of the class, below 0x80
+ * @return word with the top bit set in each byte of the class
+ */
+inline unsigned long long swarInRange(unsigned long long word, unsigned char lo, unsigned char hi) {
+    unsigned long long low = word & SWAR_LOW_BITS;
+    unsigned long long atLeastLo = low + SWAR_ONES * (0x80 - lo);
+    unsigned long long atMostHi = SWAR_ONES * (0x80 + hi) - low;
+    return atLeastLo & atMostHi & ~word & SWAR_HIGH_BITS;
+}
+
+/**
+ * The tokenizer shared by the inverted index and the queries run against it.
+ * A token is a run of letters and digits, lowercased; every other byte ends
+ * the token. This differs on purpose from linked_list_doc, ArrayAlgorithm and
+ * DataCleaning, which split only on whitespace and drop punctuation ("don't"
+ * -> "dont") to match WordIndex.bin: here "don't" gives "don" and "t", so a
+ * query matches however it is punctuated. The text is read 8 bytes at a time
+ * into a 64-bit word and classified with SWAR arithmetic: each class test sets
+ * the top bit of every byte in the class, and adding the uppercase mask shifted
+ * down to 0x20 lowercases A-Z in the register. A block of 8 letters and digits
+ * is appended whole; other blocks are walked byte by byte. The callback gets a
+ * reused buffer, so it must copy the token if it keeps it.
+ * @param text The text to split
+ * @param onToken Called with each token
+ */
+template<typename Callback>
+void forEachToken(const string& text, Callback onToken) {
+    string token;
+    for (size_t i = 0; i < text.size(); i += 8) {
+        size_t blockSize = text.size() - i < 8 ? text.size() - i : 8;
+        unsigned long long word = 0;                    // A short last block is zero padded
+        memcpy(&word, text.data() + i, blockSize);
+        unsigned long long upper = swarInRange(word, 'A', 'Z');
+        unsigned long long alnum = upper | swarInRange(word, 'a', 'z') | swarInRange(word, '0', '9');
+        word += upper >> 2;                             // 0x80 >> 2 == 'a' - 'A'
+        char bytes[8];
+        memcpy(bytes, &word, 8);
+        if (alnum == SWAR_HIGH_BITS) {
+            token.append(bytes, 8);
+            continue;
+        }
+        unsigned char alnumBytes[8];
+        memcpy(alnumBytes, &alnum, 8);
+        for (size_t j = 0; j < blockSize; j++) {
+            if (alnumBytes[j]) {
+                token.push_back(bytes[j]);
+            } else if (!token.empty()) {
+                onToken(token);
+                token.clear();
+            }
+        }
+    }
+    if (!token.empty())
+        onToken(token);
+}
+
+/**
+ * FNV-1a hash of a token
+ * @param token The token to hash
+ * @return the hash value
+ */
+unsigned int hashToken(const string& token) {
+    unsigned int h = 2166136261u;
+    for (unsigned char c : token) {
+        h ^= c;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+/**
+ * Find the term id of a token
+ * @param index The inverted index
+ * @param token The token to look up
+ * @return the term id, or -1 if the token was never indexed
+ */
+int findTerm(const InvertedIndex& index, const string& token) {
+    if (index.slotCapacity == 0) return -1;
+    unsigned int mask = index.slotCapacity - 1;
+    for (unsigned int slot = hashToken(token) & mask; index.slots[slot] != 0; slot = (slot + 1) & mask) {
+        if (index.terms[index.slots[slot] - 1] == token) return index.slots[slot] - 1;
+    }
+    return -1;
+}
+
+/**
+ * Find the term id of a token, adding it to the dictionary if needed
+ * @param index The inverted index
+ * @param token The token to look up
+ * @return the term id
+ */
+int findOrAddTerm(InvertedIndex& index, const string& token) {
+    // Keep the table at most half full
+    if ((index.termCount + 1) * 2 > index.slotCapacity) {
+        int newCapacity = index.slotCapacity ? index.slotCapacity * 2 : 1024;
+        int* newSlots = new int[newCapacity]();
+        for (int t = 0; t < index.termCount; t++) {
+            unsigned int slot = hashToken(index.terms[t]) & (newCapacity - 1);
+            while (newSlots[slot] != 0) slot = (slot + 1) & (newCapacity - 1);
+            newSlots[slot] = t + 1;
+        }
+        delete[] index.slots;
+        index.slots = newSlots;
+        index.slotCapacity = newCapacity;
+    }
+
+    unsigned int mask = index.slotCapacity - 1;
+    unsigned int slot = hashToken(token) & mask;
+    while (index.slots[slot] != 0) {
+        if (index.terms[index.slots[slot] - 1] == token) return index.slots[slot] - 1;
+        slot = (slot + 1) & mask;
+    }
+
+    if (index.termCount == index.termCapacity) {
+        int newCapacity = index.termCapacity ? index.termCapacity * 2 : 1024;
+        string* newTerms = new string[newCapacity];
+        PostingList* newPostings = new PostingList[newCapacity];
+        for (int t = 0; t < index.termCount; t++) {
+            newTerms[t].swap(index.terms[t]);
+            newPostings[t] = index.postings[t];
+        }
+        delete[] index.terms;
+        delete[] index.postings;
+        index.terms = newTerms;
+        index.postings = newPostings;
+        index.termCapacity = newCapacity;
+    }
+    index.terms[index.termCount] = token;
+    index.slots[slot] = index.termCount + 1;
+    return index.termCount++;
+}
+
+/**
+ * Append one varint (7 bits per byte, high bit = more bytes follow)
+ * @param list The posting list to append to
+ * @param value The value to encode
+ */
+void appendVarint(PostingList& list, unsigned int value) {
+    if (list.size + 5 > list.capacity) {
+        int newCapacity = list.capacity ? list.capacity * 2 : 16;
+        unsigned char* newBytes = new unsigned char[newCapacity];
+        for (int i = 0; i < list.size; i++) newBytes[i] = list.bytes[i];
+        delete[] list.bytes;
+        list.bytes = newBytes;
+        list.capacity = newCapacity;
+    }
+    while (value >= 0x80) {
+        list.bytes[list.size++] = static_cast<unsigned char>(value | 0x80);
+        value >>= 7;
+    }
+    list.bytes[list.size++] = static_cast<unsigned char>(value);
+}
+
+/**
+ * Read one varint
+ * @param bytes The encoded bytes
+ * @param pos Read position, advanced past the varint
+ * @return the decoded value
+ */
+unsigned int readVarint(const unsigned char* bytes, int& pos) {
+    unsigned int value = 0;
+    int shift = 0;
+    while (bytes[pos] & 0x80) {
+        value |= static_cast<unsigned int>(bytes[pos++] & 0x7F) << shift;
+        shift += 7;
+    }
+    value |= static_cast<unsigned int>(bytes[pos++]) << shift;
+    return value;
+}
+
+/**
+ * Add the articles from 'first' to the end of the list to the inverted index,
+ * numbering them on from index.docCount. Tokens come from forEachToken over
+ * the title and text; term frequencies are accumulated per article and
+ * flushed to the posting lists when the article ends. Article ids only grow,
+ * so the new postings continue each list's deltas. Used for the initial build
+ * and for the articles a refresh loads.
+ * @param index The index to update
+ * @param first The first article to add
+ */
+void addToInvertedIndex(InvertedIndex& index, News* first) {
+    int count = index.docCount;
+    for (News* cur = first; cur; cur = cur -> next) count++;
+    if (count > index.docCapacity) {
+        int capacity = max(count, index.docCapacity * 2);
+        News** docNodes = new News*[capacity];
+        int* docLength = new int[capacity]();
+        for (int d = 0; d < index.docCount; d++) {
+            docNodes[d] = index.docNodes[d];
+            docLength[d] = index.docLength[d];
+        }
+        delete[] index.docNodes;
+        delete[] index.docLength;
+        index.docNodes = docNodes;
+        index.docLength = docLength;
+        index.docCapacity = capacity;
+    }
+    int touchedCapacity = 1024;
+    int* touched = new int[touchedCapacity];
+
+    int doc = index.docCount;
+    for (News* cur = first; cur; cur = cur -> next, doc++) {
+        index.docNodes[doc] = cur;
+        int touchedCount = 0;
+        auto addToken = [&](const string& token) {
+            int term = findOrAddTerm(index, token);
+            PostingList& list = index.postings[term];
+            if (list.pendingDoc != doc) {
+                list.pendingDoc = doc;
+                list.pendingTf = 0;
+                if (touchedCount == touchedCapacity) {
+                    int* grown = new int[touchedCapacity * 2];
+                    for (int t = 0; t < touchedCount; t++) grown[t] = touched[t];
+                    delete[] touched;
+                    touched = grown;
+                    touchedCapacity *= 2;
+                }
+                touched[touchedCount++] = term;
+            }
+            list.pendingTf++;
+            index.docLength[doc]++;
+        };
+        forEachToken(cur -> title, addToken);
+        forEachToken(cur -> text, addToken);
+        // Flush this article's term frequencies
+        for (int t = 0; t < touchedCount; t++) {
+            PostingList& list = index.postings[touched[t]];
+            appendVarint(list, static_cast<unsigned int>(doc - list.lastDoc));
+            appendVarint(list, static_cast<unsigned int>(list.pendingTf));
+            list.lastDoc = doc;
+            list.docFreq++;
+        }
+        index.totalLength += index.docLength[doc];
+    }
+    delete[] touched;
+
+    index.docCount = count;
+    index.avgDocLength = count > 0 ? static_cast<double>(index.totalLength) / count : 0;
+    index.compressedBytes = 0;
+    for (int t = 0; t < index.termCount; t++) index.compressedBytes += index.postings[t].size;
+}
+
+/**
+ * Build the inverted index in one pass over the list
+ * @param head The head of the linked list
+ * @param index The index to fill
+ */
+void buildInvertedIndex(News* head, InvertedIndex& index) {
+    addToInvertedIndex(index, head);
+}
+
+/**
+ * Expand a posting list into article ids (ascending) and term frequencies
+ * @param list The posting list
+ * @param tfs Output term frequencies (may be nullptr)
+ * @return array of docFreq article ids (caller must delete[])
+ */
+int* decodePostings(const PostingList& list, int* tfs) {
+    int* docs = new int[list.docFreq > 0 ? list.docFreq : 1];
+    int pos = 0, doc = -1;
+    for (int i = 0; i < list.docFreq; i++) {
+        doc += static_cast<int>(readVarint(list.bytes, pos));
+        docs[i] = doc;
+        int tf = static_cast<int>(readVarint(list.bytes, pos));
+        if (tfs) tfs[i] = tf;
+    }
+    return docs;
+}
+
+/**
+ * Sorted article-id set operations used by the boolean search.
+ * Each returns a new array (caller must delete[]).
+ */
+int* intersectDocs(const int* a, int aCount, const int* b, int bCount, int& resultCount) {
+    int* result = new int[min(aCount, bCount) + 1];
+    resultCount = 0;
+    int i = 0, j = 0;
+    while (i < aCount && j < bCount) {
+        if (a[i] < b[j]) i++;
+        else if (a[i] > b[j]) j++;
+        else { result[resultCount++] = a[i]; i++; j++; }
+    }
+    return result;
+}
+
+int* uniteDocs(const int* a, int aCount, const int* b, int bCount, int& resultCount) {
+    int* result = new int[aCount + bCount + 1];
+    resultCount = 0;
+    int i = 0, j = 0;
+    while (i < aCount || j < bCount) {
+        if (j >= bCount || (i < aCount && a[i] < b[j])) result[resultCount++] = a[i++];
+        else if (i >= aCount || b[j] < a[i]) result[resultCount++] = b[j++];
+        else { result[resultCount++] = a[i]; i++; j++; }
+    }
+    return result;
+}
+
+int* subtractDocs(const int* a, int aCount, const int* b, int bCount, int& resultCount) {
+    int* result = new int[aCount + 1];
+    resultCount = 0;
+    int j = 0;
+    for (int i = 0; i < aCount; i++) {
+        while (j < bCount && b[j] < a[i]) j++;
+        if (j >= bCount || b[j] != a[i]) result[resultCount++] = a[i];
+    }
+    return result;
+}
+
+/**
+ * Articles containing a query word. The word goes through forEachToken like
+ * the indexed text, so "don't", "well-known" and "u.s." become the tokens
+ * "don" "t", "well" "known" and "u" "s", and an article must contain all of them.
+ * @param index The inverted index
+ * @param word The raw query word
+ * @param docCount Number of articles returned
+ * @return array of article ids (caller must delete[]), or nullptr if the word has no letters or digits
+ */
+int* queryWordDocs(const InvertedIndex& index, const string& word, int& docCount) {
+    int* docs = nullptr;
+    docCount = 0;
+    forEachToken(word, [&](const string& token) {
+        int termId = findTerm(index, token);
+        int tokenCount = termId >= 0 ? index.postings[termId].docFreq : 0;
+        int* tokenDocs = termId >= 0 ? decodePostings(index.postings[termId], nullptr) : new int[1];
+        if (!docs) {
+            docs = tokenDocs;
+            docCount = tokenCount;
+            return;
+        }
+        int combinedCount;
+        int* combined = intersectDocs(docs, docCount, tokenDocs, tokenCount, combinedCount);
+        delete[] docs;
+        delete[] tokenDocs;
+        docs = combined;
+        docCount = combinedCount;
+    });
+    return docs;
+}
+
+/**
+ * Boolean search, evaluated left to right, e.g. "trump AND wall NOT mexico".
+ * Adjacent terms default to AND and NOT negates the term that follows it.
+ * @param index The inverted index
+ * @param query The query text
+ * @param matchCount Number of matching articles
+ * @return array of matching article ids (caller must delete[])
+ */
+int* searchBoolean(const InvertedIndex& index, const string& query, int& matchCount) {
+    stringstream ss(query);
+    string word;
+    int* result = nullptr;
+    matchCount = 0;
+    bool first = true, useOr = false, negate = false;
+
+    // All article ids, used to negate a term
+    int* allDocs = new int[index.docCount + 1];
+    for (int d = 0; d < index.docCount; d++) allDocs[d] = d;
+
+    while (ss >> word) {
+        if (word == "AND") { useOr = false; continue; }
+        if (word == "OR") { useOr = true; continue; }
+        if (word == "NOT") { negate = !negate; continue; }
+
+        int docCount;
+        int* docs = queryWordDocs(index, word, docCount);
+        if (!docs) continue;
+
+        if (negate) {
+            int complementCount;
+            int* complement = subtractDocs(allDocs, index.docCount, docs, docCount, complementCount);
+            delete[] docs;
+            docs = complement;
+            docCount = complementCount;
+        }
+
+        if (first) {
+            result = docs;
+            matchCount = docCount;
+            first = false;
+        } else {
+            int combinedCount;
+            int* combined = useOr ? uniteDocs(result, matchCount, docs, docCount, combinedCount)
+                                  : intersectDocs(result, matchCount, docs, docCount, combinedCount);
+            delete[] result;
+            delete[] docs;
+            result = combined;
+            matchCount = combinedCount;
+        }
+        useOr = false;
+        negate = false;
+    }
+    delete[] allDocs;
+    return result;
+}
+
+/**
+ * Ranked search: score every article containing a query term with BM25
+ * @param index The inverted index
+ * @param query The query text (operators are ignored)
+ * @param topK Maximum number of results
+ * @param resultDocs Output article ids, best first
+ * @param resultScores Output scores, best first
+ * @return number of results written
+ */
+int searchRanked(const InvertedIndex& index, const string& query, int topK, int* resultDocs, double* resultScores) {
+    const double k1 = 1.2, b = 0.75;
+    double* scores = new double[index.docCount]();
+
+    stringstream ss(query);
+    string word;
+    while (ss >> word) {
+        if (word == "AND" || word == "OR" || word == "NOT") continue;
+        // Every token of the word ("u.s." is "u" and "s") is scored as a term
+        forEachToken(word, [&](const string& token) {
+            int termId = findTerm(index, token);
+            if (termId < 0) return;
+            const PostingList& list = index.postings[termId];
+            double idf = log(1.0 + (index.docCount - list.docFreq + 0.5) / (list.docFreq + 0.5));
+            int* tfs = new int[list.docFreq];
+            int* docs = decodePostings(list, tfs);
+            for (int i = 0; i < list.docFreq; i++) {
+                double norm = k1 * (1.0 - b + b * index.docLength[docs[i]] / index.avgDocLength);
+                scores[docs[i]] += idf * (tfs[i] * (k1 + 1.0)) / (tfs[i] + norm);
+            }
+            delete[] docs;
+            delete[] tfs;
+        });
+    }
+
+    // Keep the best topK by insertion into a small sorted array
+    int resultCount = 0;
+    for (int d = 0; d < index.docCount; d++) {
+        if (scores[d] <= 0) continue;
+        if (resultCount == topK && scores[d] <= resultScores[resultCount - 1]) continue;
+        int pos = resultCount < topK ? resultCount++ : topK - 1;
+        while (pos > 0 && resultScores[pos - 1] < scores[d]) {
+            resultScores[pos] = resultScores[pos - 1];
+            resultDocs[pos] = resultDocs[pos - 1];
+            pos--;
+        }
+        resultScores[pos] = scores[d];
+        resultDocs[pos] = d;
+    }
+    delete[] scores;
+    return resultCount;
+}
+
+/**
+ * Free the memory owned by the inverted index
+ * @param index The inverted index
+ */
+void freeInvertedIndex(InvertedIndex& index) {
+    for (int t = 0; t < index.termCount; t++) delete[] index.postings[t].bytes;
+    delete[] index.postings;
+    delete[] index.terms;
+    delete[] index.slots;
+    delete[] index.docNodes;
+    delete[] index.docLength;
+    index = InvertedIndex();
+}
+
 /**
  * Display the plot of fake news over time
  * @param fakeNewsCount - The count of fake news articles by month
@@ -435,7 +1325,10 @@ int binarySearch(News* head, int target) {
  */
 void displayNewsPlot(const unordered_map<int, int>& fakeNewsCount, const unordered_map<int, int>& totalNewsCount) {
     // Display the news plot here
-    for (int month = 1; month <= fakeNewsCount.size(); month++) {
+    ios_base::fmtflags flags = cout.flags();
+    streamsize precision = cout.precision();
+    // Every month, not just as many months as have fake articles
+    for (int month = 1; month <= 12; month++) {
         int fakeCount = fakeNewsCount.count(month) ? fakeNewsCount.at(month) : 0;
         int totalCount = totalNewsCount.count(month) ? totalNewsCount.at(month) : 0;
         // Calculate the percentage of fake news articles
@@ -461,10 +1354,23 @@ void displayNewsPlot(const unordered_map<int, int>& fakeNewsCount, const unorder
         cout << left << setw(10) << monthName << "\t | " << string(static_cast<int>(percentage), '*')
             << " " << fixed << setprecision(1) << percentage << "%" << endl;
     }
+    cout.flags(flags);
+    cout.precision(precision);
+}
+
+/**
+ * Whether an article counts as political news. The list baseline, the cube
+ * slice and the facet bitmaps all use this exact set, so they agree
+ * @param subject The article's subject
+ * @return true for "politics" and "politicsNews"
+ */
+bool isPoliticalSubject(const string& subject) {
+    return subject == "politics" || subject == "politicsNews";
 }
 
 /**
- * Calculate Total Number of Political News
+ * Calculate Total Number of Political News by walking the whole list; the
+ * baseline for countPoliticNewsCube
  * @param news The head of the linked list
  */
 void countPoliticNews(News** news) {
@@ -481,7 +1387,7 @@ void countPoliticNews(News** news) {
         auto [day, month, year] = trimDate(currentNews -> date);
         
         // If subject is politics and year is 2016
-        if ((currentNews -> subject == "politics" || currentNews -> subject == "politicsNews") && year == "2016") {
+        if (isPoliticalSubject(currentNews -> subject) && year == "2016") {
             if (currentNews -> identify == "FAKE") {    // If identify is FAKE
                 fakePoliticalNews2016++;                // Increment fake news count
                 fakeNewsCount[stoi(month)]++;           // Increment fake news count by month
@@ -510,40 +1416,1694 @@ void countPoliticNews(News** news) {
 }
 
 /**
- * Calculate memory usage for a single node
- * @param node Pointer to News node
- * @return Memory usage in bytes
+ * Roaring-style compressed bitmap of row ids.
+ * Rows are split into chunks of 65536 by their high 16 bits. A sparse
+ * chunk stores its sorted low 16 bits in an array; once it holds more
+ * than 4096 rows it switches to a plain 65536-bit bitmap.
  */
-size_t calculateNodeMemory(News* node) {
-    if (!node) return 0;
-    
-    size_t memory = sizeof(News);  // Struct size
-    // String content sizes
-    memory += node -> title.capacity();
-    memory += node -> text.capacity();
-    memory += node -> subject.capacity();
-    memory += node -> date.capacity();
-    memory += node -> identify.capacity();
-    // Pointer sizes
-    memory += sizeof(News*) * 2;  // next and head pointers
-    
-    return memory;
+const int ROARING_ARRAY_MAX = 4096;
+const int ROARING_WORDS = 1024;     // 65536 bits
+
+struct RoaringContainer {
+    int key = 0;                            // high 16 bits of the rows
+    int cardinality = 0;
+    int arrayCapacity = 0;
+    unsigned short* array = nullptr;        // sorted low bits (sparse chunk)
+    unsigned long long* bits = nullptr;     // 1024 words (dense chunk)
+};
+
+struct RoaringBitmap {
+    RoaringContainer* containers = nullptr;
+    int containerCount = 0;
+    int capacity = 0;
+};
+
+// Portable 64-bit population count.
+int popcount64(unsigned long long x) {
+    x = x - ((x >> 1) & 0x5555555555555555ULL);
+    x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+    x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return static_cast<int>((x * 0x0101010101010101ULL) >> 56);
+}
+
+RoaringContainer& roaringAppendContainer(RoaringBitmap& bm, int key) {
+    if (bm.containerCount == bm.capacity) {
+        int newCapacity = bm.capacity ? bm.capacity * 2 : 4;
+        RoaringContainer* grown = new RoaringContainer[newCapacity];
+        for (int i = 0; i < bm.containerCount; i++)
+            grown[i] = bm.containers[i];
+        delete[] bm.containers;
+        bm.containers = grown;
+        bm.capacity = newCapacity;
+    }
+    RoaringContainer& c = bm.containers[bm.containerCount++];
+    c = RoaringContainer();
+    c.key = key;
+    return c;
+}
+
+// Switch a sparse chunk to a dense bitmap.
+void roaringToBitmap(RoaringContainer& c) {
+    c.bits = new unsigned long long[ROARING_WORDS]();
+    for (int i = 0; i < c.cardinality; i++)
+        c.bits[c.array[i] >> 6] |= 1ULL << (c.array[i] & 63);
+    delete[] c.array;
+    c.array = nullptr;
+    c.arrayCapacity = 0;
 }
 
 /**
- * Calculate detailed memory statistics for a linked list
- * @param head Pointer to head of linked list
- * @return MemoryStats struct with detailed memory information
+ * Add a row id. Rows must be added in increasing order,
+ * which is how every index here is built (one pass over the rows).
  */
-MemoryStats calculateDetailedMemory(News* head) {
-    MemoryStats stats;
-    News* current = head;
-    
-    while (current) {
-        stats.structSize += sizeof(News);
-        stats.stringSize += current -> title.capacity() +
-                            current -> text.capacity() +
-                            current -> subject.capacity() +
+void roaringAdd(RoaringBitmap& bm, int row) {
+    int key = row >> 16;
+    unsigned short low = static_cast<unsigned short>(row & 0xFFFF);
+    RoaringContainer& c = (bm.containerCount > 0 && bm.containers[bm.containerCount - 1].key == key)
+                          ? bm.containers[bm.containerCount - 1]
+                          : roaringAppendContainer(bm, key);
+    if (c.bits) {
+        c.bits[low >> 6] |= 1ULL << (low & 63);
+        c.cardinality++;
+        return;
+    }
+    if (c.cardinality == ROARING_ARRAY_MAX) {
+        roaringToBitmap(c);
+        c.bits[low >> 6] |= 1ULL << (low & 63);
+        c.cardinality++;
+        return;
+    }
+    if (c.cardinality == c.arrayCapacity) {
+        int newCapacity = c.arrayCapacity ? c.arrayCapacity * 2 : 16;
+        unsigned short* grown = new unsigned short[newCapacity];
+        for (int i = 0; i < c.cardinality; i++)
+            grown[i] = c.array[i];
+        delete[] c.array;
+        c.array = grown;
+        c.arrayCapacity = newCapacity;
+    }
+    c.array[c.cardinality++] = low;
+}
+
+int roaringCount(const RoaringBitmap& bm) {
+    int total = 0;
+    for (int i = 0; i < bm.containerCount; i++)
+        total += bm.containers[i].cardinality;
+    return total;
+}
+
+// AND of two chunks with the same key, written into 'out' (already keyed).
+void roaringAndContainer(const RoaringContainer& a, const RoaringContainer& b, RoaringContainer& out) {
+    if (a.bits && b.bits) {
+        int card = 0;
+        for (int w = 0; w < ROARING_WORDS; w++)
+            card += popcount64(a.bits[w] & b.bits[w]);
+        out.cardinality = card;
+        if (card > ROARING_ARRAY_MAX) {
+            out.bits = new unsigned long long[ROARING_WORDS];
+            for (int w = 0; w < ROARING_WORDS; w++)
+                out.bits[w] = a.bits[w] & b.bits[w];
+        } else {
+            out.array = new unsigned short[card > 0 ? card : 1];
+            out.arrayCapacity = card;
+            int n = 0;
+            for (int w = 0; w < ROARING_WORDS; w++) {
+                unsigned long long word = a.bits[w] & b.bits[w];
+                while (word) {
+                    int bit = popcount64((word & (~word + 1)) - 1);
+                    out.array[n++] = static_cast<unsigned short>(w * 64 + bit);
+                    word &= word - 1;
+                }
+            }
+        }
+        return;
+    }
+    // At least one side is sparse: the result fits in an array.
+    const RoaringContainer& sparse = a.bits ? b : a;
+    const RoaringContainer& other = a.bits ? a : b;
+    out.array = new unsigned short[sparse.cardinality > 0 ? sparse.cardinality : 1];
+    out.arrayCapacity = sparse.cardinality;
+    int n = 0;
+    if (other.bits) {
+        for (int i = 0; i < sparse.cardinality; i++) {
+            unsigned short v = sparse.array[i];
+            if (other.bits[v >> 6] & (1ULL << (v & 63)))
+                out.array[n++] = v;
+        }
+    } else {
+        int i = 0, j = 0;
+        while (i < sparse.cardinality && j < other.cardinality) {
+            if (sparse.array[i] < other.array[j]) i++;
+            else if (sparse.array[i] > other.array[j]) j++;
+            else { out.array[n++] = sparse.array[i]; i++; j++; }
+        }
+    }
+    out.cardinality = n;
+}
+
+/**
+ * Intersection of two bitmaps (new bitmap).
+ */
+RoaringBitmap roaringAnd(const RoaringBitmap& a, const RoaringBitmap& b) {
+    RoaringBitmap out;
+    int i = 0, j = 0;
+    while (i < a.containerCount && j < b.containerCount) {
+        if (a.containers[i].key < b.containers[j].key) i++;
+        else if (a.containers[i].key > b.containers[j].key) j++;
+        else {
+            RoaringContainer& c = roaringAppendContainer(out, a.containers[i].key);
+            roaringAndContainer(a.containers[i], b.containers[j], c);
+            if (c.cardinality == 0) {
+                delete[] c.array;
+                delete[] c.bits;
+                out.containerCount--;
+            }
+            i++;
+            j++;
+        }
+    }
+    return out;
+}
+
+/**
+ * Union of two bitmaps (new bitmap). Chunks are merged as
+ * dense bitmaps and shrunk back to arrays when they are sparse.
+ */
+RoaringBitmap roaringOr(const RoaringBitmap& a, const RoaringBitmap& b) {
+    RoaringBitmap out;
+    int i = 0, j = 0;
+    while (i < a.containerCount || j < b.containerCount) {
+        int key;
+        if (j >= b.containerCount || (i < a.containerCount && a.containers[i].key < b.containers[j].key))
+            key = a.containers[i].key;
+        else
+            key = b.containers[j].key;
+        RoaringContainer& c = roaringAppendContainer(out, key);
+        c.bits = new unsigned long long[ROARING_WORDS]();
+        const RoaringContainer* sides[2] = {
+            (i < a.containerCount && a.containers[i].key == key) ? &a.containers[i++] : nullptr,
+            (j < b.containerCount && b.containers[j].key == key) ? &b.containers[j++] : nullptr
+        };
+        for (int s = 0; s < 2; s++) {
+            const RoaringContainer* side = sides[s];
+            if (!side) continue;
+            if (side->bits) {
+                for (int w = 0; w < ROARING_WORDS; w++)
+                    c.bits[w] |= side->bits[w];
+            } else {
+                for (int k = 0; k < side->cardinality; k++)
+                    c.bits[side->array[k] >> 6] |= 1ULL << (side->array[k] & 63);
+            }
+        }
+        c.cardinality = 0;
+        for (int w = 0; w < ROARING_WORDS; w++)
+            c.cardinality += popcount64(c.bits[w]);
+        if (c.cardinality <= ROARING_ARRAY_MAX) {
+            unsigned long long* bits = c.bits;
+            c.bits = nullptr;
+            c.array = new unsigned short[c.cardinality > 0 ? c.cardinality : 1];
+            c.arrayCapacity = c.cardinality;
+            int n = 0;
+            for (int w = 0; w < ROARING_WORDS; w++) {
+                for (unsigned long long word = bits[w]; word; word &= word - 1)
+                    c.array[n++] = static_cast<unsigned short>(w * 64 + popcount64((word & (~word + 1)) - 1));
+            }
+            delete[] bits;
+        }
+    }
+    return out;
+}
+
+/**
+ * Size of the intersection without building it.
+ */
+int roaringAndCount(const RoaringBitmap& a, const RoaringBitmap& b) {
+    int total = 0;
+    int i = 0, j = 0;
+    while (i < a.containerCount && j < b.containerCount) {
+        if (a.containers[i].key < b.containers[j].key) { i++; continue; }
+        if (a.containers[i].key > b.containers[j].key) { j++; continue; }
+        const RoaringContainer& x = a.containers[i++];
+        const RoaringContainer& y = b.containers[j++];
+        if (x.bits && y.bits) {
+            for (int w = 0; w < ROARING_WORDS; w++)
+                total += popcount64(x.bits[w] & y.bits[w]);
+        } else if (x.bits || y.bits) {
+            const RoaringContainer& sparse = x.bits ? y : x;
+            const RoaringContainer& dense = x.bits ? x : y;
+            for (int k = 0; k < sparse.cardinality; k++) {
+                unsigned short v = sparse.array[k];
+                if (dense.bits[v >> 6] & (1ULL << (v & 63)))
+                    total++;
+            }
+        } else {
+            int p = 0, q = 0;
+            while (p < x.cardinality && q < y.cardinality) {
+                if (x.array[p] < y.array[q]) p++;
+                else if (x.array[p] > y.array[q]) q++;
+                else { total++; p++; q++; }
+            }
+        }
+    }
+    return total;
+}
+
+void freeRoaring(RoaringBitmap& bm) {
+    for (int i = 0; i < bm.containerCount; i++) {
+        delete[] bm.containers[i].array;
+        delete[] bm.containers[i].bits;
+    }
+    delete[] bm.containers;
+    bm = RoaringBitmap();
+}
+
+/**
+ * Id of a subject in a name table, adding it if it is new. The table
+ * doubles when it is full, so every distinct subject keeps its own id.
+ * @param names Subject names, reallocated when the table grows
+ * @param count Number of names in use
+ * @param capacity Number of names allocated
+ * @param subject Subject to look up
+ */
+int internSubject(string*& names, int& count, int& capacity, const string& subject) {
+    for (int s = 0; s < count; s++)
+        if (names[s] == subject) return s;
+    if (count == capacity) {
+        int newCapacity = capacity ? capacity * 2 : 16;
+        string* grown = new string[newCapacity];
+        for (int s = 0; s < count; s++) grown[s].swap(names[s]);
+        delete[] names;
+        names = grown;
+        capacity = newCapacity;
+    }
+    names[count] = subject;
+    return count++;
+}
+
+/**
+ * Facet bitmaps built at load time: one bitmap per subject, per
+ * label and per year-month. Row ids are load positions.
+ */
+struct FacetIndex {
+    int rowCount = 0;
+    int subjectCount = 0;
+    int subjectCapacity = 0;
+    string* subjectNames = nullptr;
+    RoaringBitmap* subjects = nullptr;  // [subject], subjectCapacity entries
+    RoaringBitmap fake;
+    RoaringBitmap real;
+    int minYear = 0;
+    int yearCount = 0;
+    RoaringBitmap* years = nullptr;     // [year - minYear]
+    RoaringBitmap* months = nullptr;    // [(year - minYear) * 12 + month - 1]
+};
+
+/**
+ * Union of every subject bitmap whose name contains
+ * 'subject', or passes subjectFilter when one is given (new bitmap).
+ */
+RoaringBitmap facetSubjectUnion(const FacetIndex& index, const string& subject, bool (*subjectFilter)(const string&)) {
+    RoaringBitmap result;
+    for (int s = 0; s < index.subjectCount; s++) {
+        const string& name = index.subjectNames[s];
+        if (subjectFilter ? !subjectFilter(name) : name.find(subject) == string::npos)
+            continue;
+        RoaringBitmap merged = roaringOr(result, index.subjects[s]);
+        freeRoaring(result);
+        result = merged;
+    }
+    return result;
+}
+
+/**
+ * Generic facet query. Counts rows whose subject contains
+ * 'subject' ("" = any) or passes subjectFilter when one is given, with the
+ * given label (-1 = any, 0 = FAKE, 1 = TRUE), year (0 = any) and month
+ * (0 = any).
+ */
+int facetCount(const FacetIndex& index, const string& subject, int label, int year, int month,
+               bool (*subjectFilter)(const string&) = nullptr) {
+    // Time facet first: it is the most selective for the reports.
+    const RoaringBitmap* timeFacet = nullptr;
+    if (year != 0) {
+        if (year < index.minYear || year >= index.minYear + index.yearCount)
+            return 0;
+        if (month >= 1 && month <= 12)
+            timeFacet = &index.months[(year - index.minYear) * 12 + month - 1];
+        else
+            timeFacet = &index.years[year - index.minYear];
+    }
+    const RoaringBitmap* labelFacet = (label == 0) ? &index.fake : (label == 1) ? &index.real : nullptr;
+
+    bool anySubject = subject.empty() && !subjectFilter;
+    RoaringBitmap subjectFacet;
+    if (!anySubject)
+        subjectFacet = facetSubjectUnion(index, subject, subjectFilter);
+
+    const RoaringBitmap* facets[3];
+    int facetTotal = 0;
+    if (timeFacet) facets[facetTotal++] = timeFacet;
+    if (!anySubject) facets[facetTotal++] = &subjectFacet;
+    if (labelFacet) facets[facetTotal++] = labelFacet;
+
+    int result;
+    if (facetTotal == 0) {
+        result = index.rowCount;
+    } else if (facetTotal == 1) {
+        result = roaringCount(*facets[0]);
+    } else if (facetTotal == 2) {
+        result = roaringAndCount(*facets[0], *facets[1]);
+    } else {
+        RoaringBitmap pair = roaringAnd(*facets[0], *facets[1]);
+        result = roaringAndCount(pair, *facets[2]);
+        freeRoaring(pair);
+    }
+    freeRoaring(subjectFacet);
+    return result;
+}
+
+void freeFacetIndex(FacetIndex& index) {
+    for (int s = 0; s < index.subjectCount; s++)
+        freeRoaring(index.subjects[s]);
+    freeRoaring(index.fake);
+    freeRoaring(index.real);
+    for (int y = 0; y < index.yearCount; y++)
+        freeRoaring(index.years[y]);
+    for (int m = 0; m < index.yearCount * 12; m++)
+        freeRoaring(index.months[m]);
+    delete[] index.subjects;
+    delete[] index.subjectNames;
+    delete[] index.years;
+    delete[] index.months;
+    index.subjects = nullptr;
+    index.subjectNames = nullptr;
+    index.years = index.months = nullptr;
+    index.subjectCount = index.subjectCapacity = index.yearCount = index.rowCount = 0;
+}
+
+/**
+ * Widen the year range to include 'year'. The bitmaps are plain structs, so
+ * the existing ones are moved into the larger arrays without copying rows.
+ */
+void growFacetYears(FacetIndex& index, int year) {
+    int minYear = (index.yearCount == 0 || year < index.minYear) ? year : index.minYear;
+    int maxYear = (index.yearCount == 0 || year > index.minYear + index.yearCount - 1) ? year : index.minYear + index.yearCount - 1;
+    int yearCount = maxYear - minYear + 1;
+    RoaringBitmap* years = new RoaringBitmap[yearCount];
+    RoaringBitmap* months = new RoaringBitmap[yearCount * 12];
+    int shift = index.minYear - minYear;
+    for (int y = 0; y < index.yearCount; y++) {
+        years[y + shift] = index.years[y];
+        for (int m = 0; m < 12; m++) months[(y + shift) * 12 + m] = index.months[y * 12 + m];
+    }
+    delete[] index.years;
+    delete[] index.months;
+    index.years = years;
+    index.months = months;
+    index.minYear = minYear;
+    index.yearCount = yearCount;
+}
+
+/**
+ * Append the articles from 'first' to the end of the list to the facet
+ * bitmaps, numbering them on from index.rowCount. Used for the initial build
+ * and for the articles a refresh loads.
+ * @param index The index to update
+ * @param first The first article to add
+ */
+void addToFacetIndex(FacetIndex& index, News* first) {
+    int row = index.rowCount;
+    for (News* cur = first; cur; cur = cur -> next, row++) {
+        int oldCapacity = index.subjectCapacity;
+        int s = internSubject(index.subjectNames, index.subjectCount, index.subjectCapacity, cur -> subject);
+        if (index.subjectCapacity != oldCapacity) {
+            // The bitmaps are plain structs: move them across without copying rows
+            RoaringBitmap* subjects = new RoaringBitmap[index.subjectCapacity];
+            for (int i = 0; i < oldCapacity; i++) subjects[i] = index.subjects[i];
+            delete[] index.subjects;
+            index.subjects = subjects;
+        }
+        roaringAdd(index.subjects[s], row);
+
+        roaringAdd(cur -> identify == "FAKE" ? index.fake : index.real, row);
+
+        int packed = packDate(cur -> date);
+        if (packed != 0) {
+            int year = packed / 10000;
+            if (index.yearCount == 0 || year < index.minYear || year >= index.minYear + index.yearCount)
+                growFacetYears(index, year);
+            int y = year - index.minYear;
+            roaringAdd(index.years[y], row);
+            roaringAdd(index.months[y * 12 + packed / 100 % 100 - 1], row);
+        }
+    }
+    index.rowCount = row;
+}
+
+/**
+ * Build the facet bitmaps in one pass over the list, appending each row id
+ * (load position) to its subject, label, year and year-month bitmaps
+ * @param head The head of the linked list
+ * @param index The index to fill
+ */
+void buildFacetIndex(News* head, FacetIndex& index) {
+    int maxYear = 0;
+    index.minYear = 0;
+    for (News* cur = head; cur; cur = cur -> next) {
+        int packed = packDate(cur -> date);
+        if (packed == 0) continue;
+        int year = packed / 10000;
+        if (index.minYear == 0 || year < index.minYear) index.minYear = year;
+        if (year > maxYear) maxYear = year;
+    }
+    index.yearCount = (index.minYear > 0) ? maxYear - index.minYear + 1 : 0;
+    index.years = new RoaringBitmap[index.yearCount > 0 ? index.yearCount : 1];
+    index.months = new RoaringBitmap[index.yearCount > 0 ? index.yearCount * 12 : 1];
+    index.rowCount = 0;
+    addToFacetIndex(index, head);
+}
+
+/**
+ * Aggregate cube built at load time: article counts by (year, month,
+ * subject, label) in one dense array. Its size depends only on the number
+ * of distinct years and subjects, so every count below reads a fixed
+ * number of cells however long the list is. The last year slot holds
+ * articles without a valid date; month 0 is unused for dated articles.
+ */
+const int CUBE_MONTHS = 13;         // 0 = unknown, 1..12
+
+// Dimensions for cubeBreakdown
+const int CUBE_BY_YEAR = 0;
+const int CUBE_BY_MONTH = 1;
+const int CUBE_BY_SUBJECT = 2;
+const int CUBE_BY_LABEL = 3;
+
+struct AggregateCube {
+    int total = 0;
+    int minYear = 0;
+    int yearCount = 0;                  // year slots = yearCount + 1
+    int subjectCount = 0;
+    int subjectCapacity = 0;            // subject stride of cells
+    string* subjectNames = nullptr;
+    int* cells = nullptr;               // [((yearSlot * 13 + month) * subjectCapacity + subject) * 2 + label]
+};
+
+// A sub-cube: every field left at its default matches everything
+struct CubeSlice {
+    string subject;                     // substring of the subject name
+    bool (*subjectFilter)(const string&) = nullptr;    // if set, used instead of 'subject'
+    int label = -1;                     // 0 = FAKE, 1 = TRUE
+    int fromYear = 0, toYear = 0;       // inclusive
+    int fromMonth = 0, toMonth = 0;     // inclusive, 1..12
+};
+
+int cubeCell(const AggregateCube& cube, int yearSlot, int month, int subject, int label) {
+    return ((yearSlot * CUBE_MONTHS + month) * cube.subjectCapacity + subject) * 2 + label;
+}
+
+/**
+ * Widen the year dimension to include 'year', moving every year slot (and
+ * the "no year" slot, which stays last) to its place in the larger array
+ */
+void growCubeYears(AggregateCube& cube, int year) {
+    int minYear = (cube.yearCount == 0 || year < cube.minYear) ? year : cube.minYear;
+    int maxYear = (cube.yearCount == 0 || year > cube.minYear + cube.yearCount - 1) ? year : cube.minYear + cube.yearCount - 1;
+    int yearCount = maxYear - minYear + 1;
+    int slotSize = CUBE_MONTHS * cube.subjectCapacity * 2;
+    int* cells = new int[(yearCount + 1) * slotSize]();
+    int shift = (cube.yearCount == 0) ? 0 : cube.minYear - minYear;
+    for (int slot = 0; slot <= cube.yearCount; slot++) {
+        int target = (slot == cube.yearCount) ? yearCount : slot + shift;
+        for (int i = 0; i < slotSize; i++) cells[target * slotSize + i] = cube.cells[slot * slotSize + i];
+    }
+    delete[] cube.cells;
+    cube.cells = cells;
+    cube.minYear = minYear;
+    cube.yearCount = yearCount;
+}
+
+/**
+ * Widen the subject stride after the name table grew from oldCapacity,
+ * moving every (year, month) row of subject cells to its larger row
+ */
+void growCubeSubjects(AggregateCube& cube, int oldCapacity) {
+    int rows = (cube.yearCount + 1) * CUBE_MONTHS;
+    int* cells = new int[rows * cube.subjectCapacity * 2]();
+    for (int r = 0; r < rows; r++)
+        for (int i = 0; i < oldCapacity * 2; i++) cells[r * cube.subjectCapacity * 2 + i] = cube.cells[r * oldCapacity * 2 + i];
+    delete[] cube.cells;
+    cube.cells = cells;
+}
+
+/**
+ * Add the articles from 'first' to the end of the list to their cells.
+ * Used for the initial build and for the articles a refresh loads.
+ * @param cube The cube to update
+ * @param first The first article to add
+ */
+void addToAggregateCube(AggregateCube& cube, News* first) {
+    for (News* cur = first; cur; cur = cur -> next) {
+        int oldCapacity = cube.subjectCapacity;
+        int s = internSubject(cube.subjectNames, cube.subjectCount, cube.subjectCapacity, cur -> subject);
+        if (cube.subjectCapacity != oldCapacity) growCubeSubjects(cube, oldCapacity);
+
+        int packed = packDate(cur -> date);
+        if (packed != 0 && (cube.yearCount == 0 || packed / 10000 < cube.minYear || packed / 10000 >= cube.minYear + cube.yearCount))
+            growCubeYears(cube, packed / 10000);
+        int yearSlot = (packed != 0) ? packed / 10000 - cube.minYear : cube.yearCount;
+        int month = (packed != 0) ? packed / 100 % 100 : 0;
+        cube.cells[cubeCell(cube, yearSlot, month, s, cur -> identify == "FAKE" ? 0 : 1)]++;
+        cube.total++;
+    }
+}
+
+/**
+ * Add every article to its cell in one pass over the list (after a pass
+ * over the dates and subjects to size the year and subject dimensions)
+ * @param head The head of the linked list
+ * @param cube The cube to fill
+ */
+void buildAggregateCube(News* head, AggregateCube& cube) {
+    int maxYear = 0;
+    cube.minYear = 0;
+    for (News* cur = head; cur; cur = cur -> next) {
+        internSubject(cube.subjectNames, cube.subjectCount, cube.subjectCapacity, cur -> subject);
+        int packed = packDate(cur -> date);
+        if (packed == 0) continue;
+        int year = packed / 10000;
+        if (cube.minYear == 0 || year < cube.minYear) cube.minYear = year;
+        if (year > maxYear) maxYear = year;
+    }
+    cube.yearCount = (cube.minYear > 0) ? maxYear - cube.minYear + 1 : 0;
+    cube.cells = new int[(cube.yearCount + 1) * CUBE_MONTHS * cube.subjectCapacity * 2]();
+    addToAggregateCube(cube, head);
+}
+
+void freeAggregateCube(AggregateCube& cube) {
+    delete[] cube.cells;
+    delete[] cube.subjectNames;
+    cube = AggregateCube();
+}
+
+/**
+ * Number of entries cubeBreakdown writes for a dimension
+ */
+int cubeDimensionSize(const AggregateCube& cube, int dimension) {
+    switch (dimension) {
+        case CUBE_BY_YEAR: return cube.yearCount + 1;
+        case CUBE_BY_MONTH: return CUBE_MONTHS;
+        case CUBE_BY_SUBJECT: return cube.subjectCount;
+        default: return 2;
+    }
+}
+
+/**
+ * Totals of a slice along one dimension
+ * @param cube The aggregate cube
+ * @param slice Cells to add up
+ * @param dimension CUBE_BY_YEAR ([year - minYear], last entry = no date),
+ *        CUBE_BY_MONTH ([month]), CUBE_BY_SUBJECT ([subject id]) or
+ *        CUBE_BY_LABEL ([0] FAKE, [1] TRUE)
+ * @param totals Receives cubeDimensionSize entries
+ */
+void cubeBreakdown(const AggregateCube& cube, const CubeSlice& slice, int dimension, int* totals) {
+    for (int i = 0; i < cubeDimensionSize(cube, dimension); i++) totals[i] = 0;
+
+    // Year slots in the slice; a year filter never matches the no-date slot
+    int firstSlot = 0, lastSlot = cube.yearCount;
+    if (slice.fromYear != 0 || slice.toYear != 0) {
+        int fromYear = slice.fromYear != 0 ? slice.fromYear : cube.minYear;
+        int toYear = slice.toYear != 0 ? slice.toYear : cube.minYear + cube.yearCount - 1;
+        firstSlot = max(fromYear - cube.minYear, 0);
+        lastSlot = min(toYear - cube.minYear, cube.yearCount - 1);
+    }
+    int firstMonth = 0, lastMonth = CUBE_MONTHS - 1;
+    if (slice.fromMonth != 0 || slice.toMonth != 0) {
+        firstMonth = max(slice.fromMonth, 1);
+        lastMonth = min(slice.toMonth != 0 ? slice.toMonth : 12, 12);
+    }
+    bool* subjectMatches = new bool[cube.subjectCount > 0 ? cube.subjectCount : 1];
+    for (int s = 0; s < cube.subjectCount; s++)
+        subjectMatches[s] = slice.subjectFilter ? slice.subjectFilter(cube.subjectNames[s])
+                          : slice.subject.empty() || cube.subjectNames[s].find(slice.subject) != string::npos;
+    int firstLabel = (slice.label == 1) ? 1 : 0;
+    int lastLabel = (slice.label == 0) ? 0 : 1;
+
+    for (int y = firstSlot; y <= lastSlot; y++) {
+        for (int m = firstMonth; m <= lastMonth; m++) {
+            for (int s = 0; s < cube.subjectCount; s++) {
+                if (!subjectMatches[s]) continue;
+                for (int l = firstLabel; l <= lastLabel; l++) {
+                    int cell = cube.cells[cubeCell(cube, y, m, s, l)];
+                    switch (dimension) {
+                        case CUBE_BY_YEAR: totals[y] += cell; break;
+                        case CUBE_BY_MONTH: totals[m] += cell; break;
+                        case CUBE_BY_SUBJECT: totals[s] += cell; break;
+                        default: totals[l] += cell; break;
+                    }
+                }
+            }
+        }
+    }    delete[] subjectMatches;
+}
+
+/**
+ * Number of articles in a slice
+ */
+int cubeCount(const AggregateCube& cube, const CubeSlice& slice) {
+    int labels[2];
+    cubeBreakdown(cube, slice, CUBE_BY_LABEL, labels);
+    return labels[0] + labels[1];
+}
+
+/**
+ * Count news articles from the aggregate cube without walking the list
+ * @param cube The aggregate cube
+ */
+void countNewsCube(const AggregateCube& cube) {
+    int labels[2];
+    cubeBreakdown(cube, CubeSlice(), CUBE_BY_LABEL, labels);
+    cout << "Total news articles: " << cube.total << " (FAKE: " << labels[0] << ", TRUE: " << labels[1] << ")" << endl;
+}
+
+/**
+ * Display percentage for fake political news by every month in 2016 from
+ * the aggregate cube (politics in 2016 broken down by month, then FAKE only)
+ * @param cube The aggregate cube
+ */
+void countPoliticNewsCube(const AggregateCube& cube) {
+    unordered_map<int, int> fakeNewsCount, totalNewsCount;
+    CubeSlice politics2016;
+    politics2016.subjectFilter = isPoliticalSubject;
+    politics2016.fromYear = politics2016.toYear = 2016;
+    int total[CUBE_MONTHS], fake[CUBE_MONTHS];
+    cubeBreakdown(cube, politics2016, CUBE_BY_MONTH, total);
+    politics2016.label = 0;
+    cubeBreakdown(cube, politics2016, CUBE_BY_MONTH, fake);
+
+    double totalPoliticalNews = 0;
+    double fakePoliticalNews2016 = 0;
+    for (int month = 1; month <= 12; month++) {
+        if (total[month] > 0) totalNewsCount[month] = total[month];
+        if (fake[month] > 0) fakeNewsCount[month] = fake[month];
+        totalPoliticalNews += total[month];
+        fakePoliticalNews2016 += fake[month];
+    }
+
+    // Display the news plot
+    cout << "\nPercentage of fake Political News Article by every month in 2016" << endl;
+    displayNewsPlot(fakeNewsCount, totalNewsCount);
+
+    cout << "\nTotal number of political news articles: " << totalPoliticalNews << endl;
+    cout << "Total number of political news articles in 2016: " << fakePoliticalNews2016 << endl;
+    if (totalPoliticalNews > 0) {
+        double percentage = (fakePoliticalNews2016 / totalPoliticalNews) * 100;
+        cout << "Percentage of fake news articles in 2016: " << percentage << "%" << endl;
+    } else {
+        cout << "No political news articles found" << endl;
+    }
+}
+
+/**
+ * Filter expressions: ad-hoc article queries such as
+ *     year=2016 AND subject~politics AND label=FAKE AND date>=2016-03-01
+ * A term is <field> <op> <value>. Fields: year, month, date, subject, label,
+ * title, text. Ops: = != < <= > >= and ~ / !~ (contains / does not contain,
+ * ignoring case). Terms combine with AND, OR, NOT and parentheses; values with
+ * spaces go in double quotes and dates are YYYY-MM-DD or dd-mm-yyyy.
+ *
+ * The expression is parsed once into a predicate tree and compiled into a flat
+ * plan over the query columns below. The plan runs QUERY_BATCH rows at a time:
+ * each step reads a selection vector (the row ids still in play) and writes a
+ * new one, so a term is one tight loop over one column instead of a tree walk
+ * per node.
+ */
+const int QUERY_BATCH = 1024;
+
+const int QUERY_TERM = 0;
+const int QUERY_AND = 1;
+const int QUERY_OR = 2;
+const int QUERY_NOT = 3;
+
+const int FIELD_YEAR = 0;
+const int FIELD_MONTH = 1;
+const int FIELD_DATE = 2;
+const int FIELD_SUBJECT = 3;
+const int FIELD_LABEL = 4;
+const int FIELD_TITLE = 5;
+const int FIELD_TEXT = 6;
+
+const int OP_EQ = 0;
+const int OP_NE = 1;
+const int OP_LT = 2;
+const int OP_LE = 3;
+const int OP_GT = 4;
+const int OP_GE = 5;
+const int OP_CONTAINS = 6;
+const int OP_NOT_CONTAINS = 7;
+
+const char* const QUERY_FIELD_NAMES[] = {"year", "month", "date", "subject", "label", "title", "text"};
+const char* const QUERY_OP_NAMES[] = {"=", "!=", "<", "<=", ">", ">=", "~", "!~"};
+
+struct QueryNode {
+    int type = QUERY_TERM;
+    int field = 0;                  // terms only
+    int op = 0;
+    string value;                   // lowercased for subject / title / text
+    int number = 0;                 // year, month, packed date, or 1 = FAKE
+    QueryNode* left = nullptr;      // AND / OR / NOT
+    QueryNode* right = nullptr;     // AND / OR
+};
+
+/**
+ * Query columns: the fields a filter expression tests, copied out of the list
+ * into arrays indexed by load position. Titles and texts stay in the nodes.
+ * The sorts relink nodes without moving their contents, so the columns stay
+ * valid after option 1.
+ */
+struct QueryColumns {
+    int rowCount = 0;
+    int rowCapacity = 0;
+    short* year = nullptr;                  // 0 = unknown
+    int* date = nullptr;                    // packed YYYYMMDD, 0 = invalid
+    unsigned long long* fakeBits = nullptr; // bit i set = row i is FAKE
+    int* subjectId = nullptr;
+    int subjectCount = 0;
+    int subjectCapacity = 0;
+    string* subjectNames = nullptr;
+    News** nodes = nullptr;
+};
+
+/**
+ * Append the articles from 'first' to the end of the list to the query
+ * columns, doubling their capacity when they are full. Used for the initial
+ * build and for the articles a refresh loads.
+ * @param columns The columns to update
+ * @param first The first article to add
+ */
+void addToQueryColumns(QueryColumns& columns, News* first) {
+    int count = columns.rowCount;
+    for (News* cur = first; cur; cur = cur -> next) count++;
+    if (count > columns.rowCapacity || !columns.nodes) {
+        int capacity = max(max(count, columns.rowCapacity * 2), 1);
+        short* year = new short[capacity];
+        int* date = new int[capacity];
+        unsigned long long* fakeBits = new unsigned long long[(capacity + 63) / 64 + 1]();
+        int* subjectId = new int[capacity];
+        News** nodes = new News*[capacity];
+        for (int row = 0; row < columns.rowCount; row++) {
+            year[row] = columns.year[row];
+            date[row] = columns.date[row];
+            subjectId[row] = columns.subjectId[row];
+            nodes[row] = columns.nodes[row];
+        }
+        for (int w = 0; w < (columns.rowCount + 63) / 64; w++) fakeBits[w] = columns.fakeBits[w];
+        delete[] columns.year;
+        delete[] columns.date;
+        delete[] columns.fakeBits;
+        delete[] columns.subjectId;
+        delete[] columns.nodes;
+        columns.year = year;
+        columns.date = date;
+        columns.fakeBits = fakeBits;
+        columns.subjectId = subjectId;
+        columns.nodes = nodes;
+        columns.rowCapacity = capacity;
+    }
+    int row = columns.rowCount;
+    for (News* cur = first; cur; cur = cur -> next, row++) {
+        columns.date[row] = packDate(cur -> date);
+        columns.year[row] = static_cast<short>(columns.date[row] / 10000);
+        if (cur -> identify == "FAKE") columns.fakeBits[row >> 6] |= 1ULL << (row & 63);
+        columns.subjectId[row] = internSubject(columns.subjectNames, columns.subjectCount, columns.subjectCapacity, cur -> subject);
+        columns.nodes[row] = cur;
+    }
+    columns.rowCount = row;
+}
+
+/**
+ * Build the query columns in one pass over the list
+ * @param head The head of the linked list
+ * @param columns The columns to fill
+ */
+void buildQueryColumns(News* head, QueryColumns& columns) {
+    addToQueryColumns(columns, head);
+}
+
+void freeQueryColumns(QueryColumns& columns) {
+    delete[] columns.year;
+    delete[] columns.date;
+    delete[] columns.fakeBits;
+    delete[] columns.subjectId;
+    delete[] columns.subjectNames;
+    delete[] columns.nodes;
+    columns = QueryColumns();
+}
+
+void freeQueryNode(QueryNode* node) {
+    if (!node) return;
+    freeQueryNode(node -> left);
+    freeQueryNode(node -> right);
+    delete node;
+}
+
+/**
+ * Case-insensitive substring test
+ * @param text The text to search
+ * @param length Length of the text
+ * @param needle The lowercase string to look for
+ * @return true if the text contains the needle
+ */
+bool containsIgnoreCase(const char* text, size_t length, const string& needle) {
+    size_t m = needle.size();
+    if (m == 0) return true;
+    for (size_t i = 0; i + m <= length; i++) {
+        size_t k = 0;
+        while (k < m && tolower(static_cast<unsigned char>(text[i + k])) == needle[k]) k++;
+        if (k == m) return true;
+    }
+    return false;
+}
+
+string toLowerCopy(string s) {
+    for (char& c : s) c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+    return s;
+}
+
+/**
+ * Number of days in a month of the Gregorian calendar
+ */
+int daysInMonth(int year, int month) {
+    static const int days[12] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+    bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    return (month == 2 && leap) ? 29 : days[month - 1];
+}
+
+/**
+ * Convert a query date ("YYYY-MM-DD" or "dd-mm-yyyy") into YYYYMMDD
+ * @param value The date as written in the query
+ * @return the packed date, 0 if the date is not well formed, or -1 if the
+ *         day does not exist in that month (2016-02-30, 2015-02-29)
+ */
+int parseQueryDate(const string& value) {
+    int packed;
+    if (value.size() == 10 && value[4] == '-' && value[7] == '-')
+        packed = packDate(value.substr(8, 2) + "-" + value.substr(5, 2) + "-" + value.substr(0, 4));
+    else
+        packed = packDate(value);
+    if (packed != 0 && packed % 100 > daysInMonth(packed / 10000, packed / 100 % 100)) return -1;
+    return packed;
+}
+
+/**
+ * Recursive-descent parser state. Precedence: NOT, then AND, then OR. Every
+ * parse function returns nullptr (with 'error' set) on failure and frees
+ * whatever it had built.
+ */
+struct QueryParser {
+    string text;
+    size_t pos = 0;
+    string error;
+};
+
+void skipQuerySpace(QueryParser& p) {
+    while (p.pos < p.text.size() && isspace(static_cast<unsigned char>(p.text[p.pos]))) p.pos++;
+}
+
+/**
+ * Consume a keyword (any case) if it is the next whole word
+ * @param p The parser
+ * @param keyword The uppercase keyword
+ * @return true if the keyword was consumed
+ */
+bool acceptQueryKeyword(QueryParser& p, const char* keyword) {
+    skipQuerySpace(p);
+    size_t n = strlen(keyword);
+    if (p.pos + n > p.text.size()) return false;
+    for (size_t i = 0; i < n; i++) {
+        if (toupper(static_cast<unsigned char>(p.text[p.pos + i])) != keyword[i]) return false;
+    }
+    if (p.pos + n < p.text.size()) {
+        char next = p.text[p.pos + n];
+        if (!isspace(static_cast<unsigned char>(next)) && next != '(' && next != ')') return false;
+    }
+    p.pos += n;
+    return true;
+}
+
+QueryNode* parseQueryOr(QueryParser& p);
+
+/**
+ * Parse one <field> <op> <value> term and check the value against the field
+ * @param p The parser
+ * @return the term node, or nullptr on error
+ */
+QueryNode* parseQueryTerm(QueryParser& p) {
+    skipQuerySpace(p);
+    size_t start = p.pos;
+    while (p.pos < p.text.size() && isalpha(static_cast<unsigned char>(p.text[p.pos]))) p.pos++;
+    string name = toLowerCopy(p.text.substr(start, p.pos - start));
+    int field = -1;
+    for (int f = FIELD_YEAR; f <= FIELD_TEXT; f++) {
+        if (name == QUERY_FIELD_NAMES[f]) field = f;
+    }
+    if (field < 0) {
+        p.error = name.empty() ? "expected a field at position " + to_string(start + 1) : "unknown field '" + name + "'";
+        return nullptr;
+    }
+
+    // Longest operator that matches ("<=" before "<")
+    skipQuerySpace(p);
+    int op = -1;
+    for (int o = OP_EQ; o <= OP_NOT_CONTAINS; o++) {
+        size_t n = strlen(QUERY_OP_NAMES[o]);
+        if (p.text.compare(p.pos, n, QUERY_OP_NAMES[o]) == 0 && (op < 0 || n > strlen(QUERY_OP_NAMES[op]))) op = o;
+    }
+    if (op < 0) { p.error = "expected an operator after '" + name + "'"; return nullptr; }
+    p.pos += strlen(QUERY_OP_NAMES[op]);
+
+    skipQuerySpace(p);
+    string value;
+    if (p.pos < p.text.size() && p.text[p.pos] == '"') {
+        size_t close = p.text.find('"', p.pos + 1);
+        if (close == string::npos) { p.error = "unterminated quote"; return nullptr; }
+        value = p.text.substr(p.pos + 1, close - p.pos - 1);
+        p.pos = close + 1;
+    } else {
+        while (p.pos < p.text.size() && !isspace(static_cast<unsigned char>(p.text[p.pos]))
+            && p.text[p.pos] != '(' && p.text[p.pos] != ')') {
+            value.push_back(p.text[p.pos++]);
+        }
+    }
+    if (value.empty()) { p.error = "missing value for '" + name + "'"; return nullptr; }
+
+    QueryNode* node = new QueryNode;
+    node -> field = field;
+    node -> op = op;
+    node -> value = value;
+    bool numeric = (field == FIELD_YEAR || field == FIELD_MONTH || field == FIELD_DATE);
+    bool textOp = (op == OP_CONTAINS || op == OP_NOT_CONTAINS);
+    if (numeric) {
+        if (textOp) {
+            p.error = "'" + name + "' takes = != < <= > >=";
+        } else if (field == FIELD_DATE) {
+            node -> number = parseQueryDate(value);
+            if (node -> number == 0) p.error = "bad date '" + value + "' (use YYYY-MM-DD)";
+            else if (node -> number == -1) p.error = "bad date '" + value + "' (no such day in that month)";
+        } else {
+            bool digits = value.size() <= 6;
+            for (char c : value) digits = digits && isdigit(static_cast<unsigned char>(c));
+            node -> number = digits ? stoi(value) : 0;
+            if (!digits || (field == FIELD_MONTH && (node -> number < 1 || node -> number > 12)))
+                p.error = "bad " + name + " '" + value + "'";
+        }
+    } else if (field == FIELD_LABEL) {
+        string label = toLowerCopy(value);
+        if ((op != OP_EQ && op != OP_NE) || (label != "fake" && label != "true"))
+            p.error = "use label=FAKE, label=TRUE or label!=...";
+        node -> number = (label == "fake") ? 1 : 0;
+    } else {
+        if (op != OP_EQ && op != OP_NE && !textOp) p.error = "'" + name + "' takes = != ~ !~";
+        if (field != FIELD_SUBJECT && !textOp) p.error = "'" + name + "' takes ~ or !~";
+        node -> value = toLowerCopy(value);
+    }
+    if (!p.error.empty()) { freeQueryNode(node); return nullptr; }
+    return node;
+}
+
+QueryNode* parseQueryUnary(QueryParser& p) {
+    if (acceptQueryKeyword(p, "NOT")) {
+        QueryNode* child = parseQueryUnary(p);
+        if (!child) return nullptr;
+        QueryNode* node = new QueryNode;
+        node -> type = QUERY_NOT;
+        node -> left = child;
+        return node;
+    }
+    skipQuerySpace(p);
+    if (p.pos < p.text.size() && p.text[p.pos] == '(') {
+        p.pos++;
+        QueryNode* inner = parseQueryOr(p);
+        if (!inner) return nullptr;
+        skipQuerySpace(p);
+        if (p.pos >= p.text.size() || p.text[p.pos] != ')') {
+            p.error = "missing ')'";
+            freeQueryNode(inner);
+            return nullptr;
+        }
+        p.pos++;
+        return inner;
+    }
+    return parseQueryTerm(p);
+}
+
+/**
+ * One binary level of the grammar: operand (KEYWORD operand)*
+ * @param p The parser
+ * @param keyword "AND" or "OR"
+ * @param type Node type to build for the keyword
+ * @param operand Parser for the next tighter level
+ * @return the left-deep tree, or nullptr on error
+ */
+QueryNode* parseQueryChain(QueryParser& p, const char* keyword, int type, QueryNode* (*operand)(QueryParser&)) {
+    QueryNode* left = operand(p);
+    while (left && acceptQueryKeyword(p, keyword)) {
+        QueryNode* right = operand(p);
+        if (!right) { freeQueryNode(left); return nullptr; }
+        QueryNode* node = new QueryNode;
+        node -> type = type;
+        node -> left = left;
+        node -> right = right;
+        left = node;
+    }
+    return left;
+}
+
+QueryNode* parseQueryAnd(QueryParser& p) { return parseQueryChain(p, "AND", QUERY_AND, parseQueryUnary); }
+
+QueryNode* parseQueryOr(QueryParser& p) { return parseQueryChain(p, "OR", QUERY_OR, parseQueryAnd); }
+
+/**
+ * Parse a whole filter expression
+ * @param text The expression
+ * @param error Set to a description of the problem if the expression is invalid
+ * @return the predicate tree (caller must freeQueryNode), or nullptr
+ */
+QueryNode* parseQuery(const string& text, string& error) {
+    QueryParser p;
+    p.text = text;
+    QueryNode* root = parseQueryOr(p);
+    skipQuerySpace(p);
+    if (root && p.pos < p.text.size()) {
+        p.error = "unexpected '" + p.text.substr(p.pos) + "'";
+        freeQueryNode(root);
+        root = nullptr;
+    }
+    error = p.error;
+    return root;
+}
+
+/**
+ * Compare a year / month / date against a term. Rows without a valid date
+ * fail every comparison except !=.
+ */
+bool compareQueryNumber(int x, int op, int value) {
+    if (x == 0) return op == OP_NE;
+    switch (op) {
+        case OP_EQ: return x == value;
+        case OP_NE: return x != value;
+        case OP_LT: return x < value;
+        case OP_LE: return x <= value;
+        case OP_GT: return x > value;
+        default:    return x >= value;
+    }
+}
+
+/**
+ * Row-at-a-time evaluation of the predicate tree on one node (the baseline
+ * the compiled plan is timed against)
+ * @param node The predicate tree
+ * @param news The article to test
+ * @return true if the article matches
+ */
+bool queryMatches(const QueryNode* node, const News* news) {
+    switch (node -> type) {
+        case QUERY_AND: return queryMatches(node -> left, news) && queryMatches(node -> right, news);
+        case QUERY_OR:  return queryMatches(node -> left, news) || queryMatches(node -> right, news);
+        case QUERY_NOT: return !queryMatches(node -> left, news);
+    }
+    bool negate = (node -> op == OP_NE || node -> op == OP_NOT_CONTAINS);
+    switch (node -> field) {
+        case FIELD_YEAR:  return compareQueryNumber(packDate(news -> date) / 10000, node -> op, node -> number);
+        case FIELD_MONTH: return compareQueryNumber(packDate(news -> date) / 100 % 100, node -> op, node -> number);
+        case FIELD_DATE:  return compareQueryNumber(packDate(news -> date), node -> op, node -> number);
+        case FIELD_LABEL: return ((news -> identify == "FAKE") == (node -> number == 1)) != negate;
+        case FIELD_SUBJECT:
+            if (node -> op == OP_EQ || node -> op == OP_NE) return (toLowerCopy(news -> subject) == node -> value) != negate;
+            return containsIgnoreCase(news -> subject.data(), news -> subject.size(), node -> value) != negate;
+        case FIELD_TITLE: return containsIgnoreCase(news -> title.data(), news -> title.size(), node -> value) != negate;
+        default:          return containsIgnoreCase(news -> text.data(), news -> text.size(), node -> value) != negate;
+    }
+}
+
+/**
+ * Walk the list and collect every node that matches the predicate tree
+ * @param head The head of the linked list
+ * @param root The predicate tree
+ * @param matchCount Set to the number of matches
+ * @return the matching nodes in list order (caller must delete[])
+ */
+News** queryListRowByRow(News* head, const QueryNode* root, int& matchCount) {
+    int count = 0;
+    for (News* cur = head; cur; cur = cur -> next) count++;
+    News** results = new News*[count > 0 ? count : 1];
+    matchCount = 0;
+    for (News* cur = head; cur; cur = cur -> next) {
+        if (queryMatches(root, cur)) results[matchCount++] = cur;
+    }
+    return results;
+}
+
+/**
+ * Query plan. Register 0 holds the rows of the current batch and every step
+ * writes its own register:
+ *   FILTER  out = rows of 'input' that pass one term (one column)
+ *   EXCEPT  out = input minus other (other is a subset of input)
+ *   UNION   out = input merged with other (disjoint, both sorted)
+ * AND feeds the left result into the right term, OR runs the right side only
+ * on the rows the left side rejected, and NOT subtracts its child from its
+ * input. Column terms of an AND run before title / text scans.
+ */
+const int STEP_FILTER = 0;
+const int STEP_EXCEPT = 1;
+const int STEP_UNION = 2;
+
+struct QueryStep {
+    int kind = STEP_FILTER;
+    int input = 0;
+    int other = 0;
+    int output = 0;
+    int field = 0;
+    int lo = 0, hi = 0;         // year / month / date range, FAKE bit in lo
+    bool negate = false;
+    bool* subjectMask = nullptr;    // [subject id], subject filters only
+    string needle;              // title / text, lowercase
+};
+
+struct QueryPlan {
+    QueryStep* steps = nullptr;
+    int stepCount = 0;
+    int registerCount = 1;
+    int result = 0;             // register holding the matches
+};
+
+int countQuerySteps(const QueryNode* node) {
+    switch (node -> type) {
+        case QUERY_AND: return countQuerySteps(node -> left) + countQuerySteps(node -> right);
+        case QUERY_OR:  return countQuerySteps(node -> left) + countQuerySteps(node -> right) + 2;
+        case QUERY_NOT: return countQuerySteps(node -> left) + 1;
+        default:        return 1;
+    }
+}
+
+/**
+ * Number of title / text scans under a node, used to order AND operands
+ */
+int queryCost(const QueryNode* node) {
+    if (node -> type == QUERY_TERM) return (node -> field == FIELD_TITLE || node -> field == FIELD_TEXT) ? 1 : 0;
+    return queryCost(node -> left) + (node -> right ? queryCost(node -> right) : 0);
+}
+
+int addQueryStep(QueryPlan& plan, int kind, int input, int other) {
+    QueryStep& step = plan.steps[plan.stepCount++];
+    step.kind = kind;
+    step.input = input;
+    step.other = other;
+    step.output = plan.registerCount++;
+    return step.output;
+}
+
+/**
+ * Emit the steps for one node of the predicate tree
+ * @param node The node to compile
+ * @param input Register holding the rows the node is applied to
+ * @param columns The query columns (subject dictionary)
+ * @param plan The plan being built
+ * @return the register holding the rows that match the node
+ */
+int compileQueryNode(const QueryNode* node, int input, const QueryColumns& columns, QueryPlan& plan) {
+    if (node -> type == QUERY_AND) {
+        const QueryNode* first = node -> left;
+        const QueryNode* second = node -> right;
+        if (queryCost(first) > queryCost(second)) swap(first, second);
+        return compileQueryNode(second, compileQueryNode(first, input, columns, plan), columns, plan);
+    }
+    if (node -> type == QUERY_OR) {
+        int left = compileQueryNode(node -> left, input, columns, plan);
+        int rest = addQueryStep(plan, STEP_EXCEPT, input, left);
+        int right = compileQueryNode(node -> right, rest, columns, plan);
+        return addQueryStep(plan, STEP_UNION, left, right);
+    }
+    if (node -> type == QUERY_NOT) {
+        int child = compileQueryNode(node -> left, input, columns, plan);
+        return addQueryStep(plan, STEP_EXCEPT, input, child);
+    }
+
+    int output = addQueryStep(plan, STEP_FILTER, input, 0);
+    QueryStep& step = plan.steps[plan.stepCount - 1];
+    step.field = node -> field;
+    step.negate = (node -> op == OP_NE || node -> op == OP_NOT_CONTAINS);
+    if (node -> field == FIELD_YEAR || node -> field == FIELD_MONTH || node -> field == FIELD_DATE) {
+        // Every comparison becomes an inclusive range; 0 (unknown) is never inside it
+        int value = node -> number;
+        step.lo = 1;
+        step.hi = INT_MAX;
+        switch (node -> op) {
+            case OP_EQ: case OP_NE: step.lo = step.hi = value; break;
+            case OP_LT: step.hi = value - 1; break;
+            case OP_LE: step.hi = value; break;
+            case OP_GT: step.lo = value + 1; break;
+            case OP_GE: step.lo = value; break;
+        }
+    } else if (node -> field == FIELD_LABEL) {
+        step.lo = node -> number;
+    } else if (node -> field == FIELD_SUBJECT) {
+        // Resolve the subject test against the dictionary once
+        bool exact = (node -> op == OP_EQ || node -> op == OP_NE);
+        step.subjectMask = new bool[columns.subjectCount > 0 ? columns.subjectCount : 1];
+        for (int s = 0; s < columns.subjectCount; s++) {
+            const string& name = columns.subjectNames[s];
+            bool match = exact ? toLowerCopy(name) == node -> value : containsIgnoreCase(name.data(), name.size(), node -> value);
+            step.subjectMask[s] = match != step.negate;
+        }
+        step.negate = false;
+    } else {
+        step.needle = node -> value;
+    }
+    return output;
+}
+
+/**
+ * Compile a predicate tree into a plan over the query columns
+ * @param root The predicate tree
+ * @param columns The query columns
+ * @return the plan (caller must freeQueryPlan)
+ */
+QueryPlan compileQuery(const QueryNode* root, const QueryColumns& columns) {
+    QueryPlan plan;
+    plan.steps = new QueryStep[countQuerySteps(root)];
+    plan.result = compileQueryNode(root, 0, columns, plan);
+    return plan;
+}
+
+void freeQueryPlan(QueryPlan& plan) {
+    for (int i = 0; i < plan.stepCount; i++)
+        delete[] plan.steps[i].subjectMask;
+    delete[] plan.steps;
+    plan = QueryPlan();
+}
+
+void printQueryPlan(const QueryPlan& plan) {
+    cout << "Query plan (" << plan.stepCount << " steps):" << endl;
+    for (int i = 0; i < plan.stepCount; i++) {
+        const QueryStep& step = plan.steps[i];
+        cout << "  r" << step.output << " = r" << step.input;
+        if (step.kind == STEP_EXCEPT) { cout << " EXCEPT r" << step.other << endl; continue; }
+        if (step.kind == STEP_UNION) { cout << " UNION r" << step.other << endl; continue; }
+        cout << " WHERE " << (step.negate ? "NOT " : "") << QUERY_FIELD_NAMES[step.field];
+        if (step.field == FIELD_SUBJECT) cout << " in subject mask";
+        else if (step.field == FIELD_LABEL) cout << " is " << (step.lo ? "FAKE" : "TRUE");
+        else if (step.field == FIELD_TITLE || step.field == FIELD_TEXT) cout << " contains \"" << step.needle << "\"";
+        else cout << " in [" << step.lo << ", " << step.hi << "]";
+        cout << endl;
+    }
+}
+
+/**
+ * Run one FILTER step over a selection vector. Every row id is written and
+ * only the ones that pass advance the output, so the column loops do not branch.
+ * @param step The filter step
+ * @param columns The query columns
+ * @param in Selection vector to filter
+ * @param n Number of rows in 'in'
+ * @param out Selection vector to write
+ * @return number of rows written to 'out'
+ */
+int runQueryFilter(const QueryStep& step, const QueryColumns& columns, const int* in, int n, int* out) {
+    int j = 0;
+    bool negate = step.negate;
+    if (step.field <= FIELD_DATE && step.lo > step.hi) {
+        if (negate) memcpy(out, in, n * sizeof(int));
+        return negate ? n : 0;
+    }
+    unsigned int lo = static_cast<unsigned int>(step.lo);
+    unsigned int width = static_cast<unsigned int>(step.hi) - lo;
+    switch (step.field) {
+        case FIELD_YEAR: {
+            const short* year = columns.year;
+            for (int i = 0; i < n; i++) {
+                int r = in[i];
+                out[j] = r;
+                j += ((static_cast<unsigned int>(year[r]) - lo <= width) != negate);
+            }
+            break;
+        }
+        case FIELD_MONTH: {
+            const int* date = columns.date;
+            for (int i = 0; i < n; i++) {
+                int r = in[i];
+                out[j] = r;
+                j += ((static_cast<unsigned int>(date[r] / 100 % 100) - lo <= width) != negate);
+            }
+            break;
+        }
+        case FIELD_DATE: {
+            const int* date = columns.date;
+            for (int i = 0; i < n; i++) {
+                int r = in[i];
+                out[j] = r;
+                j += ((static_cast<unsigned int>(date[r]) - lo <= width) != negate);
+            }
+            break;
+        }
+        case FIELD_SUBJECT: {
+            const int* subjectId = columns.subjectId;
+            const bool* mask = step.subjectMask;
+            for (int i = 0; i < n; i++) {
+                int r = in[i];
+                out[j] = r;
+                j += mask[subjectId[r]];
+            }
+            break;
+        }
+        case FIELD_LABEL: {
+            const unsigned long long* bits = columns.fakeBits;
+            for (int i = 0; i < n; i++) {
+                int r = in[i];
+                out[j] = r;
+                j += ((((bits[r >> 6] >> (r & 63)) & 1) == lo) != negate);
+            }
+            break;
+        }
+        default: {
+            bool title = (step.field == FIELD_TITLE);
+            for (int i = 0; i < n; i++) {
+                int r = in[i];
+                out[j] = r;
+                const string& s = title ? columns.nodes[r] -> title : columns.nodes[r] -> text;
+                j += (containsIgnoreCase(s.data(), s.size(), step.needle) != negate);
+            }
+            break;
+        }
+    }
+    return j;
+}
+
+/**
+ * Run a compiled plan over every row. Each batch's registers are reused by the next batch.
+ * @param plan The compiled plan
+ * @param columns The query columns
+ * @param matchCount Set to the number of matches
+ * @return the matching nodes in load order (caller must delete[])
+ */
+News** runQueryPlan(const QueryPlan& plan, const QueryColumns& columns, int& matchCount) {
+    int n = columns.rowCount;
+    News** results = new News*[n > 0 ? n : 1];
+    int* registers = new int[plan.registerCount * QUERY_BATCH];
+    int* sizes = new int[plan.registerCount];
+    matchCount = 0;
+    for (int start = 0; start < n; start += QUERY_BATCH) {
+        int end = (start + QUERY_BATCH < n) ? start + QUERY_BATCH : n;
+        for (int r = start; r < end; r++) registers[r - start] = r;
+        sizes[0] = end - start;
+
+        for (int s = 0; s < plan.stepCount; s++) {
+            const QueryStep& step = plan.steps[s];
+            const int* in = registers + step.input * QUERY_BATCH;
+            const int* other = registers + step.other * QUERY_BATCH;
+            int* out = registers + step.output * QUERY_BATCH;
+            int inSize = sizes[step.input], otherSize = sizes[step.other];
+            int j = 0;
+            if (step.kind == STEP_FILTER) {
+                j = runQueryFilter(step, columns, in, inSize, out);
+            } else if (step.kind == STEP_EXCEPT) {
+                int k = 0;
+                for (int i = 0; i < inSize; i++) {
+                    if (k < otherSize && other[k] == in[i]) k++;
+                    else out[j++] = in[i];
+                }
+            } else {
+                int a = 0, b = 0;
+                while (a < inSize && b < otherSize) out[j++] = (in[a] < other[b]) ? in[a++] : other[b++];
+                while (a < inSize) out[j++] = in[a++];
+                while (b < otherSize) out[j++] = other[b++];
+            }
+            sizes[step.output] = j;
+        }
+
+        const int* matches = registers + plan.result * QUERY_BATCH;
+        for (int i = 0; i < sizes[plan.result]; i++) results[matchCount++] = columns.nodes[matches[i]];
+    }
+    delete[] registers;
+    delete[] sizes;
+    return results;
+}
+
+/**
+ * Fake-share time series: fake / total article counts per period for every
+ * subject (plus one "all subjects" series) across the whole archive. One pass
+ * over the query columns fills the monthly and the weekly series together.
+ * Weeks start on Monday.
+ */
+struct TimeSeries {
+    bool weekly = false;
+    int firstPeriod = 0;        // year * 12 + month - 1, or Monday-based week number
+    int periodCount = 0;
+    int seriesCount = 0;        // subjectCount + 1; the last series is all subjects
+    int* total = nullptr;       // [series * periodCount + period]
+    int* fake = nullptr;
+};
+
+/**
+ * Days since 1970-01-01 for a packed date (proleptic Gregorian calendar)
+ * @param packed The date as YYYYMMDD
+ * @return the day number
+ */
+int daySerial(int packed) {
+    int y = packed / 10000, m = packed / 100 % 100, d = packed % 100;
+    y -= (m <= 2);
+    int era = (y >= 0 ? y : y - 399) / 400;
+    int yearOfEra = y - era * 400;
+    int dayOfYear = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    int dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + dayOfEra - 719468;
+}
+
+/**
+ * Inverse of daySerial
+ * @param serial Days since 1970-01-01
+ * @return the date as YYYYMMDD
+ */
+int dateFromSerial(int serial) {
+    serial += 719468;
+    int era = (serial >= 0 ? serial : serial - 146096) / 146097;
+    int dayOfEra = serial - era * 146097;
+    int yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    int dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    int mp = (5 * dayOfYear + 2) / 153;
+    int d = dayOfYear - (153 * mp + 2) / 5 + 1;
+    int m = mp + (mp < 10 ? 3 : -9);
+    int y = yearOfEra + era * 400 + (m <= 2);
+    return y * 10000 + m * 100 + d;
+}
+
+/**
+ * Monday-based week number. 1970-01-01 was a Thursday, so the day number is
+ * shifted by 3; floor division keeps earlier dates in the right week.
+ */
+int weekNumber(int packed) {
+    int shifted = daySerial(packed) + 3;
+    return (shifted >= 0) ? shifted / 7 : (shifted - 6) / 7;
+}
+
+int monthNumber(int packed) { return (packed / 10000) * 12 + packed / 100 % 100 - 1; }
+
+void initTimeSeries(TimeSeries& series, bool weekly, int first, int last, int seriesCount) {
+    series.weekly = weekly;
+    series.firstPeriod = first;
+    series.periodCount = last - first + 1;
+    series.seriesCount = seriesCount;
+    series.total = new int[seriesCount * series.periodCount]();
+    series.fake = new int[seriesCount * series.periodCount]();
+}
+
+void freeTimeSeries(TimeSeries& series) {
+    delete[] series.total;
+    delete[] series.fake;
+    series = TimeSeries();
+}
+
+/**
+ * Size both series from the first and last valid date, then add every dated
+ * article to its subject and to the "all subjects" series, monthly and weekly,
+ * in the same pass
+ * @param columns The query columns
+ * @param monthly The monthly series to fill
+ * @param weekly The weekly series to fill
+ */
+void buildTimeSeries(const QueryColumns& columns, TimeSeries& monthly, TimeSeries& weekly) {
+    int minDate = 0, maxDate = 0;
+    for (int i = 0; i < columns.rowCount; i++) {
+        int date = columns.date[i];
+        if (date == 0) continue;
+        if (minDate == 0 || date < minDate) minDate = date;
+        if (date > maxDate) maxDate = date;
+    }
+    if (minDate == 0) return;
+
+    int seriesCount = columns.subjectCount + 1;
+    int all = columns.subjectCount;
+    initTimeSeries(monthly, false, monthNumber(minDate), monthNumber(maxDate), seriesCount);
+    initTimeSeries(weekly, true, weekNumber(minDate), weekNumber(maxDate), seriesCount);
+    for (int i = 0; i < columns.rowCount; i++) {
+        int date = columns.date[i];
+        if (date == 0) continue;
+        int isFake = static_cast<int>((columns.fakeBits[i >> 6] >> (i & 63)) & 1);
+        int m = monthNumber(date) - monthly.firstPeriod;
+        int w = weekNumber(date) - weekly.firstPeriod;
+        int subjectMonth = columns.subjectId[i] * monthly.periodCount + m;
+        int subjectWeek = columns.subjectId[i] * weekly.periodCount + w;
+        int allMonth = all * monthly.periodCount + m;
+        int allWeek = all * weekly.periodCount + w;
+        monthly.total[subjectMonth]++;
+        monthly.fake[subjectMonth] += isFake;
+        monthly.total[allMonth]++;
+        monthly.fake[allMonth] += isFake;
+        weekly.total[subjectWeek]++;
+        weekly.fake[subjectWeek] += isFake;
+        weekly.total[allWeek]++;
+        weekly.fake[allWeek] += isFake;
+    }
+}
+
+/**
+ * Label of a period: "2016-03" for a month, the Monday's date for a week
+ */
+string periodLabel(const TimeSeries& series, int period) {
+    int n = series.firstPeriod + period;
+    char label[16];
+    if (series.weekly) {
+        int date = dateFromSerial(n * 7 - 3);
+        snprintf(label, sizeof(label), "%04d-%02d-%02d", date / 10000, date / 100 % 100, date % 100);
+    } else {
+        snprintf(label, sizeof(label), "%04d-%02d", n / 12, n % 12 + 1);
+    }
+    return label;
+}
+
+/**
+ * Fake share over the 'window' periods ending at each period (total fake /
+ * total articles in the window, so quiet periods weigh less). The window sums
+ * are updated with one add and one subtract per step.
+ * @param series The time series
+ * @param seriesIndex Subject id, or subjectCount for all subjects
+ * @param window Number of periods in the window
+ * @param out One share per period (-1 when the window is empty)
+ */
+void rollingFakeShare(const TimeSeries& series, int seriesIndex, int window, double* out) {
+    const int* total = series.total + seriesIndex * series.periodCount;
+    const int* fake = series.fake + seriesIndex * series.periodCount;
+    long long windowTotal = 0, windowFake = 0;
+    for (int p = 0; p < series.periodCount; p++) {
+        windowTotal += total[p];
+        windowFake += fake[p];
+        if (p >= window) {
+            windowTotal -= total[p - window];
+            windowFake -= fake[p - window];
+        }
+        out[p] = (windowTotal > 0) ? static_cast<double>(windowFake) / windowTotal : -1.0;
+    }
+}
+
+/**
+ * Display the plot of one series, one line per period: the bar is the
+ * period's fake share (one '*' per 2%), followed by the share and the rolling share
+ * @param series The time series
+ * @param columns The query columns (subject names)
+ * @param seriesIndex Subject id, or subjectCount for all subjects
+ * @param window Number of periods in the rolling window
+ */
+void displayTimeSeries(const TimeSeries& series, const QueryColumns& columns, int seriesIndex, int window) {
+    string name = (seriesIndex == columns.subjectCount) ? "All subjects" : columns.subjectNames[seriesIndex];
+    cout << "\nPercentage of fake news by " << (series.weekly ? "week" : "month") << ": " << name
+        << " (rolling " << window << ")" << endl;
+    ios_base::fmtflags flags = cout.flags();
+    streamsize precision = cout.precision();
+    double* rolling = new double[series.periodCount > 0 ? series.periodCount : 1];
+    rollingFakeShare(series, seriesIndex, window, rolling);
+    for (int p = 0; p < series.periodCount; p++) {
+        int total = series.total[seriesIndex * series.periodCount + p];
+        int fake = series.fake[seriesIndex * series.periodCount + p];
+        cout << left << setw(10) << periodLabel(series, p) << "\t | ";
+        if (total == 0) {
+            cout << "no articles";
+        } else {
+            double percentage = 100.0 * fake / total;
+            cout << setw(50) << string(static_cast<int>(percentage / 2), '*') << right
+                << " " << fixed << setprecision(1) << setw(5) << percentage << "%" << left;
+        }
+        if (rolling[p] >= 0) cout << "  rolling " << right << fixed << setprecision(1) << setw(5) << rolling[p] * 100.0 << "%" << left;
+        cout << endl;
+    }
+    // Leave the stream as it was for the memory stats printed after the plot
+    cout.flags(flags);
+    cout.precision(precision);
+    delete[] rolling;
+}
+
+/**
+ * Write every series (each subject, then all subjects) as CSV rows:
+ * period,subject,total,fake,fake_share,rolling_share. Shares are fractions;
+ * empty periods leave the share blank.
+ * @return false if the file could not be opened
+ */
+bool writeTimeSeriesCsv(const TimeSeries& series, const QueryColumns& columns, int window, const string& filename) {
+    ofstream out(filename);
+    if (!out) return false;
+    out << "period,subject,total,fake,fake_share,rolling_share" << endl;
+    double* rolling = new double[series.periodCount > 0 ? series.periodCount : 1];
+    for (int s = 0; s < series.seriesCount; s++) {
+        string name = (s == columns.subjectCount) ? "ALL" : columns.subjectNames[s];
+        rollingFakeShare(series, s, window, rolling);
+        for (int p = 0; p < series.periodCount; p++) {
+            int total = series.total[s * series.periodCount + p];
+            int fake = series.fake[s * series.periodCount + p];
+            out << periodLabel(series, p) << ",\"" << name << "\"," << total << "," << fake << ",";
+            if (total > 0) out << fixed << setprecision(4) << static_cast<double>(fake) / total;
+            out << ",";
+            if (rolling[p] >= 0) out << fixed << setprecision(4) << rolling[p];
+            out << "\n";
+        }
+    }
+    delete[] rolling;
+    return true;
+}
+
+/**
+ * Calculate memory usage for a single node
+ * @param node Pointer to News node
+ * @return Memory usage in bytes
+ */
+size_t calculateNodeMemory(News* node) {
+    if (!node) return 0;
+    
+    size_t memory = sizeof(News);  // Struct size
+    // String content sizes
+    memory += node -> title.capacity();
+    memory += node -> text.capacity();
+    memory += node -> subject.capacity();
+    memory += node -> date.capacity();
+    memory += node -> identify.capacity();
+    // Pointer sizes
+    memory += sizeof(News*) * 2;  // next and head pointers
+    
+    return memory;
+}
+
+/**
+ * Calculate detailed memory statistics for a linked list
+ * @param head Pointer to head of linked list
+ * @return MemoryStats struct with detailed memory information
+ */
+MemoryStats calculateDetailedMemory(News* head) {
+    MemoryStats stats;
+    News* current = head;
+    
+    while (current) {
+        stats.structSize += sizeof(News);
+        stats.stringSize += current -> title.capacity() +
+                            current -> text.capacity() +
+                            current -> subject.capacity() +
                             current -> date.capacity() +
                             current -> identify.capacity();
         stats.pointerSize += sizeof(News*) * 2;  // next and head pointers
@@ -574,19 +3134,362 @@ void displayMemoryStats(const MemoryStats& stats, const string& operationName, s
     cout << "----------------------------------------" << endl;
 }
 
+/**
+ * Script mode: run a list of operations against one loaded dataset without
+ * the menu and print the results and timings as JSON. Operations come from
+ * the command line (--run "top 10") or a script file (--script FILE, one per
+ * line, '#' starts a comment); --out FILE writes the JSON to a file instead
+ * of standard output.
+ *   sort quick|insertion          sort the list by date, starting from the load order
+ *   search YEAR                   articles published in YEAR
+ *   percentage [YEAR] [SUBJECT]   fake share of SUBJECT in YEAR by month (default 2016, politics + politicsNews)
+ *   top N                         N most frequent terms in fake government news, from the inverted index
+ */
+struct BatchJob {
+    string* ops = nullptr;
+    int opCount = 0;
+    int opCapacity = 0;
+    string outFile;     // empty = standard output
+};
+
+void addBatchOp(BatchJob& job, const string& op) {
+    if (job.opCount == job.opCapacity) {
+        int capacity = job.opCapacity ? job.opCapacity * 2 : 16;
+        string* larger = new string[capacity];
+        for (int i = 0; i < job.opCount; i++) larger[i] = job.ops[i];
+        delete[] job.ops;
+        job.ops = larger;
+        job.opCapacity = capacity;
+    }
+    job.ops[job.opCount++] = op;
+}
+
+/**
+ * Collect the operations from the command line and script files
+ * @param job Receives the operations and the output file
+ * @param error Set when the arguments are rejected
+ * @return false on a bad argument or an unreadable script
+ */
+bool parseBatchArgs(int argc, char const *argv[], BatchJob& job, string& error) {
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if ((arg == "--run" || arg == "--script" || arg == "--out") && i + 1 >= argc) {
+            error = arg + " needs a value";
+            return false;
+        }
+        if (arg == "--run") {
+            addBatchOp(job, argv[++i]);
+        } else if (arg == "--out") {
+            job.outFile = argv[++i];
+        } else if (arg == "--script") {
+            ifstream script(argv[++i]);
+            if (!script) { error = string("Cannot open script ") + argv[i]; return false; }
+            string line;
+            while (getline(script, line)) {
+                size_t hash = line.find('#');
+                if (hash != string::npos) line.erase(hash);
+                size_t first = line.find_first_not_of(" \t\r");
+                if (first == string::npos) continue;
+                addBatchOp(job, line.substr(first, line.find_last_not_of(" \t\r") - first + 1));
+            }
+        } else {
+            error = "Unknown argument: " + arg;
+            return false;
+        }
+    }
+    if (job.opCount == 0) { error = "No operations given"; return false; }
+    return true;
+}
+
+string jsonEscape(const string& text) {
+    string out;
+    for (unsigned char c : text) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += static_cast<char>(c);
+        } else if (c < 0x20) {
+            char code[8];
+            snprintf(code, sizeof(code), "\\u%04x", c);
+            out += code;
+        } else {
+            out += static_cast<char>(c);
+        }
+    }
+    return out;
+}
+
+/**
+ * Fake share as a JSON number with 4 decimals, or null when there are no articles
+ */
+string jsonShare(int fake, int total) {
+    if (total == 0) return "null";
+    char number[32];
+    snprintf(number, sizeof(number), "%.4f", 100.0 * fake / total);
+    return number;
+}
+
+/**
+ * The topN terms with the most occurrences in the selected articles, summed
+ * from the term frequencies of the posting lists (no article is tokenized
+ * again). Ties go to the alphabetically smaller term.
+ * @param index The inverted index
+ * @param selected One flag per article id
+ * @param topN Number of terms wanted
+ * @param topCounts Receives the count of each term (topN entries)
+ * @param resultCount Set to the number of terms found
+ * @return new array of term ids (caller must delete[])
+ */
+int* topIndexTerms(const InvertedIndex& index, const bool* selected, int topN, long long* topCounts, int& resultCount) {
+    int* topIds = new int[topN];
+    resultCount = 0;
+    int* tfs = new int[index.docCount > 0 ? index.docCount : 1];
+    for (int t = 0; t < index.termCount; t++) {
+        const PostingList& list = index.postings[t];
+        int* docs = decodePostings(list, tfs);
+        long long total = 0;
+        for (int i = 0; i < list.docFreq; i++)
+            if (selected[docs[i]]) total += tfs[i];
+        delete[] docs;
+        if (total == 0) continue;
+
+        // Insert into the sorted top list, dropping the weakest when full
+        int pos = resultCount;
+        while (pos > 0 && (topCounts[pos - 1] < total ||
+                           (topCounts[pos - 1] == total && index.terms[topIds[pos - 1]] > index.terms[t])))
+            pos--;
+        if (pos >= topN) continue;
+        int last = (resultCount < topN) ? resultCount++ : topN - 1;
+        for (int i = last; i > pos; i--) {
+            topIds[i] = topIds[i - 1];
+            topCounts[i] = topCounts[i - 1];
+        }
+        topIds[pos] = t;
+        topCounts[pos] = total;
+    }
+    delete[] tfs;
+    return topIds;
+}
+
+/**
+ * Run one operation and write its JSON object
+ * @param op The operation, e.g. "search 2016"
+ * @param newsBook The linked list of news (relinked by the sorts)
+ * @param columns The query columns (load order and labels)
+ * @param json Receives the result
+ * @return false if the operation could not be run
+ */
+bool runBatchOp(const string& op, News*& newsBook, const QueryColumns& columns, const InvertedIndex& textIndex,
+                const AggregateCube& cube, ostream& json) {
+    istringstream words(op);
+    string name;
+    words >> name;
+    json << "    {\"op\": \"" << jsonEscape(op) << "\", ";
+
+    if (name == "sort") {
+        string algorithm;
+        words >> algorithm;
+        if (algorithm != "quick" && algorithm != "insertion") {
+            json << "\"error\": \"algorithm must be quick or insertion\"}";
+            return false;
+        }
+        // Relink the nodes in load order so every sort starts from the same list
+        for (int i = 0; i < columns.rowCount; i++)
+            columns.nodes[i] -> next = (i + 1 < columns.rowCount) ? columns.nodes[i + 1] : nullptr;
+        newsBook = columns.rowCount > 0 ? columns.nodes[0] : nullptr;
+
+        auto start = chrono::high_resolution_clock::now();
+        if (algorithm == "quick") quickSort(&newsBook);
+        else insertionSort(newsBook);
+        auto end = chrono::high_resolution_clock::now();
+
+        int articles = 0, lastDate = 0;
+        bool sorted = true;
+        for (News* cur = newsBook; cur; cur = cur -> next) {
+            articles++;
+            int date = packDate(cur -> date);
+            if (date == 0) continue;
+            if (date < lastDate) sorted = false;
+            lastDate = date;
+        }
+        json << "\"time_us\": " << chrono::duration_cast<chrono::microseconds>(end - start).count()
+            << ", \"result\": {\"algorithm\": \"" << algorithm << "\", \"articles\": " << articles
+            << ", \"sorted\": " << (sorted ? "true" : "false") << "}}";
+        return true;
+    }
+
+    if (name == "search") {
+        int year = 0;
+        if (!(words >> year)) { json << "\"error\": \"usage: search YEAR\"}"; return false; }
+        auto start = chrono::high_resolution_clock::now();
+        int matches = 0, fake = 0;
+        for (News* cur = newsBook; cur; cur = cur -> next) {
+            if (packDate(cur -> date) / 10000 == year) {
+                matches++;
+                if (cur -> identify == "FAKE") fake++;
+            }
+        }
+        auto end = chrono::high_resolution_clock::now();
+        json << "\"time_us\": " << chrono::duration_cast<chrono::microseconds>(end - start).count()
+            << ", \"result\": {\"year\": " << year << ", \"matches\": " << matches
+            << ", \"fake\": " << fake << ", \"true\": " << matches - fake << "}}";
+        return true;
+    }
+
+    if (name == "percentage") {
+        int year = 2016;
+        string subject = "politics", word;
+        bool politicalSubjects = true;      // no SUBJECT given: the same set as countPoliticNews
+        while (words >> word) {
+            bool digits = word.size() <= 9;
+            for (char c : word) digits = digits && isdigit(static_cast<unsigned char>(c));
+            if (digits) year = stoi(word);
+            else { subject = word; politicalSubjects = false; }
+        }
+        CubeSlice slice;
+        if (politicalSubjects) slice.subjectFilter = isPoliticalSubject;
+        else slice.subject = subject;
+        slice.fromYear = slice.toYear = year;
+        int monthTotals[CUBE_MONTHS], monthFake[CUBE_MONTHS];
+        auto start = chrono::high_resolution_clock::now();
+        cubeBreakdown(cube, slice, CUBE_BY_MONTH, monthTotals);
+        slice.label = 0;
+        cubeBreakdown(cube, slice, CUBE_BY_MONTH, monthFake);
+        auto end = chrono::high_resolution_clock::now();
+        int total = 0, fake = 0;
+        for (int m = 0; m < CUBE_MONTHS; m++) {
+            total += monthTotals[m];
+            fake += monthFake[m];
+        }
+        json << "\"time_us\": " << chrono::duration_cast<chrono::microseconds>(end - start).count()
+            << ", \"result\": {\"year\": " << year << ", \"subject\": \"" << jsonEscape(subject)
+            << "\", \"total\": " << total << ", \"fake\": " << fake << ", \"percentage\": " << jsonShare(fake, total)
+            << ", \"by_month\": [";
+        for (int m = 1; m <= 12; m++) {
+            json << (m > 1 ? ", " : "") << "{\"month\": " << m << ", \"total\": " << monthTotals[m]
+                << ", \"fake\": " << monthFake[m] << ", \"percentage\": " << jsonShare(monthFake[m], monthTotals[m]) << "}";
+        }
+        json << "]}}";
+        return true;
+    }
+
+    if (name == "top") {
+        int topN = 0;
+        if (!(words >> topN) || topN < 1) { json << "\"error\": \"usage: top N\"}"; return false; }
+        auto start = chrono::high_resolution_clock::now();
+        // Fake articles whose subject mentions government, by article id
+        bool* governmentSubject = new bool[columns.subjectCount > 0 ? columns.subjectCount : 1];
+        for (int s = 0; s < columns.subjectCount; s++)
+            governmentSubject[s] = containsIgnoreCase(columns.subjectNames[s].data(), columns.subjectNames[s].size(), "government");
+        bool* selected = new bool[columns.rowCount > 0 ? columns.rowCount : 1];
+        for (int i = 0; i < columns.rowCount; i++)
+            selected[i] = ((columns.fakeBits[i >> 6] >> (i & 63)) & 1) && governmentSubject[columns.subjectId[i]];
+        long long* topCounts = new long long[topN];
+        int resultCount = 0;
+        int* topIds = topIndexTerms(textIndex, selected, topN, topCounts, resultCount);
+        auto end = chrono::high_resolution_clock::now();
+        json << "\"time_us\": " << chrono::duration_cast<chrono::microseconds>(end - start).count()
+            << ", \"result\": {\"vocabulary\": " << textIndex.termCount << ", \"stopwords_filtered\": false, \"words\": [";
+        for (int i = 0; i < resultCount; i++) {
+            json << (i > 0 ? ", " : "") << "{\"word\": \"" << jsonEscape(textIndex.terms[topIds[i]])
+                << "\", \"count\": " << topCounts[i] << "}";
+        }
+        json << "]}}";
+        delete[] topIds;
+        delete[] topCounts;
+        delete[] selected;
+        delete[] governmentSubject;
+        return true;
+    }
+
+    json << "\"error\": \"unknown operation\"}";
+    return false;
+}
+
+/**
+ * Run every operation of the job and write the JSON report
+ * @param loadTime Microseconds spent loading the file and building the indexes
+ * @return the number of operations that failed
+ */
+int runBatch(const BatchJob& job, News*& newsBook, const QueryColumns& columns, const InvertedIndex& textIndex,
+             const AggregateCube& cube, long long loadTime, ostream& json) {
+    int failed = 0;
+    json << "{\n  \"program\": \"linked_list_vid\",\n  \"dataset\": \"DataCleaned.csv\",\n"
+        << "  \"articles\": " << columns.rowCount << ",\n  \"load_us\": " << loadTime << ",\n  \"operations\": [\n";
+    for (int i = 0; i < job.opCount; i++) {
+        if (!runBatchOp(job.ops[i], newsBook, columns, textIndex, cube, json)) failed++;
+        json << (i + 1 < job.opCount ? ",\n" : "\n");
+    }
+    json << "  ],\n  \"failed\": " << failed << "\n}" << endl;
+    return failed;
+}
+
 int main(int argc, char const *argv[]) {
+    // Operations on the command line switch to script mode
+    BatchJob job;
+    if (argc > 1) {
+        string error;
+        if (!parseBatchArgs(argc, argv, job, error)) {
+            cerr << error << endl;
+            cerr << "Usage: linked_list_vid [--script FILE] [--run \"OPERATION\"]... [--out FILE]" << endl;
+            delete[] job.ops;
+            return 2;
+        }
+    }
+    // In script mode only the JSON report is printed
+    streambuf* stdoutBuffer = cout.rdbuf();
+    if (job.opCount > 0) cout.rdbuf(nullptr);
+    auto loadStart = chrono::high_resolution_clock::now();
+
     News* newsBook = nullptr;
     News* news = new News;
 
-    ifstream infile("DataCleaned.csv"); // Open file for reading
-
-    // Check the file open successfully
-    if (!infile) { cerr << "Error opening file" << endl; return 1; }
+    // The feed remembers how far the file has been read, so a refresh only
+    // loads the articles appended after that
+    FeedState feed;
+    feed.filename = "DataCleaned.csv";
 
     cout << "Loading news into Linked List..." << endl;
-    preloadNews(infile, newsBook); // Preload news into linked list
+    News* firstNew = nullptr;
+    if (loadNewRecords(feed, newsBook, firstNew) < 0) {
+        cout.rdbuf(stdoutBuffer);
+        cerr << "Error opening file" << endl;
+        delete[] job.ops;
+        return 1;
+    }
     cout << "News loaded successfully!\n" << endl;
-    infile.close(); // Close file
+    if (feed.pendingBytes > 0)
+        cout << "Last line has no newline yet (" << feed.pendingBytes << " bytes); option 6 loads it once complete\n" << endl;
+
+    // Build the date index once; it points at the nodes, so re-sorting the list keeps it valid
+    DateIndex dateIndex;
+    buildDateIndex(newsBook, dateIndex);
+    InvertedIndex textIndex;
+    buildInvertedIndex(newsBook, textIndex);
+    FacetIndex facetIndex;
+    buildFacetIndex(newsBook, facetIndex);
+    AggregateCube cube;
+    buildAggregateCube(newsBook, cube);
+    QueryColumns queryColumns;
+    buildQueryColumns(newsBook, queryColumns);
+
+    // Express lanes are only valid over a sorted list, so they are (re)built after every sort
+    SkipList skipList;
+
+    bool running = true;
+    int failed = 0;
+    if (job.opCount > 0) {
+        long long loadTime = chrono::duration_cast<chrono::microseconds>(chrono::high_resolution_clock::now() - loadStart).count();
+        if (job.outFile.empty()) {
+            ostream json(stdoutBuffer);
+            failed = runBatch(job, newsBook, queryColumns, textIndex, cube, loadTime, json);
+        } else {
+            ofstream json(job.outFile);
+            if (json) failed = runBatch(job, newsBook, queryColumns, textIndex, cube, loadTime, json);
+            if (!json) { cerr << "Cannot write " << job.outFile << endl; failed = job.opCount; }
+        }
+        cout.rdbuf(stdoutBuffer);
+        running = false;
+    }
 
 /**
  * 1. Sort the articles by year, display whole list in ascending order
@@ -595,7 +3498,6 @@ int main(int argc, char const *argv[]) {
  * 4. Functions that display all percentage for fake political news by every month in 2016 (minimum requirements) (MOST IMPORTANT!!)
  */
 
-    bool running = true;
     while (running) {
         // User Menu
         cout << "<<< User Menu >>>" << endl;
@@ -603,6 +3505,8 @@ int main(int argc, char const *argv[]) {
         cout << "2. Calculate the total articles (fake and true csv)" << endl;
         cout << "3. Search article by specific criteria" << endl;
         cout << "4. Display percentage for fake political news by every month in 2016" << endl;
+        cout << "5. Fake news share time series (all years, monthly / weekly)" << endl;
+        cout << "6. Refresh: load articles appended to " << feed.filename << endl;
 
         // User Input
         int choice;
@@ -646,6 +3550,10 @@ int main(int argc, char const *argv[]) {
                         auto endMem_quicksort = calculateDetailedMemory(newsBook);
                         endMem_quicksort.timeElapsed = chrono::duration<double>(timeEnd_quicksort - timeStart_quicksort).count();
                         displayMemoryStats(endMem_quicksort, "Quick Sort", netMemoryUsage);
+                        if (buildSkipList(newsBook, skipList)) {
+                            cout << "Skip list built: " << skipList.lanes << " express lanes, "
+                                << skipList.entries << " entries" << endl;
+                        }
                         printList(newsBook);
                         break;
                     }
@@ -674,6 +3582,10 @@ int main(int argc, char const *argv[]) {
                         auto endMem_insertsort = calculateDetailedMemory(newsBook);
                         endMem_insertsort.timeElapsed = chrono::duration<double>(timeEnd_insertsort - timeStart_insertsort).count();
                         displayMemoryStats(endMem_insertsort, "Insertion Sort", netMemoryUsage);
+                        if (buildSkipList(newsBook, skipList)) {
+                            cout << "Skip list built: " << skipList.lanes << " express lanes, "
+                                << skipList.entries << " entries" << endl;
+                        }
                         printList(newsBook);
                         break;
                     }
@@ -683,10 +3595,10 @@ int main(int argc, char const *argv[]) {
                 break;
             }
 
-            // Calculate total articles using Iterative methods
+            // Calculate total articles
             case 2: {
                 if (!newsBook) { cout << "No news articles found." << endl; break; }
-                cout << "\nCalculating using iterative methods..." << endl;
+                cout << "\nCounting articles..." << endl;
 
                 // Get working set before counting
                 PROCESS_MEMORY_COUNTERS pmc;
@@ -696,7 +3608,7 @@ int main(int argc, char const *argv[]) {
                 SIZE_T memoryBefore = pmc.WorkingSetSize;
 
                 auto start_calcNews = chrono::high_resolution_clock::now();
-                iterativeCount(newsBook);
+                countNewsCube(cube);
                 auto end_calcNews = chrono::high_resolution_clock::now();
 
                 // Get working set after counting
@@ -709,11 +3621,191 @@ int main(int argc, char const *argv[]) {
                 MemoryStats stats_calcNews = calculateDetailedMemory(newsBook);
                 stats_calcNews.timeElapsed = chrono::duration<double>(end_calcNews - start_calcNews).count();
                 displayMemoryStats(stats_calcNews, "Total Articles Calculation", netMemoryUsage);
+
+                // Baseline: the same count from a walk of the whole list
+                cout << "\nBaseline: walking the whole list..." << endl;
+                auto start_scan = chrono::high_resolution_clock::now();
+                iterativeCount(newsBook);
+                auto end_scan = chrono::high_resolution_clock::now();
+                MemoryStats stats_scan = calculateDetailedMemory(newsBook);
+                stats_scan.timeElapsed = chrono::duration<double>(end_scan - start_scan).count();
+                displayMemoryStats(stats_scan, "Total Articles Calculation (Baseline List Scan)");
                 break;
             }
 
             // Search article by specific criteria
             case 3: { // Linear Search and Binary Search for ques 3
+                cout << "\nSearch Menu" << endl;
+                cout << "1. Search by year" << endl;
+                cout << "2. Search by date range" << endl;
+                cout << "3. Full-text search (AND / OR / NOT)" << endl;
+                cout << "4. Ranked full-text search" << endl;
+                cout << "5. Filter expression (e.g. year=2016 AND subject~politics AND label=FAKE)" << endl;
+
+                int searchChoice;
+                cout << "\nSelect search criteria: ";
+                cin >> searchChoice;
+
+                if (searchChoice == 2) {
+                    string fromDate, toDate, subject, identify;
+                    cout << "Enter start date (dd-mm-yyyy): ";
+                    cin >> fromDate;
+                    cout << "Enter end date (dd-mm-yyyy): ";
+                    cin >> toDate;
+                    cout << "Subject contains (or 'all'): ";
+                    cin >> subject;
+                    cout << "Identify FAKE/TRUE (or 'all'): ";
+                    cin >> identify;
+                    if (subject == "all") subject = "";
+                    for (char& c : identify) c = toupper(c);
+                    if (identify == "ALL") identify = "";
+
+                    int from = packDate(fromDate), to = packDate(toDate);
+                    if (from == 0 || to == 0) { cout << "Invalid date, please use dd-mm-yyyy." << endl; break; }
+
+                    PROCESS_MEMORY_COUNTERS pmc;
+                    if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) {
+                        cerr << "Failed to get memory info" << endl;
+                    }
+                    SIZE_T memoryBefore = pmc.WorkingSetSize;
+
+                    int matchCount = 0;
+                    auto start_rangeSearch = chrono::high_resolution_clock::now();
+                    News** results = queryDateRange(dateIndex, from, to, subject, identify, matchCount);
+                    auto end_rangeSearch = chrono::high_resolution_clock::now();
+
+                    if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) {
+                        cerr << "Failed to get memory info" << endl;
+                    }
+                    SIZE_T memoryAfter = pmc.WorkingSetSize;
+                    SIZE_T netMemoryUsage = (memoryAfter > memoryBefore) ? (memoryAfter - memoryBefore) : 0;
+
+                    cout << "\nTotal articles found: " << matchCount << endl;
+                    for (int i = 0; i < matchCount; i++) {
+                        cout << "Title: " << results[i] -> title << ", Date: " << results[i] -> date
+                            << ", Subject: " << results[i] -> subject << ", Identify: " << results[i] -> identify << endl;
+                    }
+                    delete[] results;
+
+                    MemoryStats stats_rangeSearch = calculateDetailedMemory(newsBook);
+                    stats_rangeSearch.timeElapsed = chrono::duration<double>(end_rangeSearch - start_rangeSearch).count();
+                    displayMemoryStats(stats_rangeSearch, "Date Range Search", netMemoryUsage);
+                    break;
+                }
+                if (searchChoice == 3 || searchChoice == 4) {
+                    string query;
+                    cout << "Enter search terms: ";
+                    cin >> ws;
+                    getline(cin, query);
+
+                    PROCESS_MEMORY_COUNTERS pmc;
+                    if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) {
+                        cerr << "Failed to get memory info" << endl;
+                    }
+                    SIZE_T memoryBefore = pmc.WorkingSetSize;
+
+                    const int TOP_RESULTS = 10;
+                    int matchCount = 0;
+                    int* docs = nullptr;
+                    double* scores = nullptr;
+                    auto start_textSearch = chrono::high_resolution_clock::now();
+                    if (searchChoice == 3) {
+                        docs = searchBoolean(textIndex, query, matchCount);
+                    } else {
+                        docs = new int[TOP_RESULTS];
+                        scores = new double[TOP_RESULTS];
+                        matchCount = searchRanked(textIndex, query, TOP_RESULTS, docs, scores);
+                    }
+                    auto end_textSearch = chrono::high_resolution_clock::now();
+
+                    if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) {
+                        cerr << "Failed to get memory info" << endl;
+                    }
+                    SIZE_T memoryAfter = pmc.WorkingSetSize;
+                    SIZE_T netMemoryUsage = (memoryAfter > memoryBefore) ? (memoryAfter - memoryBefore) : 0;
+
+                    cout << "\nTotal articles found: " << matchCount << endl;
+                    for (int i = 0; i < matchCount; i++) {
+                        News* node = textIndex.docNodes[docs[i]];
+                        cout << "Title: " << node -> title << ", Date: " << node -> date;
+                        if (scores) cout << ", Score: " << fixed << setprecision(4) << scores[i];
+                        cout << endl;
+                    }
+                    delete[] docs;
+                    delete[] scores;
+
+                    MemoryStats stats_textSearch = calculateDetailedMemory(newsBook);
+                    stats_textSearch.timeElapsed = chrono::duration<double>(end_textSearch - start_textSearch).count();
+                    displayMemoryStats(stats_textSearch, "Full-Text Search", netMemoryUsage);
+                    break;
+                }
+                if (searchChoice == 5) {
+                    string expression, error;
+                    cout << "Enter filter expression: ";
+                    cin >> ws;
+                    getline(cin, expression);
+                    QueryNode* root = parseQuery(expression, error);
+                    if (!root) { cout << "Invalid expression: " << error << endl; break; }
+                    QueryPlan plan = compileQuery(root, queryColumns);
+                    printQueryPlan(plan);
+
+                    // Row-at-a-time walk of the list
+                    PROCESS_MEMORY_COUNTERS pmc;
+                    if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) {
+                        cerr << "Failed to get memory info" << endl;
+                    }
+                    SIZE_T memoryBeforeRows = pmc.WorkingSetSize;
+
+                    int matchCountRows = 0;
+                    auto start_rowQuery = chrono::high_resolution_clock::now();
+                    News** rowResults = queryListRowByRow(newsBook, root, matchCountRows);
+                    auto end_rowQuery = chrono::high_resolution_clock::now();
+
+                    if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) {
+                        cerr << "Failed to get memory info" << endl;
+                    }
+                    SIZE_T memoryAfterRows = pmc.WorkingSetSize;
+                    SIZE_T netMemoryUsageRows = (memoryAfterRows > memoryBeforeRows) ? (memoryAfterRows - memoryBeforeRows) : 0;
+
+                    // Compiled plan over the query columns
+                    if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) {
+                        cerr << "Failed to get memory info" << endl;
+                    }
+                    SIZE_T memoryBeforePlan = pmc.WorkingSetSize;
+
+                    int matchCount = 0;
+                    auto start_planQuery = chrono::high_resolution_clock::now();
+                    News** results = runQueryPlan(plan, queryColumns, matchCount);
+                    auto end_planQuery = chrono::high_resolution_clock::now();
+
+                    if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) {
+                        cerr << "Failed to get memory info" << endl;
+                    }
+                    SIZE_T memoryAfterPlan = pmc.WorkingSetSize;
+                    SIZE_T netMemoryUsagePlan = (memoryAfterPlan > memoryBeforePlan) ? (memoryAfterPlan - memoryBeforePlan) : 0;
+
+                    int fakeMatches = 0;
+                    for (int i = 0; i < matchCount; i++) fakeMatches += (results[i] -> identify == "FAKE");
+                    cout << "\nTotal articles found: " << matchCount << " (" << fakeMatches << " FAKE)" << endl;
+                    for (int i = 0; i < matchCount; i++) {
+                        cout << "Title: " << results[i] -> title << ", Date: " << results[i] -> date
+                            << ", Subject: " << results[i] -> subject << ", Identify: " << results[i] -> identify << endl;
+                    }
+                    delete[] rowResults;
+                    delete[] results;
+                    freeQueryPlan(plan);
+                    freeQueryNode(root);
+
+                    MemoryStats stats_rowQuery = calculateDetailedMemory(newsBook);
+                    stats_rowQuery.timeElapsed = chrono::duration<double>(end_rowQuery - start_rowQuery).count();
+                    displayMemoryStats(stats_rowQuery, "Filter Expression (Row-at-a-time, " + to_string(matchCountRows) + " matches)", netMemoryUsageRows);
+                    MemoryStats stats_planQuery = calculateDetailedMemory(newsBook);
+                    stats_planQuery.timeElapsed = chrono::duration<double>(end_planQuery - start_planQuery).count();
+                    displayMemoryStats(stats_planQuery, "Filter Expression (Compiled Plan, " + to_string(matchCount) + " matches)", netMemoryUsagePlan);
+                    break;
+                }
+                if (searchChoice != 1) { cout << "\nInvalid choice. Please try again." << endl; break; }
+
                 cout << "\nEnter search criteria (year): ";
                 int year;
                 cin >> year;
@@ -759,6 +3851,32 @@ int main(int argc, char const *argv[]) {
                 MemoryStats stats_binSearch = calculateDetailedMemory(newsBook);
                 stats_binSearch.timeElapsed = chrono::duration<double>(end_binSearch - start_binSearch).count();
                 displayMemoryStats(stats_binSearch, "Binary Search", netMemoryUsageBin);
+
+                // Skip List Search (express lanes built by the last sort)
+                if (!skipList.top) {
+                    cout << "\nSkip list search unavailable: sort the list first (option 1)." << endl;
+                    break;
+                }
+                if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) {
+                    cerr << "Failed to get memory info" << endl;
+                }
+                SIZE_T memoryBeforeSkip = pmc.WorkingSetSize;
+
+                auto start_skipSearch = chrono::high_resolution_clock::now();
+                cout << "\nArticle found: " << skipListSearch(skipList, year) << endl;
+                auto end_skipSearch = chrono::high_resolution_clock::now();
+
+                if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) {
+                    cerr << "Failed to get memory info" << endl;
+                }
+                SIZE_T memoryAfterSkip = pmc.WorkingSetSize;
+                SIZE_T netMemoryUsageSkip = (memoryAfterSkip > memoryBeforeSkip) ? (memoryAfterSkip - memoryBeforeSkip) : 0;
+
+                MemoryStats stats_skipSearch = calculateDetailedMemory(newsBook);
+                stats_skipSearch.pointerSize += skipList.entries * sizeof(SkipNode);
+                stats_skipSearch.totalSize += skipList.entries * sizeof(SkipNode);
+                stats_skipSearch.timeElapsed = chrono::duration<double>(end_skipSearch - start_skipSearch).count();
+                displayMemoryStats(stats_skipSearch, "Skip List Search", netMemoryUsageSkip);
                 break;
             }
 
@@ -773,7 +3891,7 @@ int main(int argc, char const *argv[]) {
                 SIZE_T memoryBefore = pmc.WorkingSetSize;
 
                 auto start_disPercent = chrono::high_resolution_clock::now();
-                countPoliticNews(&newsBook);
+                countPoliticNewsCube(cube);
                 auto end_disPercent = chrono::high_resolution_clock::now();
 
                 if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) {
@@ -785,13 +3903,126 @@ int main(int argc, char const *argv[]) {
                 MemoryStats stats_disPercent = calculateDetailedMemory(newsBook);
                 stats_disPercent.timeElapsed = chrono::duration<double>(end_disPercent - start_disPercent).count();
                 displayMemoryStats(stats_disPercent, "Political News Analysis", netMemoryUsage);
+
+                // Baseline: the same report from a walk of the whole list
+                cout << "\nBaseline: walking the whole list..." << endl;
+                auto start_scan = chrono::high_resolution_clock::now();
+                countPoliticNews(&newsBook);
+                auto end_scan = chrono::high_resolution_clock::now();
+                MemoryStats stats_scan = calculateDetailedMemory(newsBook);
+                stats_scan.timeElapsed = chrono::duration<double>(end_scan - start_scan).count();
+                displayMemoryStats(stats_scan, "Political News Analysis (Baseline List Scan)");
+                break;
+            }
+
+            // Fake news share for every subject across all years
+            case 5: {
+                cout << "\nTime Series Menu" << endl;
+                cout << "1. Monthly" << endl;
+                cout << "2. Weekly" << endl;
+
+                int granularity;
+                cout << "\nSelect granularity: ";
+                cin >> granularity;
+                if (granularity != 1 && granularity != 2) { cout << "\nInvalid choice. Please try again." << endl; break; }
+
+                cout << "0. All subjects" << endl;
+                for (int s = 0; s < queryColumns.subjectCount; s++) cout << s + 1 << ". " << queryColumns.subjectNames[s] << endl;
+                int seriesChoice;
+                cout << "Select series to plot: ";
+                cin >> seriesChoice;
+                if (seriesChoice < 0 || seriesChoice > queryColumns.subjectCount) { cout << "\nInvalid choice. Please try again." << endl; break; }
+
+                int window;
+                cout << "Rolling window (" << (granularity == 1 ? "months" : "weeks") << "): ";
+                cin >> window;
+                if (window < 1) window = 1;
+
+                PROCESS_MEMORY_COUNTERS pmc;
+                if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) {
+                    cerr << "Failed to get memory info" << endl;
+                }
+                SIZE_T memoryBefore = pmc.WorkingSetSize;
+
+                // Both granularities come out of the same pass
+                TimeSeries monthly, weekly;
+                auto start_timeSeries = chrono::high_resolution_clock::now();
+                buildTimeSeries(queryColumns, monthly, weekly);
+                auto end_timeSeries = chrono::high_resolution_clock::now();
+
+                if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) {
+                    cerr << "Failed to get memory info" << endl;
+                }
+                SIZE_T memoryAfter = pmc.WorkingSetSize;
+                SIZE_T netMemoryUsage = (memoryAfter > memoryBefore) ? (memoryAfter - memoryBefore) : 0;
+
+                const TimeSeries& series = (granularity == 1) ? monthly : weekly;
+                int seriesIndex = (seriesChoice == 0) ? queryColumns.subjectCount : seriesChoice - 1;
+                displayTimeSeries(series, queryColumns, seriesIndex, window);
+                string csvFile = (granularity == 1) ? "FakeShareMonthly.csv" : "FakeShareWeekly.csv";
+                if (writeTimeSeriesCsv(series, queryColumns, window, csvFile)) cout << "\nAll subjects written to " << csvFile << endl;
+                else cout << "\nCould not write " << csvFile << endl;
+                cout << "Periods: " << monthly.periodCount << " months, " << weekly.periodCount << " weeks" << endl;
+
+                MemoryStats stats_timeSeries = calculateDetailedMemory(newsBook);
+                stats_timeSeries.timeElapsed = chrono::duration<double>(end_timeSeries - start_timeSeries).count();
+                displayMemoryStats(stats_timeSeries, "Time Series Build (Monthly + Weekly)", netMemoryUsage);
+                freeTimeSeries(monthly);
+                freeTimeSeries(weekly);
+                break;
+            }
+
+            // Load the articles appended to the feed and add them to every index
+            case 6: {
+                cout << "\nLoading new articles from " << feed.filename << "..." << endl;
+
+                PROCESS_MEMORY_COUNTERS pmc;
+                if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) {
+                    cerr << "Failed to get memory info" << endl;
+                }
+                SIZE_T memoryBefore = pmc.WorkingSetSize;
+
+                auto timeStart_refresh = chrono::high_resolution_clock::now();
+                int added = loadNewRecords(feed, newsBook, firstNew);
+                bool lanesDropped = added > 0 && skipList.top;
+                if (added > 0) {
+                    addToDateIndex(dateIndex, firstNew);
+                    addToInvertedIndex(textIndex, firstNew);
+                    addToFacetIndex(facetIndex, firstNew);
+                    addToAggregateCube(cube, firstNew);
+                    addToQueryColumns(queryColumns, firstNew);
+                    // The new articles sit unsorted at the end of the list
+                    freeSkipList(skipList);
+                }
+                auto timeEnd_refresh = chrono::high_resolution_clock::now();
+
+                if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) {
+                    cerr << "Failed to get memory info" << endl;
+                }
+                SIZE_T memoryAfter = pmc.WorkingSetSize;
+                SIZE_T netMemoryUsage = (memoryAfter > memoryBefore) ? (memoryAfter - memoryBefore) : 0;
+
+                if (added < 0) {
+                    cout << feed.filename << " is missing or shorter than before; restart the program to reload it" << endl;
+                    break;
+                }
+                cout << "New articles: " << added << ", Total articles: " << feed.rowCount << endl;
+                if (feed.pendingBytes > 0)
+                    cout << "Last line has no newline yet (" << feed.pendingBytes << " bytes); it will be loaded once complete" << endl;
+                if (lanesDropped)
+                    cout << "The list is no longer sorted; sort it again (option 1) for the skip list search" << endl;
+                countNewsCube(cube);
+
+                MemoryStats stats_refresh = calculateDetailedMemory(newsBook);
+                stats_refresh.timeElapsed = chrono::duration<double>(timeEnd_refresh - timeStart_refresh).count();
+                displayMemoryStats(stats_refresh, "Refresh (" + to_string(added) + " new articles)", netMemoryUsage);
                 break;
             }
 
             default: { cout << "Invalid choice, please try again." << endl; }
         }
 
-        if (running && choice >= 1 && choice <= 4) {
+        if (running && choice >= 1 && choice <= 6) {
             cout << "\nPress Enter to return to menu...\n";
             cin.ignore();   // Ignore newline character
             cin.get();      // Wait for user input
@@ -799,6 +4030,13 @@ int main(int argc, char const *argv[]) {
     }
     // Cleanup
     // Free memory allocated for the linked list
+    freeSkipList(skipList);
+    freeQueryColumns(queryColumns);
+    freeAggregateCube(cube);
+    freeFacetIndex(facetIndex);
+    freeInvertedIndex(textIndex);
+    freeDateIndex(dateIndex);
+    delete[] job.ops;
     delete news;
-    return 0;
+    return failed > 0 ? 1 : 0;
 }